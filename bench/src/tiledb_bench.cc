@@ -0,0 +1,1028 @@
+/**
+ * @file   tiledb_bench.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ * 
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * It benchmarks the main TileDB operations on synthetic arrays generated
+ * locally from a fixed seed, namely dense and sparse writes, unsorted writes,
+ * sorted row/column reads, subarray reads of varying selectivity, AIO reads,
+ * metadata writes and reads, consolidation, and every compressor. Each
+ * benchmark is repeated several times, and its results are emitted as one
+ * JSON object per line, so that runs on different commits can be compared.
+ *
+ * Usage: tiledb_bench [--workspace DIR] [--output FILE] [--filter SUBSTRING]
+ *                     [--size N] [--repeat R] 
+ */
+
+#include "tiledb.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+
+/* ****************************** */
+/*           CONSTANTS            */
+/* ****************************** */
+
+/** The number of concurrent AIO read requests. */
+#define BENCH_AIO_NUM                                  16
+/** The tile capacity of the sparse arrays. */
+#define BENCH_CAPACITY                              10000
+/** The number of fragments of the multi-fragment sparse arrays. */
+#define BENCH_FRAGMENT_NUM                              4
+/** The number of keys read from the metadata. */
+#define BENCH_METADATA_GET_NUM                       1000
+/** The number of keys written to the metadata. */
+#define BENCH_METADATA_PUT_NUM                      10000
+/** The default number of repetitions of each benchmark. */
+#define BENCH_REPEAT                                    5
+/** The seed of the synthetic data generator. */
+#define BENCH_SEED                                     42
+/** The default side of the square domain of the arrays. */
+#define BENCH_SIZE                                   1000
+/** The number of cells of the small read buffers. */
+#define BENCH_SMALL_BUFFER_CELLS                     1000
+/** A sparse cell is written every that many dense cells on average. */
+#define BENCH_SPARSE_STEP                              10
+/** The tile extent on both dimensions of the dense arrays. */
+#define BENCH_TILE_EXTENT                             100
+/** The number of update fragments consolidated. */
+#define BENCH_UPDATE_NUM                                4
+
+
+
+
+/* ****************************** */
+/*             MACROS             */
+/* ****************************** */
+
+/** Returns with an error if a TileDB call fails, printing its message. */
+#define BENCH_CHECK(x)                                                        \
+  do {                                                                        \
+    if((x) != TILEDB_OK) {                                                    \
+      fprintf(stderr, "%s\n", tiledb_errmsg);                                 \
+      return TILEDB_ERR;                                                      \
+    }                                                                         \
+  } while(0)
+
+
+
+
+/* ****************************** */
+/*        GLOBAL VARIABLES        */
+/* ****************************** */
+
+/** The TileDB context. */
+static TileDB_CTX* tiledb_ctx = NULL;
+
+/** Only the benchmarks whose name contains this string are run. */
+static std::string bench_filter;
+
+/** The file the results are written to. */
+static FILE* bench_out = stdout;
+
+/** The number of repetitions of each benchmark. */
+static int bench_repeat = BENCH_REPEAT;
+
+/** The side of the square domain of the arrays. */
+static int64_t bench_size = BENCH_SIZE;
+
+/** The workspace the arrays are created in. */
+static std::string bench_workspace = "tiledb_bench_workspace";
+
+/** The compressors benchmarked, along with their names. */
+static const struct { int compression_; const char* name_; } 
+    bench_compressors[] = {
+        { TILEDB_NO_COMPRESSION, "none" },
+        { TILEDB_GZIP, "gzip" },
+        { TILEDB_ZSTD, "zstd" },
+        { TILEDB_LZ4, "lz4" },
+        { TILEDB_BLOSC, "blosc" },
+        { TILEDB_BLOSC_LZ4, "blosc_lz4" },
+        { TILEDB_BLOSC_LZ4HC, "blosc_lz4hc" },
+        { TILEDB_BLOSC_SNAPPY, "blosc_snappy" },
+        { TILEDB_BLOSC_ZLIB, "blosc_zlib" },
+        { TILEDB_BLOSC_ZSTD, "blosc_zstd" },
+        { TILEDB_RLE, "rle" } };
+
+
+
+
+/* ****************************** */
+/*        SYNTHETIC DATA          */
+/* ****************************** */
+
+/** 
+ * Returns the next number of a linear congruential generator, so that the
+ * synthetic data are identical across runs and platforms.
+ */
+static int64_t bench_rand(uint64_t& state) {
+  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return int64_t(state >> 33);
+}
+
+/** 
+ * Generates the values of all the cells of a dense array in the global cell
+ * order, i.e., tile by tile. Each value is the row-major position of the cell
+ * plus a small random noise, which makes the data moderately compressible.
+ */
+static void bench_dense_cells(std::vector<int>& cells) {
+  uint64_t state = BENCH_SEED;
+  int64_t tile_num = bench_size / BENCH_TILE_EXTENT;
+  cells.resize(bench_size * bench_size);
+  int64_t i = 0;
+  for(int64_t tr=0; tr<tile_num; ++tr) 
+    for(int64_t tc=0; tc<tile_num; ++tc) 
+      for(int64_t r=0; r<BENCH_TILE_EXTENT; ++r) 
+        for(int64_t c=0; c<BENCH_TILE_EXTENT; ++c) 
+          cells[i++] = 
+              int((tr * BENCH_TILE_EXTENT + r) * bench_size + 
+                  tc * BENCH_TILE_EXTENT + c + bench_rand(state) % 16);
+}
+
+/** 
+ * Generates the coordinates and values of the cells of a sparse array in
+ * row-major order, one random cell every BENCH_SPARSE_STEP cells. The value
+ * of each cell is its row-major position. If *shuffle* is true, the cells are
+ * randomly shuffled.
+ */
+static void bench_sparse_cells(
+    std::vector<int>& cells,
+    std::vector<int64_t>& coords,
+    bool shuffle) {
+  uint64_t state = BENCH_SEED;
+  int64_t cell_num = bench_size * bench_size / BENCH_SPARSE_STEP;
+  cells.resize(cell_num);
+  coords.resize(2*cell_num);
+  for(int64_t i=0; i<cell_num; ++i) {
+    int64_t pos = i * BENCH_SPARSE_STEP + bench_rand(state) % BENCH_SPARSE_STEP;
+    cells[i] = int(pos);
+    coords[2*i] = pos / bench_size;
+    coords[2*i+1] = pos % bench_size;
+  }
+
+  if(shuffle) {
+    for(int64_t i=cell_num-1; i>0; --i) {
+      int64_t j = bench_rand(state) % (i+1);
+      std::swap(cells[i], cells[j]);
+      std::swap(coords[2*i], coords[2*j]);
+      std::swap(coords[2*i+1], coords[2*j+1]);
+    }
+  }
+}
+
+
+
+
+/* ****************************** */
+/*        TILEDB OPERATIONS       */
+/* ****************************** */
+
+/** Returns the path of a TileDB object in the benchmark workspace. */
+static std::string bench_path(const std::string& name) {
+  return bench_workspace + "/" + name;
+}
+
+/** Deletes a TileDB object, ignoring the error if it does not exist. */
+static void bench_delete(const std::string& name) {
+  tiledb_delete(tiledb_ctx, bench_path(name).c_str());
+}
+
+/** 
+ * (Re-)creates a 2D array with a single int32 attribute "a1" and int64
+ * coordinates, whose attribute and coordinates use the input compression.
+ */
+static int bench_array_create(
+    const std::string& name, 
+    bool dense, 
+    int compression) {
+  bench_delete(name);
+
+  std::string array_name = bench_path(name);
+  const char* attributes[] = { "a1" };
+  const char* dimensions[] = { "d1", "d2" };
+  int64_t domain[] = { 0, bench_size-1, 0, bench_size-1 };
+  int64_t tile_extents[] = { BENCH_TILE_EXTENT, BENCH_TILE_EXTENT };
+  const int compressions[] = { compression, compression };
+  const int types[] = { TILEDB_INT32, TILEDB_INT64 };
+
+  TileDB_ArraySchema array_schema;
+  BENCH_CHECK(
+      tiledb_array_set_schema( 
+          &array_schema, 
+          array_name.c_str(), 
+          attributes, 
+          1,
+          BENCH_CAPACITY,
+          TILEDB_ROW_MAJOR,
+          NULL,
+          compressions,
+          dense,
+          dimensions,
+          2,
+          domain,
+          sizeof(domain),
+          dense ? tile_extents : NULL,
+          dense ? sizeof(tile_extents) : 0,
+          TILEDB_ROW_MAJOR,
+          types));
+  int rc = tiledb_array_create(tiledb_ctx, &array_schema);
+  tiledb_array_free_schema(&array_schema);
+  BENCH_CHECK(rc);
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Reads attribute "a1" of an array in the input subarray, repeating the read
+ * until the results are exhausted. 
+ */
+static int bench_array_read(
+    const std::string& name, 
+    int mode,
+    const int64_t* subarray,
+    std::vector<int>& buffer) {
+  TileDB_Array* tiledb_array;
+  const char* attributes[] = { "a1" };
+  BENCH_CHECK(
+      tiledb_array_init(
+          tiledb_ctx,
+          &tiledb_array,
+          bench_path(name).c_str(),
+          mode,
+          subarray,
+          attributes,
+          1));
+
+  void* buffers[] = { &buffer[0] };
+  size_t buffer_sizes[1];
+  do {
+    buffer_sizes[0] = buffer.size() * sizeof(int);
+    if(tiledb_array_read(tiledb_array, buffers, buffer_sizes) != TILEDB_OK) {
+      tiledb_array_finalize(tiledb_array);
+      BENCH_CHECK(TILEDB_ERR);
+    }
+  } while(tiledb_array_overflow(tiledb_array, 0) == 1);
+
+  BENCH_CHECK(tiledb_array_finalize(tiledb_array));
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Writes attribute "a1" (and the coordinates, if *coords* is not NULL) of an
+ * array in the input subarray. 
+ */
+static int bench_array_write(
+    const std::string& name, 
+    int mode,
+    const int64_t* subarray,
+    const std::vector<int>& cells,
+    const std::vector<int64_t>* coords) {
+  TileDB_Array* tiledb_array;
+  BENCH_CHECK(
+      tiledb_array_init(
+          tiledb_ctx,
+          &tiledb_array,
+          bench_path(name).c_str(),
+          mode,
+          subarray,
+          NULL,
+          0));
+
+  const void* buffers[] = 
+      { &cells[0], (coords != NULL) ? &(*coords)[0] : NULL };
+  const size_t buffer_sizes[] = 
+      { 
+          cells.size() * sizeof(int), 
+          (coords != NULL) ? coords->size() * sizeof(int64_t) : 0 
+      };
+  if(tiledb_array_write(tiledb_array, buffers, buffer_sizes) != TILEDB_OK) {
+    tiledb_array_finalize(tiledb_array);
+    BENCH_CHECK(TILEDB_ERR);
+  }
+
+  BENCH_CHECK(tiledb_array_finalize(tiledb_array));
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Computes the centered square subarray that contains the input fraction of
+ * the array domain.
+ */
+static void bench_subarray(double selectivity, int64_t* subarray) {
+  int64_t side = 
+      std::max(int64_t(1), int64_t(llround(bench_size * sqrt(selectivity))));
+  int64_t lo = (bench_size - side) / 2;
+  subarray[0] = subarray[2] = lo;
+  subarray[1] = subarray[3] = lo + side - 1;
+}
+
+
+
+
+/* ****************************** */
+/*            BENCHMARKS          */
+/* ****************************** */
+
+/** Wraps a benchmark setup so that it runs only before the first repetition. */
+static std::function<int()> bench_once(const std::function<int()>& setup) {
+  std::shared_ptr<bool> done(new bool(false));
+  return [=]() {
+    if(*done)
+      return TILEDB_OK;
+    *done = true;
+    return setup();
+  };
+}
+
+/** 
+ * Runs a benchmark *bench_repeat* times and writes its results as a JSON
+ * object in a single line. The setup (if any) runs untimed before every
+ * repetition, whereas the body is timed. 
+ *
+ * @param name The benchmark name.
+ * @param cells The number of cells the body processes.
+ * @param bytes The number of bytes the body processes.
+ * @param setup The untimed setup.
+ * @param body The timed body.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+static int bench_run(
+    const std::string& name,
+    int64_t cells,
+    int64_t bytes,
+    const std::function<int()>& setup,
+    const std::function<int()>& body) {
+  // Apply the filter
+  if(name.find(bench_filter) == std::string::npos)
+    return TILEDB_OK;
+
+  // Run
+  std::vector<double> seconds;
+  for(int i=0; i<bench_repeat; ++i) {
+    if(setup && setup() != TILEDB_OK) 
+      return TILEDB_ERR;
+    std::chrono::steady_clock::time_point start = 
+        std::chrono::steady_clock::now();
+    if(body() != TILEDB_OK) 
+      return TILEDB_ERR;
+    seconds.push_back(
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+  }
+
+  // Emit the results
+  std::sort(seconds.begin(), seconds.end());
+  double median = seconds[seconds.size()/2];
+  fprintf(
+      bench_out,
+      "{\"benchmark\": \"%s\", \"size\": %lld, \"repeat\": %d, "
+      "\"cells\": %lld, \"bytes\": %lld, \"min_seconds\": %.6f, "
+      "\"median_seconds\": %.6f, \"max_seconds\": %.6f, "
+      "\"mb_per_second\": %.2f}\n",
+      name.c_str(),
+      (long long) bench_size,
+      bench_repeat,
+      (long long) cells,
+      (long long) bytes,
+      seconds.front(),
+      median,
+      seconds.back(),
+      (median > 0) ? bytes / median / (1024*1024) : 0.0);
+  fflush(bench_out);
+
+  return TILEDB_OK;
+}
+
+/** Benchmarks dense writes and full reads with every compressor. */
+static int bench_dense_compressors() {
+  std::vector<int> cells;
+  bench_dense_cells(cells);
+  std::vector<int> buffer(cells.size());
+  int64_t bytes = cells.size() * sizeof(int);
+  int compressor_num = 
+      sizeof(bench_compressors) / sizeof(bench_compressors[0]);
+
+  for(int i=0; i<compressor_num; ++i) {
+    int compression = bench_compressors[i].compression_;
+    std::string suffix = bench_compressors[i].name_;
+    std::string name = "dense_" + suffix;
+    std::function<int()> create = [&]() { 
+      return bench_array_create(name, true, compression);
+    };
+    std::function<int()> write = [&]() { 
+      return bench_array_write(name, TILEDB_ARRAY_WRITE, NULL, cells, NULL);
+    };
+    std::function<int()> read = [&]() { 
+      return bench_array_read(name, TILEDB_ARRAY_READ, NULL, buffer);
+    };
+    std::function<int()> create_and_write = [&]() { 
+      return (create() == TILEDB_OK) ? write() : TILEDB_ERR;
+    };
+
+    if(bench_run(
+           "dense_write_" + suffix, cells.size(), bytes, 
+           create, write) != TILEDB_OK ||
+       bench_run(
+           "dense_read_" + suffix, cells.size(), bytes, 
+           bench_once(create_and_write), read) != TILEDB_OK) 
+      return TILEDB_ERR;
+    bench_delete(name);
+  }
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks the sorted row and column reads, as well as the subarray reads
+ * of varying selectivity, on a GZIP-compressed dense array.
+ */
+static int bench_dense_reads() {
+  std::vector<int> cells;
+  bench_dense_cells(cells);
+  std::vector<int> buffer(cells.size());
+  std::string name = "dense_gzip";
+  std::function<int()> setup = bench_once([&]() {
+    if(bench_array_create(name, true, TILEDB_GZIP) != TILEDB_OK)
+      return TILEDB_ERR;
+    return bench_array_write(name, TILEDB_ARRAY_WRITE, NULL, cells, NULL);
+  });
+
+  // Sorted reads in a subarray that is not aligned with the tiles
+  int64_t lo = BENCH_TILE_EXTENT / 4;
+  int64_t hi = bench_size - BENCH_TILE_EXTENT / 4 - 1;
+  int64_t sorted_subarray[] = { lo, hi, lo, hi };
+  int64_t sorted_cells = (hi - lo + 1) * (hi - lo + 1);
+  const struct { int mode_; const char* name_; } sorted_reads[] = {
+      { TILEDB_ARRAY_READ_SORTED_ROW, "dense_read_sorted_row" },
+      { TILEDB_ARRAY_READ_SORTED_COL, "dense_read_sorted_col" } };
+  for(int i=0; i<2; ++i) {
+    int mode = sorted_reads[i].mode_;
+    if(bench_run(
+           sorted_reads[i].name_, 
+           sorted_cells, 
+           sorted_cells * sizeof(int),
+           setup,
+           [&]() { 
+             return bench_array_read(name, mode, sorted_subarray, buffer); 
+           }) != TILEDB_OK)
+      return TILEDB_ERR;
+  }
+
+  // Subarray reads
+  const struct { double selectivity_; const char* name_; } subarray_reads[] = {
+      { 0.001, "dense_read_subarray_0.1pct" },
+      { 0.01, "dense_read_subarray_1pct" },
+      { 0.1, "dense_read_subarray_10pct" },
+      { 1.0, "dense_read_subarray_100pct" } };
+  for(int i=0; i<4; ++i) {
+    int64_t subarray[4];
+    bench_subarray(subarray_reads[i].selectivity_, subarray);
+    int64_t subarray_cells = 
+        (subarray[1] - subarray[0] + 1) * (subarray[3] - subarray[2] + 1);
+    if(bench_run(
+           subarray_reads[i].name_, 
+           subarray_cells, 
+           subarray_cells * sizeof(int),
+           setup,
+           [&]() { 
+             return bench_array_read(
+                        name, TILEDB_ARRAY_READ, subarray, buffer); 
+           }) != TILEDB_OK)
+      return TILEDB_ERR;
+  }
+
+  // AIO reads, issuing one request per band of rows concurrently
+  int request_num = 
+      int(std::min(int64_t(BENCH_AIO_NUM), bench_size));
+  if(bench_run(
+         "dense_read_aio", 
+         cells.size(), 
+         cells.size() * sizeof(int),
+         setup,
+         [&]() {
+           TileDB_Array* tiledb_array;
+           const char* attributes[] = { "a1" };
+           BENCH_CHECK(
+               tiledb_array_init(
+                   tiledb_ctx,
+                   &tiledb_array,
+                   bench_path(name).c_str(),
+                   TILEDB_ARRAY_READ,
+                   NULL,
+                   attributes,
+                   1));
+           std::vector<TileDB_AIO_Request> requests(request_num);
+           std::vector<int64_t> subarrays(4*request_num);
+           std::vector<void*> buffers(request_num);
+           std::vector<size_t> buffer_sizes(request_num);
+           int rc = TILEDB_OK;
+           for(int r=0; r<request_num; ++r) {
+             int64_t* subarray = &subarrays[4*r];
+             subarray[0] = r * bench_size / request_num;
+             subarray[1] = (r+1) * bench_size / request_num - 1;
+             subarray[2] = 0;
+             subarray[3] = bench_size - 1;
+             buffers[r] = &buffer[subarray[0] * bench_size];
+             buffer_sizes[r] = 
+                 (subarray[1] - subarray[0] + 1) * bench_size * sizeof(int);
+             memset(&requests[r], 0, sizeof(struct TileDB_AIO_Request));
+             requests[r].buffers_ = &buffers[r];
+             requests[r].buffer_sizes_ = &buffer_sizes[r];
+             requests[r].subarray_ = subarray;
+             if(tiledb_array_aio_read(tiledb_array, &requests[r]) != 
+                TILEDB_OK) {
+               request_num = r;
+               rc = TILEDB_ERR;
+               break;
+             }
+           }
+           for(int r=0; r<request_num; ++r) {
+             volatile int* status = &requests[r].status_;
+             while(*status == TILEDB_AIO_INPROGRESS);
+             if(*status != TILEDB_AIO_COMPLETED)
+               rc = TILEDB_ERR;
+           }
+           if(tiledb_array_finalize(tiledb_array) != TILEDB_OK)
+             rc = TILEDB_ERR;
+           BENCH_CHECK(rc);
+           return TILEDB_OK;
+         }) != TILEDB_OK)
+    return TILEDB_ERR;
+
+  bench_delete(name);
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks a full read of a dense array in which only the first tile is
+ * written, so that nearly all the results are empty cells.
+ */
+static int bench_dense_empty_reads() {
+  std::vector<int> buffer(bench_size * bench_size);
+  std::string name = "dense_empty";
+  std::function<int()> setup = bench_once([&]() {
+    if(bench_array_create(name, true, TILEDB_GZIP) != TILEDB_OK)
+      return TILEDB_ERR;
+    int64_t subarray[] = 
+        { 0, BENCH_TILE_EXTENT - 1, 0, BENCH_TILE_EXTENT - 1 };
+    std::vector<int> tile(BENCH_TILE_EXTENT * BENCH_TILE_EXTENT, 1);
+    return bench_array_write(
+               name, TILEDB_ARRAY_WRITE_SORTED_ROW, subarray, tile, NULL);
+  });
+
+  if(bench_run(
+         "dense_read_mostly_empty", 
+         buffer.size(), 
+         buffer.size() * sizeof(int),
+         setup,
+         [&]() { 
+           return bench_array_read(name, TILEDB_ARRAY_READ, NULL, buffer); 
+         }) != TILEDB_OK)
+    return TILEDB_ERR;
+
+  bench_delete(name);
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks sorted and unsorted sparse writes, as well as the subarray reads
+ * of varying selectivity, on a GZIP-compressed sparse array.
+ */
+static int bench_sparse() {
+  std::vector<int> cells, unsorted_cells;
+  std::vector<int64_t> coords, unsorted_coords;
+  bench_sparse_cells(cells, coords, false);
+  bench_sparse_cells(unsorted_cells, unsorted_coords, true);
+  std::vector<int> buffer(cells.size());
+  int64_t bytes = cells.size() * (sizeof(int) + 2*sizeof(int64_t));
+  std::string name = "sparse_gzip";
+  std::function<int()> create = [&]() {
+    return bench_array_create(name, false, TILEDB_GZIP);
+  };
+  std::function<int()> write = [&]() {
+    return bench_array_write(name, TILEDB_ARRAY_WRITE, NULL, cells, &coords);
+  };
+
+  // Writes
+  if(bench_run(
+         "sparse_write", cells.size(), bytes, create, write) != TILEDB_OK ||
+     bench_run(
+         "sparse_write_unsorted", 
+         cells.size(), 
+         bytes, 
+         create,
+         [&]() {
+           return bench_array_write(
+                      name, 
+                      TILEDB_ARRAY_WRITE_UNSORTED, 
+                      NULL, 
+                      unsorted_cells, 
+                      &unsorted_coords);
+         }) != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Subarray reads
+  std::function<int()> setup = bench_once([&]() {
+    return (create() == TILEDB_OK) ? write() : TILEDB_ERR;
+  });
+  const struct { double selectivity_; const char* name_; } subarray_reads[] = {
+      { 0.001, "sparse_read_subarray_0.1pct" },
+      { 0.01, "sparse_read_subarray_1pct" },
+      { 0.1, "sparse_read_subarray_10pct" },
+      { 1.0, "sparse_read_subarray_100pct" } };
+  for(int i=0; i<4; ++i) {
+    int64_t subarray[4];
+    bench_subarray(subarray_reads[i].selectivity_, subarray);
+    int64_t subarray_cells = 
+        (subarray[1] - subarray[0] + 1) * (subarray[3] - subarray[2] + 1) / 
+        BENCH_SPARSE_STEP;
+    if(bench_run(
+           subarray_reads[i].name_, 
+           subarray_cells, 
+           subarray_cells * sizeof(int),
+           setup,
+           [&]() { 
+             return bench_array_read(
+                        name, TILEDB_ARRAY_READ, subarray, buffer); 
+           }) != TILEDB_OK)
+      return TILEDB_ERR;
+  }
+
+  bench_delete(name);
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks full reads of a GZIP-compressed sparse array written in a single
+ * fragment, as well as in BENCH_FRAGMENT_NUM fragments of disjoint row bands,
+ * with buffers that fit all the results or only BENCH_SMALL_BUFFER_CELLS
+ * cells, i.e., with one or many small read rounds.
+ */
+static int bench_sparse_fragments() {
+  std::vector<int> cells;
+  std::vector<int64_t> coords;
+  bench_sparse_cells(cells, coords, false);
+  std::vector<int> buffer(cells.size());
+  std::vector<int> small_buffer(BENCH_SMALL_BUFFER_CELLS);
+  int64_t bytes = cells.size() * sizeof(int);
+
+  const int fragment_nums[] = { 1, BENCH_FRAGMENT_NUM };
+  for(int j=0; j<2; ++j) {
+    int f = fragment_nums[j];
+    std::string suffix = (f == 1) ? "one_fragment" : "fragments";
+    std::string name = "sparse_" + suffix;
+    std::function<int()> setup = bench_once([&, f, name]() {
+      if(bench_array_create(name, false, TILEDB_GZIP) != TILEDB_OK)
+        return TILEDB_ERR;
+      int64_t cell_num = cells.size();
+      for(int i=0; i<f; ++i) {
+        int64_t start = cell_num * i / f, end = cell_num * (i+1) / f;
+        std::vector<int> fragment_cells(
+            cells.begin() + start, 
+            cells.begin() + end);
+        std::vector<int64_t> fragment_coords(
+            coords.begin() + 2*start, 
+            coords.begin() + 2*end);
+        if(bench_array_write(
+               name, 
+               TILEDB_ARRAY_WRITE, 
+               NULL, 
+               fragment_cells, 
+               &fragment_coords) != TILEDB_OK)
+          return TILEDB_ERR;
+      }
+      return TILEDB_OK;
+    });
+
+    if(bench_run(
+           "sparse_read_" + suffix, 
+           cells.size(), 
+           bytes,
+           setup,
+           [&]() { 
+             return bench_array_read(name, TILEDB_ARRAY_READ, NULL, buffer); 
+           }) != TILEDB_OK ||
+       bench_run(
+           "sparse_read_" + suffix + "_small_buffers", 
+           cells.size(), 
+           bytes,
+           setup,
+           [&]() { 
+             return bench_array_read(
+                        name, TILEDB_ARRAY_READ, NULL, small_buffer); 
+           }) != TILEDB_OK)
+      return TILEDB_ERR;
+
+    bench_delete(name);
+  }
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks the consolidation of a dense array with a full fragment and
+ * BENCH_UPDATE_NUM update fragments.
+ */
+static int bench_consolidate() {
+  std::vector<int> cells;
+  bench_dense_cells(cells);
+  std::string name = "dense_consolidate";
+
+  if(bench_run(
+         "dense_consolidate",
+         cells.size(),
+         cells.size() * sizeof(int),
+         [&]() {
+           if(bench_array_create(name, true, TILEDB_GZIP) != TILEDB_OK ||
+              bench_array_write(
+                  name, TILEDB_ARRAY_WRITE, NULL, cells, NULL) != TILEDB_OK)
+             return TILEDB_ERR;
+           uint64_t state = BENCH_SEED;
+           int64_t side = std::max(int64_t(1), bench_size / 4);
+           std::vector<int> update(side * side, -1);
+           for(int u=0; u<BENCH_UPDATE_NUM; ++u) {
+             int64_t row = bench_rand(state) % (bench_size - side + 1);
+             int64_t col = bench_rand(state) % (bench_size - side + 1);
+             int64_t subarray[] = { row, row + side - 1, col, col + side - 1 };
+             if(bench_array_write(
+                    name, 
+                    TILEDB_ARRAY_WRITE_SORTED_ROW, 
+                    subarray, 
+                    update, 
+                    NULL) != TILEDB_OK)
+               return TILEDB_ERR;
+           }
+           return TILEDB_OK;
+         },
+         [&]() {
+           BENCH_CHECK(
+               tiledb_array_consolidate(
+                   tiledb_ctx, bench_path(name).c_str()));
+           return TILEDB_OK;
+         }) != TILEDB_OK)
+    return TILEDB_ERR;
+
+  bench_delete(name);
+
+  return TILEDB_OK;
+}
+
+/** 
+ * Benchmarks writing BENCH_METADATA_PUT_NUM keys to a metadata object in one
+ * batch, and reading BENCH_METADATA_GET_NUM random keys one by one.
+ */
+static int bench_metadata() {
+  // Prepare keys and values
+  std::vector<int> values(BENCH_METADATA_PUT_NUM);
+  std::vector<size_t> key_offsets(BENCH_METADATA_PUT_NUM);
+  std::string keys;
+  for(int i=0; i<BENCH_METADATA_PUT_NUM; ++i) {
+    values[i] = i;
+    key_offsets[i] = keys.size();
+    keys += "key_" + std::to_string(i);
+    keys.push_back('\0');
+  }
+  std::string name = "meta";
+  std::function<int()> create = [&]() {
+    bench_delete(name);
+    std::string metadata_name = bench_path(name);
+    const char* attributes[] = { "a1" };
+    const int compression[] = { TILEDB_GZIP, TILEDB_GZIP };
+    const int types[] = { TILEDB_INT32 };
+    TileDB_MetadataSchema metadata_schema;
+    BENCH_CHECK(
+        tiledb_metadata_set_schema(
+            &metadata_schema,
+            metadata_name.c_str(),
+            attributes,
+            1,
+            BENCH_CAPACITY,
+            NULL,
+            compression,
+            types));
+    int rc = tiledb_metadata_create(tiledb_ctx, &metadata_schema);
+    tiledb_metadata_free_schema(&metadata_schema);
+    BENCH_CHECK(rc);
+    return TILEDB_OK;
+  };
+  std::function<int()> put = [&]() {
+    TileDB_Metadata* tiledb_metadata;
+    BENCH_CHECK(
+        tiledb_metadata_init(
+            tiledb_ctx,
+            &tiledb_metadata,
+            bench_path(name).c_str(),
+            TILEDB_METADATA_WRITE,
+            NULL,
+            0));
+    const void* buffers[] = { &values[0], &key_offsets[0], keys.c_str() };
+    size_t buffer_sizes[] = 
+        { 
+            values.size() * sizeof(int), 
+            key_offsets.size() * sizeof(size_t),
+            keys.size()
+        };
+    int rc = tiledb_metadata_write(
+                 tiledb_metadata, 
+                 keys.c_str(), 
+                 keys.size(), 
+                 buffers, 
+                 buffer_sizes);
+    if(tiledb_metadata_finalize(tiledb_metadata) != TILEDB_OK)
+      rc = TILEDB_ERR;
+    BENCH_CHECK(rc);
+    return TILEDB_OK;
+  };
+
+  if(bench_run(
+         "metadata_put", 
+         BENCH_METADATA_PUT_NUM,
+         values.size() * sizeof(int) + keys.size(),
+         create, 
+         put) != TILEDB_OK ||
+     bench_run(
+         "metadata_get",
+         BENCH_METADATA_GET_NUM,
+         BENCH_METADATA_GET_NUM * sizeof(int),
+         bench_once([&]() { 
+           return (create() == TILEDB_OK) ? put() : TILEDB_ERR;
+         }),
+         [&]() {
+           TileDB_Metadata* tiledb_metadata;
+           const char* attributes[] = { "a1" };
+           BENCH_CHECK(
+               tiledb_metadata_init(
+                   tiledb_ctx,
+                   &tiledb_metadata,
+                   bench_path(name).c_str(),
+                   TILEDB_METADATA_READ,
+                   attributes,
+                   1));
+           uint64_t state = BENCH_SEED;
+           int rc = TILEDB_OK;
+           for(int i=0; i<BENCH_METADATA_GET_NUM && rc == TILEDB_OK; ++i) {
+             int key = bench_rand(state) % BENCH_METADATA_PUT_NUM;
+             int value;
+             void* buffers[] = { &value };
+             size_t buffer_sizes[] = { sizeof(int) };
+             rc = tiledb_metadata_read(
+                      tiledb_metadata, 
+                      keys.c_str() + key_offsets[key], 
+                      buffers, 
+                      buffer_sizes);
+             if(rc == TILEDB_OK && 
+                (buffer_sizes[0] != sizeof(int) || value != key)) {
+               fprintf(stderr, "Metadata key %d read incorrectly\n", key);
+               rc = TILEDB_ERR;
+             }
+           }
+           if(tiledb_metadata_finalize(tiledb_metadata) != TILEDB_OK)
+             rc = TILEDB_ERR;
+           BENCH_CHECK(rc);
+           return TILEDB_OK;
+         }) != TILEDB_OK)
+    return TILEDB_ERR;
+
+  bench_delete(name);
+
+  return TILEDB_OK;
+}
+
+
+
+
+/* ****************************** */
+/*              MAIN              */
+/* ****************************** */
+
+/** Prints the usage of the benchmark program. */
+static void bench_usage() {
+  fprintf(
+      stderr, 
+      "Usage: tiledb_bench [--workspace DIR] [--output FILE] "
+      "[--filter SUBSTRING] [--size N] [--repeat R]\n"
+      "  --workspace  The workspace of the arrays (it is deleted), "
+      "default: tiledb_bench_workspace\n"
+      "  --output     The file the JSON results are written to, "
+      "default: stdout\n"
+      "  --filter     Runs only the benchmarks whose name contains the "
+      "substring\n"
+      "  --size       The side of the square array domain, a multiple "
+      "of %d, default: %d\n"
+      "  --repeat     The repetitions of each benchmark, default: %d\n",
+      BENCH_TILE_EXTENT, 
+      BENCH_SIZE,
+      BENCH_REPEAT);
+}
+
+int main(int argc, char** argv) {
+  // Parse arguments
+  const char* output = NULL;
+  for(int i=1; i<argc; ++i) {
+    std::string arg = argv[i];
+    if(i == argc-1) {
+      bench_usage();
+      return -1;
+    }
+    const char* value = argv[++i];
+    if(arg == "--workspace") {
+      bench_workspace = value;
+    } else if(arg == "--output") {
+      output = value;
+    } else if(arg == "--filter") {
+      bench_filter = value;
+    } else if(arg == "--size") {
+      bench_size = atoll(value);
+    } else if(arg == "--repeat") {
+      bench_repeat = atoi(value);
+    } else {
+      bench_usage();
+      return -1;
+    }
+  }
+  if(bench_size <= 0 || bench_size % BENCH_TILE_EXTENT != 0 || 
+     bench_repeat <= 0) {
+    bench_usage();
+    return -1;
+  }
+  if(output != NULL) {
+    bench_out = fopen(output, "w");
+    if(bench_out == NULL) {
+      fprintf(stderr, "Cannot open output file %s\n", output);
+      return -1;
+    }
+  }
+
+  // Initialize context and workspace
+  if(tiledb_ctx_init(&tiledb_ctx, NULL) != TILEDB_OK) {
+    fprintf(stderr, "%s\n", tiledb_errmsg);
+    return -1;
+  }
+  tiledb_delete(tiledb_ctx, bench_workspace.c_str());
+  int rc = tiledb_workspace_create(tiledb_ctx, bench_workspace.c_str());
+  if(rc != TILEDB_OK) 
+    fprintf(stderr, "%s\n", tiledb_errmsg);
+
+  // Run benchmarks
+  if(rc == TILEDB_OK) 
+    rc = bench_dense_compressors();
+  if(rc == TILEDB_OK) 
+    rc = bench_dense_reads();
+  if(rc == TILEDB_OK) 
+    rc = bench_dense_empty_reads();
+  if(rc == TILEDB_OK) 
+    rc = bench_sparse();
+  if(rc == TILEDB_OK) 
+    rc = bench_sparse_fragments();
+  if(rc == TILEDB_OK) 
+    rc = bench_consolidate();
+  if(rc == TILEDB_OK) 
+    rc = bench_metadata();
+
+  // Clean up
+  tiledb_delete(tiledb_ctx, bench_workspace.c_str());
+  tiledb_ctx_finalize(tiledb_ctx);
+  if(bench_out != stdout)
+    fclose(bench_out);
+
+  return (rc == TILEDB_OK) ? 0 : -1;
+}
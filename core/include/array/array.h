@@ -40,7 +40,11 @@
 #include "array_schema.h"
 #include "book_keeping.h"
 #include "fragment.h"
+#include "fragment_snapshot.h"
+#include "predicate.h"
+#include "stats.h"
 #include "storage_manager_config.h"
+#include "thread_pool.h"
 #include "tiledb_constants.h"
 #include <pthread.h>
 #include <queue>
@@ -141,10 +145,60 @@ class Array {
   /** Returns the configuration parameters. */
   const StorageManagerConfig* config() const;
 
-  /** Returns the number of fragments in this array. */
+  /**
+   * Retrieves the code of a value in the dictionary of an attribute encoded
+   * with TILEDB_DICTIONARY. The codes are local to each fragment, hence the
+   * array must have at most one fragment (e.g., after consolidation). The
+   * result does not depend on the subarray.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param value The value to look up.
+   * @param value_size The size of the value in bytes.
+   * @param code The code of the value, or -1 if the value does not appear in
+   *     the array.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int dictionary_code(
+      int attribute_id,
+      const void* value,
+      size_t value_size,
+      int& code) const;
+
+  /** 
+   * Returns *true* if reads return the dictionary codes of the attributes
+   * encoded with TILEDB_DICTIONARY instead of their values. 
+   */
+  bool dictionary_codes() const;
+
+  /**
+   * Computes an upper bound on the sizes of the buffers that a read of the
+   * current subarray would fill, so that they can be allocated before
+   * reading. Only the fragment book-keeping is used (the MBRs, the number
+   * of cells and the sizes of the variable-sized tiles), without fetching
+   * any tile. Applicable only to arrays opened in read mode.
+   *
+   * @param buffer_sizes The estimated buffer sizes (in bytes), one for each
+   *     buffer passed to read(), i.e., two for each variable-sized attribute.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int estimate_buffer_sizes(size_t* buffer_sizes);
+
+  /** 
+   * Returns the number of fragments in this array. In read mode, these are
+   * only the fragments that overlap the current subarray.
+   */
   int fragment_num() const;
 
-  /** Returns the fragment objects of this array. */
+  /** 
+   * Returns the fragments of the array the reads are performed on, or NULL in
+   * write mode.
+   */
+  FragmentSnapshot* fragment_snapshot() const;
+
+  /** 
+   * Returns the fragment objects of this array. In read mode, these are only
+   * the fragments that overlap the current subarray.
+   */
   std::vector<Fragment*> fragments() const;
 
   /** Returns the array mode. */
@@ -167,6 +221,36 @@ class Array {
    */
   bool overflow(int attribute_id) const;
 
+  /**
+   * Splits the subarray specified in init() or reset_subarray() into disjoint
+   * subarrays that cover it, so that parallel readers get balanced work 
+   * without fetching the same tiles. The subarray is cut along a single
+   * dimension:
+   *  - **Dense** arrays: the first dimension of the tile order (or, if it 
+   *    spans fewer tiles than *partition_num*, the dimension that spans the
+   *    most tiles). The cuts follow the tile grid and the partitions get 
+   *    roughly equal numbers of cells.
+   *  - **Sparse** arrays: the first dimension of the cell order. The cuts 
+   *    balance the number of cells, which is estimated from the MBRs and the
+   *    cell numbers of the tiles in the book-keeping of the fragments.
+   *
+   * @param partition_num The maximum number of partitions.
+   * @param partitions The partitions written by the function one after the
+   *     other, each in the same format as the subarray. It must have space
+   *     for *partition_num* subarrays.
+   * @param result_num The number of partitions written, which is smaller than
+   *     *partition_num* if the subarray cannot be split further (e.g., if it
+   *     spans fewer tiles).
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int partition_subarray(
+      int partition_num, 
+      void* partitions, 
+      int* result_num) const;
+
+  /** Returns the attribute predicates the read cells must satisfy. */
+  const std::vector<Predicate>& predicates() const;
+
   /**
    * Performs a read operation in an array, which must be initialized in read 
    * mode. The function retrieves the result cells that lie inside
@@ -219,16 +303,100 @@ class Array {
    *     on an overflow flag which can be checked with function overflow(). The
    *     next invocation will resume for the point the previous one stopped,
    *     without inflicting a considerable performance penalty due to overflow.
+   * @param validity The validity bitmaps of the attributes (see 
+   *     read_validity()), or NULL if they are not requested.
    * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
    */
-  int read_default(void** buffers, size_t* buffer_sizes); 
+  int read_default(
+      void** buffers, 
+      size_t* buffer_sizes, 
+      unsigned char** validity = NULL); 
 
   /** Returns true if the array is in read mode. */
   bool read_mode() const;
 
+  /**
+   * Performs a read operation over the ranges set with reset_ranges(). The
+   * ranges are served in the global cell order of their lower corners, so
+   * that a tile overlapping several consecutive ranges is fetched once. The
+   * results of each range are written contiguously in the buffers, in the
+   * same way as in read(). The offsets of the variable-sized cells are 
+   * relative to the start of the corresponding buffer, across all ranges.
+   *
+   * @param buffers An array of buffers, one for each attribute, as in read().
+   * @param buffer_sizes The sizes (in bytes) allocated by the user for the
+   *     input buffers, as in read(). If the buffers cannot hold all results,
+   *     the function writes as much data as it can and turns on the overflow
+   *     flag. The next invocation resumes each attribute from the range and
+   *     the cell it stopped at.
+   * @param range_offsets The position of the first cell of each range in the
+   *     buffers of each attribute, counted in cells. The entry of the *i*-th
+   *     attribute and the *r*-th range (in the order given in reset_ranges())
+   *     is at position i * range_num + r. The attributes are in the order
+   *     given in init() or reset_attributes().
+   * @param range_cell_nums The number of cells of each range written in the
+   *     buffers of each attribute by this invocation, laid out as 
+   *     *range_offsets*. The numbers of the attributes may differ when their
+   *     buffers fill up at different cells.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int read_ranges(
+      void** buffers, 
+      size_t* buffer_sizes,
+      int64_t* range_offsets,
+      int64_t* range_cell_nums);
+
+  /**
+   * Same as read(), but it also produces a validity bitmap for each attribute,
+   * which tells the cells that come from some fragment apart from those that
+   * lie in an empty region of the array and hold the special empty value. 
+   * Contrary to comparing with the special empty values, this works for cells
+   * that were explicitly written with the same value (e.g., INT_MAX). It is
+   * applicable only to mode TILEDB_ARRAY_READ, in which the cells are returned
+   * in their native order.
+   *
+   * @param buffers An array of buffers, one for each attribute, as in read().
+   * @param buffer_sizes The sizes (in bytes) allocated by the user for the
+   *     input buffers, as in read().
+   * @param validity An array of bitmaps, one for each attribute (regardless of
+   *     whether it is fixed- or variable-sized), in the order of the
+   *     attributes. Bit *i* (counting from the least significant bit of the
+   *     first byte) is set to 1 if the *i*-th cell written in the buffers of
+   *     the attribute is valid, and to 0 if it is empty. Each bitmap must hold
+   *     at least one bit per cell that fits in the buffers.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int read_validity(
+      void** buffers, 
+      size_t* buffer_sizes, 
+      unsigned char** validity);
+
+  /** 
+   * Returns true if the dense tiles whose cells are all empty are not stored
+   * in the written fragments (see set_skip_empty_tiles()).
+   */
+  bool skip_empty_tiles() const;
+
+#ifdef TILEDB_STATS
+  /** Returns the query statistics of the array (excluding its clone). */
+  Stats* stats() const;
+
+  /** 
+   * Adds the query statistics of the array and of its clone (which serves
+   * the AIO requests of the sorted reads) to the input object. 
+   */
+  void stats_collect(Stats& stats) const;
+#endif
+
   /** Returns the subarray in which the array is constrained. */
   const void* subarray() const;
 
+  /** 
+   * Returns the thread pool running the parallel tasks of the array, or NULL
+   * if the tasks run on the calling thread.
+   */
+  ThreadPool* thread_pool() const;
+
   /** Returns true if the array is in write mode. */
   bool write_mode() const;
 
@@ -239,6 +407,62 @@ class Array {
   /*              MUTATORS             */
   /* ********************************* */
 
+  /**
+   * Adds a predicate on an attribute, which the cells returned by subsequent
+   * reads must satisfy. Multiple predicates are combined conjunctively.
+   * Applicable only to **sparse** arrays opened in read mode, and to
+   * fixed-sized attributes of type TILEDB_INT32, TILEDB_INT64, TILEDB_FLOAT32
+   * or TILEDB_FLOAT64 with a single value per cell. Empty cells never satisfy
+   * a predicate. The read state is reset, similar to reset_subarray(), but
+   * the ranges set with reset_ranges() are kept and read from the first one.
+   *
+   * @param attribute The name of the attribute. 
+   * @param op The comparison operator. It can be one of the following:
+   *    - TILEDB_LT
+   *    - TILEDB_LE
+   *    - TILEDB_GT
+   *    - TILEDB_GE
+   *    - TILEDB_EQ
+   *    - TILEDB_NE
+   * @param value The constant the attribute values are compared against,
+   *     which must have the type of the attribute.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int add_predicate(const char* attribute, int op, const void* value);
+
+  /**
+   * Computes an aggregate of an attribute over the cells that a read would
+   * return, i.e., the cells in the current subarray that satisfy the 
+   * attribute predicates, with the newer fragments taking precedence. The
+   * empty cells are ignored. The cells are not copied and the tiles are
+   * aggregated in parallel. Applicable only to arrays opened in read mode, 
+   * and to attributes of type TILEDB_INT32, TILEDB_INT64, TILEDB_FLOAT32 or
+   * TILEDB_FLOAT64 with a single value per cell. The read state is reset,
+   * similar to reset_subarray().
+   *
+   * @param attribute The name of the attribute.
+   * @param aggregate The aggregate function. It can be one of the following:
+   *    - TILEDB_COUNT (the result is an int64_t)
+   *    - TILEDB_SUM (the result is an int64_t for integer attributes and a
+   *      double for real attributes)
+   *    - TILEDB_MIN (the result has the attribute type)
+   *    - TILEDB_MAX (the result has the attribute type)
+   *    The minimum and maximum are the empty value of the attribute type if
+   *    there are no non-empty cells.
+   * @param result The aggregate result.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int aggregate(const char* attribute, int aggregate, void* result);
+
+  /**
+   * Removes all the attribute predicates. The read state is reset, similar
+   * to reset_subarray(), but the ranges set with reset_ranges() are kept and
+   * read from the first one.
+   *
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int clear_predicates();
+
   /**
    * Consolidates all fragments into a new single one, on a per-attribute basis.
    * Returns the new fragment (which has to be finalized outside this function),
@@ -275,9 +499,10 @@ class Array {
    * Initializes a TileDB array object.
    *
    * @param array_schema The array schema.
-   * @param fragment_names The names of the fragments of the array.
-   * @param book_keeping The book-keeping structures of the fragments
-   *     of the array.
+   * @param fragment_snapshot The fragments of the array to read from 
+   *     (applicable only to read mode). In read mode, only the fragments that
+   *     overlap the subarray are opened (and they are re-opened whenever the
+   *     subarray is reset). The snapshot must outlive the array object.
    * @param mode The mode of the array. It must be one of the following:
    *    - TILEDB_ARRAY_WRITE 
    *    - TILEDB_ARRAY_WRITE_SORTED_COL 
@@ -296,19 +521,22 @@ class Array {
    *     array domain. For the case of writes, this is meaningful only for
    *     dense arrays, and specifically dense writes.
    * @param config Configuration parameters.
+   * @param thread_pool The thread pool of the storage manager, which runs the
+   *     parallel tasks of the array. If it is NULL, the tasks run on the
+   *     calling thread.
    * @param array_clone An clone of this array object. Used specifically in 
    *     asynchronous IO (AIO) read/write operations.
    * @return TILEDB_AR_OK on success, and TILEDB_AR_ERR on error.
    */
   int init(
       const ArraySchema* array_schema, 
-      const std::vector<std::string>& fragment_names,
-      const std::vector<BookKeeping*>& book_keeping,
+      FragmentSnapshot* fragment_snapshot,
       int mode,
       const char** attributes,
       int attribute_num,
       const void* subarray,
       const StorageManagerConfig* config,
+      ThreadPool* thread_pool,
       Array* array_clone = NULL);
 
   /**
@@ -323,6 +551,22 @@ class Array {
    */
   int reset_attributes(const char** attributes, int attribute_num);
 
+  /**
+   * Sets a batch of subarrays (ranges) to be read with read_ranges(). The
+   * fragments overlapping the bounding box of the ranges are opened once for
+   * the entire batch. Applicable only to arrays opened in TILEDB_ARRAY_READ
+   * mode. A subsequent reset_subarray() discards the ranges. The tiles that
+   * overlap several ranges are fetched once, as long as they fit in the tile
+   * cache of each fragment (see TILEDB_RANGE_TILE_CACHE_NUM).
+   *
+   * @param ranges The ranges, each given as a sequence of [low, high] pairs
+   *     (one pair per dimension), whose type should be the same as that of
+   *     the coordinates.
+   * @param range_num The number of ranges.
+   * @return TILEDB_AR_OK on success, and TILEDB_AR_ERR on error.
+   */
+  int reset_ranges(const void* ranges, int range_num);
+
   /**
    * Resets the subarray used upon initialization of the array. This is useful
    * when the array is used for reading, and the user wishes to change the
@@ -345,6 +589,40 @@ class Array {
    */
   int reset_subarray_soft(const void* subarray);
 
+  /**
+   * Sets whether reads return the dictionary codes of the attributes encoded
+   * with TILEDB_DICTIONARY instead of their values. In the former case, the
+   * variable-sized values of each cell are replaced with a single int code.
+   * The codes are local to each fragment, hence they can be enabled only if
+   * the array has at most one fragment (e.g., after consolidation). The read
+   * state is reset, similar to reset_subarray(), but the ranges set with
+   * reset_ranges() are kept and read from the first one.
+   *
+   * @param dictionary_codes *true* to read the codes, *false* to read the
+   *     values.
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int set_dictionary_codes(bool dictionary_codes);
+
+  /**
+   * Sets whether dense writes skip the tiles whose cells are all empty in
+   * every written attribute. Such tiles are not stored in the fragment, and
+   * the fragment book-keeping records which tiles are present. Upon reading,
+   * the cells of the absent tiles are retrieved from the older fragments,
+   * i.e., an absent tile does not overwrite the tiles beneath it (whereas
+   * the empty cells of a stored tile do, as usual). This allows small
+   * scattered updates to a dense array to be written as a dense fragment
+   * covering their bounding region, storing only the modified tiles. The
+   * flag applies to the fragments that have not been written to yet, and
+   * the attribute buffers of each write must then contain the same number
+   * of cells.
+   *
+   * @param skip_empty_tiles *true* to skip the empty tiles, *false* to store
+   *     all tiles (default).
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int set_skip_empty_tiles(bool skip_empty_tiles);
+
   /**
    * Syncs all currently written files in the input array. 
    *
@@ -473,6 +751,21 @@ class Array {
   std::vector<int> attribute_ids_;
   /** Configuration parameters. */
   const StorageManagerConfig* config_;
+  /** 
+   * Indicates whether reads return the dictionary codes of the attributes
+   * encoded with TILEDB_DICTIONARY instead of their values.
+   */
+  bool dictionary_codes_;
+  /** 
+   * The positions of the opened fragments in the fragment snapshot
+   * (applicable only to read mode).
+   */
+  std::vector<int> fragment_ids_;
+  /** 
+   * The fragments of the array the reads are performed on. It is NULL in
+   * write mode.
+   */
+  FragmentSnapshot* fragment_snapshot_;
   /** The array fragments. */
   std::vector<Fragment*> fragments_;
   /** 
@@ -486,11 +779,34 @@ class Array {
    *    - TILEDB_ARRAY_READ_SORTED_ROW
    */
   int mode_;
+  /** The attribute predicates the read cells must satisfy. */
+  std::vector<Predicate> predicates_;
+  /** The number of ranges set with reset_ranges(). */
+  int range_num_;
+  /** 
+   * The positions of the ranges sorted on the global cell order of their
+   * lower corners, i.e., the order in which the ranges are read.
+   */
+  std::vector<int> range_order_;
+  /** The position in range_order_ of the range currently read. */
+  int range_pos_;
+  /** The ranges set with reset_ranges(). */
+  void* ranges_;
+  /** 
+   * Indicates whether dense writes skip the tiles whose cells are all empty.
+   */
+  bool skip_empty_tiles_;
+#ifdef TILEDB_STATS
+  /** The query statistics of the array. */
+  mutable Stats stats_;
+#endif
   /**
    * The subarray in which the array is constrained. Note that the type of the
    * range must be the same as the type of the array coordinates.
    */
   void* subarray_;
+  /** The thread pool running the parallel tasks of the array. */
+  ThreadPool* thread_pool_;
 
 
 
@@ -541,8 +857,8 @@ class Array {
   
   /** 
    * Returns a new fragment name, which is in the form: <br>
-   * .__MAC-address_thread-id_timestamp. For instance,
-   *  __00332a0b8c6426153_1458759561320
+   * .__MAC-address thread-id_timestamp_sequence-number. For instance,
+   *  __00332a0b8c6426153_1458759561320_17 (see new_fragment_id()).
    *
    * Note that this is a temporary name, initiated by a new write process.
    * After the new fragmemt is finalized, the array will change its name
@@ -554,15 +870,89 @@ class Array {
   std::string new_fragment_name() const;
 
   /**
-   * Opens the existing fragments.
+   * Opens the existing fragments that overlap the subarray, preserving their
+   * order.
    *
-   * @param fragment_names The vector with the fragment names.
-   * @param book_keeping The book-keeping of the array fragments.
    * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
    */
-  int open_fragments(
-      const std::vector<std::string>& fragment_names,
-      const std::vector<BookKeeping*>& book_keeping);
+  int open_fragments();
+
+  /**
+   * Computes the positions of the fragments of the fragment snapshot that 
+   * overlap the subarray, in increasing order.
+   *
+   * @param fragment_ids The fragment positions to be returned.
+   * @return void
+   */
+  void overlapping_fragments(std::vector<int>& fragment_ids) const;
+
+  /**
+   * Implements partition_subarray() for **dense** arrays.
+   *
+   * @tparam T The coordinates type.
+   * @param partition_num See partition_subarray().
+   * @param partitions See partition_subarray().
+   * @param result_num See partition_subarray().
+   * @return void
+   */
+  template<class T>
+  void partition_subarray_dense(
+      int partition_num, 
+      T* partitions, 
+      int& result_num) const;
+
+  /**
+   * Implements partition_subarray() for **sparse** arrays.
+   *
+   * @tparam T The coordinates type.
+   * @param partition_num See partition_subarray().
+   * @param partitions See partition_subarray().
+   * @param result_num See partition_subarray().
+   * @return void
+   */
+  template<class T>
+  void partition_subarray_sparse(
+      int partition_num, 
+      T* partitions, 
+      int& result_num) const;
+
+  /**
+   * Re-initializes the read state of the fragments upon a subarray reset. If
+   * the fragments that overlap the new subarray are different from the ones
+   * currently open, the fragments are re-opened.
+   *
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int reset_fragments();
+
+  /**
+   * Sets the subarray to the range currently read and re-initializes the
+   * read state, without re-opening the fragments. The tiles each fragment
+   * has already fetched remain available to the new range.
+   *
+   * @return void
+   */
+  void reset_range_read_state();
+
+  /**
+   * Starts the read of the ranges set with reset_ranges() from the first
+   * range, (re-)opening the fragments that overlap any range. It is also
+   * invoked when a change to the read (e.g., a new predicate) discards the
+   * cell ranges computed so far.
+   *
+   * @return TILEDB_AR_OK for success and TILEDB_AR_ERR for error.
+   */
+  int restart_ranges();
+
+  /**
+   * Sorts the ranges on the global cell order of their lower corners and
+   * sets the subarray to the bounding box of the ranges.
+   *
+   * @tparam T The coordinates type.
+   * @return void
+   */
+  template<class T>
+  void sort_ranges();
 };
 
 #endif
@@ -85,6 +85,9 @@ class ArrayIterator {
   /*             ACCESSORS             */
   /* ********************************* */
 
+  /** Returns the array object the iterator iterates over. */
+  Array* array() const;
+
   /** Return the array name. */
   const std::string& array_name() const;
 
@@ -35,9 +35,11 @@
 
 #include "array.h"
 #include "array_schema.h"
+#include <atomic>
 #include <cstring>
 #include <inttypes.h>
 #include <queue>
+#include <string>
 #include <vector>
 
 
@@ -66,13 +68,17 @@
 /*          GLOBAL VARIABLES         */
 /* ********************************* */
 
-/** Stores potential error messages. */
-extern std::string tiledb_ars_errmsg;
+/** 
+ * Stores potential error messages. It is thread-local, since the tiles of
+ * different fragments may be processed concurrently.
+ */
+extern thread_local std::string tiledb_ars_errmsg;
 
 
 
 
 class Array;
+class Fragment;
 class ReadState;
 
 /** Stores the state necessary when reading cells from the array fragments. */
@@ -118,6 +124,63 @@ class ArrayReadState {
 
   /** A vector of fragment cell ranges. */
   typedef std::vector<FragmentCellRange> FragmentCellRanges;
+
+  /**
+   * Used to pass data to the threads that work on the fragments of a read
+   * round. There is one task per fragment, or per prefetched or aggregated
+   * tile, and every
+   * thread repeatedly claims the next unclaimed task until none is left, so
+   * that the threads that finish early take over the remaining tasks. All
+   * the threads share a single object.
+   */
+  struct FragmentTaskData {
+    /** The array read state. */
+    ArrayReadState* array_read_state_;
+    /** The id of the attribute whose tiles are prefetched or aggregated. */
+    int attribute_id_;
+    /** The error message of each task (empty upon success). */
+    std::vector<std::string>* errmsgs_;
+    /** The id of the fragment of each task. */
+    const std::vector<int>* fragment_ids_;
+    /** The next task to be claimed. */
+    std::atomic<int>* next_task_;
+    /** 
+     * The (prefetching read state, tile) pair of each task prefetching a tile
+     * (see ReadState::prefetch_tile()).
+     */
+    const std::vector<std::pair<int, int64_t> >* tiles_;
+    /** The fragment cell ranges computed for each fragment. */
+    std::vector<FragmentCellRanges>* unsorted_fragment_cell_ranges_;
+  };
+
+  /** 
+   * Used to pass data to the threads that compute an aggregate. Every task
+   * aggregates the fragment cell position ranges of a single tile into its
+   * own partial aggregate, so that the partial aggregates are merged in the
+   * same order regardless of the threads that computed them.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum (see cells_aggregate()).
+   */
+  template<class T, class S>
+  struct AggregateData : public FragmentTaskData {
+    /** The aggregate function. */
+    int aggregate_;
+    /** The number of non-empty values of each task. */
+    std::vector<int64_t> counts_;
+    /** The special value of type T indicating an empty cell. */
+    T empty_value_;
+    /** The fragment cell position ranges to be aggregated. */
+    const FragmentCellPosRanges* fragment_cell_pos_ranges_;
+    /** The maximum of the non-empty values of each task. */
+    std::vector<T> maxs_;
+    /** The minimum of the non-empty values of each task. */
+    std::vector<T> mins_;
+    /** The positions of the ranges of each task in the aggregated ranges. */
+    std::vector<std::vector<int64_t> > range_positions_;
+    /** The sum of the non-empty values of each task. */
+    std::vector<S> sums_;
+  };
  
 
 
@@ -143,6 +206,27 @@ class ArrayReadState {
   /*             ACCESSORS             */
   /* ********************************* */
 
+  /**
+   * Computes an aggregate of an attribute over the cells that a read would
+   * return (i.e., respecting the query subarray, the fragment precedence,
+   * and the attribute predicates), without copying the cells. The empty
+   * cells are ignored. The tiles are aggregated in parallel.
+   *
+   * @param attribute_id The id of the attribute, which must be numeric with
+   *     a single value per cell.
+   * @param aggregate The aggregate function. It can be one of the following:
+   *    - TILEDB_COUNT (the result is an int64_t)
+   *    - TILEDB_SUM (the result is an int64_t for integer attributes and a
+   *      double for real attributes)
+   *    - TILEDB_MIN (the result has the attribute type)
+   *    - TILEDB_MAX (the result has the attribute type)
+   *    The minimum and maximum are the empty value of the attribute type if
+   *    there are no non-empty cells.
+   * @param result The aggregate result.
+   * @return TILEDB_ARS_OK for success and TILEDB_ARS_ERR for error.
+   */
+  int aggregate(int attribute_id, int aggregate, void* result);
+
   /** Indicates whether the read on at least one attribute overflowed. */
   bool overflow() const;
 
@@ -173,9 +257,34 @@ class ArrayReadState {
    *     on an overflow flag which can be checked with function overflow(). The
    *     next invocation will resume for the point the previous one stopped,
    *     without inflicting a considerable performance penalty due to overflow.
+   * @param validity An array of bitmaps, one for each attribute (regardless of
+   *     whether it is fixed- or variable-sized), in the order of the
+   *     attributes. Bit *i* of a bitmap is set to 1 if the *i*-th cell
+   *     written in the buffers of the attribute comes from some fragment, and
+   *     to 0 if it lies in an empty region of the array and holds the special
+   *     empty value. If it is NULL, no validity information is produced.
    * @return TILEDB_ARS_OK for success and TILEDB_ARS_ERR for error.
    */
-  int read(void** buffers, size_t* buffer_sizes); 
+  int read(
+      void** buffers, 
+      size_t* buffer_sizes, 
+      unsigned char** validity = NULL); 
+
+
+
+
+  /* ********************************* */
+  /*             MUTATORS              */
+  /* ********************************* */
+
+  /**
+   * Resets the state to read the (new) subarray of the array from the start,
+   * keeping the fragment read states and the tiles they have fetched. It is
+   * used to move to the next range of a multi-range read.
+   *
+   * @return void
+   */
+  void reset();
 
 
 
@@ -223,6 +332,16 @@ class ArrayReadState {
   void* subarray_tile_coords_;
   /** The tile domain of the query subarray. */
   void* subarray_tile_domain_;
+  /** 
+   * The maximum number of threads working on a read round, i.e., the number
+   * of online processors up to TILEDB_READ_THREAD_NUM, or one with MPI-IO.
+   */
+  int thread_num_;
+  /** 
+   * The validity bitmap of each attribute for the current read, or NULL if
+   * it was not requested (see read()).
+   */
+  std::vector<unsigned char*> validity_;
 
 
 
@@ -231,9 +350,54 @@ class ArrayReadState {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Computes an aggregate over the input fragment cell position ranges, 
+   * running one task per tile (see run_fragment_tasks() and 
+   * ArrayReadState::aggregate(int, int, void*)).
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum (see cells_aggregate()).
+   * @param attribute_id The id of the attribute.
+   * @param aggregate The aggregate function.
+   * @param empty_value The special value of type T indicating an empty cell.
+   * @param fragment_cell_pos_ranges The fragment cell position ranges.
+   * @param result The aggregate result.
+   * @return TILEDB_ARS_OK for success and TILEDB_ARS_ERR for error.
+   */
+  template<class T, class S>
+  int aggregate(
+      int attribute_id,
+      int aggregate,
+      T empty_value,
+      const FragmentCellPosRanges& fragment_cell_pos_ranges,
+      void* result);
+
+  /**
+   * Function called by each thread computing an aggregate, which claims the
+   * tiles to be aggregated until none is left.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum (see cells_aggregate()).
+   * @param data An AggregateData<T, S> object.
+   * @return void
+   */
+  template<class T, class S>
+  static void *aggregate_s(void* data);
+
   /** Cleans fragment cell positions that are processed by all attributes. */
   void clean_up_processed_fragment_cell_pos_ranges();
 
+  /**
+   * Appends the fragment cell position ranges of the current read round to
+   * the input ranges, and marks the read round as processed by all the
+   * attributes.
+   *
+   * @param fragment_cell_pos_ranges The fragment cell position ranges.
+   * @return void
+   */
+  void collect_fragment_cell_pos_ranges(
+      FragmentCellPosRanges& fragment_cell_pos_ranges);
+
   /**
    * Computes the cell position ranges that must be copied from each fragment to
    * the user buffers for the current read round. The cell positions are 
@@ -250,6 +414,34 @@ class ArrayReadState {
       FragmentCellRanges& fragment_cell_ranges,
       FragmentCellPosRanges& fragment_cell_pos_ranges) const;
 
+  /**
+   * Computes the fragment cell ranges of a single fragment for the current
+   * read round, focusing on the **sparse** array case, and updates the start
+   * bounding coordinates of its active tile to exceed the minimum bounding
+   * coordinates end. The fragment must have an active tile that starts no
+   * later than the minimum bounding coordinates end.
+   *
+   * @tparam T The coordinates type.
+   * @param fragment_id The id of the fragment.
+   * @param fragment_cell_ranges It will hold the result of this function.
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  template<class T>
+  int compute_fragment_cell_ranges_sparse(
+      int fragment_id,
+      FragmentCellRanges& fragment_cell_ranges);
+
+  /**
+   * Function called by each thread computing the fragment cell ranges of the
+   * current read round (see compute_fragment_cell_ranges_sparse()).
+   *
+   * @tparam T The coordinates type.
+   * @param data A FragmentTaskData object.
+   * @return void
+   */
+  template<class T>
+  static void *compute_fragment_cell_ranges_sparse_s(void* data);
+
   /**
    * Computes the smallest end bounding coordinates for the current read round.
    *
@@ -278,7 +470,7 @@ class ArrayReadState {
    * focusing on the **sparse* array case. These cell ranges will be properly
    * cut and sorted later on. This function also properly updates the start
    * bounding coordinates of the active tiles (to exceed the minimum bounding
-   * coordinates end).
+   * coordinates end). The fragments are processed in parallel threads.
    *
    * @tparam T The coordinates type.
    * @param unsorted_fragment_cell_ranges It will hold the result of this
@@ -434,6 +626,44 @@ class ArrayReadState {
   template<class T>
   FragmentCellRanges empty_fragment_cell_ranges() const; 
 
+  /**
+   * Filters the input fragment cell position ranges with the attribute
+   * predicates of the array, so that they include only the cells that
+   * satisfy all the predicates. Applicable only to the **sparse** array case.
+   *
+   * @param fragment_cell_pos_ranges The fragment cell position ranges to be
+   *     filtered (in place).
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  int filter_fragment_cell_pos_ranges(
+      FragmentCellPosRanges& fragment_cell_pos_ranges) const;
+
+  /**
+   * Gets the fragment cell position ranges of all the read rounds at once,
+   * which are the cells that a read would return, focusing on the dense
+   * case.
+   *
+   * @tparam T The coordinates type.
+   * @param fragment_cell_pos_ranges The fragment cell position ranges.
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  template<class T>
+  int get_all_fragment_cell_pos_ranges_dense(
+      FragmentCellPosRanges& fragment_cell_pos_ranges);
+
+  /**
+   * Gets the fragment cell position ranges of all the read rounds at once,
+   * which are the cells that a read would return, focusing on the sparse
+   * case.
+   *
+   * @tparam T The coordinates type.
+   * @param fragment_cell_pos_ranges The fragment cell position ranges.
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  template<class T>
+  int get_all_fragment_cell_pos_ranges_sparse(
+      FragmentCellPosRanges& fragment_cell_pos_ranges);
+
   /**
    * Gets the next fragment cell ranges that are relevant in the current read
    * round, focusing on the dense case.
@@ -493,6 +723,33 @@ class ArrayReadState {
   template<class T>
   void init_subarray_tile_coords();
 
+  /**
+   * Fetches in parallel threads the tiles of the fragments that participate
+   * in the read round the input attribute is about to copy cells from, so
+   * that the fetches and decompressions of different tiles overlap. For each
+   * fragment that has a tile of the round not yet in main memory, the tiles
+   * of the round along with the next overlapping ones are prefetched, up to
+   * TILEDB_READ_PREFETCH_TILE_NUM tiles split among the array fragments.
+   * Hence, the reads of many small rounds decompress a batch of tiles only
+   * once every few tiles. This is applicable only to compressed attributes
+   * of **sparse** arrays, and only if multiple threads work on the read
+   * rounds (see thread_num_).
+   *
+   * @tparam T The coordinates type.
+   * @param attribute_id The id of the attribute.
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  template<class T>
+  int prefetch_tiles(int attribute_id);
+
+  /**
+   * Function called by each thread prefetching tiles (see prefetch_tiles()).
+   *
+   * @param data A FragmentTaskData object.
+   * @return void
+   */
+  static void *prefetch_tiles_s(void* data);
+
   /**
    * Performs a read operation in a **dense** array.
    * 
@@ -647,6 +904,19 @@ class ArrayReadState {
       void* buffer_var, 
       size_t& buffer_var_size);
 
+  /**
+   * Runs the tasks of a read round in up to *thread_num_* threads of the
+   * thread pool of the array, which claim the tasks dynamically. The calling
+   * thread participates in the work, and it is the only one that runs the
+   * tasks if there is a single task or *thread_num_* is one. The caller sets
+   * up the task-specific fields of *data*.
+   *
+   * @param task_s The function called by each thread.
+   * @param data The data shared by the threads.
+   * @return TILEDB_ARS_OK on success and TILEDB_ARS_ERR on error.
+   */
+  int run_fragment_tasks(void *(*task_s)(void*), FragmentTaskData& data);
+
   /**
    * Uses the heap algorithm to cut and sort the relevant cell ranges for
    * the current read run. The function properly cleans up the input
@@ -662,6 +932,26 @@ class ArrayReadState {
   int sort_fragment_cell_ranges(
       std::vector<FragmentCellRanges>& unsorted_fragment_cell_ranges,
       FragmentCellRanges& fragment_cell_ranges) const;
+
+  /**
+   * Updates the validity bitmap of an attribute (if one is requested in the
+   * current read) for the cells written in the buffer between two offsets.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param cell_size The size of each cell in the buffer.
+   * @param buffer_offset_start The buffer offset before the cells were
+   *     written.
+   * @param buffer_offset_end The buffer offset after the cells were written.
+   * @param valid *true* if the cells come from some fragment, and *false* if
+   *     they hold the special empty value.
+   * @return void
+   */
+  void update_validity(
+      int attribute_id,
+      size_t cell_size,
+      size_t buffer_offset_start,
+      size_t buffer_offset_end,
+      bool valid);
 };
 
 
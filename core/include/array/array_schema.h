@@ -125,6 +125,18 @@ class ArraySchema {
   /** Returns the number of attributes. */
   int attribute_num() const;
 
+  /**
+   * Returns the Blosc shuffle mode of the attribute with the input id. It
+   * defaults to TILEDB_BLOSC_SHUFFLE.
+   */
+  int blosc_shuffle(int attribute_id) const;
+
+  /**
+   * Returns the Blosc typesize of the attribute with the input id. It defaults
+   * to the size of the attribute type.
+   */
+  size_t blosc_typesize(int attribute_id) const;
+
   /** Returns the attributes. */
   const std::vector<std::string>& attributes() const;
 
@@ -148,6 +160,20 @@ class ArraySchema {
   /** Returns the compression type of the attribute with the input id. */
   int compression(int attribute_id) const;
 
+  /**
+   * Returns the compression level of the attribute with the input id. If the
+   * level was left to TILEDB_COMPRESSION_LEVEL_DEFAULT, the default level of
+   * the corresponding compressor is returned, except for GZIP whose default
+   * level is resolved by gzip().
+   */
+  int compression_level(int attribute_id) const;
+
+  /** 
+   * Returns the layout of the coordinates within a tile on disk
+   * (TILEDB_COORDS_INTERLEAVED or TILEDB_COORDS_COLUMNAR). 
+   */
+  int coords_layout() const;
+
   /** Returns the coordinates size. */
   size_t coords_size() const;
 
@@ -163,6 +189,9 @@ class ArraySchema {
   /** Returns the domain. */
   const void* domain() const;
 
+  /** Returns the filter type of the attribute with the input id. */
+  int filter(int attribute_id) const;
+
   /**
    * Gets the ids of the input attributes.
    *
@@ -371,9 +400,66 @@ class ArraySchema {
   /** Sets the compression types. */
   int set_compression(int* compression);
 
+  /**
+   * Sets the per-attribute compression parameters. There should be one value
+   * per attribute plus one (the last one) for the coordinates. A NULL input
+   * sets the corresponding parameter to its default for all attributes.
+   *
+   * @param compression_level The compression levels. Supported values are
+   *     TILEDB_COMPRESSION_LEVEL_DEFAULT, [-1,9] for TILEDB_GZIP, [1,22] for
+   *     TILEDB_ZSTD and [0,9] for the Blosc compressors.
+   * @param blosc_shuffle The Blosc shuffle modes (TILEDB_BLOSC_NOSHUFFLE,
+   *     TILEDB_BLOSC_SHUFFLE, or TILEDB_BLOSC_BITSHUFFLE).
+   * @param blosc_typesize The Blosc typesizes in [0,255], where 0 stands for
+   *     the attribute type size.
+   * @return TILEDB_AS_OK for success, and TILEDB_AS_ERR for error.
+   *
+   * @note The compression types must already have been set before calling
+   *     this function.
+   */
+  int set_compression_params(
+      const int* compression_level,
+      const int* blosc_shuffle,
+      const int* blosc_typesize);
+
+  /**
+   * Sets the layout of the coordinates within a tile on disk. Supported
+   * layouts:
+   *    - TILEDB_COORDS_INTERLEAVED
+   *    - TILEDB_COORDS_COLUMNAR
+   *
+   * @param coords_layout The coordinates layout.
+   * @return TILEDB_AS_OK for success, and TILEDB_AS_ERR for error.
+   *
+   * @note The compression types must already have been set before calling
+   *     this function, since the columnar layout applies only to compressed
+   *     coordinates.
+   */
+  int set_coords_layout(int coords_layout);
+
   /** Sets the proper flag to indicate if the array is dense. */
   void set_dense(int dense);
 
+  /**
+   * Sets the filter types. There should be one filter per attribute plus one
+   * (the last one) for the coordinates. The supported filters are:
+   *     - TILEDB_NO_FILTER
+   *     - TILEDB_DELTA
+   *     - TILEDB_DOUBLE_DELTA
+   *     - TILEDB_DICTIONARY
+   *
+   * @param filter The filter types. If it is NULL, no filter is used.
+   * @return TILEDB_AS_OK for success, and TILEDB_AS_ERR for error.
+   *
+   * @note The types, the number of values per cell and the compression types
+   *     must have already been set before calling this function, since the
+   *     filters apply only to compressed TILEDB_INT32 and TILEDB_INT64
+   *     attributes and coordinates, as well as to the cell offsets of
+   *     compressed variable-sized attributes. TILEDB_DICTIONARY applies only
+   *     to compressed variable-sized attributes.
+   */
+  int set_filter(const int* filter);
+
   /** 
    * Sets dimension names. There should not be any duplicate names. Moreover,
    * there should not be a dimension with the same name as an attribute.
@@ -685,12 +771,32 @@ class ArraySchema {
   std::vector<std::string> attributes_;
   /** The number of attributes. */
   int attribute_num_;
+  /**
+   * The Blosc shuffle mode for each attribute (plus one extra at the end for
+   * the coordinates).
+   */
+  std::vector<int> blosc_shuffle_;
+  /**
+   * The Blosc typesize for each attribute (plus one extra at the end for the
+   * coordinates). A value of 0 stands for the size of the attribute type.
+   */
+  std::vector<int> blosc_typesize_;
   /** 
    * The tile capacity for the case of sparse fragments.
    */
   int64_t capacity_;
   /** The number of cells per tile. Meaningful only for the **dense** case. */
   int64_t cell_num_per_tile_;
+  /**
+   * Offsets for calculating cell positions within a tile for the column-major
+   * cell order.
+   */
+  std::vector<int64_t> cell_offsets_col_;
+  /**
+   * Offsets for calculating cell positions within a tile for the row-major
+   * cell order.
+   */
+  std::vector<int64_t> cell_offsets_row_;
   /** 
    * The cell order. It can be one of the following:
    *    - TILEDB_ROW_MAJOR
@@ -723,8 +829,21 @@ class ArraySchema {
    *    - TILEDB_RLE 
    */
   std::vector<int> compression_;
+  /**
+   * The compression level for each attribute (plus one extra at the end for
+   * the coordinates). TILEDB_COMPRESSION_LEVEL_DEFAULT stands for the default
+   * level of the corresponding compressor.
+   */
+  std::vector<int> compression_level_;
   /** Auxiliary variable used when calculating Hilbert ids. */
   int* coords_for_hilbert_;
+  /**
+   * The layout of the coordinates within a tile on disk. It can be one of the
+   * following:
+   *    - TILEDB_COORDS_INTERLEAVED
+   *    - TILEDB_COORDS_COLUMNAR
+   */
+  int coords_layout_;
   /** The size (in bytes) of the coordinates. */
   size_t coords_size_;
   /** 
@@ -742,6 +861,18 @@ class ArraySchema {
    * type.
    */
   void* domain_;
+  /**
+   * The filter type for each attribute (plus one extra at the end for the
+   * coordinates). It can be one of the following:
+   *    - TILEDB_NO_FILTER
+   *    - TILEDB_DELTA
+   *    - TILEDB_DOUBLE_DELTA
+   *    - TILEDB_DICTIONARY
+   *
+   * For variable-sized attributes, the delta filters apply to the cell
+   * offsets.
+   */
+  std::vector<int> filter_;
   /** 
    * Number of bits used for the calculation of cell ids with the 
    * Hilbert curve. 
@@ -804,6 +935,34 @@ class ArraySchema {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Kernel of cell_order_cmp() for the column-major cell order, specialized
+   * on the number of dimensions.
+   *
+   * @tparam T The coordinates type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param coords_a The first coordinates.
+   * @param coords_b The second coordinates.
+   * @return -1 if *coords_a* precedes *coords_b*, 0 if *coords_a* and
+   *     *coords_b* are equal, and +1 if *coords_a* succeeds *coords_b*.
+   */
+  template<class T, int N>
+  int cell_order_cmp_col_kernel(const T* coords_a, const T* coords_b) const;
+
+  /**
+   * Kernel of cell_order_cmp() for the row-major cell order, specialized
+   * on the number of dimensions.
+   *
+   * @tparam T The coordinates type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param coords_a The first coordinates.
+   * @param coords_b The second coordinates.
+   * @return -1 if *coords_a* precedes *coords_b*, 0 if *coords_a* and
+   *     *coords_b* are equal, and +1 if *coords_a* succeeds *coords_b*.
+   */
+  template<class T, int N>
+  int cell_order_cmp_row_kernel(const T* coords_a, const T* coords_b) const;
+
   /** 
    * Computes and returns the size of the binary representation of the
    * ArraySchema object. 
@@ -828,6 +987,24 @@ class ArraySchema {
   template<class T>
   void compute_cell_num_per_tile();
 
+  /**
+   * Computes cell offsets neccessary when computing cell positions within
+   * a tile. Applicable only to arrays with regular tiles.
+   *
+   * @return void 
+   */
+  void compute_cell_offsets();
+
+  /**
+   * Computes cell offsets neccessary when computing cell positions within
+   * a tile. Applicable only to arrays with regular tiles.
+   *
+   * @tparam T The coordinates type.
+   * @return void 
+   */
+  template<class T>
+  void compute_cell_offsets();
+
   /** Computes and returns the size of an attribute (or coordinates). */
   size_t compute_cell_size(int attribute_id) const;
 
@@ -890,6 +1067,19 @@ class ArraySchema {
   template<class T>
   int64_t get_cell_pos_col(const T* coords) const;
 
+  /**
+   * Kernel of get_cell_pos_col() specialized on the number of dimensions.
+   * 
+   * @tparam T The coordinates type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param coords The input coordindates, which are expressed as global 
+   *     coordinates in the array domain.
+   * @return The position of the cell coordinates in the column-major cell
+   *     order within its corresponding tile.
+   */
+  template<class T, int N>
+  int64_t get_cell_pos_col_kernel(const T* coords) const;
+
   /**
    * Returns the position of the input coordinates inside its corresponding
    * tile, based on the array cell order. Applicable only to **dense** arrays,
@@ -905,6 +1095,19 @@ class ArraySchema {
   template<class T>
   int64_t get_cell_pos_row(const T* coords) const;
 
+  /**
+   * Kernel of get_cell_pos_row() specialized on the number of dimensions.
+   * 
+   * @tparam T The coordinates type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param coords The input coordindates, which are expressed as global 
+   *     coordinates in the array domain.
+   * @return The position of the cell coordinates in the row-major cell
+   *     order within its corresponding tile.
+   */
+  template<class T, int N>
+  int64_t get_cell_pos_row_kernel(const T* coords) const;
+
   /**
    * Retrieves the next coordinates along the array cell order within a given
    * domain (desregarding whether the domain is split into tiles or not). 
@@ -1034,6 +1237,18 @@ class ArraySchema {
       const T* domain,
       const T* tile_coords) const;
 
+  /**
+   * Kernel of get_tile_pos_col() specialized on the number of dimensions.
+   * 
+   * @tparam T The domain type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param tile_coords The tile coordinates. 
+   * @return The tile position of *tile_coords* along the column-major tile
+   *     order inside the array domain.
+   */
+  template<class T, int N> 
+  int64_t get_tile_pos_col_kernel(const T* tile_coords) const;
+
   /**
    * Returns the tile position along the array tile order within the input
    * domain. Applicable only to **dense** arrays, and focusing on the 
@@ -1065,9 +1280,37 @@ class ArraySchema {
       const T* domain,
       const T* tile_coords) const;
 
+  /**
+   * Kernel of get_tile_pos_row() specialized on the number of dimensions.
+   * 
+   * @tparam T The domain type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param tile_coords The tile coordinates. 
+   * @return The tile position of *tile_coords* along the row-major tile
+   *     order inside the array domain.
+   */
+  template<class T, int N> 
+  int64_t get_tile_pos_row_kernel(const T* tile_coords) const;
+
   /** Initializes a Hilbert curve. */
   void init_hilbert_curve();
 
+  /**
+   * Kernel of tile_order_cmp() for integral coordinates, specialized on the
+   * number of dimensions.
+   *
+   * @tparam T The coordinates type.
+   * @tparam N The number of dimensions, or 0 for the generic kernel.
+   * @param coords_a The first coordinates.
+   * @param coords_b The second coordinates.
+   * @return One of the following:
+   *    - -1 if the first coordinates precede the second on the tile order
+   *    -  0 if the two coordinates have the same tile order
+   *    - +1 if the first coordinates succeed the second on the tile order
+   */
+  template<class T, int N>
+  int tile_order_cmp_kernel(const T* coords_a, const T* coords_b) const;
+
   /** Return the number of cells in a column tile slab of an input subarray. */
   template<class T>
   int64_t tile_slab_col_cell_num(const T* subarray) const;
@@ -81,6 +81,58 @@ typedef struct ArraySchemaC {
    *    - TILEDB_RLE 
    */
   int* compression_;
+  /**
+   * The layout of the coordinates within each tile of a sparse fragment on
+   * disk. It can be one of the following:
+   *    - TILEDB_COORDS_INTERLEAVED (default), i.e., (x0,y0,x1,y1,...)
+   *    - TILEDB_COORDS_COLUMNAR, i.e., (x0,x1,...,y0,y1,...)
+   *
+   * The columnar layout is applicable only to compressed coordinates.
+   */
+  int coords_layout_;
+  /**
+   * The compression level for each attribute (plus one extra at the end for
+   * the coordinates). TILEDB_COMPRESSION_LEVEL_DEFAULT selects the default
+   * level of the corresponding compressor. If it is NULL, the default level
+   * is used for all attributes.
+   */
+  int* compression_level_;
+  /**
+   * The Blosc shuffle mode for each attribute (plus one extra at the end for
+   * the coordinates), applicable only to the Blosc compressors. It can be one
+   * of the following:
+   *    - TILEDB_BLOSC_NOSHUFFLE
+   *    - TILEDB_BLOSC_SHUFFLE
+   *    - TILEDB_BLOSC_BITSHUFFLE
+   *
+   * If it is NULL, TILEDB_BLOSC_SHUFFLE is used for all attributes.
+   */
+  int* blosc_shuffle_;
+  /**
+   * The Blosc typesize for each attribute (plus one extra at the end for
+   * the coordinates), applicable only to the Blosc compressors. A value of 0
+   * selects the size of the attribute type. If it is NULL, the size of the
+   * attribute type is used for all attributes.
+   */
+  int* blosc_typesize_;
+  /**
+   * The filter applied to the tiles of each attribute (plus one extra at the
+   * end for the coordinates) before compression. It can be one of the
+   * following:
+   *    - TILEDB_NO_FILTER
+   *    - TILEDB_DELTA
+   *    - TILEDB_DOUBLE_DELTA
+   *    - TILEDB_DICTIONARY
+   *
+   * Filters are applicable only to compressed attributes and coordinates. For
+   * fixed-sized attributes and coordinates, the type must be TILEDB_INT32 or
+   * TILEDB_INT64. For variable-sized attributes, the delta filters are applied
+   * to the cell offsets, whereas TILEDB_DICTIONARY (applicable only to
+   * variable-sized attributes) replaces each cell value with a code into a
+   * dictionary of the distinct values of the fragment. If it is NULL, no
+   * filter is used.
+   */
+  int* filter_;
   /** 
    * Specifies if the array is dense (1) or sparse (0). If the array is dense, 
    * then the user must specify tile extents (see below).
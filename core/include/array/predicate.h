@@ -0,0 +1,62 @@
+/**
+ * @file   predicate.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file declares the Predicate struct. 
+ */
+
+#ifndef __PREDICATE_H__
+#define __PREDICATE_H__
+
+#include <stdint.h>
+
+/** 
+ * Describes a comparison of a fixed-sized attribute against a constant,
+ * which the cells returned by a read must satisfy. 
+ */
+struct Predicate {
+  /** The id of the attribute whose values are compared. */
+  int attribute_id_;
+  /** 
+   * The comparison operator. It can be one of the following:
+   *    - TILEDB_LT
+   *    - TILEDB_LE
+   *    - TILEDB_GT
+   *    - TILEDB_GE
+   *    - TILEDB_EQ
+   *    - TILEDB_NE
+   */
+  int op_;
+  /** 
+   * The constant the attribute values are compared against, stored with the
+   * type of the attribute. 
+   */
+  char value_[sizeof(int64_t)];
+};
+
+#endif
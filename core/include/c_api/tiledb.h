@@ -39,6 +39,7 @@
 #endif
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <string>
 #include <unistd.h>
 
@@ -251,6 +252,58 @@ typedef struct TileDB_ArraySchema {
    * attributes.
    */
   int* compression_;
+  /**
+   * The layout of the coordinates within each tile of a sparse fragment on
+   * disk. It can be one of the following:
+   *    - TILEDB_COORDS_INTERLEAVED (default), i.e., (x0,y0,x1,y1,...)
+   *    - TILEDB_COORDS_COLUMNAR, i.e., (x0,x1,...,y0,y1,...)
+   *
+   * The columnar layout is applicable only to compressed coordinates.
+   */
+  int coords_layout_;
+  /**
+   * The compression level for each attribute (plus one extra at the end for
+   * the coordinates). TILEDB_COMPRESSION_LEVEL_DEFAULT selects the default
+   * level of the corresponding compressor. It is ignored by TILEDB_LZ4 and
+   * TILEDB_RLE. If it is *NULL*, the default level is used for all attributes.
+   */
+  int* compression_level_;
+  /**
+   * The Blosc shuffle mode for each attribute (plus one extra at the end for
+   * the coordinates), applicable only to the Blosc compressors. It can be one
+   * of the following:
+   *    - TILEDB_BLOSC_NOSHUFFLE
+   *    - TILEDB_BLOSC_SHUFFLE
+   *    - TILEDB_BLOSC_BITSHUFFLE
+   *
+   * If it is *NULL*, TILEDB_BLOSC_SHUFFLE is used for all attributes.
+   */
+  int* blosc_shuffle_;
+  /**
+   * The Blosc typesize for each attribute (plus one extra at the end for
+   * the coordinates), applicable only to the Blosc compressors. A value of 0
+   * selects the size of the attribute type. If it is *NULL*, the size of the
+   * attribute type is used for all attributes.
+   */
+  int* blosc_typesize_;
+  /**
+   * The filter applied to the tiles of each attribute (plus one extra at the
+   * end for the coordinates) before compression. It can be one of the
+   * following:
+   *    - TILEDB_NO_FILTER
+   *    - TILEDB_DELTA
+   *    - TILEDB_DOUBLE_DELTA
+   *    - TILEDB_DICTIONARY
+   *
+   * Filters are applicable only to compressed attributes and coordinates. For
+   * fixed-sized attributes and coordinates, the type must be TILEDB_INT32 or
+   * TILEDB_INT64. For variable-sized attributes, the delta filters are applied
+   * to the cell offsets, whereas TILEDB_DICTIONARY (applicable only to
+   * variable-sized attributes) replaces each cell value with a code into a
+   * dictionary of the distinct values of the fragment. If it is *NULL*, no
+   * filter is used.
+   */
+  int* filter_;
   /** 
    * Specifies if the array is dense (1) or sparse (0). If the array is dense, 
    * then the user must specify tile extents (see below).
@@ -339,6 +392,74 @@ TILEDB_EXPORT int tiledb_array_set_schema(
     int tile_order,
     const int* types);
 
+/**
+ * Sets the per-attribute compression parameters of an array schema that has
+ * already been populated with tiledb_array_set_schema(). Each input holds one
+ * value per attribute, plus an extra one in the end for the coordinates. A
+ * NULL input leaves the corresponding parameter to its default.
+ *
+ * @param tiledb_array_schema The array schema to be updated.
+ * @param compression_level The compression level for each attribute. Use
+ *     TILEDB_COMPRESSION_LEVEL_DEFAULT for the compressor default.
+ * @param blosc_shuffle The Blosc shuffle mode for each attribute.
+ * @param blosc_typesize The Blosc typesize for each attribute (0 for the
+ *     attribute type size).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ * @see TileDB_ArraySchema
+ */
+TILEDB_EXPORT int tiledb_array_set_compression_params(
+    TileDB_ArraySchema* tiledb_array_schema,
+    const int* compression_level,
+    const int* blosc_shuffle,
+    const int* blosc_typesize);
+
+/**
+ * Sets the filters of an array schema that has already been populated with
+ * tiledb_array_set_schema(). A filter transforms each tile of an attribute
+ * before it gets compressed, in order to make it more compressible. 
+ *
+ * @param tiledb_array_schema The array schema to be updated.
+ * @param filter The filter for each attribute, plus an extra one in the end
+ *     for the coordinates. It can be one of the following:
+ *        - TILEDB_NO_FILTER
+ *        - TILEDB_DELTA
+ *        - TILEDB_DOUBLE_DELTA (zig-zag encoded)
+ *        - TILEDB_DICTIONARY (variable-sized attributes only)
+ *
+ *     If it is NULL, no filter is used.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ * @note The filters are applicable only to compressed attributes and
+ *     coordinates. Fixed-sized attributes and coordinates must be of type
+ *     TILEDB_INT32 or TILEDB_INT64. For variable-sized attributes of any type,
+ *     the delta filters are applied to the cell offsets, i.e., TILEDB_DELTA
+ *     stores the cell lengths instead of the offsets. TILEDB_DICTIONARY is
+ *     meant for variable-sized attributes with few distinct values (e.g.,
+ *     categorical strings); each fragment stores its distinct values once, 
+ *     and a 32-bit code per cell.
+ * @see TileDB_ArraySchema
+ */
+TILEDB_EXPORT int tiledb_array_set_filter(
+    TileDB_ArraySchema* tiledb_array_schema,
+    const int* filter);
+
+/**
+ * Sets the layout of the coordinates within each tile of the sparse fragments
+ * on disk, for an array schema that has already been populated with
+ * tiledb_array_set_schema(). Storing the coordinates of each dimension
+ * contiguously typically improves their compression ratio.
+ *
+ * @param tiledb_array_schema The array schema to be updated.
+ * @param coords_layout The coordinates layout. It can be one of the following:
+ *        - TILEDB_COORDS_INTERLEAVED (default)
+ *        - TILEDB_COORDS_COLUMNAR
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ * @note The columnar layout is applicable only to compressed coordinates.
+ * @see TileDB_ArraySchema
+ */
+TILEDB_EXPORT int tiledb_array_set_coords_layout(
+    TileDB_ArraySchema* tiledb_array_schema,
+    int coords_layout);
+
 /**
  * Creates a new TileDB array.
  *
@@ -388,6 +509,42 @@ TILEDB_EXPORT int tiledb_array_init(
     const char** attributes,
     int attribute_num);
 
+/**
+ * Initializes a TileDB array on a read-only snapshot of its fragments, 
+ * shared by all the TileDB contexts of the process. The first time the array 
+ * is opened this way, its fragment book-keeping is loaded without acquiring 
+ * the consolidation filelock, and the fragment set is fixed thereafter. All
+ * subsequent snapshot opens of the array, from any context, reuse the loaded
+ * book-keeping and thus do not access the disk. This is intended for arrays
+ * that are no longer modified (e.g., fully consolidated archives). The 
+ * snapshot is dropped, if no array object uses it, by tiledb_array_refresh(),
+ * tiledb_clear(), tiledb_delete() and tiledb_move().
+ *
+ * @param tiledb_ctx The TileDB context.
+ * @param tiledb_array The array object to be initialized. The function
+ *     will allocate memory space for it.
+ * @param array The directory of the array to be initialized.
+ * @param mode The mode of the array. It must be one of the following:
+ *    - TILEDB_ARRAY_READ 
+ *    - TILEDB_ARRAY_READ_SORTED_COL 
+ *    - TILEDB_ARRAY_READ_SORTED_ROW
+ * @param subarray The subarray in which the array read will be constrained
+ *     on (see tiledb_array_init()).
+ * @param attributes A subset of the array attributes the read will be
+ *     constrained on (see tiledb_array_init()).
+ * @param attribute_num The number of the input attributes. If *attributes* is
+ *     NULL, then this should be set to 0.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_init_snapshot(
+    const TileDB_CTX* tiledb_ctx,
+    TileDB_Array** tiledb_array,
+    const char* array,
+    int mode,
+    const void* subarray,
+    const char** attributes,
+    int attribute_num);
+
 /**
  * Resets the subarray used upon initialization of the array. This is useful
  * when the array is used for reading, and the user wishes to change the
@@ -405,6 +562,27 @@ TILEDB_EXPORT int tiledb_array_reset_subarray(
     const TileDB_Array* tiledb_array,
     const void* subarray);
 
+/**
+ * Sets a batch of subarrays (ranges) to be read in a single query with
+ * tiledb_array_read_ranges(). This is much faster than resetting the subarray
+ * and reading once per range, since the ranges are read in the order of the
+ * tiles, the fragments are opened once for the entire batch, and a tile
+ * overlapping several ranges is fetched once. A subsequent
+ * tiledb_array_reset_subarray() discards the ranges.
+ *
+ * @param tiledb_array The TileDB array (must be initialized in mode
+ *     TILEDB_ARRAY_READ).
+ * @param ranges The ranges, each given as a sequence of [low, high] pairs
+ *     (one pair per dimension), whose type should be the same as that of the
+ *     coordinates.
+ * @param range_num The number of ranges.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_reset_ranges(
+    const TileDB_Array* tiledb_array,
+    const void* ranges,
+    int range_num);
+
 /**
  * Resets the attributes used upon initialization of the array. 
  *
@@ -421,6 +599,117 @@ TILEDB_EXPORT int tiledb_array_reset_attributes(
     const char** attributes,
     int attribute_num);
 
+/**
+ * Sets whether the subsequent reads return the dictionary codes of the
+ * attributes encoded with TILEDB_DICTIONARY, instead of their values. In the
+ * former case, the variable-sized buffer of such an attribute receives a 
+ * single int code per cell, which allows evaluating equality conditions on
+ * integers (see tiledb_array_get_dictionary_code()). The codes are local to
+ * each fragment, hence they can be enabled only if the array has at most one
+ * fragment (e.g., after consolidation). This resets the subarray similar to
+ * tiledb_array_reset_subarray(), keeping the ranges set with
+ * tiledb_array_reset_ranges(), if any.
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @param dictionary_codes If it is 1, the codes are read, whereas if it is
+ *     0 the values are read (default).
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_set_dictionary_codes(
+    const TileDB_Array* tiledb_array,
+    int dictionary_codes);
+
+/**
+ * Retrieves the dictionary code of a value of an attribute encoded with
+ * TILEDB_DICTIONARY. The array must have at most one fragment. 
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @param attribute The attribute name.
+ * @param value The value to look up.
+ * @param value_size The size of the value in bytes.
+ * @param code The retrieved code, or -1 if the value does not appear in the
+ *     array.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_get_dictionary_code(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    const void* value,
+    size_t value_size,
+    int* code);
+
+/**
+ * Adds a predicate on an attribute to an array opened in read mode, so that
+ * the subsequent reads return only the cells whose attribute value satisfies
+ * the comparison with the input constant, across all the attributes read.
+ * Multiple predicates are combined conjunctively. The tile zone maps are
+ * used to skip the tiles that cannot contain qualifying cells. Empty cells
+ * never satisfy a predicate. Applicable only to **sparse** arrays, and to
+ * attributes of type TILEDB_INT32, TILEDB_INT64, TILEDB_FLOAT32 or
+ * TILEDB_FLOAT64 with a single value per cell. This resets the subarray
+ * similar to tiledb_array_reset_subarray(), keeping the ranges set with
+ * tiledb_array_reset_ranges(), if any.
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @param attribute The attribute name.
+ * @param op The comparison operator. It can be one of the following:
+ *    - TILEDB_LT
+ *    - TILEDB_LE
+ *    - TILEDB_GT
+ *    - TILEDB_GE
+ *    - TILEDB_EQ
+ *    - TILEDB_NE
+ * @param value The constant the attribute values are compared against. It
+ *     must have the type of the attribute.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_add_predicate(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    int op,
+    const void* value);
+
+/**
+ * Removes all the predicates added with tiledb_array_add_predicate(). This
+ * resets the subarray similar to tiledb_array_reset_subarray(), keeping the
+ * ranges set with tiledb_array_reset_ranges(), if any.
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_clear_predicates(
+    const TileDB_Array* tiledb_array);
+
+/**
+ * Computes an aggregate of an attribute over the cells that a read would
+ * return, i.e., the cells in the current subarray that satisfy the predicates
+ * added with tiledb_array_add_predicate(), with the newer fragments taking
+ * precedence. The empty cells are ignored. Instead of copying the cells into
+ * user buffers, the tiles are aggregated in parallel inside the read engine,
+ * using the tile zone maps where possible. Applicable to attributes of type
+ * TILEDB_INT32, TILEDB_INT64, TILEDB_FLOAT32 or TILEDB_FLOAT64 with a single
+ * value per cell. This resets the subarray similar to 
+ * tiledb_array_reset_subarray().
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @param attribute The attribute name.
+ * @param aggregate The aggregate function. It can be one of the following:
+ *    - TILEDB_COUNT (the result is an int64_t)
+ *    - TILEDB_SUM (the result is an int64_t for integer attributes and a
+ *      double for real attributes)
+ *    - TILEDB_MIN (the result has the attribute type)
+ *    - TILEDB_MAX (the result has the attribute type)
+ *    The minimum and maximum are the empty value of the attribute type (e.g.,
+ *    TILEDB_EMPTY_INT32) if there are no non-empty cells.
+ * @param result The aggregate result.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_aggregate(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    int aggregate,
+    void* result);
+
 /**
  * Retrieves the schema of an already initialized array.
  *
@@ -454,6 +743,29 @@ TILEDB_EXPORT int tiledb_array_load_schema(
 TILEDB_EXPORT int tiledb_array_free_schema(
     TileDB_ArraySchema* tiledb_array_schema);
 
+/**
+ * Sets whether the subsequent dense writes skip the tiles whose cells are
+ * all empty (i.e., equal to TILEDB_EMPTY_*, with a single empty value per
+ * variable-sized cell) in every written attribute. Such tiles are not
+ * stored, and a read retrieves their cells from the older fragments (the
+ * stored tiles are written entirely as usual, including their empty cells).
+ * This allows writing small scattered updates as a dense fragment that
+ * covers their bounding subarray and stores only the updated tiles, instead
+ * of turning them into a sparse fragment with explicit coordinates or a
+ * large dense rewrite. The flag applies to the fragments that have not been
+ * written to yet, and the buffers of each tiledb_array_write() must then be
+ * synchronized, i.e., have the same number of cells across all attributes.
+ *
+ * @param tiledb_array The TileDB array (must be dense and initialized in a
+ *     write mode).
+ * @param skip_empty_tiles If it is 1, the empty tiles are skipped, whereas
+ *     if it is 0 all tiles are stored (default).
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_set_skip_empty_tiles(
+    const TileDB_Array* tiledb_array,
+    int skip_empty_tiles);
+
 /**
  * Performs a write operation to an array.  
  * The array must be initialized in one of the following write modes,
@@ -506,6 +818,47 @@ TILEDB_EXPORT int tiledb_array_write(
     const void** buffers,
     const size_t* buffer_sizes);
 
+/**
+ * Estimates the buffer sizes that a read of the current subarray would fill,
+ * so that the buffers can be allocated once before calling 
+ * tiledb_array_read(). The estimate is an upper bound, computed from the
+ * fragment book-keeping (the tile MBRs, the number of cells per tile and
+ * the sizes of the variable-sized tiles) without reading or decompressing
+ * any tile. The attribute predicates are not taken into account.
+ *
+ * @param tiledb_array The TileDB array (must be initialized in read mode).
+ * @param buffer_sizes The estimated sizes (in bytes), one for each buffer 
+ *     that would be passed to tiledb_array_read(), i.e., two for each
+ *     variable-sized attribute (the offsets and the values).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_estimate_buffer_sizes(
+    const TileDB_Array* tiledb_array,
+    size_t* buffer_sizes);
+
+/**
+ * Splits the subarray of the array (set in tiledb_array_init() or 
+ * tiledb_array_reset_subarray()) into disjoint subarrays that cover it, to be
+ * read by parallel readers. For dense arrays the partitions are aligned to 
+ * the tile grid, so that no tile is fetched by two readers. For sparse arrays
+ * they hold roughly equal numbers of cells, estimated from the MBRs of the
+ * tiles. Applicable only to the read modes.
+ *
+ * @param tiledb_array The TileDB array.
+ * @param partition_num The maximum number of partitions.
+ * @param partitions The partitions written one after the other, each in the
+ *     same format as the subarray. It must have space for *partition_num*
+ *     subarrays.
+ * @param result_num The number of partitions written, which may be smaller
+ *     than *partition_num* if the subarray cannot be split further.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_partition_subarray(
+    const TileDB_Array* tiledb_array,
+    int partition_num,
+    void* partitions,
+    int* result_num);
+
 /**
  * Performs a read operation on an array.
  * The array must be initialized in one of the following read modes,
@@ -545,6 +898,67 @@ TILEDB_EXPORT int tiledb_array_read(
     void** buffers,
     size_t* buffer_sizes);
 
+/**
+ * Performs a read operation over the ranges set with 
+ * tiledb_array_reset_ranges(). The results are grouped per range: the cells
+ * of each range are stored contiguously in the buffers, as in 
+ * tiledb_array_read(), and the ranges follow the order of the tiles. The 
+ * offsets of the variable-sized cells are relative to the start of the 
+ * corresponding buffer, across all ranges.
+ *
+ * @param tiledb_array The TileDB array.
+ * @param buffers An array of buffers, one for each attribute, as in
+ *     tiledb_array_read().
+ * @param buffer_sizes The sizes (in bytes) allocated by the user for the input
+ *     buffers, as in tiledb_array_read(). If the buffers cannot hold all
+ *     results, the function writes as much data as it can and turns on the
+ *     overflow flag (see tiledb_array_overflow()). The next invocation resumes
+ *     each attribute from the range and the cell it stopped at.
+ * @param range_offsets The position of the first cell of each range in the
+ *     buffers of each attribute, counted in cells. There is one entry per
+ *     attribute and range: the entry of the *i*-th attribute and the *r*-th
+ *     range (in the order the ranges were given in 
+ *     tiledb_array_reset_ranges()) is at position i * range_num + r.
+ * @param range_cell_nums The number of cells of each range written in the
+ *     buffers of each attribute by this invocation, laid out as 
+ *     *range_offsets*. The numbers of different attributes may differ if
+ *     their buffers fill up at different cells.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_read_ranges(
+    const TileDB_Array* tiledb_array,
+    void** buffers,
+    size_t* buffer_sizes,
+    int64_t* range_offsets,
+    int64_t* range_cell_nums);
+
+/**
+ * Same as tiledb_array_read(), but it also produces a validity bitmap for
+ * each attribute. A cell is valid if it comes from some fragment, and empty
+ * if it lies in an empty region of the array, in which case it holds the
+ * special empty value (e.g., TILEDB_EMPTY_INT32). Contrary to comparing with
+ * the special empty values, the bitmaps also work for cells that were written
+ * with these values. Applicable only to mode TILEDB_ARRAY_READ.
+ *
+ * @param tiledb_array The TileDB array.
+ * @param buffers An array of buffers, one for each attribute, as in
+ *     tiledb_array_read().
+ * @param buffer_sizes The sizes (in bytes) allocated by the user for the input
+ *     buffers, as in tiledb_array_read().
+ * @param validity An array of bitmaps, one for each attribute (regardless of
+ *     whether it is fixed- or variable-sized), in the order of the attributes.
+ *     Bit *i* (counting from the least significant bit of the first byte) is
+ *     set to 1 if the *i*-th cell written in the buffers of the attribute is
+ *     valid, and to 0 if it is empty. Each bitmap must hold at least one bit
+ *     per cell that fits in the buffers.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_read_validity(
+    const TileDB_Array* tiledb_array,
+    void** buffers,
+    size_t* buffer_sizes,
+    unsigned char** validity);
+
 /**
  * Checks if a read operation for a particular attribute resulted in a
  * buffer overflow.
@@ -566,6 +980,23 @@ TILEDB_EXPORT int tiledb_array_overflow(
     const TileDB_Array* tiledb_array,
     int attribute_id);
 
+/**
+ * Dumps the query statistics of an array in JSON format, namely the bytes
+ * read, the tiles fetched and decompressed, the tile cache hits and the
+ * fragment cell ranges merged, as well as the number of invocations and the
+ * total time of the read phases (tile search, fragment merge, I/O,
+ * decompression and copy). The statistics accumulate over all the reads
+ * since the array was initialized. They are collected only if TileDB is
+ * compiled with TILEDB_STATS, otherwise the function returns an error.
+ *
+ * @param tiledb_array The TileDB array.
+ * @param out The file the statistics are written to (e.g., stdout).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_stats_dump(
+    const TileDB_Array* tiledb_array,
+    FILE* out);
+
 /**
  * Consolidates the fragments of an array into a single fragment. 
  * 
@@ -577,6 +1008,22 @@ TILEDB_EXPORT int tiledb_array_consolidate(
     const TileDB_CTX* tiledb_ctx,
     const char* array);
 
+/**
+ * Refreshes the fragments of an array that is currently initialized in read
+ * mode. The book-keeping structures are loaded only for the fragments created
+ * since the array was opened (or last refreshed), and the fragments that no
+ * longer exist (e.g., after a consolidation) are dropped. The array objects
+ * initialized after the refresh see the new fragments, whereas those already
+ * initialized are unaffected and keep reading from their own fragments. 
+ * 
+ * @param tiledb_ctx The TileDB context.
+ * @param array The name of the TileDB array to be refreshed.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_refresh(
+    const TileDB_CTX* tiledb_ctx,
+    const char* array);
+
 /** 
  * Finalizes a TileDB array, properly freeing its memory space. 
  *
@@ -1197,6 +1644,37 @@ TILEDB_EXPORT int tiledb_ls_c(
     const char* parent_dir,
     int* dir_num);
 
+/** 
+ * Retrieves the number of filesystem stat calls saved so far by the context,
+ * which caches the array and metadata schemas, as well as the types of the
+ * TileDB objects it has encountered. The caches are invalidated by the
+ * TileDB create, clear, delete and move operations, but not by changes
+ * made to the directories outside TileDB.
+ *
+ * @param tiledb_ctx The TileDB context.
+ * @param stat_saved_num The number of saved stat calls to be retrieved.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_ctx_stat_saved_num(
+    const TileDB_CTX* tiledb_ctx,
+    int64_t* stat_saved_num);
+
+/**
+ * Dumps the query statistics of a context in JSON format (see
+ * tiledb_array_stats_dump()). These include the time spent loading the
+ * fragment book-keeping, plus the statistics of all the arrays and array
+ * iterators finalized so far in the context. They are collected only if
+ * TileDB is compiled with TILEDB_STATS, otherwise the function returns an
+ * error.
+ *
+ * @param tiledb_ctx The TileDB context.
+ * @param out The file the statistics are written to (e.g., stdout).
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_ctx_stats_dump(
+    const TileDB_CTX* tiledb_ctx,
+    FILE* out);
+
 
 
 
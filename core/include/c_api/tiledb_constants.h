@@ -99,6 +99,30 @@
 /** Size of the buffer used during consolidation. */
 #define TILEDB_CONSOLIDATION_BUFFER_SIZE      10000000 // ~10 MB
 
+/** 
+ * Maximum number of threads of the pool shared by the arrays of a TileDB
+ * context, including the thread that runs a task on it.
+ */
+#define TILEDB_CTX_THREAD_NUM                       16
+
+/** Maximum number of threads loading fragment book-keeping on array open. */
+#define TILEDB_BOOK_KEEPING_THREAD_NUM              16
+
+/** Maximum number of threads reading the fragments or tiles of a read. */
+#define TILEDB_READ_THREAD_NUM                      16
+
+/** 
+ * Maximum number of tiles of an attribute decompressed ahead of a read, split
+ * among the array fragments.
+ */
+#define TILEDB_READ_PREFETCH_TILE_NUM               16
+
+/** 
+ * Maximum number of tiles of an attribute kept in main memory across the
+ * ranges of a multi-range read, split among the array fragments.
+ */
+#define TILEDB_RANGE_TILE_CACHE_NUM                 16
+
 /**@{*/
 /** Special empty cell value. */
 #define TILEDB_EMPTY_INT32                     INT_MAX
@@ -123,6 +147,24 @@
 #define TILEDB_CHAR                                  4
 /**@}*/
 
+/**@{*/
+/** Comparison operator of an attribute predicate. */
+#define TILEDB_LT                                    0
+#define TILEDB_LE                                    1
+#define TILEDB_GT                                    2
+#define TILEDB_GE                                    3
+#define TILEDB_EQ                                    4
+#define TILEDB_NE                                    5
+/**@}*/
+
+/**@{*/
+/** Aggregate function. */
+#define TILEDB_COUNT                                 0
+#define TILEDB_SUM                                   1
+#define TILEDB_MIN                                   2
+#define TILEDB_MAX                                   3
+/**@}*/
+
 /**@{*/
 /** Tile or cell order. */
 #define TILEDB_ROW_MAJOR                             0
@@ -145,6 +187,20 @@
 #define TILEDB_RLE                                  10
 /**@}*/
 
+/**@{*/
+/** Filter type, applied to a tile before compression. */
+#define TILEDB_NO_FILTER                             0
+#define TILEDB_DELTA                                 1
+#define TILEDB_DOUBLE_DELTA                          2
+#define TILEDB_DICTIONARY                            3
+/**@}*/
+
+/**@{*/
+/** Layout of the coordinates of a tile on disk. */
+#define TILEDB_COORDS_INTERLEAVED                    0
+#define TILEDB_COORDS_COLUMNAR                       1
+/**@}*/
+
 /**@{*/
 /** Special attribute name. */
 #define TILEDB_COORDS                       "__coords"
@@ -189,6 +245,19 @@
 #endif
 /**@}*/
 
+/** 
+ * Special compression level value indicating that the compile-time default
+ * level of the corresponding compressor must be used.
+ */
+#define TILEDB_COMPRESSION_LEVEL_DEFAULT               INT_MIN
+
+/**@{*/
+/** Blosc shuffle mode. */
+#define TILEDB_BLOSC_NOSHUFFLE                       0
+#define TILEDB_BLOSC_SHUFFLE                         1
+#define TILEDB_BLOSC_BITSHUFFLE                      2
+/**@}*/
+
 /**@{*/
 /** MAC address interface. */
 #if defined(__APPLE__) && defined(__MACH__)
@@ -61,8 +61,11 @@
 /*          GLOBAL VARIABLES         */
 /* ********************************* */
 
-/** Stores potential error messages. */
-extern std::string tiledb_bk_errmsg;
+/** 
+ * Stores potential error messages. It is thread-local, since book-keeping
+ * structures may be loaded concurrently.
+ */
+extern thread_local std::string tiledb_bk_errmsg;
 
 
 
@@ -125,7 +128,22 @@ class BookKeeping {
   /** Returns true if the array is in read mode. */
   bool read_mode() const;
 
-  /** Returns the number of tiles in the fragment. */
+  /**
+   * Returns the position of the input tile among the tiles actually stored
+   * in the fragment, or -1 if the tile is not stored. The two positions
+   * differ only in dense fragments written with Array::skip_empty_tiles(),
+   * which do not store the tiles whose cells are all empty.
+   *
+   * @param tile_pos The position of the tile in the (expanded) domain of a
+   *     dense fragment, or the tile position in a sparse fragment.
+   * @return The position of the stored tile, or -1 if the tile is absent.
+   */
+  int64_t stored_tile_pos(int64_t tile_pos) const;
+
+  /** 
+   * Returns the number of tiles in the fragment. For dense fragments, these
+   * are only the tiles stored in the fragment (see stored_tile_pos()).
+   */
   int64_t tile_num() const;
 
   /** Returns the tile offsets. */
@@ -140,6 +158,24 @@ class BookKeeping {
   /** Returns true if the array is in write mode. */
   bool write_mode() const;
 
+  /** 
+   * Returns the zone map of the input attribute for the tile at the input
+   * position, or NULL if the fragment has no zone maps for the attribute.
+   * The zone map consists of the minimum and maximum value in the tile (of
+   * the attribute type), followed by the number of non-empty and the number
+   * of empty values in the tile (int64_t each). Empty values are ignored in
+   * the minimum and maximum, which are both the empty value if the tile has
+   * no other values.
+   */
+  const void* zone_map(int attribute_id, int64_t tile_pos) const;
+
+  /** 
+   * Returns the size of a zone map of the input attribute, or 0 if zone maps
+   * are not applicable to the attribute. Zone maps are maintained only for
+   * compressed, fixed-sized numeric attributes.
+   */
+  size_t zone_map_size(int attribute_id) const;
+
 
 
 
@@ -174,6 +210,15 @@ class BookKeeping {
    */
   void append_tile_offset(int attribute_id, size_t step);
 
+  /** 
+   * Appends the presence of the next tile of a dense fragment, i.e., whether
+   * the tile is stored or skipped because all its cells are empty.
+   *
+   * @param present *true* if the tile is stored, and *false* otherwise.
+   * @return void
+   */
+  void append_tile_presence(bool present);
+
   /** 
    * Appends a variable tile offset for the input attribute. 
    *
@@ -194,6 +239,16 @@ class BookKeeping {
    */
   void append_tile_var_size(int attribute_id, size_t size);
 
+  /** 
+   * Appends a tile zone map for the input attribute (see zone_map()).
+   *
+   * @param attribute_id The id of the attribute for which the zone map is
+   *     appended.
+   * @param zone_map The zone map to be appended.
+   * @return void
+   */
+  void append_zone_map(int attribute_id, const void* zone_map);
+
   /**
    * Finalizes the book-keeping structures, properly flushing them to the disk.
    *
@@ -268,6 +323,18 @@ class BookKeeping {
    * when there is compression.
    */
   std::vector<std::vector<off_t> > tile_offsets_;
+  /**
+   * A bitmap with one bit per tile of a dense fragment, set if the tile is
+   * stored in the fragment. It is empty if all tiles are stored.
+   */
+  std::vector<uint64_t> tile_presence_;
+  /** The number of tiles (bits) in the tile presence bitmap. */
+  int64_t tile_presence_num_;
+  /** 
+   * The number of stored tiles before each word of the tile presence
+   * bitmap, used to compute stored_tile_pos() in constant time.
+   */
+  std::vector<int64_t> tile_presence_ranks_;
   /**
    * The variable tile offsets in their corresponding attribute files.
    * Meaningful only for variable-sized tiles.
@@ -278,6 +345,12 @@ class BookKeeping {
    * Meaningful only when there is compression for variable tiles.
    */
   std::vector<std::vector<size_t> > tile_var_sizes_;
+  /**
+   * The tile zone maps of each attribute, stored contiguously (see 
+   * zone_map()). Empty for the attributes to which zone maps are not
+   * applicable, as well as for fragments created before zone maps.
+   */
+  std::vector<std::vector<char> > zone_maps_;
 
 
 
@@ -326,6 +399,14 @@ class BookKeeping {
    */
   int flush_tile_offsets(gzFile fd) const;
 
+ /**
+   * Writes the tile presence bitmap in the book-keeping file on disk.
+   *
+   * @param fd The descriptor of the book-keeping file.
+   * @return TILEDB_BK_OK on success and TILEDB_BK_ERR on error.
+   */
+  int flush_tile_presence(gzFile fd) const;
+
  /**
    * Writes the variable tile offsets in the book-keeping file on disk.
    *
@@ -342,6 +423,14 @@ class BookKeeping {
    */
   int flush_tile_var_sizes(gzFile fd) const;
 
+ /**
+   * Writes the zone maps in the book-keeping file on disk.
+   *
+   * @param fd The descriptor of the book-keeping file.
+   * @return TILEDB_BK_OK on success and TILEDB_BK_ERR on error.
+   */
+  int flush_zone_maps(gzFile fd) const;
+
   /**
    * Loads the bounding coordinates from the book-keeping file on disk.
    *
@@ -382,6 +471,15 @@ class BookKeeping {
    */
   int load_tile_offsets(gzFile fd);
 
+  /**
+   * Loads the tile presence bitmap from the book-keeping file on disk.
+   * Fragments created before the bitmap store all their tiles.
+   *
+   * @param fd The descriptor of the book-keeping file.
+   * @return TILEDB_BK_OK on success and TILEDB_BK_ERR on error.
+   */
+  int load_tile_presence(gzFile fd);
+
   /**
    * Loads the variable tile offsets from the book-keeping file on disk.
    *
@@ -397,6 +495,18 @@ class BookKeeping {
    * @return TILEDB_BK_OK on success and TILEDB_BK_ERR on error.
    */
   int load_tile_var_sizes(gzFile fd);
+
+  /**
+   * Loads the zone maps from the book-keeping file on disk. Fragments created
+   * before zone maps simply have none.
+   *
+   * @param fd The descriptor of the book-keeping file.
+   * @return TILEDB_BK_OK on success and TILEDB_BK_ERR on error.
+   */
+  int load_zone_maps(gzFile fd);
+
+  /** Returns the number of tiles stored according to the presence bitmap. */
+  int64_t present_tile_num() const;
 };
 
 #endif
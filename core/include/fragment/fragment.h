@@ -101,6 +101,9 @@ class Fragment {
   /** Returns the array the fragment belongs to. */
   const Array* array() const;
 
+  /** Returns the book-keeping of the fragment. */
+  BookKeeping* book_keeping() const;
+
   /** Returns the number of cell per (full) tile. */
   int64_t cell_num_per_tile() const;
 
@@ -0,0 +1,158 @@
+/**
+ * @file   fragment_index.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file defines class FragmentIndex. 
+ */
+
+#ifndef __FRAGMENT_INDEX_H__
+#define __FRAGMENT_INDEX_H__
+
+#include "array_schema.h"
+#include "book_keeping.h"
+#include <vector>
+
+
+
+
+/** 
+ * An interval index over the bounding boxes of the fragments of an array, 
+ * used to find the fragments that overlap a subarray without inspecting all
+ * of them. The bounding box of a fragment is its non-empty domain if it is
+ * dense, and the union of its MBRs if it is sparse. The boxes are sorted on
+ * the lower bound of their first dimension, along with the running maximum
+ * of their upper bounds, so that a query considers only the fragments whose
+ * first-dimension interval may overlap the subarray.
+ */
+class FragmentIndex {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** 
+   * Constructor. 
+   *
+   * @param array_schema The array schema.
+   * @param book_keeping The book-keeping structures of the fragments of the
+   *     array, in the order in which the fragments were created.
+   */
+  FragmentIndex(
+      const ArraySchema* array_schema, 
+      const std::vector<BookKeeping*>& book_keeping);
+
+  /** Destructor. */
+  ~FragmentIndex();
+
+
+
+
+  /* ********************************* */
+  /*             ACCESSORS             */
+  /* ********************************* */
+
+  /** Returns the number of indexed fragments. */
+  int fragment_num() const;
+
+  /**
+   * Finds the fragments whose bounding box overlaps the input subarray.
+   *
+   * @param subarray The subarray, whose type must be the same as the type of
+   *     the array coordinates.
+   * @param fragment_ids The positions of the overlapping fragments in the
+   *     book-keeping vector the index was built on, in increasing order (i.e.,
+   *     preserving the order of the fragments) to be returned.
+   * @return void
+   */
+  void overlapping_fragments(
+      const void* subarray, 
+      std::vector<int>& fragment_ids) const;
+
+
+
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The array schema. */
+  const ArraySchema* array_schema_;
+  /** 
+   * The bounding box of each fragment, stored contiguously in the order of
+   * the fragments, i.e., one [lower, upper] pair per dimension per fragment. 
+   */
+  void* bounds_;
+  /** The number of indexed fragments. */
+  int fragment_num_;
+  /** 
+   * The lower bounds of the first dimension of the bounding boxes, sorted
+   * in increasing order. 
+   */
+  void* lows_;
+  /** 
+   * The running maximum of the upper bounds of the first dimension of the
+   * bounding boxes, following the order of *lows_*.
+   */
+  void* max_highs_;
+  /** The fragment positions, sorted on the values of *lows_*. */
+  std::vector<int> order_;
+
+
+
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Builds the index.
+   *
+   * @tparam T The coordinates type.
+   * @param book_keeping The book-keeping structures of the fragments.
+   * @return void
+   */
+  template<class T>
+  void build(const std::vector<BookKeeping*>& book_keeping);
+
+  /**
+   * Finds the fragments whose bounding box overlaps the input subarray.
+   *
+   * @tparam T The coordinates type.
+   * @param subarray The subarray.
+   * @param fragment_ids The positions of the overlapping fragments to be
+   *     returned, in increasing order.
+   * @return void
+   */
+  template<class T>
+  void overlapping_fragments(
+      const T* subarray, 
+      std::vector<int>& fragment_ids) const;
+};
+
+#endif
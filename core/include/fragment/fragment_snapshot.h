@@ -0,0 +1,135 @@
+/**
+ * @file   fragment_snapshot.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file defines class FragmentSnapshot. 
+ */
+
+#ifndef __FRAGMENT_SNAPSHOT_H__
+#define __FRAGMENT_SNAPSHOT_H__
+
+#include "array_schema.h"
+#include "book_keeping.h"
+#include "fragment_index.h"
+#include <string>
+#include <vector>
+
+
+
+
+/** 
+ * An immutable set of fragments of an array, along with their book-keeping
+ * structures and an index over their bounding boxes. Array objects read from
+ * the snapshot they were initialized with, so that refreshing the fragments
+ * of an open array does not affect in-flight reads. The snapshot does not own
+ * the book-keeping structures, which may be shared by several snapshots.
+ * The reference counter is not synchronized; the owner of the snapshot (i.e.,
+ * the storage manager) must serialize the calls to acquire() and release().
+ */
+class FragmentSnapshot {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** 
+   * Constructor. The reference counter is initialized to 1.
+   *
+   * @param array_schema The array schema.
+   * @param fragment_names The names of the fragments, in the order in which
+   *     they were created.
+   * @param book_keeping The book-keeping structures of the fragments.
+   */
+  FragmentSnapshot(
+      const ArraySchema* array_schema, 
+      const std::vector<std::string>& fragment_names,
+      const std::vector<BookKeeping*>& book_keeping);
+
+  /** Destructor. */
+  ~FragmentSnapshot();
+
+
+
+
+  /* ********************************* */
+  /*             ACCESSORS             */
+  /* ********************************* */
+
+  /** Returns the book-keeping structures of the fragments. */
+  const std::vector<BookKeeping*>& book_keeping() const;
+
+  /** Returns the index over the bounding boxes of the fragments. */
+  const FragmentIndex* fragment_index() const;
+
+  /** Returns the names of the fragments. */
+  const std::vector<std::string>& fragment_names() const;
+
+  /** Returns the number of fragments. */
+  int fragment_num() const;
+
+
+
+
+  /* ********************************* */
+  /*             MUTATORS              */
+  /* ********************************* */
+
+  /** 
+   * Increments the reference counter.
+   *
+   * @return The new value of the reference counter.
+   */
+  int acquire();
+
+  /** 
+   * Decrements the reference counter. The snapshot must be deleted by the
+   * caller when the counter reaches zero.
+   *
+   * @return The new value of the reference counter.
+   */
+  int release();
+
+
+
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The book-keeping structures of the fragments. */
+  std::vector<BookKeeping*> book_keeping_;
+  /** The reference counter. */
+  int cnt_;
+  /** The index over the bounding boxes of the fragments. */
+  FragmentIndex* fragment_index_;
+  /** The names of the fragments. */
+  std::vector<std::string> fragment_names_;
+};
+
+#endif
@@ -36,6 +36,7 @@
 #include "array.h"
 #include "book_keeping.h"
 #include "fragment.h"
+#include "predicate.h"
 #include <vector>
 
 
@@ -62,8 +63,11 @@
 /*          GLOBAL VARIABLES         */
 /* ********************************* */
 
-/** Stores potential error messages. */
-extern std::string tiledb_rs_errmsg;
+/** 
+ * Stores potential error messages. It is thread-local, since the read states
+ * of different fragments may be used concurrently.
+ */
+extern thread_local std::string tiledb_rs_errmsg;
 
 
 
@@ -156,6 +160,13 @@ class ReadState {
    */
   bool subarray_area_covered() const;
 
+  /**
+   * Returns *true* if the input tile of the input attribute is in main
+   * memory, either in this read state or in one of its prefetching read
+   * states (see prefetch_read_states_).
+   */
+  bool tile_fetched(int attribute_id, int64_t tile_i) const;
+
 
 
 
@@ -179,6 +190,18 @@ class ReadState {
    */
   void reset_overflow();
 
+  /**
+   * Sets the number of tiles per attribute that the read state keeps in main
+   * memory after moving to another tile, so that a later request overlapping
+   * them (e.g., another range of a multi-range read) does not fetch them
+   * again. The least recently used tile is evicted first. Zero disables the
+   * cache, which is the default.
+   *
+   * @param tile_cache_num The number of cached tiles per attribute.
+   * @return void.
+   */
+  void set_tile_cache_num(int tile_cache_num);
+
 
 
 
@@ -186,6 +209,56 @@ class ReadState {
   /*              MISC                 */
   /* ********************************* */
 
+  /**
+   * Aggregates the values of the input attribute in the input cell position
+   * range into the input running count, sum, minimum and maximum, ignoring
+   * the empty values. If the range covers the entire tile and the sum is not
+   * needed, the tile zone map is used instead of the values, if it exists.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum (see cells_aggregate()).
+   * @param attribute_id The id of the attribute.
+   * @param aggregate The aggregate function (TILEDB_COUNT, TILEDB_SUM,
+   *     TILEDB_MIN or TILEDB_MAX).
+   * @param empty_value The special value of type T indicating an empty cell.
+   * @param tile_i The tile to aggregate.
+   * @param cell_pos_range The cell position range to be aggregated.
+   * @param count The running number of non-empty values.
+   * @param sum The running sum of the non-empty values.
+   * @param min The running minimum of the non-empty values.
+   * @param max The running maximum of the non-empty values.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  template<class T, class S>
+  int aggregate(
+      int attribute_id,
+      int aggregate,
+      T empty_value,
+      int64_t tile_i,
+      const CellPosRange& cell_pos_range,
+      int64_t& count,
+      S& sum,
+      T& min,
+      T& max);
+
+  /**
+   * Assigns the input tiles of the input attribute to the prefetching read
+   * states (see prefetch_read_states_), creating them if needed. A tile that
+   * is already in main memory is not assigned again, and the prefetching read
+   * states holding one of the input tiles are not reused. The assigned tiles
+   * are then fetched with prefetch_tile(), possibly in parallel.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param tiles The tiles to be prefetched.
+   * @param tasks The (prefetching read state, tile) pairs that must be
+   *     fetched, appended to the input vector.
+   * @return void
+   */
+  void assign_prefetch_tiles(
+      int attribute_id,
+      const std::vector<int64_t>& tiles,
+      std::vector<std::pair<int, int64_t> >& tasks);
+
   /**
    * Copies the cells of the input attribute into the input buffers, as 
    * determined by the input cell position range.
@@ -234,6 +307,55 @@ class ReadState {
       size_t& buffer_var_offset,
       const CellPosRange& cell_pos_range);
 
+  /**
+   * Retrieves the code of the input value in the dictionary of the input
+   * attribute, which must be encoded with TILEDB_DICTIONARY.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param value The value to look up.
+   * @param value_size The size of the value in bytes.
+   * @param code The code of the value, or -1 if the value does not appear
+   *     in the fragment.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int dictionary_code(
+      int attribute_id,
+      const void* value,
+      size_t value_size,
+      int& code);
+
+  /**
+   * Adds to the input counters an upper bound on the number of cells of the
+   * fragment that lie in the current subarray, and on the size of their
+   * variable-sized values. Only the book-keeping is used, i.e., all the cells
+   * of the tiles overlapping the subarray are counted and no tile is fetched.
+   *
+   * @param cell_num The number of cells to be incremented.
+   * @param var_sizes The sizes (in bytes) of the variable-sized values to be
+   *     incremented, one per attribute id (the fixed-sized attributes are
+   *     ignored).
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int estimate_result_size(
+      int64_t& cell_num, 
+      std::vector<size_t>& var_sizes);
+
+  /**
+   * Filters the input fragment cell position range with the attribute
+   * predicates of the array, appending to the output the sub-ranges of the
+   * cells that satisfy all of them. The tile zone maps are consulted first,
+   * so that the values of an attribute are fetched only if its zone map
+   * cannot decide the predicate for the whole tile.
+   *
+   * @param fragment_cell_pos_range The input fragment cell position range.
+   * @param fragment_cell_pos_ranges The fragment cell position ranges the
+   *     qualifying sub-ranges are appended to.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int filter_fragment_cell_pos_range(
+      const FragmentCellPosRange& fragment_cell_pos_range,
+      FragmentCellPosRanges& fragment_cell_pos_ranges);
+
   /** 
    * Retrieves the coordinates after the input coordinates in the search tile.
    * 
@@ -342,10 +464,33 @@ class ReadState {
       const T* end_coords,
       FragmentCellRanges& fragment_cell_ranges); 
 
+  /**
+   * Computes the fragment cell ranges corresponding to the current search
+   * tile, which are contained within the input start and end positions.
+   * The subarray check is performed for all the cells in a single pass that
+   * produces a bitmap, and the cell ranges are then derived from the runs of
+   * set bytes in the bitmap. Applicable only to **sparse** fragments for
+   * **sparse** arrays, when the coordinates tile is in main memory.
+   *
+   * @tparam T The coordinates type.
+   * @param fragment_i The fragment id. 
+   * @param start_pos The position of the first cell to be checked.
+   * @param end_pos The position of the last cell to be checked.
+   * @param fragment_cell_ranges The output fragment cell ranges.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  template<class T>
+  int get_fragment_cell_ranges_sparse_bitmap(
+      int fragment_i,
+      int64_t start_pos,
+      int64_t end_pos,
+      FragmentCellRanges& fragment_cell_ranges); 
+
   /**
    * Gets the next overlapping tile from the fragment, which may overlap or not
    * with the tile specified by the input tile coordinates. This is applicable
-   * only to **dense** fragments.
+   * only to **dense** fragments. A tile that is not stored in the fragment
+   * (see BookKeeping::stored_tile_pos()) does not overlap.
    *
    * @tparam T The coordinates type.
    * @param tile_coords The input tile coordinates.
@@ -376,6 +521,36 @@ class ReadState {
   template<class T>
   void get_next_overlapping_tile_sparse(const T* tile_coords);
 
+  /**
+   * Gets the positions of up to *tile_num* tiles following the input tile
+   * that overlap with the subarray query, without changing the search tile.
+   * This is applicable only to **sparse** arrays.
+   *
+   * @tparam T The coordinates type.
+   * @param tile_i The tile after which the search starts.
+   * @param tile_num The maximum number of tiles to get.
+   * @param tiles The overlapping tile positions, appended to the input vector.
+   * @return void
+   */
+  template<class T>
+  void get_next_overlapping_tiles_sparse(
+      int64_t tile_i,
+      int tile_num,
+      std::vector<int64_t>& tiles) const;
+
+  /**
+   * Fetches (and decompresses) a tile of a compressed attribute into one of
+   * the prefetching read states (see assign_prefetch_tiles()). A subsequent
+   * copy of cells from the tile takes it over instead of fetching it. Each
+   * prefetching read state may fetch its tile in a different thread.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param tile_i The tile to be fetched.
+   * @param prefetch_i The prefetching read state fetching the tile.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int prefetch_tile(int attribute_id, int64_t tile_i, int prefetch_i);
+
 
 
 
@@ -392,8 +567,23 @@ class ReadState {
   int attribute_num_;
   /** The book-keeping of the fragment the read state belongs to. */
   BookKeeping* book_keeping_;
+  /** 
+   * Bitmap with one byte per cell of the current search tile, marking the
+   * cells inside the subarray (see get_fragment_cell_ranges_sparse_bitmap()).
+   */
+  unsigned char* cell_bitmap_;
+  /** The allocated size of cell_bitmap_. */
+  size_t cell_bitmap_allocated_size_;
   /** The size of the array coordinates. */
   size_t coords_size_;
+  /** 
+   * The dictionary of each attribute encoded with TILEDB_DICTIONARY, as
+   * stored in its dictionary file (see WriteState::write_dictionaries()). It
+   * is loaded upon the first access to the attribute.
+   */
+  std::vector<void*> dictionaries_;
+  /** The sizes of the buffers in dictionaries_. */
+  std::vector<size_t> dictionary_sizes_;
   /** Indicates if the read operation on this fragment finished. */
   bool done_;
   /** Keeps track of which tile is in main memory for each attribute. */ 
@@ -434,6 +624,27 @@ class ReadState {
   int mbr_tile_overlap_;
   /** Indicates buffer overflow for each attribute. */ 
   std::vector<bool> overflow_;
+  /** 
+   * A separate read state for the same fragment, which fetches the attribute
+   * tiles on which predicates are evaluated. This prevents the evaluation
+   * from evicting tiles whose cells are still being copied. It is created
+   * upon the first evaluation.
+   */
+  ReadState* predicate_read_state_;
+  /** 
+   * Separate read states for the same fragment, which decompress tiles of
+   * compressed attributes ahead of the copies, each possibly in a different
+   * thread (see prefetch_tile()). A copy from a tile held by one of them
+   * swaps the tile buffers with it (see take_prefetched_tile()). They are
+   * created upon the first prefetch. They also hold the tiles evicted from
+   * this read state when the tile cache is enabled (see cache_tile()).
+   */
+  std::vector<ReadState*> prefetch_read_states_;
+  /**
+   * The last use of the tile of each attribute held by each prefetching read
+   * state (see tile_use_num_), used to evict the least recently used one.
+   */
+  std::vector<std::vector<int64_t> > prefetch_tile_uses_;
   /**
    * The type of overlap of the current search tile with the query subarray
    * is full or not. It can be one of the following:
@@ -452,10 +663,28 @@ class ReadState {
    * in the current overlapping tile.
    */
   bool subarray_area_covered_;
+  /** The number of cached tiles per attribute (see set_tile_cache_num()). */
+  int tile_cache_num_;
+  /** 
+   * Internal buffer holding the decompressed dictionary codes of a variable
+   * tile, prior to their decoding.
+   */
+  void* tile_codes_;
+  /** Allocated size for the internal buffer of the dictionary codes. */
+  size_t tile_codes_allocated_size_;
+  /** 
+   * Internal buffer holding a decompressed coordinates tile in the columnar
+   * layout.
+   */
+  void* tile_columnar_;
+  /** Allocated size for the internal buffer of the columnar layout. */
+  size_t tile_columnar_allocated_size_;
   /** Internal buffer used in the case of compression. */
   void* tile_compressed_;
   /** Allocated size for internal buffer used in the case of compression. */
   size_t tile_compressed_allocated_size_;
+  /** Counter stamping the uses of the tiles in prefetch_tile_uses_. */
+  int64_t tile_use_num_;
   /** File offset for each attribute tile. */
   std::vector<off_t> tiles_file_offsets_;
   /** File offset for each variable-sized attribute tile. */
@@ -486,6 +715,13 @@ class ReadState {
   void* tmp_coords_;
   /** Temporary offset. */
   size_t tmp_offset_;
+  /** 
+   * Buffer holding attribute values read from the disk, when the tile is not
+   * in main memory (see get_values()).
+   */
+  void* values_;
+  /** The allocated size of values_. */
+  size_t values_allocated_size_;
 
 
 
@@ -494,6 +730,27 @@ class ReadState {
   /*          PRIVATE METHODS          */
   /* ********************************* */
 
+  /**
+   * Makes sure that the cell bitmap can hold a byte for each of the input
+   * number of cells.
+   *
+   * @param cell_num The number of cells.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int allocate_cell_bitmap(int64_t cell_num);
+
+  /**
+   * If the tile cache is enabled (see set_tile_cache_num()), it moves the
+   * tile of the input compressed attribute currently held by the read state
+   * to the prefetching read state holding the least recently used tile,
+   * which is discarded. It is invoked before another tile of the attribute is
+   * fetched.
+   *
+   * @param attribute_id The id of the attribute.
+   * @return void
+   */
+  void cache_tile(int attribute_id);
+
   /**
    * Compares input coordinates to coordinates from the search tile.
    *
@@ -577,6 +834,29 @@ class ReadState {
   template<class T>
   void compute_tile_search_range_hil();
 
+  /**
+   * Creates the missing prefetching read states, so that there are at least
+   * as many as the input number.
+   *
+   * @param prefetch_num The number of prefetching read states.
+   * @return void
+   */
+  void create_prefetch_read_states(int prefetch_num);
+
+  /**
+   * Decodes the dictionary codes of a variable tile, held in tile_codes_,
+   * into the variable tile buffer of the attribute, and rewrites the cell
+   * offsets of the corresponding offsets tile accordingly. If the array reads
+   * dictionary codes (see Array::dictionary_codes()), the codes themselves
+   * are stored as the cell values.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile_var_size The size of the codes in bytes. After the function
+   *     call, it holds the size of the decoded variable tile.
+   * @return TILEDB_RS_OK for success and TILEDB_RS_ERR for error.
+   */
+  int decode_dictionary_tile(int attribute_id, size_t& tile_var_size);
+
   /**
    * Decompresses a tile.
    * 
@@ -740,9 +1020,86 @@ class ReadState {
       int64_t i,
       const size_t*& offset);
 
+  /**
+   * Evaluates a predicate on a range of cells of a tile, clearing the bytes
+   * of the cell bitmap that correspond to the cells that do not satisfy it.
+   *
+   * @param predicate The predicate.
+   * @param tile_i The tile position.
+   * @param start_pos The position of the first cell of the range in the tile.
+   * @param cell_num The number of cells in the range.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int evaluate_predicate(
+      const Predicate& predicate,
+      int64_t tile_i,
+      int64_t start_pos,
+      int64_t cell_num);
+
+  /**
+   * Retrieves the positions of the stored tiles of a dense fragment that
+   * overlap the subarray.
+   *
+   * @tparam T The coordinates type.
+   * @param tiles The tile positions to be retrieved.
+   * @return void
+   */
+  template<class T>
+  void get_overlapping_tiles_dense(std::vector<int64_t>& tiles) const;
+
+  /**
+   * Retrieves the positions of the tiles of a sparse fragment whose MBR
+   * overlaps the subarray.
+   *
+   * @tparam T The coordinates type.
+   * @param tiles The tile positions to be retrieved.
+   * @return void
+   */
+  template<class T>
+  void get_overlapping_tiles_sparse(std::vector<int64_t>& tiles) const;
+
+  /**
+   * Gets the values of a range of cells of the currently fetched tile of a
+   * fixed-sized attribute. If the tile is not in main memory, the values are
+   * read from the disk into an internal buffer.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param start_pos The position of the first cell of the range in the tile.
+   * @param cell_num The number of cells in the range.
+   * @param values The retrieved values.
+   * @return TILEDB_RS_OK on success and TILEDB_RS_ERR on error.
+   */
+  int get_values(
+      int attribute_id,
+      int64_t start_pos,
+      int64_t cell_num,
+      const void*& values);
+
   /** Returns *true* if the file of the input attribute is empty. */
   bool is_empty_attribute(int attribute_id) const;
 
+  /**
+   * Returns the prefetching read state that holds the least recently used
+   * tile of the input attribute, among those not marked as busy.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param prefetch_busy One flag per prefetching read state, indicating
+   *     whether it must not be chosen.
+   * @return The position of the prefetching read state.
+   */
+  int least_recently_used_prefetch_read_state(
+      int attribute_id,
+      const std::vector<bool>& prefetch_busy) const;
+
+  /**
+   * Loads the dictionary of the input attribute from its dictionary file, if
+   * it is not already loaded.
+   *
+   * @param attribute_id The id of the attribute.
+   * @return TILEDB_RS_OK for success and TILEDB_RS_ERR for error.
+   */
+  int load_dictionary(int attribute_id);
+
   /** 
    * Maps a tile from the disk for an attribute into a local buffer, using 
    * memory map (mmap). This function works with any compression.
@@ -951,6 +1308,17 @@ class ReadState {
       off_t offset,
       size_t tile_size);
 
+  /**
+   * Converts the decompressed coordinates tile stored in tile_columnar_ back
+   * to the cell layout, storing the result in the local tile buffer of the
+   * input attribute.
+   *
+   * @param attribute_id The attribute id (the coordinates or the search tile).
+   * @param tile_size The size of the tile in bytes.
+   * @return void
+   */
+  void restore_coords_tile_layout(int attribute_id, size_t tile_size);
+
   /** 
    * Saves in the read state the file offset for an attribute tile.
    * This will be used in subsequent read requests.
@@ -999,6 +1367,67 @@ class ReadState {
       void* buffer, 
       int64_t offset_num, 
       size_t new_start_offset);
+
+  /**
+   * Swaps the tile of the input attribute held by this read state, along with
+   * its buffers, with the one held by the input read state.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param read_state The read state to swap the tile with.
+   * @return void
+   */
+  void swap_tile(int attribute_id, ReadState* read_state);
+
+  /**
+   * If one of the prefetching read states holds the input tile of the input
+   * compressed attribute, it swaps its tile buffers for that attribute with
+   * those of this read state, so that the tile becomes the fetched one
+   * without being decompressed again.
+   *
+   * @param attribute_id The id of the attribute.
+   * @param tile_i The tile to be taken.
+   * @return *true* if the tile was taken and *false* otherwise.
+   */
+  bool take_prefetched_tile(int attribute_id, int64_t tile_i);
+
+  /**
+   * Reverses in place the filter (e.g., delta encoding) applied to the input
+   * decompressed tile upon writing. If the attribute has no filter, the
+   * function does nothing. For variable-sized attributes, the input tile
+   * must hold the cell offsets.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile The decompressed tile buffer.
+   * @param tile_size The size of the tile in bytes.
+   * @return void
+   */
+  void unfilter_tile(
+      int attribute_id,
+      unsigned char* tile,
+      size_t tile_size);
+
+  /**
+   * Checks a predicate against the zone map of a tile.
+   *
+   * @param predicate The predicate.
+   * @param tile_i The tile position.
+   * @return 1 if all the cells of the tile satisfy the predicate, -1 if none
+   *     does, and 0 if this cannot be decided from the zone map (or there is
+   *     no zone map for the tile).
+   */
+  int zone_map_cmp(const Predicate& predicate, int64_t tile_i) const;
+
+  /**
+   * Checks a predicate against a tile zone map (see zone_map_cmp()).
+   *
+   * @tparam T The attribute type.
+   * @param predicate The predicate.
+   * @param zone_map The zone map.
+   * @return 1 if all the cells of the tile satisfy the predicate, -1 if none
+   *     does, and 0 if this cannot be decided from the zone map.
+   */
+  template<class T>
+  int zone_map_cmp(const Predicate& predicate, const void* zone_map) const;
 };
 
 #endif
@@ -35,6 +35,8 @@
 
 #include "book_keeping.h"
 #include "fragment.h"
+#include <map>
+#include <string>
 #include <vector>
 #include <iostream>
 
@@ -175,10 +177,37 @@ class WriteState {
    * variable-sized attribute.
    */
   std::vector<size_t> buffer_var_offsets_;
+  /**
+   * The dictionary of each variable-sized attribute encoded with
+   * TILEDB_DICTIONARY, mapping each distinct cell value written in the
+   * fragment to its code. The codes are assigned in order of appearance.
+   */
+  std::vector<std::map<std::string, int> > dictionaries_;
+  /**
+   * The number of cells of the offsets tile most recently written for each
+   * attribute encoded with TILEDB_DICTIONARY. It delimits the cell values
+   * of the corresponding variable tile upon its encoding.
+   */
+  std::vector<int64_t> dictionary_tile_cell_num_;
   /** The fragment the write state belongs to. */
   const Fragment* fragment_;
   /** The MBR of the tile currently being populated. */
   void* mbr_;
+  /**
+   * The cells of the dense tile currently being received, one buffer for 
+   * each buffer passed to write(). They are held back until the tile is
+   * complete, so that it is known whether the tile is empty (applicable only
+   * when skipping the empty tiles). The offsets of the variable-sized cells
+   * are relative to the start of their values buffer.
+   */
+  std::vector<std::vector<char> > pending_buffers_;
+  /** The number of cells in pending_buffers_. */
+  int64_t pending_cell_num_;
+  /** 
+   * True if the dense tiles whose cells are all empty are not stored (see
+   * Array::set_skip_empty_tiles()). It is set upon the first write.
+   */
+  bool skip_empty_tiles_;
   /** The number of cells written in the current tile for each attribute. */
   std::vector<int64_t> tile_cell_num_;
   /** Internal buffers used in the case of compression. */
@@ -196,6 +225,17 @@ class WriteState {
   void* tile_compressed_;
   /** Allocated size for internal buffer used in the case of compression. */
   size_t tile_compressed_allocated_size_;
+  /** 
+   * Internal buffer holding a coordinates tile in the columnar layout, prior
+   * to its compression. 
+   */
+  void* tile_columnar_;
+  /** Allocated size for the internal buffer of the columnar layout. */
+  size_t tile_columnar_allocated_size_;
+  /** Internal buffer holding a filtered tile, prior to its compression. */
+  void* tile_filtered_;
+  /** Allocated size for the internal buffer holding a filtered tile. */
+  size_t tile_filtered_allocated_size_;
   /** Offsets to the internal tile buffers used in compression. */
   std::vector<size_t> tile_offsets_;
 
@@ -206,6 +246,34 @@ class WriteState {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Appends a range of cells of the input buffers to pending_buffers_.
+   *
+   * @param buffers See write().
+   * @param buffer_sizes See write().
+   * @param cell_pos The position of the first cell of the range in the
+   *     buffers.
+   * @param cell_num The number of cells in the range.
+   * @return void
+   */
+  void buffer_dense_cells(
+      const void** buffers, 
+      const size_t* buffer_sizes,
+      int64_t cell_pos,
+      int64_t cell_num);
+
+  /**
+   * Converts the input coordinates tile to the columnar layout, i.e., it 
+   * stores the coordinates of each dimension contiguously. The result is
+   * stored in the tile_columnar_ member attribute.
+   *
+   * @param tile The coordinates tile. After the function call, it points to
+   *     the tile in the columnar layout.
+   * @param tile_size The size of the tile buffer in bytes.
+   * @return void
+   */
+  void columnarize_coords_tile(unsigned char*& tile, size_t tile_size);
+
   /**
    * Compresses the input tile buffer, and stores it inside tile_compressed_
    * member attribute. 
@@ -226,12 +294,14 @@ class WriteState {
    * Compresses with GZIP the input tile buffer, and stores it inside 
    * tile_compressed_ member attribute. 
    * 
+   * @param attribute_id The id of the attribute the tile belongs to.
    * @param tile The tile buffer to be compressed.
    * @param tile_size The size of the tile buffer in bytes.
    * @param tile_compressed_size The size of the resulting compressed tile.
    * @return TILEDB_WS_OK on success and TILEDB_WS_ERR on error.
    */
   int compress_tile_gzip(
+      int attribute_id,
       unsigned char* tile,
       size_t tile_size,
       size_t& tile_compressed_size);
@@ -240,12 +310,14 @@ class WriteState {
    * Compresses with Zstandard the input tile buffer, and stores it inside 
    * tile_compressed_ member attribute. 
    * 
+   * @param attribute_id The id of the attribute the tile belongs to.
    * @param tile The tile buffer to be compressed.
    * @param tile_size The size of the tile buffer in bytes.
    * @param tile_compressed_size The size of the resulting compressed tile.
    * @return TILEDB_WS_OK on success and TILEDB_WS_ERR on error.
    */
   int compress_tile_zstd(
+      int attribute_id,
       unsigned char* tile,
       size_t tile_size,
       size_t& tile_compressed_size);
@@ -318,6 +390,53 @@ class WriteState {
    */
   int compress_and_write_tile_var(int attribute_id);
 
+  /**
+   * Computes the zone map of the input tile of a fixed-sized numeric
+   * attribute and appends it to the book-keeping (see BookKeeping::zone_map()).
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile The tile, before it gets filtered and compressed.
+   * @param tile_size The size of the tile in bytes.
+   * @return void
+   */
+  void compute_zone_map(int attribute_id, const void* tile, size_t tile_size);
+
+  /**
+   * Computes the zone map of the input values (see BookKeeping::zone_map()).
+   *
+   * @tparam T The type of the values.
+   * @param values The values.
+   * @param value_num The number of values.
+   * @param empty_value The value that represents an empty value.
+   * @param zone_map The buffer where the zone map will be stored.
+   * @return void
+   */
+  template<class T>
+  void compute_zone_map(
+      const T* values, 
+      int64_t value_num, 
+      T empty_value,
+      void* zone_map) const;
+
+  /**
+   * Replaces the cell values of the input variable tile with their codes in
+   * the dictionary of the attribute, adding any new values to the
+   * dictionary. The cells are delimited by the offsets tile of the attribute,
+   * which must have just been written. The codes are stored in the
+   * tile_filtered_ member attribute.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile The variable tile. After the function call, it points to the
+   *     codes.
+   * @param tile_size The size of the variable tile in bytes. After the
+   *     function call, it holds the size of the codes.
+   * @return void
+   */
+  void encode_dictionary_tile(
+      int attribute_id,
+      unsigned char*& tile,
+      size_t& tile_size);
+
   /**
    * Expands the current MBR with the input coordinates.
    *
@@ -328,6 +447,51 @@ class WriteState {
   template<class T>
   void expand_mbr(const T* coords);
 
+  /**
+   * Applies the filter of the input attribute (e.g., delta encoding) to the
+   * input tile. The filtered tile is stored in the tile_filtered_ member
+   * attribute, so that the input tile (which may be a user buffer) is not
+   * modified. If the attribute has no filter, the function does nothing.
+   * For variable-sized attributes, the input tile must hold the cell offsets.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile The tile buffer to be filtered. After the function call, it
+   *     points to the filtered tile.
+   * @param tile_size The size of the tile buffer in bytes.
+   * @return void
+   */
+  void filter_tile(
+      int attribute_id,
+      unsigned char*& tile,
+      size_t tile_size);
+
+  /**
+   * Checks whether all the values of the input tile are the empty value of
+   * the type of the input attribute.
+   *
+   * @param attribute_id The id of the attribute the tile belongs to.
+   * @param tile The tile (the values of the variable-sized cells for
+   *     variable-sized attributes).
+   * @param tile_size The size of the tile in bytes.
+   * @return *true* if the tile is empty, and *false* otherwise.
+   */
+  bool is_empty_tile(
+      int attribute_id, 
+      const void* tile, 
+      size_t tile_size) const;
+
+  /**
+   * Checks whether all the input values are equal to the input empty value.
+   *
+   * @tparam T The type of the values.
+   * @param values The values.
+   * @param value_num The number of values.
+   * @param empty The special empty value of type T.
+   * @return *true* if all values are empty, and *false* otherwise.
+   */
+  template<class T>
+  bool is_empty_tile(const T* values, int64_t value_num, T empty) const;
+
   /**
    * Shifts the offsets of the variable-sized cells recorded in the input
    * buffer, so that they correspond to the actual offsets in the corresponding
@@ -520,6 +684,58 @@ class WriteState {
       const void* buffer_var, 
       size_t buffer_var_size);
 
+  /**
+   * Writes the tile held back in pending_buffers_ (see write_dense_tile()),
+   * and clears the held back cells.
+   *
+   * @return TILEDB_WS_OK on success and TILEDB_WS_ERR on error.
+   */
+  int write_dense_pending_tile();
+
+  /**
+   * Performs the write operation for the case of a dense fragment that skips
+   * the empty tiles. The buffers must contain the same number of cells. The
+   * entire tiles are written directly from the buffers (see
+   * write_dense_tile()), whereas the cells of a partially received tile are
+   * held back in pending_buffers_ until it is complete.
+   *
+   * @param buffers See write().
+   * @param buffer_sizes See write().
+   * @return TILEDB_WS_OK on success and TILEDB_WS_ERR on error.
+   */
+  int write_dense_skip_empty(
+      const void** buffers, 
+      const size_t* buffer_sizes);
+
+  /**
+   * Writes a tile of a dense fragment, located in a range of cells of the
+   * input buffers, unless the cells of the tile are all empty in every 
+   * attribute. The presence of the tile is recorded in the book-keeping.
+   *
+   * @param buffers See write().
+   * @param buffer_sizes See write().
+   * @param cell_pos The position of the first cell of the tile in the
+   *     buffers.
+   * @param cell_num The number of cells of the tile (fewer than the cells
+   *     per tile only for an incomplete last tile).
+   * @return TILEDB_WS_OK on success and TILEDB_WS_ERR on error.
+   */
+  int write_dense_tile(
+      const void** buffers, 
+      const size_t* buffer_sizes,
+      int64_t cell_pos,
+      int64_t cell_num);
+
+  /**
+   * Writes the dictionary of each attribute encoded with TILEDB_DICTIONARY
+   * to its dictionary file in the fragment. The file stores the number of
+   * distinct values (int64_t), followed by their start offsets (size_t), 
+   * followed by the values themselves in the order of their codes.
+   *
+   * @return TILEDB_WS_OK for success and TILEDB_WS_ERR for error.
+   */
+  int write_dictionaries();
+
   /**
    * Performs the write operation for the case of a sparse fragment.
    *
@@ -157,9 +157,8 @@ class Metadata {
    * Initializes a TileDB metadata object.
    *
    * @param array_schema This essentially encapsulates the metadata schema.
-   * @param fragment_names The names of the fragments of the array.
-   * @param book_keeping The book-keeping structures of the fragments
-   *     of the array.
+   * @param fragment_snapshot The fragments of the underlying array to read
+   *     from (applicable only to read mode).
    * @param mode The mode of the metadata. It must be one of the following:
    *    - TILEDB_METADATA_WRITE 
    *    - TILEDB_METADATA_READ 
@@ -169,16 +168,18 @@ class Metadata {
    * @param attribute_num The number of the input attributes. If *attributes* is
    *     NULL, then this should be set to 0.
    * @param config Congiguration parameters.
+   * @param thread_pool The thread pool of the storage manager (see
+   *     Array::init()).
    * @return TILEDB_MT_OK on success, and TILEDB_MT_ERR on error.
    */
   int init(
       const ArraySchema* array_schema, 
-      const std::vector<std::string>& fragment_names,
-      const std::vector<BookKeeping*>& book_keeping,
+      FragmentSnapshot* fragment_snapshot,
       int mode,
       const char** attributes,
       int attribute_num,
-      const StorageManagerConfig* config);
+      const StorageManagerConfig* config,
+      ThreadPool* thread_pool);
 
   /**
    * Resets the attributes used upon initialization of the metadata. 
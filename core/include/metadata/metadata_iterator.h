@@ -85,6 +85,9 @@ class MetadataIterator {
   /*             ACCESSORS             */
   /* ********************************* */
 
+  /** Returns the metadata object the iterator iterates over. */
+  Metadata* metadata() const;
+
   /** Return the metadata name. */
   const std::string& metadata_name() const;
 
@@ -34,6 +34,7 @@
 #ifndef __COMPARATORS_H__
 #define __COMPARATORS_H__
 
+#include "array_schema.h"
 #include <inttypes.h>
 #include <vector>
 
@@ -230,4 +231,43 @@ class SmallerRow {
   int dim_num_;
 };
 
+/** 
+ * Wrapper of comparison function for sorting cells on the global cell order
+ * of an array, i.e., first on the tile order and then on the cell order. 
+ */
+template<class T>
+class SmallerTileCell {
+ public:
+  /** 
+   * Constructor. 
+   * 
+   * @param buffer The buffer containing the cells to be sorted.
+   * @param array_schema The schema of the array the cells belong to.
+   */
+  SmallerTileCell(const T* buffer, const ArraySchema* array_schema) 
+      : array_schema_(array_schema),
+        buffer_(buffer),
+        dim_num_(array_schema->dim_num()) { }
+
+  /**
+   * Comparison operator. 
+   *
+   * @param a The first cell position in the cell buffer.
+   * @param b The second cell position in the cell buffer.
+   */
+  bool operator () (int64_t a, int64_t b) {
+    return array_schema_->tile_cell_order_cmp(
+               &buffer_[a * dim_num_], 
+               &buffer_[b * dim_num_]) < 0;
+  }
+
+ private:
+  /** The array schema. */
+  const ArraySchema* array_schema_;
+  /** Cell buffer. */
+  const T* buffer_;
+  /** Number of dimensions. */
+  int dim_num_;
+};
+
 #endif
@@ -0,0 +1,228 @@
+/**
+ * @file   stats.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file defines class Stats, which collects query statistics.
+ */
+
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+
+
+
+/* ********************************* */
+/*               MACROS              */
+/* ********************************* */
+
+/**
+ * The statistics macros. They expand to nothing (and, hence, they do not
+ * evaluate their arguments) unless TileDB is compiled with TILEDB_STATS.
+ */
+#ifdef TILEDB_STATS
+/** Adds *value* to *counter* of the input Stats object. */
+#  define STATS_ADD(stats, counter, value) \
+       (stats)->add(Stats::counter, (value))
+/** Times the enclosing scope under *timer* of the input Stats object. */
+#  define STATS_TIMER(stats, timer) \
+       StatsTimer stats_timer_##timer((stats), Stats::timer)
+#else
+#  define STATS_ADD(stats, counter, value)
+#  define STATS_TIMER(stats, timer)
+#endif
+
+
+
+
+/** 
+ * Collects query statistics, namely a set of counters and a set of timers
+ * that measure the phases of a read. All statistics are updated atomically,
+ * since a single array may be read by several threads (e.g., the AIO and the
+ * sorted read threads). The timers are inclusive, i.e., the time of a phase
+ * includes the time of the phases nested in it (e.g., the copy phase includes
+ * the I/O and decompression of the tiles it fetches).
+ */
+class Stats {
+ public:
+  /* ********************************* */
+  /*             CONSTANTS             */
+  /* ********************************* */
+
+  /** The counters. */
+  enum Counter {
+    /** Number of bytes read from the fragment files. */
+    BYTES_READ,
+    /** Number of tile requests served by the already fetched tile. */
+    CACHE_HITS,
+    /** Number of fragment cell ranges merged across fragments. */
+    RANGES_MERGED,
+    /** Number of tiles decompressed. */
+    TILES_DECOMPRESSED,
+    /** Number of tiles fetched from the fragment files. */
+    TILES_FETCHED,
+    /** Number of counters. */
+    COUNTER_NUM
+  };
+
+  /** The timers. */
+  enum Timer {
+    /** Loading the fragment book-keeping upon opening an array. */
+    TIMER_BOOK_KEEPING_LOAD,
+    /** Copying cells into the user buffers. */
+    TIMER_COPY,
+    /** Decompressing tiles. */
+    TIMER_DECOMPRESS,
+    /** Merging the cell ranges of multiple fragments. */
+    TIMER_FRAGMENT_MERGE,
+    /** Reading from the fragment files. */
+    TIMER_IO,
+    /** An entire read query. */
+    TIMER_READ,
+    /** Computing the tile search range of a fragment. */
+    TIMER_TILE_SEARCH,
+    /** Number of timers. */
+    TIMER_NUM
+  };
+
+
+
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. All statistics are initialized to zero. */
+  Stats();
+
+  /** Destructor. */
+  ~Stats();
+
+
+
+
+  /* ********************************* */
+  /*             ACCESSORS             */
+  /* ********************************* */
+
+  /** Returns the value of the input counter. */
+  int64_t counter(Counter counter) const;
+
+  /** Returns the total time in nanoseconds recorded for the input timer. */
+  int64_t time(Timer timer) const;
+
+  /** Returns the number of times the input timer has been recorded. */
+  int64_t timer_calls(Timer timer) const;
+
+  /** 
+   * Returns the statistics in JSON format, i.e., an object with a
+   * "counters" member mapping each counter name to its value, and a "timers"
+   * member mapping each timer name to an object with its number of "calls"
+   * and total "seconds".
+   */
+  std::string to_json() const;
+
+
+
+
+  /* ********************************* */
+  /*             MUTATORS              */
+  /* ********************************* */
+
+  /** Adds the input value to the input counter. */
+  void add(Counter counter, int64_t value);
+
+  /** Records *nsec* nanoseconds for one invocation of the input timer. */
+  void add_time(Timer timer, int64_t nsec);
+
+  /** Adds all the statistics of the input object to this object. */
+  void merge(const Stats& stats);
+
+  /** Resets all statistics to zero. */
+  void reset();
+
+
+
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The counter values. */
+  std::atomic<int64_t> counters_[COUNTER_NUM];
+  /** The number of invocations recorded per timer. */
+  std::atomic<int64_t> timer_calls_[TIMER_NUM];
+  /** The total time in nanoseconds recorded per timer. */
+  std::atomic<int64_t> times_[TIMER_NUM];
+};
+
+
+
+
+/** 
+ * Times a scope: it records the time elapsed between its construction and
+ * destruction under a timer of a Stats object.
+ */
+class StatsTimer {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** 
+   * Constructor. It starts the timer.
+   *
+   * @param stats The object the elapsed time is recorded in.
+   * @param timer The timer the elapsed time is recorded under.
+   */
+  StatsTimer(Stats* stats, Stats::Timer timer);
+
+  /** Destructor. It stops the timer and records the elapsed time. */
+  ~StatsTimer();
+
+
+
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The start time in nanoseconds. */
+  int64_t start_;
+  /** The object the elapsed time is recorded in. */
+  Stats* stats_;
+  /** The timer the elapsed time is recorded under. */
+  Stats::Timer timer_;
+};
+
+#endif
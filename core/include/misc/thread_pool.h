@@ -0,0 +1,188 @@
+/**
+ * @file   thread_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file defines class ThreadPool. 
+ */
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+
+
+
+/* ********************************* */
+/*             CONSTANTS             */
+/* ********************************* */
+
+/**@{*/
+/** Return code. */
+#define TILEDB_TP_OK          0
+#define TILEDB_TP_ERR        -1
+/**@}*/
+
+/** Default error message. */
+#define TILEDB_TP_ERRMSG std::string("[TileDB::ThreadPool] Error: ")
+
+
+
+
+/* ********************************* */
+/*          GLOBAL VARIABLES         */
+/* ********************************* */
+
+/** 
+ * Stores potential error messages. It is thread-local, since the pool is
+ * shared by the arrays of a context, which may be used by different threads.
+ */
+extern thread_local std::string tiledb_tp_errmsg;
+
+
+
+
+/** 
+ * A set of persistent threads that run a function along with the calling
+ * thread. The threads are created upon the first run that needs them and
+ * are reused by all subsequent runs, until the pool is destroyed. The
+ * function is expected to claim its work dynamically from the data it is
+ * given (e.g., through an atomic counter), since the number of threads that
+ * actually run it is not known in advance. A single function runs on the
+ * pool at a time; a run requested while another one is in progress (e.g.,
+ * from another thread or from within the function) is carried out by the
+ * calling thread alone.
+ */
+class ThreadPool {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** 
+   * Constructor. 
+   *
+   * @param thread_num The maximum number of threads that run a function,
+   *     including the calling thread.
+   */
+  ThreadPool(int thread_num);
+
+  /** Destructor. It stops and joins the threads of the pool. */
+  ~ThreadPool();
+
+
+
+
+  /* ********************************* */
+  /*             MUTATORS              */
+  /* ********************************* */
+
+  /**
+   * Initializes the pool synchronization primitives. No thread is created.
+   *
+   * @return TILEDB_TP_OK on success and TILEDB_TP_ERR on error.
+   */
+  int init();
+
+  /**
+   * Runs a function on the calling thread and on up to *thread_num*-1
+   * threads of the pool, and returns when all of them are done. If some
+   * thread cannot be created, or the pool is busy with another run, the
+   * function runs on fewer threads.
+   *
+   * @param func The function to be run.
+   * @param data The data passed to every run of the function.
+   * @param thread_num The number of threads that run the function, including
+   *     the calling thread. It is capped by the pool size.
+   * @return TILEDB_TP_OK on success and TILEDB_TP_ERR on error.
+   */
+  int run(void *(*func)(void*), void* data, int thread_num);
+
+
+
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Signaled when the last thread of a run is done. */
+  pthread_cond_t done_cond_;
+  /** The function of the current run. */
+  void *(*func_)(void*);
+  /** The data of the current run. */
+  void* func_data_;
+  /** True if the synchronization primitives have been initialized. */
+  bool initialized_;
+  /** Protects the state of the current run. */
+  pthread_mutex_t mtx_;
+  /** Held by the thread whose function runs on the pool. */
+  pthread_mutex_t run_mtx_;
+  /** The number of runs of the current function still in progress. */
+  int run_num_;
+  /** True if the threads must exit. */
+  bool stop_;
+  /** The maximum number of threads running a function. */
+  int thread_num_;
+  /** The threads of the pool. */
+  std::vector<pthread_t> threads_;
+  /** 
+   * The number of threads of the pool that must still start running the 
+   * current function.
+   */
+  int waiting_run_num_;
+  /** Signaled when a function is ready to be run by the pool threads. */
+  pthread_cond_t work_cond_;
+
+
+
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** 
+   * The loop of every thread of the pool, which waits for a function and 
+   * runs it, until the pool is destroyed.
+   *
+   * @return void
+   */
+  void work();
+
+  /**
+   * Function called by each pool thread upon its creation (see work()).
+   *
+   * @param data The thread pool.
+   * @return void
+   */
+  static void *work_s(void* data);
+};
+
+#endif
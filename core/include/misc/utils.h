@@ -62,13 +62,50 @@
 /** Maximum number of bytes written in a single I/O. */
 #define TILEDB_UT_MAX_WRITE_COUNT 1500000000    // ~ 1.5 GB
 
+/** The maximum number of dimensions with specialized coordinate kernels. */
+#define TILEDB_UT_KERNEL_DIM_NUM_MAX 4
+
+/** 
+ * Maximum number of bytes copied at once when filling a buffer with a 
+ * repeated pattern, so that the source of the copies stays in the cache.
+ */
+#define TILEDB_UT_FILL_CHUNK_SIZE 65536         // 64 KB
+
+
+
+
+/* ********************************* */
+/*               MACROS              */
+/* ********************************* */
+
+/**
+ * Returns the result of the input kernel template invoked on the remaining
+ * arguments, specialized on the coordinates type *T* and the number of
+ * dimensions *dim_num* for up to TILEDB_UT_KERNEL_DIM_NUM_MAX dimensions.
+ * For more dimensions, the generic kernel (with 0 as its number of
+ * dimensions), which loops over the dimensions at runtime, is invoked.
+ */
+#define TILEDB_UT_DIM_NUM_DISPATCH(dim_num, kernel, T, ...) \
+  do {                                                      \
+    switch(dim_num) {                                       \
+      case 1: return kernel<T, 1>(__VA_ARGS__);             \
+      case 2: return kernel<T, 2>(__VA_ARGS__);             \
+      case 3: return kernel<T, 3>(__VA_ARGS__);             \
+      case 4: return kernel<T, 4>(__VA_ARGS__);             \
+      default: return kernel<T, 0>(__VA_ARGS__);            \
+    }                                                       \
+  } while(0)
+
 
 /* ********************************* */
 /*          GLOBAL VARIABLES         */
 /* ********************************* */
 
-/** Stores potential error messages. */
-extern std::string tiledb_ut_errmsg;
+/** 
+ * Stores potential error messages. It is thread-local, since the utilities
+ * may be called concurrently, e.g., by threads reading different fragments.
+ */
+extern thread_local std::string tiledb_ut_errmsg;
 
 
 /* ********************************* */
@@ -89,6 +126,23 @@ bool array_read_mode(int mode);
 /** Returns true if the input is an array write mode. */
 bool array_write_mode(int mode); 
 
+/**
+ * Groups consecutive units into at most *partition_num* partitions of 
+ * balanced total weight, where each partition gets at least one unit. A 
+ * partition ends at the unit whose weight midpoint is closest to its share of
+ * the total weight. If all weights are zero, the units are counted instead.
+ *
+ * @param weights The weight of each unit.
+ * @param partition_num The maximum number of partitions.
+ * @param partition_starts The index of the first unit of each partition, 
+ *     which is retrieved by the function.
+ * @return void
+ */
+void balanced_partitions(
+    const std::vector<double>& weights,
+    int partition_num,
+    std::vector<int64_t>& partition_starts);
+
 /**
  * Checks if both inputs represent the '/' character. This is an auxiliary
  * function to adjacent_slashes_dedup().
@@ -109,6 +163,125 @@ bool both_slashes(char a, char b);
 template<class T>
 bool cell_in_subarray(const T* cell, const T* subarray, int dim_num);
 
+/** 
+ * Kernel of cell_in_subarray() specialized on the number of dimensions.
+ *
+ * @tparam T The type of the cell and subarray.
+ * @tparam N The number of dimensions, or 0 for the generic kernel that uses
+ *     *dim_num* instead.
+ * @param cell The cell to be checked.
+ * @param subarray The subarray to be checked, expresses as [low, high] pairs
+ *     along each dimension.
+ * @param dim_num The number of dimensions for the cell and subarray.
+ * @return *true* if the input cell is inside the input range and
+ *     *false* otherwise.
+ */
+template<class T, int N>
+bool cell_in_subarray_kernel(const T* cell, const T* subarray, int dim_num);
+
+/** 
+ * Aggregates the input values into the input running count, sum, minimum
+ * and maximum, ignoring the empty values. The loop is branch-free, so that
+ * the compiler can vectorize it.
+ *
+ * @tparam T The type of the values.
+ * @tparam S The type of the sum (int64_t for integers and double for real
+ *     numbers).
+ * @param values The values to be aggregated.
+ * @param value_num The number of values.
+ * @param empty_value The special value of type T indicating an empty cell,
+ *     which must be the maximum value of the type.
+ * @param count The running number of non-empty values.
+ * @param sum The running sum of the non-empty values.
+ * @param min The running minimum of the non-empty values.
+ * @param max The running maximum of the non-empty values.
+ * @return void
+ */
+template<class T, class S>
+void cells_aggregate(
+    const T* values,
+    int64_t value_num,
+    T empty_value,
+    int64_t& count,
+    S& sum,
+    T& min,
+    T& max);
+
+/** 
+ * Compares each of the input values against a constant, clearing the
+ * corresponding byte of the input bitmap if the comparison does not hold. The
+ * empty values never satisfy the comparison. The check is branch-free, so
+ * that the compiler can vectorize it.
+ *
+ * @tparam T The type of the values.
+ * @param values The values to be compared.
+ * @param value_num The number of values.
+ * @param op The comparison operator. It can be one of the following:
+ *    - TILEDB_LT
+ *    - TILEDB_LE
+ *    - TILEDB_GT
+ *    - TILEDB_GE
+ *    - TILEDB_EQ
+ *    - TILEDB_NE
+ * @param value The constant the values are compared against.
+ * @param empty_value The special value of type T indicating an empty cell.
+ * @param bitmap The bitmap to be updated, which must hold *value_num* bytes.
+ * @return void
+ */
+template<class T>
+void cells_cmp_value(
+    const T* values,
+    int64_t value_num,
+    int op,
+    T value,
+    T empty_value,
+    unsigned char* bitmap);
+
+/** 
+ * Checks which of the input cells are inside the input subarray, producing
+ * a bitmap with one byte per cell, which is 1 if the cell is inside the
+ * subarray and 0 otherwise. The check is branch-free, so that the compiler
+ * can vectorize it.
+ *
+ * @tparam T The type of the cells and subarray.
+ * @param cells The cells to be checked, with their coordinates interleaved.
+ * @param cell_num The number of cells to be checked.
+ * @param subarray The subarray to be checked, expresses as [low, high] pairs
+ *     along each dimension.
+ * @param dim_num The number of dimensions for the cells and subarray.
+ * @param bitmap The output bitmap, which must hold *cell_num* bytes.
+ * @return void
+ */
+template<class T>
+void cells_in_subarray(
+    const T* cells,
+    int64_t cell_num,
+    const T* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+
+/** 
+ * Kernel of cells_in_subarray() specialized on the number of dimensions.
+ *
+ * @tparam T The type of the cells and subarray.
+ * @tparam N The number of dimensions, or 0 for the generic kernel that uses
+ *     *dim_num* instead.
+ * @param cells The cells to be checked, with their coordinates interleaved.
+ * @param cell_num The number of cells to be checked.
+ * @param subarray The subarray to be checked, expresses as [low, high] pairs
+ *     along each dimension.
+ * @param dim_num The number of dimensions for the cells and subarray.
+ * @param bitmap The output bitmap, which must hold *cell_num* bytes.
+ * @return void
+ */
+template<class T, int N>
+void cells_in_subarray_kernel(
+    const T* cells,
+    int64_t cell_num,
+    const T* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+
 /** 
  * Returns the number of cells in the input subarray (considering that the
  * subarray is dense). 
@@ -159,6 +332,24 @@ int cmp_col_order(
     const T* coords_b, 
     int dim_num);
 
+/**
+ * Kernel of cmp_col_order() specialized on the number of dimensions.
+ *
+ * @tparam T The type of the input coordinates.
+ * @tparam N The number of dimensions, or 0 for the generic kernel that uses
+ *     *dim_num* instead.
+ * @param coords_a The first coordinates.
+ * @param coords_b The second coordinates.
+ * @param dim_num The number of dimensions of the coordinates.
+ * @return -1 if *coords_a* precedes *coords_b*, 0 if *coords_a* and
+ *     *coords_b* are equal, and +1 if *coords_a* succeeds *coords_b*.
+ */
+template<class T, int N>
+int cmp_col_order_kernel(
+    const T* coords_a, 
+    const T* coords_b, 
+    int dim_num); 
+
 /**
  * Compares the precedence of two coordinates based on the row-major order.
  *
@@ -197,6 +388,63 @@ int cmp_row_order(
     const T* coords_b, 
     int dim_num); 
 
+/**
+ * Kernel of cmp_row_order() specialized on the number of dimensions.
+ *
+ * @tparam T The type of the input coordinates.
+ * @tparam N The number of dimensions, or 0 for the generic kernel that uses
+ *     *dim_num* instead.
+ * @param coords_a The first coordinates.
+ * @param coords_b The second coordinates.
+ * @param dim_num The number of dimensions of the coordinates.
+ * @return -1 if *coords_a* precedes *coords_b*, 0 if *coords_a* and
+ *     *coords_b* are equal, and +1 if *coords_a* succeeds *coords_b*.
+ */
+template<class T, int N>
+int cmp_row_order_kernel(
+    const T* coords_a, 
+    const T* coords_b, 
+    int dim_num); 
+
+/**
+ * Converts coordinates stored per dimension, i.e., (x0,x1,...,y0,y1,...), to
+ * the cell layout, i.e., (x0,y0,x1,y1,...).
+ *
+ * @tparam T The coordinates type.
+ * @param in The input coordinates in the columnar layout.
+ * @param out The output coordinates in the cell layout. It must not overlap
+ *     with the input.
+ * @param cell_num The number of cells.
+ * @param dim_num The number of dimensions.
+ * @return void
+ */
+template<class T>
+void coords_from_columnar(
+    const T* in, 
+    T* out, 
+    int64_t cell_num, 
+    int dim_num);
+
+/**
+ * Converts coordinates stored in the cell layout, i.e., (x0,y0,x1,y1,...), to
+ * the columnar layout, i.e., (x0,x1,...,y0,y1,...), where the coordinates of 
+ * each dimension are contiguous.
+ *
+ * @tparam T The coordinates type.
+ * @param in The input coordinates in the cell layout.
+ * @param out The output coordinates in the columnar layout. It must not 
+ *     overlap with the input.
+ * @param cell_num The number of cells.
+ * @param dim_num The number of dimensions.
+ * @return void
+ */
+template<class T>
+void coords_to_columnar(
+    const T* in, 
+    T* out, 
+    int64_t cell_num, 
+    int dim_num);
+
 /**
  * Creates a new directory.
  *
@@ -231,6 +479,72 @@ std::string current_dir();
  */
 int delete_dir(const std::string& dirname);
 
+/**
+ * Reverses delta encoding in place (see delta_encode()).
+ *
+ * @tparam T The type of the values (an integer type).
+ * @param buffer The delta-encoded values, which are replaced by the original
+ *     values.
+ * @param value_num The number of values in the buffer.
+ * @param stride The distance (in values) between a value and the one it is
+ *     encoded against.
+ * @return void
+ */
+template<class T>
+void delta_decode(T* buffer, int64_t value_num, int stride);
+
+/**
+ * Delta-encodes the input values. The first *stride* values are copied
+ * unchanged, and every subsequent value is replaced by its difference from the
+ * value *stride* positions before it. Using the number of dimensions as the
+ * stride encodes each coordinate against the same coordinate of the previous
+ * cell.
+ *
+ * @tparam T The type of the values (an integer type).
+ * @param in The input values.
+ * @param out The output buffer, which must hold *value_num* values and must
+ *     not overlap with the input.
+ * @param value_num The number of input values.
+ * @param stride The distance (in values) between a value and the one it is
+ *     encoded against.
+ * @return void
+ */
+template<class T>
+void delta_encode(const T* in, T* out, int64_t value_num, int stride);
+
+/**
+ * Reverses double-delta encoding in place (see double_delta_encode()).
+ *
+ * @tparam T The type of the values (an integer type).
+ * @param buffer The double-delta-encoded values, which are replaced by the
+ *     original values.
+ * @param value_num The number of values in the buffer.
+ * @param stride The distance (in values) between a value and the one it is
+ *     encoded against.
+ * @return void
+ */
+template<class T>
+void double_delta_decode(T* buffer, int64_t value_num, int stride);
+
+/**
+ * Double-delta-encodes the input values. Each value is replaced by the
+ * difference between its delta and the delta of the value *stride* positions
+ * before it. The results are zig-zag encoded, so that small negative
+ * differences map to small unsigned integers. This suits monotonic sequences
+ * with near-constant steps (e.g., timestamps), which become runs of zeros.
+ *
+ * @tparam T The type of the values (an integer type).
+ * @param in The input values.
+ * @param out The output buffer, which must hold *value_num* values and must
+ *     not overlap with the input.
+ * @param value_num The number of input values.
+ * @param stride The distance (in values) between a value and the one it is
+ *     encoded against.
+ * @return void
+ */
+template<class T>
+void double_delta_encode(const T* in, T* out, int64_t value_num, int stride);
+
 /**
  * Checks if the input is a special TileDB empty value.
  *
@@ -272,6 +586,43 @@ void expand_mbr(T* mbr, const T* coords, int dim_num);
  */
 off_t file_size(const std::string& filename);
 
+/**
+ * Fills a buffer with an arithmetic sequence of offsets, i.e., 
+ * *start*, *start* + *step*, *start* + 2 * *step*, etc.
+ *
+ * @param buffer The buffer to be filled, which must hold *offset_num* 
+ *     offsets.
+ * @param start The first offset.
+ * @param step The difference between two consecutive offsets.
+ * @param offset_num The number of offsets.
+ * @return void
+ */
+void fill_offsets(
+    void* buffer, 
+    size_t start, 
+    size_t step, 
+    int64_t offset_num);
+
+/**
+ * Fills a buffer with copies of the input pattern. The pattern is written 
+ * once, and then the filled prefix of the buffer is copied after itself,
+ * doubling its size on every copy up to TILEDB_UT_FILL_CHUNK_SIZE bytes. This
+ * way, the buffer is filled with a few large memcpy calls instead of a
+ * memcpy per pattern.
+ *
+ * @param buffer The buffer to be filled, which must hold 
+ *     *pattern_size* * *pattern_num* bytes.
+ * @param pattern The pattern.
+ * @param pattern_size The size of the pattern in bytes.
+ * @param pattern_num The number of copies of the pattern.
+ * @return void
+ */
+void fill_pattern(
+    void* buffer, 
+    const void* pattern, 
+    size_t pattern_size, 
+    int64_t pattern_num);
+
 /** Returns the names of the directories inside the input directory. */
 std::vector<std::string> get_dirs(const std::string& dir);
 
@@ -292,13 +643,16 @@ std::string get_mac_addr();
  * @param in_size The size of the input buffer.
  * @param out The output buffer.
  * @param out_size The available size in the output buffer.
+ * @param level The compression level, or TILEDB_COMPRESSION_LEVEL_DEFAULT for
+ *     the compile-time default (TILEDB_COMPRESSION_LEVEL_GZIP).
  * @return The size of compressed data on success, and TILEDB_UT_ERR on error.
  */
 ssize_t gzip(
     unsigned char* in, 
     size_t in_size, 
     unsigned char* out, 
-    size_t out_size);
+    size_t out_size,
+    int level);
 
 /** 
  * Decompresses the GZIPed input buffer and stores the result in the output 
@@ -542,6 +896,30 @@ int mutex_lock(pthread_mutex_t* mtx);
  */
 int mutex_unlock(pthread_mutex_t* mtx);
 
+/**
+ * Generates a new fragment id, unique within the process, of the form
+ * <MAC address><thread id>_<timestamp in ms>_<sequence number>, e.g.,
+ * 00332a0b8c64140253587359488_1458759561320_17. The MAC address is retrieved
+ * only once per process. The sequence number is drawn from a process-wide
+ * monotonic counter, so that fragments created within the same millisecond
+ * (by the same or different threads) get distinct ids ordered by creation.
+ * The timestamp never decreases across calls, even if the clock does.
+ *
+ * @return The new fragment id, or "" (empty string) on error.
+ */
+std::string new_fragment_id();
+
+/**
+ * Returns the smallest value of type T that is greater than the input, i.e.,
+ * *value* + 1 for integers and the next representable value for reals.
+ *
+ * @tparam T The value type.
+ * @param value The input value.
+ * @return The next value.
+ */
+template<class T>
+T next_value(T value);
+
 /** 
  * Returns the parent directory of the input directory. 
  *
@@ -550,6 +928,17 @@ int mutex_unlock(pthread_mutex_t* mtx);
  */
 std::string parent_dir(const std::string& dir);
 
+/**
+ * Returns the largest value of type T that is smaller than the input, i.e.,
+ * *value* - 1 for integers and the previous representable value for reals.
+ *
+ * @tparam T The value type.
+ * @param value The input value.
+ * @return The previous value.
+ */
+template<class T>
+T previous_value(T value);
+
 /**
  * It takes as input an **absolute** path, and returns it in its canonicalized
  * form, after appropriately replacing "./" and "../" in the path.
@@ -748,6 +1137,23 @@ int RLE_decompress_coords_row(
     size_t value_size,
     int dim_num);
 
+/**
+ * Sets the bits in positions [start, end) of a bitmap to *value*. Bits are
+ * numbered from the least significant bit of the first byte. The whole bytes
+ * covered by the range are set with a single memset.
+ *
+ * @param bitmap The bitmap to be updated.
+ * @param start The first bit position of the range.
+ * @param end The position right after the last bit of the range.
+ * @param value The value the bits are set to.
+ * @return void
+ */
+void set_bitmap_range(
+    unsigned char* bitmap, 
+    int64_t start, 
+    int64_t end, 
+    bool value);
+
 /** 
  * Checks if a string starts with a certain prefix.
  *
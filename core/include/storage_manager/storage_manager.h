@@ -41,6 +41,8 @@
 #include "metadata_iterator.h"
 #include "metadata_schema_c.h"
 #include "storage_manager_config.h"
+#include "thread_pool.h"
+#include <atomic>
 #include <map>
 #ifdef HAVE_OPENMP
   #include <omp.h>
@@ -96,6 +98,27 @@ class StorageManager {
   /*         TYPE DEFINITIONS          */
   /* ********************************* */
 
+  /** 
+   * Used to pass data to the threads that load the book-keeping structures of
+   * the fragments of an array. Every thread repeatedly claims the next
+   * fragment not yet claimed until none is left. All the threads share a
+   * single object.
+   */
+  struct BookKeepingLoadData {
+    /** The array schema. */
+    const ArraySchema* array_schema_;
+    /** The book-keeping structures, one per fragment. */
+    std::vector<BookKeeping*>* book_keeping_;
+    /** The error messages, one per fragment (empty upon success). */
+    std::vector<std::string>* errmsgs_;
+    /** The names of the fragments to be loaded. */
+    const std::vector<std::string>* fragment_names_;
+    /** The array mode. */
+    int mode_;
+    /** The next fragment to be claimed. */
+    std::atomic<int>* next_fragment_;
+  };
+
   /** The operation type on the master catalog (insertion or deletion). */
   enum MasterCatalogOp {TILEDB_SM_MC_INS, TILEDB_SM_MC_DEL};
 
@@ -260,6 +283,10 @@ class StorageManager {
    *     the coordinates in the case of sparse arrays).
    * @param attribute_num The number of the input attributes. If *attributes* is
    *     NULL, then this should be set to 0.
+   * @param snapshot If *true* (applicable only to the read modes), the array
+   *     is opened on the process-wide read-only snapshot of its fragments,
+   *     without locking the consolidation filelock (see 
+   *     array_snapshot_open()).
    * @return TILEDB_SM_OK on success, and TILEDB_SM_ERR on error.
    */
   int array_init(
@@ -268,7 +295,8 @@ class StorageManager {
       int mode, 
       const void* subarray,
       const char** attributes,
-      int attribute_num);
+      int attribute_num,
+      bool snapshot = false);
 
   /** 
    * Finalizes an array, properly freeing the memory space.
@@ -278,6 +306,21 @@ class StorageManager {
    */
   int array_finalize(Array* array);
 
+  /** 
+   * Refreshes the fragments of an open array. It rescans the array directory,
+   * loads the book-keeping structures only of the fragments created since the
+   * last refresh, and drops the fragments that no longer exist (e.g., after
+   * a consolidation). The arrays initialized after the refresh read from the
+   * new set of fragments, whereas the arrays that are already initialized
+   * keep reading from the fragments they were initialized with. If the array
+   * is not open, the function does nothing, since the fragments are loaded
+   * upon the next array initialization anyway.
+   *
+   * @param array_dir The array directory.
+   * @return TILEDB_SM_OK on success, and TILEDB_SM_ERR on error.
+   */
+  int array_refresh(const char* array_dir);
+
   /** 
    * Syncs all currently written files in the input array. 
    *
@@ -538,15 +581,45 @@ class StorageManager {
    */
   int move(const std::string& old_dir, const std::string& new_dir);
 
+  /**
+   * Returns the number of filesystem stat calls saved so far by the object
+   * type and schema caches of the storage manager.
+   *
+   * @return The number of saved stat calls.
+   */
+  int64_t stat_saved_num() const;
+
+#ifdef TILEDB_STATS
+  /**
+   * Returns the query statistics of the storage manager, i.e., the time spent
+   * loading fragment book-keeping, plus the statistics of all the arrays
+   * (and array iterators) finalized so far.
+   */
+  const Stats& stats() const;
+#endif
+
  private:
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
 
+  /** OpenMP mutex protecting the object type and schema caches. */
+#ifdef HAVE_OPENMP
+  mutable omp_lock_t cache_omp_mtx_;
+#endif
+  /** Pthread mutex protecting the object type and schema caches. */
+  mutable pthread_mutex_t cache_pthread_mtx_;
   /** The TileDB configuration parameters. */
   StorageManagerConfig* config_;
   /** The directory of the master catalog. */
   std::string master_catalog_dir_;
+  /** 
+   * Caches the types of the directories found to be TileDB objects. For each
+   * real directory path, it stores a bitmap with bit (1 << type) set for
+   * every confirmed object type (TILEDB_WORKSPACE, TILEDB_GROUP, TILEDB_ARRAY
+   * or TILEDB_METADATA). Only positive checks are cached. 
+   */
+  mutable std::map<std::string, int> object_type_cache_;
   /** OpneMP mutex for creating/deleting an OpenArray object. */
 #ifdef HAVE_OPENMP
   omp_lock_t open_array_omp_mtx_;
@@ -555,6 +628,30 @@ class StorageManager {
   pthread_mutex_t open_array_pthread_mtx_;
   /** Stores the currently open arrays. */
   std::map<std::string, OpenArray*> open_arrays_;
+  /** Caches the serialized array and metadata schemas per schema file. */
+  mutable std::map<std::string, std::vector<char> > schema_cache_;
+  /** 
+   * The read-only array snapshots shared by all the storage managers (and,
+   * hence, all the TileDB contexts) of the process, indexed by real array
+   * directory. Each entry holds the array schema and a fixed fragment
+   * snapshot, and outlives the arrays that use it, so that re-opening the
+   * array does not touch the disk.
+   */
+  static std::map<std::string, OpenArray*> snapshot_arrays_;
+  /** Pthread mutex protecting the shared array snapshots. */
+  static pthread_mutex_t snapshot_arrays_mtx_;
+  /** The number of filesystem stat calls saved by the caches. */
+  mutable int64_t stat_saved_num_;
+#ifdef TILEDB_STATS
+  /** The query statistics accumulated by the storage manager. */
+  Stats stats_;
+#endif
+  /** 
+   * The pool of threads shared by the arrays of the storage manager (see
+   * TILEDB_CTX_THREAD_NUM), whose threads are created upon the first task
+   * that needs them.
+   */
+  ThreadPool* thread_pool_;
   /** The TileDB home directory. */
   std::string tiledb_home_;
 
@@ -577,9 +674,13 @@ class StorageManager {
    * the schema and fragment book-keeping of the array).
    *
    * @param array The array name.
+   * @param fragment_snapshot The fragment snapshot acquired when the array
+   *     was opened, which is released.
    * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
    */
-  int array_close(const std::string& array);
+  int array_close(
+      const std::string& array,
+      FragmentSnapshot* fragment_snapshot);
 
   /**
    * Deletes a TileDB array entirely.
@@ -615,7 +716,11 @@ class StorageManager {
 
   /**
    * Loads the book-keeping structures of all the fragments of an array from the
-   * disk, allocating appropriate memory space for them.
+   * disk, allocating appropriate memory space for them. The fragments are
+   * loaded concurrently by up to TILEDB_BOOK_KEEPING_THREAD_NUM threads of
+   * the thread pool. Upon
+   * error, all loaded structures are deleted and the error messages of the
+   * failed fragments are aggregated in tiledb_sm_errmsg.
    *
    * @param array_schema The array schema.
    * @param fragment_names The names of the fragments of the array.
@@ -629,6 +734,16 @@ class StorageManager {
       std::vector<BookKeeping*>& book_keeping,
       int mode);
 
+  /**
+   * Loads the book-keeping structures of the fragments of an array claimed
+   * by the calling thread. This is executed by each of the threads of the
+   * thread pool run by array_load_book_keeping().
+   *
+   * @param data A BookKeepingLoadData object.
+   * @return Always NULL. The per-fragment errors are stored in the input data.
+   */
+  static void *array_load_book_keeping_s(void* data);
+
   /**
    * Moves a TileDB array.
    *
@@ -643,20 +758,77 @@ class StorageManager {
   /**
    * Opens an array. This creates or updates an OpenArray entry for this array,
    * and loads the array schema and book-keeping if it is the first time this
-   * array is being initialized. The book-keeping structures are loaded only
-   * if the input mode is a read mode.
+   * array is being initialized (or if the array had no fragments so far). The
+   * book-keeping structures are loaded only if the input mode is a read mode.
    *
    * @param array_name The array name (must be absolute path).
-   * @param mode The mode in which the array is being initialized.
-   * @param open_array The open array entry that is retrieved.
+   * @param fragment_snapshot The current fragment snapshot of the array, 
+   *     which is acquired and must be released with array_close().
    * @param mode The array mode.
    * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
    */
   int array_open(
       const std::string& array_name, 
-      OpenArray*& open_array,
+      FragmentSnapshot*& fragment_snapshot,
+      int mode);
+
+  /**
+   * Rescans the fragments of an open array, loading the book-keeping 
+   * structures only of the new fragments, and replaces the current fragment
+   * snapshot of the open array entry if the fragments changed. It must be
+   * called while holding the mutex of the open array entry.
+   *
+   * @param array_name The array name (must be absolute path).
+   * @param open_array The open array entry.
+   * @param mode The array mode.
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int array_refresh_fragments(
+      const std::string& array_name, 
+      OpenArray* open_array,
       int mode);
 
+  /**
+   * Removes the shared read-only snapshots of an array, or of all the arrays
+   * under a directory, that are not currently used by any array object. 
+   * Subsequent snapshot opens will load the array anew.
+   *
+   * @param dir The (real) array directory, or a directory containing arrays.
+   * @return void
+   */
+  void array_snapshot_evict(const std::string& dir) const;
+
+  /**
+   * Opens an array on its shared read-only snapshot. The first time the
+   * snapshot is opened in the process, the array schema and the book-keeping
+   * of all its fragments are loaded, without acquiring the consolidation 
+   * filelock. The array is thereby assumed to be immutable (e.g., a fully
+   * consolidated archive). All subsequent opens, from any TileDB context,
+   * acquire the same fragment snapshot without accessing the disk.
+   *
+   * @param array_name The (real) array directory.
+   * @param fragment_snapshot The acquired fragment snapshot.
+   * @param mode The array mode.
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int array_snapshot_open(
+      const std::string& array_name,
+      FragmentSnapshot*& fragment_snapshot,
+      int mode);
+
+  /**
+   * Releases a fragment snapshot if it is a shared read-only snapshot of the
+   * array, acquired with array_snapshot_open().
+   *
+   * @param array_name The array directory.
+   * @param fragment_snapshot The fragment snapshot to be released.
+   * @return *true* if the snapshot was a shared one and was released, and
+   *     *false* otherwise.
+   */
+  bool array_snapshot_release(
+      const std::string& array_name,
+      FragmentSnapshot* fragment_snapshot) const;
+
   /**
    * Stores the input array schema into the input array directory (serializing
    * it into a sequence of bytes and storing it in a binary file).
@@ -669,6 +841,44 @@ class StorageManager {
       const std::string& dir, 
       const ArraySchema* array_schema) const;
 
+  /**
+   * Removes from the object type and schema caches a directory and everything
+   * under it. It is invoked by every operation that creates, deletes, moves
+   * or clears a TileDB object.
+   *
+   * @param dir The directory to be invalidated.
+   * @return void
+   */
+  void cache_invalidate(const std::string& dir) const;
+
+  /**
+   * Destroys the cache mutexes.
+   *
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int cache_mtx_destroy();
+
+  /**
+   * Initializes the cache mutexes.
+   *
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int cache_mtx_init();
+
+  /**
+   * Locks the cache mutexes.
+   *
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int cache_mtx_lock() const;
+
+  /**
+   * Unlocks the cache mutexes.
+   *
+   * @return TILEDB_SM_OK for success and TILEDB_SM_ERR for error.
+   */
+  int cache_mtx_unlock() const;
+
   /** 
    * It sets the TileDB configuration parameters.
    *
@@ -782,6 +992,18 @@ class StorageManager {
        const std::string& old_group,
        const std::string& new_group) const;
 
+  /**
+   * Checks if a directory is a TileDB object of the input type, consulting
+   * the object type cache before the filesystem. 
+   *
+   * @param dir The real directory path.
+   * @param object_type One of TILEDB_WORKSPACE, TILEDB_GROUP, TILEDB_ARRAY
+   *     or TILEDB_METADATA.
+   * @return *true* if *dir* is an object of type *object_type*, and *false*
+   *     otherwise.
+   */
+  bool is_object(const std::string& dir, int object_type) const;
+
   /** 
    * Consolidates the fragments of the master catalog.
    *
@@ -854,6 +1076,31 @@ class StorageManager {
    */
   int open_array_mtx_unlock();
 
+  /**
+   * Stores the contents of a schema file in the schema cache.
+   *
+   * @param filename The schema file name.
+   * @param buffer The serialized schema.
+   * @param buffer_size The size of *buffer*.
+   * @return void
+   */
+  void schema_cache_insert(
+      const std::string& filename,
+      const void* buffer,
+      size_t buffer_size) const;
+
+  /**
+   * Deserializes a schema from the schema cache.
+   *
+   * @param filename The schema file name.
+   * @param array_schema The deserialized schema, allocated only upon a cache
+   *     hit.
+   * @return *true* upon a cache hit, and *false* otherwise.
+   */
+  bool schema_cache_lookup(
+      const std::string& filename,
+      ArraySchema*& array_schema) const;
+
   /** 
    * Appropriately sorts the fragment names based on their name timestamps.
    * The result is stored in the input vector.
@@ -909,8 +1156,11 @@ class StorageManager::OpenArray {
 
   /** The array schema. */
   ArraySchema* array_schema_;
-  /** The book-keeping structures for all the fragments of the array. */
-  std::vector<BookKeeping*> book_keeping_;
+  /** 
+   * The book-keeping structures loaded for the fragments of the array, 
+   * along with the number of fragment snapshots that refer to each of them. 
+   */
+  std::map<BookKeeping*, int> book_keeping_cnt_;
   /** 
    * A counter for the number of times the array has been initialized after 
    * it was opened.
@@ -918,8 +1168,13 @@ class StorageManager::OpenArray {
   int cnt_;
   /** Descriptor for the consolidation filelock. */
   int consolidation_filelock_;
-  /** The names of the fragments of the open array. */
-  std::vector<std::string> fragment_names_;
+  /** 
+   * The current fragment snapshot of the array, i.e., the one acquired by the
+   * arrays upon initialization. The snapshot is replaced upon a refresh, 
+   * whereas the previous one lives on until all the arrays that acquired it 
+   * are closed.
+   */
+  FragmentSnapshot* fragment_snapshot_;
   /** 
    * An OpenMP mutex used to lock the array when loading the array schema and
    * the book-keeping structures from the disk.
@@ -962,6 +1217,26 @@ class StorageManager::OpenArray {
    * @return TILEDB_SM_OK for success, and TILEDB_SM_ERR for error.
    */
   int mutex_unlock();
+
+  /**
+   * Releases a fragment snapshot. If its reference counter reaches zero, it
+   * deletes the snapshot along with the book-keeping structures that no other
+   * snapshot refers to. It must be called while holding the mutexes.
+   *
+   * @param fragment_snapshot The fragment snapshot to be released.
+   * @return void
+   */
+  void release_fragment_snapshot(FragmentSnapshot* fragment_snapshot);
+
+  /**
+   * Sets the current fragment snapshot, releasing the previous one. It must be
+   * called while holding the mutexes.
+   *
+   * @param fragment_snapshot The new fragment snapshot, whose reference 
+   *     counter is owned by the open array entry.
+   * @return void
+   */
+  void set_fragment_snapshot(FragmentSnapshot* fragment_snapshot);
 };
 
 #endif
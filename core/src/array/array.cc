@@ -31,12 +31,13 @@
  */
 
 #include "array.h"
+#include "comparators.h"
 #include "utils.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
-#include <sys/time.h>
+#include <limits>
 #include <sys/syscall.h>
 #include <unistd.h>
 
@@ -72,8 +73,15 @@ Array::Array() {
   array_sorted_write_state_ = NULL;
   array_schema_ = NULL;
   subarray_ = NULL;
+  thread_pool_ = NULL;
   aio_thread_created_ = false;
   array_clone_ = NULL;
+  dictionary_codes_ = false;
+  fragment_snapshot_ = NULL;
+  range_num_ = 0;
+  range_pos_ = 0;
+  skip_empty_tiles_ = false;
+  ranges_ = NULL;
 }
 
 Array::~Array() {
@@ -88,6 +96,8 @@ Array::~Array() {
     delete array_sorted_read_state_;
   if(array_sorted_write_state_ != NULL)
     delete array_sorted_write_state_;
+  if(ranges_ != NULL)
+    free(ranges_);
 
   // Applicable only to non-clones
   if(array_clone_ != NULL) {
@@ -231,10 +241,154 @@ const StorageManagerConfig* Array::config() const {
   return config_;
 }
 
+int Array::dictionary_code(
+    int attribute_id,
+    const void* value,
+    size_t value_size,
+    int& code) const {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot get dictionary code; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(attribute_id < 0 || 
+     attribute_id >= array_schema_->attribute_num() ||
+     array_schema_->filter(attribute_id) != TILEDB_DICTIONARY) {
+    std::string errmsg = 
+        "Cannot get dictionary code; The attribute is not dictionary-encoded";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(fragment_snapshot_ != NULL && 
+     fragment_snapshot_->fragment_num() > 1) {
+    std::string errmsg = 
+        "Cannot get dictionary code; The array has multiple fragments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Trivial case - No fragments
+  if(fragment_snapshot_ == NULL || fragment_snapshot_->fragment_num() == 0) {
+    code = -1;
+    return TILEDB_AR_OK;
+  }
+
+  // The dictionary does not depend on the subarray. If the fragment does not
+  // overlap the subarray, it is opened only for the look-up.
+  bool fragment_opened = fragments_.empty();
+  Fragment* fragment;
+  if(!fragment_opened) {
+    fragment = fragments_[0];
+  } else {
+    fragment = new Fragment(this);
+    if(fragment->init(
+           fragment_snapshot_->fragment_names()[0], 
+           fragment_snapshot_->book_keeping()[0]) != TILEDB_FG_OK) {
+      delete fragment;
+      tiledb_ar_errmsg = tiledb_fg_errmsg;
+      return TILEDB_AR_ERR;
+    }
+  }
+
+  // Look up value
+  int rc = fragment->read_state()->dictionary_code(
+               attribute_id, 
+               value, 
+               value_size, 
+               code);
+  if(fragment_opened)
+    delete fragment;
+  if(rc != TILEDB_RS_OK) {
+    tiledb_ar_errmsg = tiledb_rs_errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
+bool Array::dictionary_codes() const {
+  return dictionary_codes_;
+}
+
+int Array::estimate_buffer_sizes(size_t* buffer_sizes) {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot estimate buffer sizes; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(buffer_sizes == NULL) {
+    std::string errmsg = "Cannot estimate buffer sizes; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // For easy reference
+  int attribute_num = array_schema_->attribute_num();
+  int attribute_id_num = attribute_ids_.size();
+  int fragment_num = fragments_.size();
+
+  // Add up the cells of the tiles of each fragment overlapping the subarray
+  int64_t cell_num = 0;
+  std::vector<size_t> var_sizes(attribute_num+1, 0);
+  for(int i=0; i<fragment_num; ++i) {
+    if(fragments_[i]->read_state()->estimate_result_size(
+           cell_num, 
+           var_sizes) != TILEDB_RS_OK) {
+      tiledb_ar_errmsg = tiledb_rs_errmsg;
+      return TILEDB_AR_ERR;
+    }
+  }
+
+  // Dense reads return every cell of the subarray, including the empty ones
+  if(array_schema_->dense() && fragment_num != 0) {
+    int dim_num = array_schema_->dim_num();
+    int coords_type = array_schema_->coords_type();
+    if(coords_type == TILEDB_INT32) 
+      cell_num = cell_num_in_subarray(static_cast<int*>(subarray_), dim_num);
+    else if(coords_type == TILEDB_INT64) 
+      cell_num = 
+          cell_num_in_subarray(static_cast<int64_t*>(subarray_), dim_num);
+    for(int i=0; i<attribute_id_num; ++i) {
+      int attribute_id = attribute_ids_[i];
+      if(array_schema_->var_size(attribute_id))
+        var_sizes[attribute_id] += 
+            cell_num * array_schema_->type_size(attribute_id);
+    }
+  }
+
+  // Compute the buffer sizes
+  int buffer_i = 0;
+  for(int i=0; i<attribute_id_num; ++i) {
+    int attribute_id = attribute_ids_[i];
+    if(!array_schema_->var_size(attribute_id)) {
+      buffer_sizes[buffer_i++] = 
+          cell_num * array_schema_->cell_size(attribute_id);
+    } else {
+      buffer_sizes[buffer_i++] = cell_num * TILEDB_CELL_VAR_OFFSET_SIZE;
+      buffer_sizes[buffer_i++] = var_sizes[attribute_id];
+    }
+  }
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
 int Array::fragment_num() const {
   return fragments_.size();
 }
 
+FragmentSnapshot* Array::fragment_snapshot() const {
+  return fragment_snapshot_;
+}
+
 std::vector<Fragment*> Array::fragments() const {
   return fragments_;
 }
@@ -269,6 +423,56 @@ bool Array::overflow(int attribute_id) const {
     return array_read_state_->overflow(attribute_id);
 }
 
+int Array::partition_subarray(
+    int partition_num, 
+    void* partitions, 
+    int* result_num) const {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot partition subarray; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(partition_num <= 0 || partitions == NULL || result_num == NULL) {
+    std::string errmsg = "Cannot partition subarray; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Invoke the proper templated function
+  int coords_type = array_schema_->coords_type();
+  if(array_schema_->dense()) {
+    if(coords_type == TILEDB_INT32) 
+      partition_subarray_dense(
+          partition_num, static_cast<int*>(partitions), *result_num);
+    else if(coords_type == TILEDB_INT64) 
+      partition_subarray_dense(
+          partition_num, static_cast<int64_t*>(partitions), *result_num);
+  } else {
+    if(coords_type == TILEDB_INT32) 
+      partition_subarray_sparse(
+          partition_num, static_cast<int*>(partitions), *result_num);
+    else if(coords_type == TILEDB_INT64) 
+      partition_subarray_sparse(
+          partition_num, static_cast<int64_t*>(partitions), *result_num);
+    else if(coords_type == TILEDB_FLOAT32) 
+      partition_subarray_sparse(
+          partition_num, static_cast<float*>(partitions), *result_num);
+    else if(coords_type == TILEDB_FLOAT64) 
+      partition_subarray_sparse(
+          partition_num, static_cast<double*>(partitions), *result_num);
+  }
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
+const std::vector<Predicate>& Array::predicates() const {
+  return predicates_;
+}
+
 int Array::read(void** buffers, size_t* buffer_sizes) {
   // Sanity checks
   if(!read_mode()) {
@@ -278,6 +482,8 @@ int Array::read(void** buffers, size_t* buffer_sizes) {
     return TILEDB_AR_ERR;
   }
 
+  STATS_TIMER(&stats_, TIMER_READ);
+
   // Check if there are no fragments 
   int buffer_i = 0;
   int attribute_id_num = attribute_ids_.size();
@@ -308,8 +514,12 @@ int Array::read(void** buffers, size_t* buffer_sizes) {
   }
 }
 
-int Array::read_default(void** buffers, size_t* buffer_sizes) {
-  if(array_read_state_->read(buffers, buffer_sizes) != TILEDB_ARS_OK) {
+int Array::read_default(
+    void** buffers, 
+    size_t* buffer_sizes,
+    unsigned char** validity) {
+  if(array_read_state_->read(buffers, buffer_sizes, validity) != 
+     TILEDB_ARS_OK) {
     tiledb_ar_errmsg = tiledb_ars_errmsg;
     return TILEDB_AR_ERR;
   }
@@ -322,10 +532,159 @@ bool Array::read_mode() const {
   return array_read_mode(mode_);
 }
 
+int Array::read_ranges(
+    void** buffers, 
+    size_t* buffer_sizes,
+    int64_t* range_offsets,
+    int64_t* range_cell_nums) {
+  // Sanity checks
+  if(range_num_ == 0) {
+    std::string errmsg = "Cannot read ranges; The ranges are not set";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(range_offsets == NULL || range_cell_nums == NULL) {
+    std::string errmsg = "Cannot read ranges; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  STATS_TIMER(&stats_, TIMER_READ);
+
+  // For easy reference
+  int attribute_id_num = attribute_ids_.size();
+  int buffer_num = 0;
+  for(int i=0; i<attribute_id_num; ++i) 
+    buffer_num += (array_schema_->var_size(attribute_ids_[i])) ? 2 : 1;
+
+  // The ranges not read by this invocation get no cells
+  for(int i=0; i<attribute_id_num*range_num_; ++i) {
+    range_offsets[i] = -1;
+    range_cell_nums[i] = 0;
+  }
+
+  // The fragments overlapping no range have no cells
+  if(fragments_.size() == 0) 
+    range_pos_ = range_num_;
+
+  // Read the ranges in order, each after the cells of the previous ones
+  std::vector<void*> range_buffers(buffer_num);
+  std::vector<size_t> range_buffer_sizes(buffer_num);
+  std::vector<size_t> buffer_offsets(buffer_num, 0);
+  std::vector<int64_t> cell_nums(attribute_id_num, 0);
+  while(range_pos_ < range_num_) {
+    for(int i=0; i<buffer_num; ++i) {
+      range_buffers[i] = static_cast<char*>(buffers[i]) + buffer_offsets[i];
+      range_buffer_sizes[i] = buffer_sizes[i] - buffer_offsets[i];
+    }
+    if(read_default(&range_buffers[0], &range_buffer_sizes[0]) != 
+       TILEDB_AR_OK)
+      return TILEDB_AR_ERR;
+
+    // Record the cells of the range for each attribute, which may differ
+    // if the buffers of the attributes fill up at different cells. Make
+    // also the variable cell offsets relative to the start of the buffers.
+    int range_id = range_order_[range_pos_];
+    int buffer_i = 0;
+    for(int i=0; i<attribute_id_num; ++i) {
+      bool var_size = array_schema_->var_size(attribute_ids_[i]);
+      size_t cell_size = var_size ? sizeof(size_t) 
+                                  : array_schema_->cell_size(attribute_ids_[i]);
+      int64_t range_cell_num = range_buffer_sizes[buffer_i] / cell_size;
+      if(var_size) {
+        size_t* offsets = static_cast<size_t*>(range_buffers[buffer_i]);
+        for(int64_t j=0; j<range_cell_num; ++j)
+          offsets[j] += buffer_offsets[buffer_i+1];
+      }
+      range_offsets[i*range_num_ + range_id] = cell_nums[i];
+      range_cell_nums[i*range_num_ + range_id] = range_cell_num;
+      cell_nums[i] += range_cell_num;
+      buffer_i += var_size ? 2 : 1;
+    }
+    for(int i=0; i<buffer_num; ++i) 
+      buffer_offsets[i] += range_buffer_sizes[i];
+
+    // The next invocation resumes the range
+    if(array_read_state_->overflow())
+      break;
+
+    // Move to the next range
+    if(++range_pos_ < range_num_)
+      reset_range_read_state();
+  }
+
+  // Set the useful buffer sizes and the offsets of the ranges not read
+  for(int i=0; i<buffer_num; ++i) 
+    buffer_sizes[i] = buffer_offsets[i];
+  for(int i=0; i<attribute_id_num*range_num_; ++i) 
+    if(range_offsets[i] == -1)
+      range_offsets[i] = cell_nums[i / range_num_];
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
+int Array::read_validity(
+    void** buffers, 
+    size_t* buffer_sizes,
+    unsigned char** validity) {
+  // Sanity checks
+  if(mode_ != TILEDB_ARRAY_READ) {
+    std::string errmsg = 
+        "Cannot read validity; The array must be in TILEDB_ARRAY_READ mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(validity == NULL) {
+    std::string errmsg = "Cannot read validity; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  STATS_TIMER(&stats_, TIMER_READ);
+
+  // Check if there are no fragments 
+  if(fragments_.size() == 0) {             
+    int attribute_id_num = attribute_ids_.size();
+    int buffer_i = 0;
+    for(int i=0; i<attribute_id_num; ++i) {
+      buffer_sizes[buffer_i] = 0; 
+      buffer_i += (array_schema_->var_size(attribute_ids_[i])) ? 2 : 1;
+    }
+    return TILEDB_AR_OK;
+  }
+
+  return read_default(buffers, buffer_sizes, validity);
+}
+
+bool Array::skip_empty_tiles() const {
+  return skip_empty_tiles_;
+}
+
+#ifdef TILEDB_STATS
+Stats* Array::stats() const {
+  return &stats_;
+}
+
+void Array::stats_collect(Stats& stats) const {
+  stats.merge(stats_);
+  if(array_clone_ != NULL)
+    stats.merge(array_clone_->stats_);
+}
+#endif
+
 const void* Array::subarray() const {
   return subarray_;
 }
 
+ThreadPool* Array::thread_pool() const {
+  return thread_pool_;
+}
+
 bool Array::write_mode() const {
   return array_write_mode(mode_);
 }
@@ -336,6 +695,148 @@ bool Array::write_mode() const {
 /*            MUTATORS            */
 /* ****************************** */
 
+int Array::aggregate(const char* attribute, int aggregate, void* result) {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot compute aggregate; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(attribute == NULL || result == NULL) {
+    std::string errmsg = "Cannot compute aggregate; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(aggregate != TILEDB_COUNT && aggregate != TILEDB_SUM &&
+     aggregate != TILEDB_MIN   && aggregate != TILEDB_MAX) {
+    std::string errmsg = "Cannot compute aggregate; Invalid aggregate function";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Check attribute
+  int attribute_id = array_schema_->attribute_id(attribute);
+  if(attribute_id == TILEDB_AS_ERR) {
+    tiledb_ar_errmsg = tiledb_as_errmsg;
+    return TILEDB_AR_ERR;
+  }
+  int type = array_schema_->type(attribute_id);
+  if(attribute_id == array_schema_->attribute_num() ||
+     array_schema_->cell_val_num(attribute_id) != 1 ||
+     (type != TILEDB_INT32   && type != TILEDB_INT64 &&
+      type != TILEDB_FLOAT32 && type != TILEDB_FLOAT64)) {
+    std::string errmsg = 
+        std::string("Cannot compute aggregate; Attribute '") + attribute + 
+        "' is not a numeric attribute with a single value per cell";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Start from fresh fragment read states
+  if(reset_subarray(subarray_) != TILEDB_AR_OK)
+    return TILEDB_AR_ERR;
+
+  // Compute aggregate
+  if(array_read_state_->aggregate(attribute_id, aggregate, result) != 
+     TILEDB_ARS_OK) {
+    tiledb_ar_errmsg = tiledb_ars_errmsg;
+    reset_subarray(subarray_);
+    return TILEDB_AR_ERR;
+  }
+
+  // Subsequent reads start from the beginning of the subarray
+  return reset_subarray(subarray_);
+}
+
+int Array::add_predicate(const char* attribute, int op, const void* value) {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot add predicate; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(array_schema_->dense()) {
+    std::string errmsg = 
+        "Cannot add predicate; Predicates are applicable only to sparse arrays";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(attribute == NULL || value == NULL) {
+    std::string errmsg = "Cannot add predicate; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(op != TILEDB_LT && op != TILEDB_LE && op != TILEDB_GT &&
+     op != TILEDB_GE && op != TILEDB_EQ && op != TILEDB_NE) {
+    std::string errmsg = "Cannot add predicate; Invalid comparison operator";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Check attribute
+  int attribute_id = array_schema_->attribute_id(attribute);
+  if(attribute_id == TILEDB_AS_ERR) {
+    tiledb_ar_errmsg = tiledb_as_errmsg;
+    return TILEDB_AR_ERR;
+  }
+  int type = array_schema_->type(attribute_id);
+  if(attribute_id == array_schema_->attribute_num() ||
+     array_schema_->cell_val_num(attribute_id) != 1 ||
+     (type != TILEDB_INT32   && type != TILEDB_INT64 &&
+      type != TILEDB_FLOAT32 && type != TILEDB_FLOAT64)) {
+    std::string errmsg = 
+        std::string("Cannot add predicate; Attribute '") + attribute + 
+        "' is not a numeric attribute with a single value per cell";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Create predicate
+  Predicate predicate;
+  predicate.attribute_id_ = attribute_id;
+  predicate.op_ = op;
+  memcpy(predicate.value_, value, array_schema_->cell_size(attribute_id));
+
+  // Add predicate, also to the clone used in AIO
+  predicates_.push_back(predicate);
+  if(array_clone_ != NULL)
+    array_clone_->predicates_.push_back(predicate);
+
+  // Discard the cell ranges computed so far, keeping the ranges
+  if(range_num_ > 0)
+    return restart_ranges();
+  return reset_subarray(subarray_);
+}
+
+int Array::clear_predicates() {
+  // Sanity check
+  if(!read_mode()) {
+    std::string errmsg = "Cannot clear predicates; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Clear predicates, also of the clone used in AIO
+  predicates_.clear();
+  if(array_clone_ != NULL)
+    array_clone_->predicates_.clear();
+
+  // Discard the cell ranges computed so far, keeping the ranges
+  if(range_num_ > 0)
+    return restart_ranges();
+  return reset_subarray(subarray_);
+}
+
 int Array::consolidate(
     Fragment*& new_fragment,
     std::vector<std::string>& old_fragment_names) {
@@ -535,13 +1036,13 @@ int Array::finalize() {
 
 int Array::init(
     const ArraySchema* array_schema,
-    const std::vector<std::string>& fragment_names,
-    const std::vector<BookKeeping*>& book_keeping,
+    FragmentSnapshot* fragment_snapshot,
     int mode,
     const char** attributes,
     int attribute_num,
     const void* subarray,
     const StorageManagerConfig* config,
+    ThreadPool* thread_pool,
     Array* array_clone) {
   // Set mode
   mode_ = mode;
@@ -549,6 +1050,9 @@ int Array::init(
   // Set array clone
   array_clone_ = array_clone;
 
+  // Set fragment snapshot
+  fragment_snapshot_ = fragment_snapshot;
+
   // Sanity check on mode
   if(!read_mode() && !write_mode()) {
     std::string errmsg = "Cannot initialize array; Invalid array mode";
@@ -557,8 +1061,9 @@ int Array::init(
     return TILEDB_AR_ERR;
   }
 
-  // Set config
+  // Set config and thread pool
   config_ = config;
+  thread_pool_ = thread_pool;
 
   // Set subarray
   size_t subarray_size = 2*array_schema->coords_size();
@@ -655,7 +1160,7 @@ int Array::init(
     }
   } else {           // READ MODE
     // Open fragments
-    if(open_fragments(fragment_names, book_keeping) != TILEDB_AR_OK) {
+    if(open_fragments() != TILEDB_AR_OK) {
       array_schema_ = NULL;
       return TILEDB_AR_ERR;
     }
@@ -744,6 +1249,73 @@ int Array::reset_attributes(
   return TILEDB_AR_OK;
 }
 
+int Array::reset_ranges(const void* ranges, int range_num) {
+  // Sanity checks
+  if(mode_ != TILEDB_ARRAY_READ) {
+    std::string errmsg = "Cannot set ranges; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(ranges == NULL || range_num <= 0) {
+    std::string errmsg = "Cannot set ranges; Invalid arguments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Copy the ranges
+  size_t range_size = 2*array_schema_->coords_size();
+  if(ranges_ != NULL)
+    free(ranges_);
+  ranges_ = malloc(range_num*range_size);
+  memcpy(ranges_, ranges, range_num*range_size);
+  range_num_ = range_num;
+
+  // Start the read from the first range
+  return restart_ranges();
+}
+
+int Array::restart_ranges() {
+  // Sort the ranges and set the subarray to their bounding box
+  size_t range_size = 2*array_schema_->coords_size();
+  if(subarray_ == NULL) 
+    subarray_ = malloc(range_size);
+  int coords_type = array_schema_->coords_type();
+  if(coords_type == TILEDB_INT32) 
+    sort_ranges<int>();
+  else if(coords_type == TILEDB_INT64) 
+    sort_ranges<int64_t>();
+  else if(coords_type == TILEDB_FLOAT32) 
+    sort_ranges<float>();
+  else if(coords_type == TILEDB_FLOAT64) 
+    sort_ranges<double>();
+
+  // Open the fragments overlapping any range
+  if(reset_fragments() != TILEDB_AR_OK) {
+    range_num_ = 0;
+    return TILEDB_AR_ERR;
+  }
+
+  // Keep the tiles overlapping several ranges in main memory
+  int fragment_num = fragments_.size();
+  int tile_cache_num = 
+      (fragment_num == 0) 
+          ? 0 : std::max(1, TILEDB_RANGE_TILE_CACHE_NUM / fragment_num);
+  for(int i=0; i<fragment_num; ++i) 
+    fragments_[i]->read_state()->set_tile_cache_num(tile_cache_num);
+
+  // Prepare the first range, on a read state of the (re-)opened fragments
+  if(array_read_state_ != NULL) 
+    delete array_read_state_;
+  array_read_state_ = NULL;
+  range_pos_ = 0;
+  reset_range_read_state();
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
 int Array::reset_subarray(const void* subarray) {
   // Sanity check
   assert(read_mode() || write_mode());
@@ -815,9 +1387,14 @@ int Array::reset_subarray(const void* subarray) {
       return TILEDB_AR_ERR;
     }
   } else {           // READ MODE
-    // Re-initialize the read state of the fragments
-    for(int i=0; i<fragment_num; ++i) 
-      fragments_[i]->reset_read_state();
+    // Discard the ranges
+    range_num_ = 0;
+
+    // Re-initialize the fragments, which no longer cache tiles
+    if(reset_fragments() != TILEDB_AR_OK)
+      return TILEDB_AR_ERR;
+    for(int i=0; i<int(fragments_.size()); ++i) 
+      fragments_[i]->read_state()->set_tile_cache_num(0);
 
     // Re-initialize array read state
     if(array_read_state_ != NULL) {
@@ -876,9 +1453,9 @@ int Array::reset_subarray_soft(const void* subarray) {
   if(write_mode()) {  // WRITE MODE 
     // Do nothing
   } else {            // READ MODE
-    // Re-initialize the read state of the fragments
-    for(int i=0; i<fragment_num; ++i) 
-      fragments_[i]->reset_read_state();
+    // Re-initialize the fragments
+    if(reset_fragments() != TILEDB_AR_OK)
+      return TILEDB_AR_ERR;
 
     // Re-initialize array read state
     if(array_read_state_ != NULL) {
@@ -892,6 +1469,62 @@ int Array::reset_subarray_soft(const void* subarray) {
   return TILEDB_AR_OK;
 }
 
+int Array::set_dictionary_codes(bool dictionary_codes) {
+  // Sanity checks
+  if(!read_mode()) {
+    std::string errmsg = "Cannot set dictionary codes; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(dictionary_codes           &&
+     fragment_snapshot_ != NULL && 
+     fragment_snapshot_->fragment_num() > 1) {
+    std::string errmsg = 
+        "Cannot set dictionary codes; The array has multiple fragments";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Set flag, also for the clone used in AIO (which resets its read state
+  // upon every request)
+  dictionary_codes_ = dictionary_codes;
+  if(array_clone_ != NULL)
+    array_clone_->dictionary_codes_ = dictionary_codes;
+
+  // Discard the tiles decoded so far, keeping the ranges
+  if(range_num_ > 0)
+    return restart_ranges();
+  return reset_subarray(subarray_);
+}
+
+int Array::set_skip_empty_tiles(bool skip_empty_tiles) {
+  // Sanity checks
+  if(!write_mode()) {
+    std::string errmsg = "Cannot set skipping empty tiles; Invalid mode";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+  if(!array_schema_->dense()) {
+    std::string errmsg = 
+        "Cannot set skipping empty tiles; The array is not dense";
+    PRINT_ERROR(errmsg);
+    tiledb_ar_errmsg = TILEDB_AR_ERRMSG + errmsg;
+    return TILEDB_AR_ERR;
+  }
+
+  // Set flag, also for the clone used in AIO (which performs the sorted 
+  // writes)
+  skip_empty_tiles_ = skip_empty_tiles;
+  if(array_clone_ != NULL)
+    array_clone_->skip_empty_tiles_ = skip_empty_tiles;
+
+  // Success
+  return TILEDB_AR_OK;
+}
+
 int Array::sync() {
   // Sanity check
   if(!write_mode()) {
@@ -1209,49 +1842,29 @@ int Array::aio_thread_destroy() {
 }
 
 std::string Array::new_fragment_name() const {
-  struct timeval tp;
-  gettimeofday(&tp, NULL);
-  uint64_t ms = (uint64_t) tp.tv_sec * 1000L + tp.tv_usec / 1000;
-  pthread_t self = pthread_self();
-  uint64_t tid = 0;
-  memcpy(&tid, &self, std::min(sizeof(self), sizeof(tid)));
-  char fragment_name[TILEDB_NAME_MAX_LEN];
-
-  // Get MAC address
-  std::string mac = get_mac_addr();
-  if(mac == "")
+  // Get a process-wide unique fragment id
+  std::string fragment_id = new_fragment_id();
+  if(fragment_id == "")
     return "";
 
   // Generate fragment name
-  int n = sprintf(
-              fragment_name, 
-              "%s/.__%s%llu_%llu", 
-              array_schema_->array_name().c_str(), 
-              mac.c_str(),
-              tid, 
-              ms);
-
-  // Handle error
-  if(n<0) 
-    return "";
-
-  // Return
-  return fragment_name;
+  return array_schema_->array_name() + "/.__" + fragment_id;
 }
 
-int Array::open_fragments(
-    const std::vector<std::string>& fragment_names,
-    const std::vector<BookKeeping*>& book_keeping) {
-  // Sanity check
-  assert(fragment_names.size() == book_keeping.size());
+int Array::open_fragments() {
+  // Find the fragments that overlap the subarray
+  overlapping_fragments(fragment_ids_);
 
-  // Create a fragment object for each fragment directory
-  int fragment_num = fragment_names.size();
+  // Create a fragment object for each overlapping fragment directory
+  int fragment_num = fragment_ids_.size();
   for(int i=0; i<fragment_num; ++i) {
     Fragment* fragment = new Fragment(this);
     fragments_.push_back(fragment);
 
-    if(fragment->init(fragment_names[i], book_keeping[i]) != TILEDB_FG_OK) {
+    int fragment_id = fragment_ids_[i];
+    if(fragment->init(
+           fragment_snapshot_->fragment_names()[fragment_id], 
+           fragment_snapshot_->book_keeping()[fragment_id]) != TILEDB_FG_OK) {
       tiledb_ar_errmsg = tiledb_fg_errmsg;
       return TILEDB_AR_ERR;
     }
@@ -1261,3 +1874,263 @@ int Array::open_fragments(
   return TILEDB_AR_OK;
 }
 
+void Array::overlapping_fragments(std::vector<int>& fragment_ids) const {
+  // Trivial case
+  if(fragment_snapshot_ == NULL) {
+    fragment_ids.clear();
+    return;
+  }
+
+  // Only the fragments whose bounding box overlaps the subarray
+  fragment_snapshot_->fragment_index()->overlapping_fragments(
+      subarray_, 
+      fragment_ids);
+}
+
+template<class T>
+void Array::partition_subarray_dense(
+    int partition_num, 
+    T* partitions, 
+    int& result_num) const {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* subarray = static_cast<const T*>(subarray_);
+  const T* domain = static_cast<const T*>(array_schema_->domain());
+  const T* tile_extents = 
+      static_cast<const T*>(array_schema_->tile_extents());
+
+  // Get the tiles overlapping the subarray
+  T* tile_domain = new T[2*dim_num];
+  T* subarray_tile_domain = new T[2*dim_num];
+  array_schema_->get_subarray_tile_domain(
+      subarray, 
+      tile_domain, 
+      subarray_tile_domain);
+
+  // Pick the first dimension of the tile order, unless it spans too few tiles
+  std::vector<int64_t> tile_nums(dim_num);
+  for(int i=0; i<dim_num; ++i)
+    tile_nums[i] = 
+        subarray_tile_domain[2*i+1] - subarray_tile_domain[2*i] + 1;
+  int dim = (array_schema_->tile_order() == TILEDB_COL_MAJOR) ? dim_num-1 : 0;
+  if(tile_nums[dim] < partition_num) {
+    for(int i=0; i<dim_num; ++i)
+      if(tile_nums[i] > tile_nums[dim])
+        dim = i;
+  }
+
+  // Compute the range of each tile slab along the dimension, weighted by its
+  // length (the other dimensions span the same range in every slab)
+  int64_t slab_num = tile_nums[dim];
+  std::vector<T> slab_lo(slab_num), slab_hi(slab_num);
+  std::vector<double> weights(slab_num);
+  for(int64_t i=0; i<slab_num; ++i) {
+    T tile = subarray_tile_domain[2*dim] + i;
+    T tile_lo = domain[2*dim] + tile * tile_extents[dim];
+    slab_lo[i] = std::max(subarray[2*dim], tile_lo);
+    slab_hi[i] = 
+        std::min(subarray[2*dim+1], T(tile_lo + tile_extents[dim] - 1));
+    weights[i] = double(slab_hi[i]) - double(slab_lo[i]) + 1;
+  }
+  delete [] tile_domain;
+  delete [] subarray_tile_domain;
+
+  // Group the slabs into partitions
+  std::vector<int64_t> partition_starts;
+  balanced_partitions(weights, partition_num, partition_starts);
+  result_num = partition_starts.size();
+  for(int p=0; p<result_num; ++p) {
+    int64_t last = (p == result_num-1) ? slab_num-1 : partition_starts[p+1]-1;
+    T* partition = partitions + 2*dim_num*p;
+    memcpy(partition, subarray, 2*dim_num*sizeof(T));
+    partition[2*dim] = slab_lo[partition_starts[p]];
+    partition[2*dim+1] = slab_hi[last];
+  }
+}
+
+template<class T>
+void Array::partition_subarray_sparse(
+    int partition_num, 
+    T* partitions, 
+    int& result_num) const {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* subarray = static_cast<const T*>(subarray_);
+  int dim = (array_schema_->cell_order() == TILEDB_COL_MAJOR) ? dim_num-1 : 0;
+  T lo = subarray[2*dim];
+  T hi = subarray[2*dim+1];
+  int fragment_num = fragments_.size();
+  bool integer = std::numeric_limits<T>::is_integer;
+
+  // Collect the range along the dimension and the estimated number of cells
+  // in the subarray of each MBR that overlaps the subarray. The cells of an
+  // MBR are assumed to be uniformly distributed in its volume.
+  std::vector<std::pair<T, T> > mbr_ranges;
+  std::vector<double> mbr_cell_nums;
+  std::vector<T> breakpoints(1, lo);
+  for(int f=0; f<fragment_num; ++f) {
+    const BookKeeping* book_keeping = fragments_[f]->book_keeping();
+    const std::vector<void*>& mbrs = book_keeping->mbrs();
+    int64_t mbr_num = mbrs.size();
+    for(int64_t t=0; t<mbr_num; ++t) {
+      const T* mbr = static_cast<const T*>(mbrs[t]);
+      double fraction = 1;
+      bool overlap = true;
+      for(int i=0; i<dim_num && overlap; ++i) {
+        T overlap_lo = std::max(mbr[2*i], subarray[2*i]);
+        T overlap_hi = std::min(mbr[2*i+1], subarray[2*i+1]);
+        if(overlap_lo > overlap_hi) {
+          overlap = false;
+        } else if(i != dim) {
+          double mbr_length = double(mbr[2*i+1]) - double(mbr[2*i]) + integer;
+          if(mbr_length > 0)
+            fraction *= 
+                (double(overlap_hi) - double(overlap_lo) + integer) / 
+                mbr_length;
+        }
+      }
+      if(!overlap)
+        continue;
+
+      // Clip the range along the dimension to the subarray, keeping the
+      // fraction of the cells that lie in the clipped range
+      T range_lo = std::max(mbr[2*dim], lo);
+      T range_hi = std::min(mbr[2*dim+1], hi);
+      double mbr_length = 
+          double(mbr[2*dim+1]) - double(mbr[2*dim]) + integer;
+      if(mbr_length > 0)
+        fraction *= 
+            (double(range_hi) - double(range_lo) + integer) / mbr_length;
+      mbr_ranges.push_back(std::pair<T, T>(range_lo, range_hi));
+      mbr_cell_nums.push_back(book_keeping->cell_num(t) * fraction);
+      breakpoints.push_back(range_lo);
+      if(range_hi < hi)
+        breakpoints.push_back(next_value(range_hi));
+    }
+  }
+
+  // The breakpoints split the range along the dimension into units, each of 
+  // which is either inside or outside every MBR range
+  std::sort(breakpoints.begin(), breakpoints.end());
+  breakpoints.erase(
+      std::unique(breakpoints.begin(), breakpoints.end()), 
+      breakpoints.end());
+  int64_t unit_num = breakpoints.size();
+  std::vector<double> unit_pos(unit_num+1);
+  for(int64_t i=0; i<unit_num; ++i)
+    unit_pos[i] = double(breakpoints[i]);
+  unit_pos[unit_num] = double(hi) + integer;
+
+  // Spread the cells of each MBR uniformly over the units of its range, 
+  // adding up the densities of the overlapping MBRs in a difference array
+  std::vector<double> weights(unit_num, 0);
+  std::vector<double> density_diffs(unit_num+1, 0);
+  int64_t mbr_range_num = mbr_ranges.size();
+  for(int64_t j=0; j<mbr_range_num; ++j) {
+    int64_t first = 
+        std::lower_bound(
+            breakpoints.begin(), 
+            breakpoints.end(), 
+            mbr_ranges[j].first) - breakpoints.begin();
+    int64_t end = (mbr_ranges[j].second < hi) ?
+        std::lower_bound(
+            breakpoints.begin(), 
+            breakpoints.end(), 
+            next_value(mbr_ranges[j].second)) - breakpoints.begin() :
+        unit_num;
+    double length = unit_pos[end] - unit_pos[first];
+    if(length > 0) {
+      density_diffs[first] += mbr_cell_nums[j] / length;
+      density_diffs[end] -= mbr_cell_nums[j] / length;
+    } else {
+      weights[first] += mbr_cell_nums[j];
+    }
+  }
+  double density = 0;
+  for(int64_t i=0; i<unit_num; ++i) {
+    density += density_diffs[i];
+    weights[i] += density * (unit_pos[i+1] - unit_pos[i]);
+  }
+
+  // Group the units into partitions
+  std::vector<int64_t> partition_starts;
+  balanced_partitions(weights, partition_num, partition_starts);
+  result_num = partition_starts.size();
+  for(int p=0; p<result_num; ++p) {
+    T* partition = partitions + 2*dim_num*p;
+    memcpy(partition, subarray, 2*dim_num*sizeof(T));
+    partition[2*dim] = breakpoints[partition_starts[p]];
+    partition[2*dim+1] = (p == result_num-1) ? 
+        hi : previous_value(breakpoints[partition_starts[p+1]]);
+  }
+}
+
+int Array::reset_fragments() {
+  // Find the fragments that overlap the new subarray
+  std::vector<int> fragment_ids;
+  overlapping_fragments(fragment_ids);
+
+  // Same fragments - Re-initialize their read state
+  if(fragment_ids == fragment_ids_) {
+    int fragment_num = fragments_.size();
+    for(int i=0; i<fragment_num; ++i) 
+      fragments_[i]->reset_read_state();
+    return TILEDB_AR_OK;
+  }
+
+  // Different fragments - Re-open them
+  int fragment_num = fragments_.size();
+  for(int i=0; i<fragment_num; ++i) 
+    delete fragments_[i];
+  fragments_.clear();
+  return open_fragments();
+}
+
+void Array::reset_range_read_state() {
+  // Set the subarray to the range
+  size_t range_size = 2*array_schema_->coords_size();
+  memcpy(
+      subarray_, 
+      static_cast<const char*>(ranges_) + 
+          range_order_[range_pos_]*range_size, 
+      range_size);
+
+  // Re-initialize the read state in place, keeping the fetched tiles
+  int fragment_num = fragments_.size();
+  for(int i=0; i<fragment_num; ++i) 
+    fragments_[i]->reset_read_state();
+  if(array_read_state_ != NULL) 
+    array_read_state_->reset();
+  else
+    array_read_state_ = new ArrayReadState(this);
+}
+
+template<class T>
+void Array::sort_ranges() {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* ranges = static_cast<const T*>(ranges_);
+  T* subarray = static_cast<T*>(subarray_);
+
+  // Gather the lower corners and the bounding box of the ranges
+  std::vector<T> lows(range_num_*dim_num);
+  memcpy(subarray, ranges, 2*dim_num*sizeof(T));
+  for(int i=0; i<range_num_; ++i) {
+    const T* range = &ranges[2*dim_num*i];
+    for(int j=0; j<dim_num; ++j) {
+      lows[i*dim_num+j] = range[2*j];
+      subarray[2*j] = std::min(subarray[2*j], range[2*j]);
+      subarray[2*j+1] = std::max(subarray[2*j+1], range[2*j+1]);
+    }
+  }
+
+  // Sort the ranges on their lower corners
+  range_order_.resize(range_num_);
+  for(int i=0; i<range_num_; ++i) 
+    range_order_[i] = i;
+  std::sort(
+      range_order_.begin(), 
+      range_order_.end(), 
+      SmallerTileCell<T>(&lows[0], array_schema_));
+}
+
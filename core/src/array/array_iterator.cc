@@ -79,6 +79,10 @@ ArrayIterator::~ArrayIterator() {
 /*           ACCESSORS            */
 /* ****************************** */
 
+Array* ArrayIterator::array() const {
+  return array_;
+}
+
 const std::string& ArrayIterator::array_name() const {
   return array_->array_schema()->array_name();
 }
@@ -34,6 +34,9 @@
 #include "utils.h"
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <map>
+#include <unistd.h>
 
 
 
@@ -55,7 +58,7 @@
 /*        GLOBAL VARIABLES        */
 /* ****************************** */
 
-std::string tiledb_ars_errmsg = "";
+thread_local std::string tiledb_ars_errmsg = "";
 
 
 
@@ -80,6 +83,7 @@ ArrayReadState::ArrayReadState(
   read_round_done_.resize(attribute_num_);
   subarray_tile_coords_ = NULL;
   subarray_tile_domain_ = NULL;
+  validity_.assign(attribute_num_+1, NULL);
 
   for(int i=0; i<attribute_num_+1; ++i) {
     empty_cells_written_[i] = 0;
@@ -93,6 +97,16 @@ ArrayReadState::ArrayReadState(
   fragment_read_states_.resize(fragment_num_);
   for(int i=0; i<fragment_num_; ++i)
     fragment_read_states_[i] = fragments[i]->read_state(); 
+
+  // More threads than processors only add overhead, and a single thread
+  // fetches the tiles with MPI-IO or without a thread pool
+  long processor_num = sysconf(_SC_NPROCESSORS_ONLN);
+  thread_num_ = 
+      (processor_num > 0) 
+          ? int(std::min(processor_num, long(TILEDB_READ_THREAD_NUM))) : 1;
+  if(array_->config()->read_method() == TILEDB_IO_MPI ||
+     array_->thread_pool() == NULL)
+    thread_num_ = 1;
 }
 
 ArrayReadState::~ArrayReadState() { 
@@ -123,6 +137,80 @@ ArrayReadState::~ArrayReadState() {
 /*           ACCESSORS            */
 /* ****************************** */
 
+int ArrayReadState::aggregate(
+    int attribute_id, 
+    int aggregate, 
+    void* result) {
+  // For easy reference
+  int coords_type = array_schema_->coords_type();
+  int type = array_schema_->type(attribute_id);
+
+  // Get the cells a read would return
+  FragmentCellPosRanges fragment_cell_pos_ranges;
+  int rc = TILEDB_ARS_OK;
+  if(fragment_num_ == 0) {                 // No cells
+    rc = TILEDB_ARS_OK;
+  } else if(array_schema_->dense()) {      // DENSE
+    if(coords_type == TILEDB_INT32)
+      rc = get_all_fragment_cell_pos_ranges_dense<int>(
+               fragment_cell_pos_ranges);
+    else if(coords_type == TILEDB_INT64)
+      rc = get_all_fragment_cell_pos_ranges_dense<int64_t>(
+               fragment_cell_pos_ranges);
+  } else {                                 // SPARSE
+    if(coords_type == TILEDB_INT32)
+      rc = get_all_fragment_cell_pos_ranges_sparse<int>(
+               fragment_cell_pos_ranges);
+    else if(coords_type == TILEDB_INT64)
+      rc = get_all_fragment_cell_pos_ranges_sparse<int64_t>(
+               fragment_cell_pos_ranges);
+    else if(coords_type == TILEDB_FLOAT32)
+      rc = get_all_fragment_cell_pos_ranges_sparse<float>(
+               fragment_cell_pos_ranges);
+    else if(coords_type == TILEDB_FLOAT64)
+      rc = get_all_fragment_cell_pos_ranges_sparse<double>(
+               fragment_cell_pos_ranges);
+  }
+  if(rc != TILEDB_ARS_OK)
+    return TILEDB_ARS_ERR;
+
+  // Aggregate the cells
+  if(type == TILEDB_INT32) {
+    return this->aggregate<int, int64_t>(
+               attribute_id, 
+               aggregate, 
+               TILEDB_EMPTY_INT32, 
+               fragment_cell_pos_ranges, 
+               result);
+  } else if(type == TILEDB_INT64) {
+    return this->aggregate<int64_t, int64_t>(
+               attribute_id, 
+               aggregate, 
+               TILEDB_EMPTY_INT64, 
+               fragment_cell_pos_ranges, 
+               result);
+  } else if(type == TILEDB_FLOAT32) {
+    return this->aggregate<float, double>(
+               attribute_id, 
+               aggregate, 
+               TILEDB_EMPTY_FLOAT32, 
+               fragment_cell_pos_ranges, 
+               result);
+  } else if(type == TILEDB_FLOAT64) {
+    return this->aggregate<double, double>(
+               attribute_id, 
+               aggregate, 
+               TILEDB_EMPTY_FLOAT64, 
+               fragment_cell_pos_ranges, 
+               result);
+  } else {
+    std::string errmsg = "Cannot compute aggregate; Invalid attribute type"; 
+    PRINT_ERROR(errmsg);
+    tiledb_ars_errmsg = TILEDB_ARS_ERRMSG + errmsg;
+    return TILEDB_ARS_ERR;
+  }
+}
+
 bool ArrayReadState::overflow() const {
   int attribute_num = (int) array_->attribute_ids().size();
   for(int i=0; i<attribute_num; ++i)
@@ -138,10 +226,20 @@ bool ArrayReadState::overflow(int attribute_id) const {
 
 int ArrayReadState::read(
     void** buffers, 
-    size_t* buffer_sizes) {
+    size_t* buffer_sizes,
+    unsigned char** validity) {
   // Sanity check
   assert(fragment_num_);
 
+  // Set the validity bitmaps
+  validity_.assign(attribute_num_+1, NULL);
+  if(validity != NULL) {
+    const std::vector<int>& attribute_ids = array_->attribute_ids();
+    int attribute_id_num = attribute_ids.size();
+    for(int i=0; i<attribute_id_num; ++i)
+      validity_[attribute_ids[i]] = validity[i];
+  }
+
   // Reset overflow
   overflow_.resize(attribute_num_+1); 
   for(int i=0; i<attribute_num_+1; ++i)
@@ -159,10 +257,176 @@ int ArrayReadState::read(
 
 
 
+/* ****************************** */
+/*            MUTATORS            */
+/* ****************************** */
+
+void ArrayReadState::reset() {
+  // Discard the state of the previous subarray
+  done_ = false;
+
+  if(subarray_tile_coords_ != NULL) {
+    free(subarray_tile_coords_);
+    subarray_tile_coords_ = NULL;
+  }
+
+  if(subarray_tile_domain_ != NULL) {
+    free(subarray_tile_domain_);
+    subarray_tile_domain_ = NULL;
+  }
+
+  int fragment_bounding_coords_num = fragment_bounding_coords_.size();
+  for(int i=0; i<fragment_bounding_coords_num; ++i)
+    if(fragment_bounding_coords_[i] != NULL)
+      free(fragment_bounding_coords_[i]);
+  fragment_bounding_coords_.clear();
+
+  int64_t fragment_cell_pos_ranges_vec_size = 
+      fragment_cell_pos_ranges_vec_.size();
+  for(int64_t i=0; i<fragment_cell_pos_ranges_vec_size; ++i)
+    delete fragment_cell_pos_ranges_vec_[i];
+  fragment_cell_pos_ranges_vec_.clear();
+
+  for(int i=0; i<attribute_num_+1; ++i) {
+    empty_cells_written_[i] = 0;
+    fragment_cell_pos_ranges_vec_pos_[i] = 0;
+  }
+  read_round_done_.assign(read_round_done_.size(), true);
+}
+
+
+
+
 /* ****************************** */
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
+template<class T, class S>
+int ArrayReadState::aggregate(
+    int attribute_id,
+    int aggregate,
+    T empty_value,
+    const FragmentCellPosRanges& fragment_cell_pos_ranges,
+    void* result) {
+  // For easy reference
+  int64_t fragment_cell_pos_ranges_num = fragment_cell_pos_ranges.size();
+
+  // Create a task for every tile, holding all the ranges of the tile, and
+  // skip the empty cells
+  AggregateData<T, S> data;
+  std::vector<int> fragment_ids;
+  std::map<FragmentInfo, int> tile_tasks;
+  for(int64_t i=0; i<fragment_cell_pos_ranges_num; ++i) {
+    const FragmentInfo& fragment_info = fragment_cell_pos_ranges[i].first;
+    if(fragment_info.first == -1)
+      continue;
+    std::pair<std::map<FragmentInfo, int>::iterator, bool> it = 
+        tile_tasks.insert(
+            std::pair<FragmentInfo, int>(fragment_info, fragment_ids.size()));
+    if(it.second) {
+      fragment_ids.push_back(fragment_info.first);
+      data.range_positions_.push_back(std::vector<int64_t>());
+    }
+    data.range_positions_[it.first->second].push_back(i);
+  }
+  int task_num = fragment_ids.size();
+
+  // Aggregate the tiles
+  data.aggregate_ = aggregate;
+  data.attribute_id_ = attribute_id;
+  data.counts_.assign(task_num, 0);
+  data.empty_value_ = empty_value;
+  data.fragment_cell_pos_ranges_ = &fragment_cell_pos_ranges;
+  data.fragment_ids_ = &fragment_ids;
+  data.maxs_.assign(task_num, std::numeric_limits<T>::lowest());
+  data.mins_.assign(task_num, empty_value);
+  data.sums_.assign(task_num, 0);
+  if(run_fragment_tasks(aggregate_s<T, S>, data) != TILEDB_ARS_OK)
+    return TILEDB_ARS_ERR;
+
+  // Merge the partial aggregates
+  int64_t count = 0;
+  S sum = 0;
+  T min = empty_value, max = std::numeric_limits<T>::lowest();
+  for(int i=0; i<task_num; ++i) {
+    count += data.counts_[i];
+    sum += data.sums_[i];
+    if(data.mins_[i] < min)
+      min = data.mins_[i];
+    if(data.maxs_[i] > max)
+      max = data.maxs_[i];
+  }
+  if(count == 0)
+    max = empty_value;
+
+  // Set the result
+  if(aggregate == TILEDB_COUNT)
+    memcpy(result, &count, sizeof(int64_t));
+  else if(aggregate == TILEDB_SUM)
+    memcpy(result, &sum, sizeof(S));
+  else if(aggregate == TILEDB_MIN)
+    memcpy(result, &min, sizeof(T));
+  else if(aggregate == TILEDB_MAX)
+    memcpy(result, &max, sizeof(T));
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
+template<class T, class S>
+void *ArrayReadState::aggregate_s(void* data) {
+  // For easy reference
+  AggregateData<T, S>* d = 
+      static_cast<AggregateData<T, S>*>(static_cast<FragmentTaskData*>(data));
+  const FragmentCellPosRanges& fragment_cell_pos_ranges = 
+      *d->fragment_cell_pos_ranges_;
+  std::vector<Fragment*> fragments = d->array_read_state_->array_->fragments();
+  int task_num = d->fragment_ids_->size();
+
+  // Every thread fetches tiles with its own read state for each fragment
+  std::vector<ReadState*> read_states(fragments.size(), NULL);
+
+  // Claim tiles until none is left
+  for(int i = (*d->next_task_)++; i < task_num; i = (*d->next_task_)++) {
+    // For easy reference
+    int fragment_id = (*d->fragment_ids_)[i];
+    const std::vector<int64_t>& range_positions = d->range_positions_[i];
+    int64_t range_num = range_positions.size();
+
+    // Aggregate the ranges of the tile
+    if(read_states[fragment_id] == NULL)
+      read_states[fragment_id] = 
+          new ReadState(
+              fragments[fragment_id], 
+              fragments[fragment_id]->book_keeping());
+    for(int64_t j=0; j<range_num; ++j) {
+      const FragmentCellPosRange& fragment_cell_pos_range = 
+          fragment_cell_pos_ranges[range_positions[j]];
+      if(read_states[fragment_id]->aggregate<T, S>(
+             d->attribute_id_,
+             d->aggregate_,
+             d->empty_value_,
+             fragment_cell_pos_range.first.second,
+             fragment_cell_pos_range.second,
+             d->counts_[i],
+             d->sums_[i],
+             d->mins_[i],
+             d->maxs_[i]) != TILEDB_RS_OK) {
+        (*d->errmsgs_)[i] = tiledb_rs_errmsg;
+        break;
+      }
+    }
+  }
+
+  // Clean up
+  int read_state_num = read_states.size();
+  for(int i=0; i<read_state_num; ++i)
+    if(read_states[i] != NULL)
+      delete read_states[i];
+
+  return NULL;
+}
+
 void ArrayReadState::clean_up_processed_fragment_cell_pos_ranges() {
   // Find the minimum overlapping tile position across all attributes
   const std::vector<int>& attribute_ids = array_->attribute_ids();
@@ -189,6 +453,22 @@ void ArrayReadState::clean_up_processed_fragment_cell_pos_ranges() {
   }
 }
 
+void ArrayReadState::collect_fragment_cell_pos_ranges(
+    FragmentCellPosRanges& fragment_cell_pos_ranges) {
+  // Append the ranges of the current read round
+  const FragmentCellPosRanges& read_round_ranges = 
+      *fragment_cell_pos_ranges_vec_.back();
+  fragment_cell_pos_ranges.insert(
+      fragment_cell_pos_ranges.end(),
+      read_round_ranges.begin(),
+      read_round_ranges.end());
+
+  // Mark the read round as processed by all attributes, so that it is
+  // cleaned up when the next one is computed
+  for(int i=0; i<attribute_num_+1; ++i)
+    fragment_cell_pos_ranges_vec_pos_[i] = fragment_cell_pos_ranges_vec_.size();
+}
+
 template<class T>
 int ArrayReadState::compute_fragment_cell_pos_ranges(
     FragmentCellRanges& fragment_cell_ranges,
@@ -245,6 +525,71 @@ int ArrayReadState::compute_fragment_cell_pos_ranges(
   return TILEDB_ARS_OK;
 }
 
+template<class T>
+int ArrayReadState::compute_fragment_cell_ranges_sparse(
+    int fragment_id,
+    FragmentCellRanges& fragment_cell_ranges) {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  T* min_bounding_coords_end = static_cast<T*>(min_bounding_coords_end_);
+  T* fragment_bounding_coords = 
+      static_cast<T*>(fragment_bounding_coords_[fragment_id]);
+  ReadState* read_state = fragment_read_states_[fragment_id];
+
+  // Compute new fragment cell ranges
+  if(read_state->get_fragment_cell_ranges_sparse<T>(
+         fragment_id,
+         fragment_bounding_coords,
+         min_bounding_coords_end,
+         fragment_cell_ranges) != TILEDB_RS_OK) {
+    tiledb_ars_errmsg = tiledb_rs_errmsg;
+    return TILEDB_ARS_ERR;
+  }
+
+  // If the end bounding coordinate is not the same as the smallest one, 
+  // update the start bounding coordinate to exceed the smallest
+  // end bounding coordinates
+  if(memcmp(
+         &fragment_bounding_coords[dim_num], 
+         min_bounding_coords_end, 
+         coords_size_)) {
+    // Get the first coordinates AFTER the min bounding coords end 
+    bool coords_retrieved;
+    if(read_state->get_coords_after<T>(
+           min_bounding_coords_end, 
+           fragment_bounding_coords,
+           coords_retrieved) != TILEDB_RS_OK) {  
+      tiledb_ars_errmsg = tiledb_rs_errmsg;
+      return TILEDB_ARS_ERR;
+    }
+
+    // Sanity check for the sparse case
+    assert(coords_retrieved);
+  } 
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
+template<class T>
+void *ArrayReadState::compute_fragment_cell_ranges_sparse_s(void* data) {
+  // For easy reference
+  FragmentTaskData* d = (FragmentTaskData*) data;
+  int task_num = d->fragment_ids_->size();
+
+  // Claim tasks until none is left
+  for(int i = (*d->next_task_)++; i < task_num; i = (*d->next_task_)++) {
+    int fragment_id = (*d->fragment_ids_)[i];
+    if(d->array_read_state_->compute_fragment_cell_ranges_sparse<T>(
+           fragment_id,
+           (*d->unsorted_fragment_cell_ranges_)[fragment_id]) != 
+       TILEDB_ARS_OK)
+      (*d->errmsgs_)[i] = tiledb_ars_errmsg;
+  }
+
+  return NULL;
+}
+
 template<class T>
 void ArrayReadState::compute_min_bounding_coords_end() {
   // For easy reference
@@ -348,58 +693,26 @@ template<class T>
 int ArrayReadState::compute_unsorted_fragment_cell_ranges_sparse(
     std::vector<FragmentCellRanges>& unsorted_fragment_cell_ranges) {
   // For easy reference
-  int dim_num = array_schema_->dim_num();
   T* min_bounding_coords_end = static_cast<T*>(min_bounding_coords_end_);
 
-  // Compute the relevant fragment cell ranges
+  // Find the fragments participating in the read round. The rest get an 
+  // empty list.
+  unsorted_fragment_cell_ranges.resize(fragment_num_);
+  std::vector<int> fragment_ids;
   for(int i=0; i<fragment_num_; ++i) {
     T* fragment_bounding_coords = static_cast<T*>(fragment_bounding_coords_[i]);
-
-    // Compute new fragment cell ranges
     if(fragment_bounding_coords != NULL &&
        array_schema_->tile_cell_order_cmp(
              fragment_bounding_coords,
-             min_bounding_coords_end) <= 0) {
-      FragmentCellRanges fragment_cell_ranges;
-      if(fragment_read_states_[i]->get_fragment_cell_ranges_sparse<T>(
-          i,
-          fragment_bounding_coords,
-          min_bounding_coords_end,
-          fragment_cell_ranges) != TILEDB_RS_OK) {
-        tiledb_ars_errmsg = tiledb_rs_errmsg;
-        return TILEDB_ARS_ERR;
-      }
-
-      unsorted_fragment_cell_ranges.push_back(fragment_cell_ranges);
-
-      // If the end bounding coordinate is not the same as the smallest one, 
-      // update the start bounding coordinate to exceed the smallest
-      // end bounding coordinates
-      if(memcmp(
-             &fragment_bounding_coords[dim_num], 
-             min_bounding_coords_end, 
-             coords_size_)) {
-        // Get the first coordinates AFTER the min bounding coords end 
-        bool coords_retrieved;
-        if(fragment_read_states_[i]->get_coords_after<T>(
-               min_bounding_coords_end, 
-               fragment_bounding_coords,
-               coords_retrieved) != TILEDB_RS_OK) {  
-          tiledb_ars_errmsg = tiledb_rs_errmsg;
-          return TILEDB_ARS_ERR;
-        }
-
-        // Sanity check for the sparse case
-        assert(coords_retrieved);
-      } 
-    } else {
-      // Append an empty list
-      unsorted_fragment_cell_ranges.push_back(FragmentCellRanges());
-    }
+             min_bounding_coords_end) <= 0) 
+      fragment_ids.push_back(i);
   }
 
-  // Success
-  return TILEDB_ARS_OK;
+  // Compute the relevant fragment cell ranges in parallel
+  FragmentTaskData data;
+  data.fragment_ids_ = &fragment_ids;
+  data.unsorted_fragment_cell_ranges_ = &unsorted_fragment_cell_ranges;
+  return run_fragment_tasks(compute_fragment_cell_ranges_sparse_s<T>, data);
 }
 
 int ArrayReadState::copy_cells(
@@ -407,6 +720,8 @@ int ArrayReadState::copy_cells(
     void* buffer,  
     size_t buffer_size,
     size_t& buffer_offset) {
+  STATS_TIMER(array_->stats(), TIMER_COPY);
+
   // For easy reference
   int type = array_schema_->type(attribute_id);
 
@@ -467,6 +782,9 @@ int ArrayReadState::copy_cells(
   int fragment_id; // Fragment id
   int64_t tile_pos; // Tile position in the fragment
 
+  size_t cell_size = array_schema_->cell_size(attribute_id);
+  size_t buffer_offset_start; // Buffer offset before copying a range
+
   // Sanity check
   assert(!array_schema_->var_size(attribute_id));
 
@@ -475,6 +793,7 @@ int ArrayReadState::copy_cells(
     fragment_id = fragment_cell_pos_ranges[i].first.first; 
     tile_pos = fragment_cell_pos_ranges[i].first.second; 
     CellPosRange& cell_pos_range = fragment_cell_pos_ranges[i].second; 
+    buffer_offset_start = buffer_offset;
 
     // Handle empty fragment
     if(fragment_id == -1) {
@@ -484,6 +803,12 @@ int ArrayReadState::copy_cells(
            buffer_size,
            buffer_offset,
            cell_pos_range);
+      update_validity(
+          attribute_id,
+          cell_size,
+          buffer_offset_start,
+          buffer_offset,
+          false);
       if(overflow_[attribute_id])
         break;
       else
@@ -501,6 +826,12 @@ int ArrayReadState::copy_cells(
        tiledb_ars_errmsg = tiledb_rs_errmsg;
        return TILEDB_ARS_ERR;
      }
+     update_validity(
+         attribute_id,
+         cell_size,
+         buffer_offset_start,
+         buffer_offset,
+         true);
 
      // Handle overflow
      if(fragment_read_states_[fragment_id]->overflow(attribute_id)) {
@@ -529,6 +860,8 @@ int ArrayReadState::copy_cells_var(
     void* buffer_var,  
     size_t buffer_var_size,
     size_t& buffer_var_offset) {
+  STATS_TIMER(array_->stats(), TIMER_COPY);
+
   // For easy reference
   int type = array_schema_->type(attribute_id);
 
@@ -607,6 +940,8 @@ int ArrayReadState::copy_cells_var(
   int fragment_id; // Fragment id
   int64_t tile_pos; // Tile position in the fragment
 
+  size_t buffer_offset_start; // Buffer offset before copying a range
+
   // Sanity check
   assert(array_schema_->var_size(attribute_id));
 
@@ -615,6 +950,7 @@ int ArrayReadState::copy_cells_var(
     tile_pos = fragment_cell_pos_ranges[i].first.second; 
     fragment_id = fragment_cell_pos_ranges[i].first.first; 
     CellPosRange& cell_pos_range = fragment_cell_pos_ranges[i].second; 
+    buffer_offset_start = buffer_offset;
 
     // Handle empty fragment
     if(fragment_id == -1) {
@@ -627,6 +963,12 @@ int ArrayReadState::copy_cells_var(
            buffer_var_size,
            buffer_var_offset,
            cell_pos_range);
+      update_validity(
+          attribute_id,
+          TILEDB_CELL_VAR_OFFSET_SIZE,
+          buffer_offset_start,
+          buffer_offset,
+          false);
       if(overflow_[attribute_id])
         break;
       else
@@ -647,6 +989,12 @@ int ArrayReadState::copy_cells_var(
        tiledb_ars_errmsg = tiledb_rs_errmsg;
        return TILEDB_ARS_ERR;
      }
+     update_validity(
+         attribute_id,
+         TILEDB_CELL_VAR_OFFSET_SIZE,
+         buffer_offset_start,
+         buffer_offset,
+         true);
 
      // Handle overflow
      if(fragment_read_states_[fragment_id]->overflow(attribute_id)) {
@@ -701,12 +1049,12 @@ void ArrayReadState::copy_cells_with_empty<int>(
 
   // Copy empty cells to buffer
   int empty = TILEDB_EMPTY_INT32;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    for(int j=0; j<cell_val_num; ++j) {
-      memcpy(buffer_c + buffer_offset, &empty, sizeof(int));
-      buffer_offset += sizeof(int);
-    }
-  } 
+  fill_pattern(
+      buffer_c + buffer_offset, 
+      &empty, 
+      sizeof(int), 
+      cell_num_to_copy * cell_val_num);
+  buffer_offset += cell_num_to_copy * cell_size;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -750,12 +1098,12 @@ void ArrayReadState::copy_cells_with_empty<int64_t>(
 
   // Copy empty cells to buffer
   int64_t empty = TILEDB_EMPTY_INT64;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    for(int j=0; j<cell_val_num; ++j) {
-      memcpy(buffer_c + buffer_offset, &empty, sizeof(int64_t));
-      buffer_offset += sizeof(int64_t);
-    }
-  } 
+  fill_pattern(
+      buffer_c + buffer_offset, 
+      &empty, 
+      sizeof(int64_t), 
+      cell_num_to_copy * cell_val_num);
+  buffer_offset += cell_num_to_copy * cell_size;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -799,12 +1147,12 @@ void ArrayReadState::copy_cells_with_empty<float>(
 
   // Copy empty cells to buffer
   float empty = TILEDB_EMPTY_FLOAT32;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    for(int j=0; j<cell_val_num; ++j) {
-      memcpy(buffer_c + buffer_offset, &empty, sizeof(float));
-      buffer_offset += sizeof(float);
-    }
-  } 
+  fill_pattern(
+      buffer_c + buffer_offset, 
+      &empty, 
+      sizeof(float), 
+      cell_num_to_copy * cell_val_num);
+  buffer_offset += cell_num_to_copy * cell_size;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -848,12 +1196,12 @@ void ArrayReadState::copy_cells_with_empty<double>(
 
   // Copy empty cells to buffer
   double empty = TILEDB_EMPTY_FLOAT64;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    for(int j=0; j<cell_val_num; ++j) {
-      memcpy(buffer_c + buffer_offset, &empty, sizeof(double));
-      buffer_offset += sizeof(double);
-    }
-  } 
+  fill_pattern(
+      buffer_c + buffer_offset, 
+      &empty, 
+      sizeof(double), 
+      cell_num_to_copy * cell_val_num);
+  buffer_offset += cell_num_to_copy * cell_size;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -897,12 +1245,12 @@ void ArrayReadState::copy_cells_with_empty<char>(
 
   // Copy empty cells to buffer
   char empty = TILEDB_EMPTY_CHAR;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    for(int j=0; j<cell_val_num; ++j) {
-      memcpy(buffer_c + buffer_offset, &empty, sizeof(char));
-      buffer_offset += sizeof(char);
-    }
-  } 
+  fill_pattern(
+      buffer_c + buffer_offset, 
+      &empty, 
+      sizeof(char), 
+      cell_num_to_copy * cell_val_num);
+  buffer_offset += cell_num_to_copy * cell_size;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -959,18 +1307,18 @@ void ArrayReadState::copy_cells_with_empty_var<int>(
 
   // Copy empty cells to buffers
   int empty = TILEDB_EMPTY_INT32;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    memcpy(
-        buffer_c + buffer_offset, 
-        &buffer_var_offset, 
-        cell_size);
-    buffer_offset += cell_size;
-    memcpy(
-        buffer_var_c + buffer_var_offset, 
-        &empty,
-        cell_size_var);
-    buffer_var_offset += cell_size_var;
-  }
+  fill_offsets(
+      buffer_c + buffer_offset, 
+      buffer_var_offset, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_offset += cell_num_to_copy * cell_size;
+  fill_pattern(
+      buffer_var_c + buffer_var_offset, 
+      &empty, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_var_offset += cell_num_to_copy * cell_size_var;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -1027,18 +1375,18 @@ void ArrayReadState::copy_cells_with_empty_var<int64_t>(
 
   // Copy empty cells to buffers
   int64_t empty = TILEDB_EMPTY_INT64;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    memcpy(
-        buffer_c + buffer_offset, 
-        &buffer_var_offset, 
-        cell_size);
-    buffer_offset += cell_size;
-    memcpy(
-        buffer_var_c + buffer_var_offset, 
-        &empty,
-        cell_size_var);
-    buffer_var_offset += cell_size_var;
-  }
+  fill_offsets(
+      buffer_c + buffer_offset, 
+      buffer_var_offset, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_offset += cell_num_to_copy * cell_size;
+  fill_pattern(
+      buffer_var_c + buffer_var_offset, 
+      &empty, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_var_offset += cell_num_to_copy * cell_size_var;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -1095,18 +1443,18 @@ void ArrayReadState::copy_cells_with_empty_var<float>(
 
   // Copy empty cells to buffers
   float empty = TILEDB_EMPTY_FLOAT32;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    memcpy(
-        buffer_c + buffer_offset, 
-        &buffer_var_offset, 
-        cell_size);
-    buffer_offset += cell_size;
-    memcpy(
-        buffer_var_c + buffer_var_offset, 
-        &empty,
-        cell_size_var);
-    buffer_var_offset += cell_size_var;
-  }
+  fill_offsets(
+      buffer_c + buffer_offset, 
+      buffer_var_offset, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_offset += cell_num_to_copy * cell_size;
+  fill_pattern(
+      buffer_var_c + buffer_var_offset, 
+      &empty, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_var_offset += cell_num_to_copy * cell_size_var;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -1162,18 +1510,18 @@ void ArrayReadState::copy_cells_with_empty_var<double>(
 
   // Copy empty cells to buffers
   double empty = TILEDB_EMPTY_FLOAT64;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    memcpy(
-        buffer_c + buffer_offset, 
-        &buffer_var_offset, 
-        cell_size);
-    buffer_offset += cell_size;
-    memcpy(
-        buffer_var_c + buffer_var_offset, 
-        &empty,
-        cell_size_var);
-    buffer_var_offset += cell_size_var;
-  }
+  fill_offsets(
+      buffer_c + buffer_offset, 
+      buffer_var_offset, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_offset += cell_num_to_copy * cell_size;
+  fill_pattern(
+      buffer_var_c + buffer_var_offset, 
+      &empty, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_var_offset += cell_num_to_copy * cell_size_var;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -1229,18 +1577,18 @@ void ArrayReadState::copy_cells_with_empty_var<char>(
 
   // Copy empty cells to buffers
   char empty = TILEDB_EMPTY_CHAR;
-  for(int64_t i=0; i<cell_num_to_copy; ++i) {
-    memcpy(
-        buffer_c + buffer_offset, 
-        &buffer_var_offset, 
-        cell_size);
-    buffer_offset += cell_size;
-    memcpy(
-        buffer_var_c + buffer_var_offset, 
-        &empty,
-        cell_size_var);
-    buffer_var_offset += cell_size_var;
-  }
+  fill_offsets(
+      buffer_c + buffer_offset, 
+      buffer_var_offset, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_offset += cell_num_to_copy * cell_size;
+  fill_pattern(
+      buffer_var_c + buffer_var_offset, 
+      &empty, 
+      cell_size_var, 
+      cell_num_to_copy);
+  buffer_var_offset += cell_num_to_copy * cell_size_var;
   empty_cells_written_[attribute_id] += cell_num_to_copy;
 
   // Handle buffer overflow
@@ -1361,6 +1709,68 @@ ArrayReadState::empty_fragment_cell_ranges() const {
   return fragment_cell_ranges;
 }
 
+int ArrayReadState::filter_fragment_cell_pos_ranges(
+    FragmentCellPosRanges& fragment_cell_pos_ranges) const {
+  // For easy reference
+  int64_t fragment_cell_pos_ranges_num = fragment_cell_pos_ranges.size();
+
+  // Filter each fragment cell position range in the read state of its fragment
+  FragmentCellPosRanges filtered_fragment_cell_pos_ranges;
+  for(int64_t i=0; i<fragment_cell_pos_ranges_num; ++i) {
+    int fragment_id = fragment_cell_pos_ranges[i].first.first;
+    if(fragment_read_states_[fragment_id]->filter_fragment_cell_pos_range(
+           fragment_cell_pos_ranges[i],
+           filtered_fragment_cell_pos_ranges) != TILEDB_RS_OK) {
+      tiledb_ars_errmsg = tiledb_rs_errmsg;
+      return TILEDB_ARS_ERR;
+    }
+  }
+  fragment_cell_pos_ranges.swap(filtered_fragment_cell_pos_ranges);
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
+template<class T>
+int ArrayReadState::get_all_fragment_cell_pos_ranges_dense(
+    FragmentCellPosRanges& fragment_cell_pos_ranges) {
+  for(;;) {
+    // Get the ranges of the next read round
+    if(get_next_fragment_cell_ranges_dense<T>() != TILEDB_ARS_OK)
+      return TILEDB_ARS_ERR;
+
+    // Check if done
+    if(done_)
+      break;
+
+    // Collect the ranges of the read round
+    collect_fragment_cell_pos_ranges(fragment_cell_pos_ranges);
+  }
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
+template<class T>
+int ArrayReadState::get_all_fragment_cell_pos_ranges_sparse(
+    FragmentCellPosRanges& fragment_cell_pos_ranges) {
+  for(;;) {
+    // Get the ranges of the next read round
+    if(get_next_fragment_cell_ranges_sparse<T>() != TILEDB_ARS_OK)
+      return TILEDB_ARS_ERR;
+
+    // Check if done
+    if(done_)
+      break;
+
+    // Collect the ranges of the read round
+    collect_fragment_cell_pos_ranges(fragment_cell_pos_ranges);
+  }
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
 template<class T>
 int ArrayReadState::get_next_fragment_cell_ranges_dense() {
   // Trivial case
@@ -1441,6 +1851,14 @@ int ArrayReadState::get_next_fragment_cell_ranges_sparse() {
          *fragment_cell_pos_ranges) != TILEDB_ARS_OK) 
     return TILEDB_ARS_ERR;
 
+  // Keep only the cells that satisfy the attribute predicates
+  if(!array_->predicates().empty() &&
+     filter_fragment_cell_pos_ranges(*fragment_cell_pos_ranges) != 
+     TILEDB_ARS_OK) {
+    delete fragment_cell_pos_ranges;
+    return TILEDB_ARS_ERR;
+  }
+
   // Insert cell pos ranges in the state
   fragment_cell_pos_ranges_vec_.push_back(fragment_cell_pos_ranges);
 
@@ -1647,6 +2065,94 @@ void ArrayReadState::get_next_subarray_tile_coords() {
   } 
 }
 
+template<class T>
+int ArrayReadState::prefetch_tiles(int attribute_id) {
+  // Trivial case - nothing to overlap
+  if(thread_num_ == 1)
+    return TILEDB_ARS_OK;
+
+  // For easy reference
+  const FragmentCellPosRanges& fragment_cell_pos_ranges = 
+      *fragment_cell_pos_ranges_vec_[
+          fragment_cell_pos_ranges_vec_pos_[attribute_id]];
+  int64_t fragment_cell_pos_ranges_num = fragment_cell_pos_ranges.size();
+  int prefetch_num = 
+      std::max(1, TILEDB_READ_PREFETCH_TILE_NUM / fragment_num_);
+
+  // Find the tiles of each participating fragment
+  std::vector<std::vector<int64_t> > fragment_tiles(fragment_num_);
+  for(int64_t i=0; i<fragment_cell_pos_ranges_num; ++i) {
+    int fragment_id = fragment_cell_pos_ranges[i].first.first;
+    int64_t tile_i = fragment_cell_pos_ranges[i].first.second;
+    if(fragment_id != -1 && 
+       (fragment_tiles[fragment_id].empty() || 
+        fragment_tiles[fragment_id].back() != tile_i))
+      fragment_tiles[fragment_id].push_back(tile_i);
+  }
+
+  // Assign the tiles to be prefetched for each fragment with a tile of the
+  // read round that is not in main memory, looking ahead for the next
+  // overlapping tiles
+  std::vector<int> fragment_ids;
+  std::vector<std::pair<int, int64_t> > tiles;
+  for(int i=0; i<fragment_num_; ++i) {
+    // Check if the tiles of the read round are in main memory
+    std::vector<int64_t>& fragment_tiles_i = fragment_tiles[i];
+    int fragment_tile_num = fragment_tiles_i.size();
+    bool fetched = true;
+    for(int j=0; j<fragment_tile_num && fetched; ++j) 
+      fetched = fragment_read_states_[i]->tile_fetched(
+                    attribute_id, 
+                    fragment_tiles_i[j]);
+    if(fetched)
+      continue;
+
+    // Assign the tiles
+    if(fragment_tile_num >= prefetch_num) 
+      fragment_tiles_i.resize(prefetch_num);
+    else
+      fragment_read_states_[i]->get_next_overlapping_tiles_sparse<T>(
+          fragment_tiles_i.back(), 
+          prefetch_num - fragment_tile_num,
+          fragment_tiles_i);
+    fragment_read_states_[i]->assign_prefetch_tiles(
+        attribute_id, 
+        fragment_tiles_i, 
+        tiles);
+    fragment_ids.resize(tiles.size(), i);
+  }
+
+  // Nothing to prefetch
+  if(tiles.empty())
+    return TILEDB_ARS_OK;
+
+  // Prefetch the tiles in parallel
+  FragmentTaskData data;
+  data.attribute_id_ = attribute_id;
+  data.fragment_ids_ = &fragment_ids;
+  data.tiles_ = &tiles;
+  return run_fragment_tasks(prefetch_tiles_s, data);
+}
+
+void *ArrayReadState::prefetch_tiles_s(void* data) {
+  // For easy reference
+  FragmentTaskData* d = (FragmentTaskData*) data;
+  int task_num = d->fragment_ids_->size();
+
+  // Claim tasks until none is left
+  for(int i = (*d->next_task_)++; i < task_num; i = (*d->next_task_)++) {
+    int fragment_id = (*d->fragment_ids_)[i];
+    const std::pair<int, int64_t>& tile = (*d->tiles_)[i];
+    if(d->array_read_state_->fragment_read_states_[fragment_id]->prefetch_tile(
+           d->attribute_id_,
+           tile.second,
+           tile.first) != TILEDB_RS_OK)
+      (*d->errmsgs_)[i] = tiledb_rs_errmsg;
+  }
+
+  return NULL;
+}
+
 int ArrayReadState::read_dense(
     void** buffers,  
     size_t* buffer_sizes) {
@@ -2005,6 +2511,10 @@ int ArrayReadState::read_sparse_attr(
       return TILEDB_ARS_OK;
     }
 
+    // Fetch the tiles of the read round and the next ones in parallel
+    if(prefetch_tiles<T>(attribute_id) != TILEDB_ARS_OK)
+      return TILEDB_ARS_ERR;
+
     // Copy cells to buffers
     if(copy_cells(
            attribute_id, 
@@ -2116,6 +2626,10 @@ int ArrayReadState::read_sparse_attr_var(
       return TILEDB_ARS_OK;
     }
  
+    // Fetch the tiles of the read round and the next ones in parallel
+    if(prefetch_tiles<T>(attribute_id) != TILEDB_ARS_OK)
+      return TILEDB_ARS_ERR;
+
     // Copy cells to buffers
     if(copy_cells_var(
              attribute_id,
@@ -2136,6 +2650,43 @@ int ArrayReadState::read_sparse_attr_var(
   }
 }
 
+int ArrayReadState::run_fragment_tasks(
+    void *(*task_s)(void*), 
+    FragmentTaskData& data) {
+  // For easy reference
+  int task_num = data.fragment_ids_->size();
+
+  // Initialization
+  std::atomic<int> next_task(0);
+  std::vector<std::string> errmsgs(task_num);
+  data.array_read_state_ = this;
+  data.errmsgs_ = &errmsgs;
+  data.next_task_ = &next_task;
+  int thread_num = std::min(task_num, thread_num_);
+
+  // Run the tasks on the thread pool of the array, letting the calling thread
+  // work as well. Since the tasks are claimed dynamically, any number of
+  // threads completes them.
+  if(thread_num == 1) {
+    task_s(&data);
+  } else if(array_->thread_pool()->run(task_s, &data, thread_num) != 
+            TILEDB_TP_OK) {
+    tiledb_ars_errmsg = tiledb_tp_errmsg;
+    return TILEDB_ARS_ERR;
+  }
+
+  // Check for errors
+  for(int i=0; i<task_num; ++i) {
+    if(!errmsgs[i].empty()) {
+      tiledb_ars_errmsg = errmsgs[i];
+      return TILEDB_ARS_ERR;
+    }
+  }
+
+  // Success
+  return TILEDB_ARS_OK;
+}
+
 template<class T>
 int ArrayReadState::sort_fragment_cell_ranges(
     std::vector<FragmentCellRanges>& unsorted_fragment_cell_ranges,
@@ -2164,6 +2715,15 @@ int ArrayReadState::sort_fragment_cell_ranges(
     return TILEDB_ARS_OK;
   }
 
+  STATS_TIMER(array_->stats(), TIMER_FRAGMENT_MERGE);
+#ifdef TILEDB_STATS
+  for(int i=0; i<fragment_num; ++i) 
+    STATS_ADD(
+        array_->stats(), 
+        RANGES_MERGED, 
+        unsorted_fragment_cell_ranges[i].size());
+#endif
+
   // For easy reference
   int dim_num = array_schema_->dim_num();
   const T* domain = static_cast<const T*>(array_schema_->domain());
@@ -2434,6 +2994,24 @@ int ArrayReadState::sort_fragment_cell_ranges(
   return rc;
 }
 
+void ArrayReadState::update_validity(
+    int attribute_id,
+    size_t cell_size,
+    size_t buffer_offset_start,
+    size_t buffer_offset_end,
+    bool valid) {
+  // Nothing to do if the validity bitmap is not requested
+  unsigned char* validity = validity_[attribute_id];
+  if(validity == NULL) 
+    return;
+
+  set_bitmap_range(
+      validity,
+      buffer_offset_start / cell_size,
+      buffer_offset_end / cell_size,
+      valid);
+}
+
 
 
 
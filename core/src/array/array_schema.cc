@@ -71,6 +71,7 @@ std::string tiledb_as_errmsg = "";
 ArraySchema::ArraySchema() {
   cell_num_per_tile_ = -1;
   coords_for_hilbert_ = NULL;
+  coords_layout_ = TILEDB_COORDS_INTERLEAVED;
   domain_ = NULL;
   hilbert_curve_ = NULL;
   tile_extents_ = NULL;
@@ -175,6 +176,27 @@ void ArraySchema::array_schema_export(ArraySchemaC* array_schema_c) const {
       (int*) malloc((attribute_num_+1)*sizeof(int));
   for(int i=0; i<attribute_num_+1; ++i)
     array_schema_c->compression_[i] = compression_[i];
+
+  // Set compression parameters
+  array_schema_c->compression_level_ = 
+      (int*) malloc((attribute_num_+1)*sizeof(int));
+  array_schema_c->blosc_shuffle_ = 
+      (int*) malloc((attribute_num_+1)*sizeof(int));
+  array_schema_c->blosc_typesize_ = 
+      (int*) malloc((attribute_num_+1)*sizeof(int));
+  for(int i=0; i<attribute_num_+1; ++i) {
+    array_schema_c->compression_level_[i] = compression_level_[i];
+    array_schema_c->blosc_shuffle_[i] = blosc_shuffle_[i];
+    array_schema_c->blosc_typesize_[i] = blosc_typesize_[i];
+  }
+
+  // Set coordinates layout
+  array_schema_c->coords_layout_ = coords_layout_;
+
+  // Set filter
+  array_schema_c->filter_ = (int*) malloc((attribute_num_+1)*sizeof(int));
+  for(int i=0; i<attribute_num_+1; ++i)
+    array_schema_c->filter_[i] = filter_[i];
 }
 
 void ArraySchema::array_schema_export(
@@ -246,6 +268,31 @@ int ArraySchema::attribute_num() const {
   return attribute_num_;
 }
 
+int ArraySchema::blosc_shuffle(int attribute_id) const {
+  assert(attribute_id >= 0 && attribute_id <= attribute_num_+1);
+
+  // Special case for the "search tile", which is essentially the 
+  // coordinates tile
+  if(attribute_id == attribute_num_+1)
+    attribute_id = attribute_num_;
+
+  return blosc_shuffle_[attribute_id];
+}
+
+size_t ArraySchema::blosc_typesize(int attribute_id) const {
+  assert(attribute_id >= 0 && attribute_id <= attribute_num_+1);
+
+  // Special case for the "search tile", which is essentially the 
+  // coordinates tile
+  if(attribute_id == attribute_num_+1)
+    attribute_id = attribute_num_;
+
+  if(blosc_typesize_[attribute_id] == 0)
+    return type_sizes_[attribute_id];
+  else
+    return blosc_typesize_[attribute_id];
+}
+
 const std::vector<std::string>& ArraySchema::attributes() const {
   return attributes_;
 }
@@ -288,6 +335,38 @@ int ArraySchema::compression(int attribute_id) const {
   return compression_[attribute_id];
 }
 
+int ArraySchema::compression_level(int attribute_id) const {
+  assert(attribute_id >= 0 && attribute_id <= attribute_num_+1);
+
+  // Special case for the "search tile", which is essentially the 
+  // coordinates tile
+  if(attribute_id == attribute_num_+1)
+    attribute_id = attribute_num_;
+
+  // User-defined level
+  if(compression_level_[attribute_id] != TILEDB_COMPRESSION_LEVEL_DEFAULT)
+    return compression_level_[attribute_id];
+
+  // Default level of the compressor. The GZIP default is defined by zlib and
+  // it is resolved upon compression (see gzip()).
+  int compression = compression_[attribute_id];
+  if(compression == TILEDB_ZSTD)
+    return TILEDB_COMPRESSION_LEVEL_ZSTD;
+  else if(compression == TILEDB_BLOSC        ||
+          compression == TILEDB_BLOSC_LZ4    ||
+          compression == TILEDB_BLOSC_LZ4HC  ||
+          compression == TILEDB_BLOSC_SNAPPY ||
+          compression == TILEDB_BLOSC_ZLIB   ||
+          compression == TILEDB_BLOSC_ZSTD)
+    return TILEDB_COMPRESSION_LEVEL_BLOSC;
+  else
+    return TILEDB_COMPRESSION_LEVEL_DEFAULT;
+}
+
+int ArraySchema::coords_layout() const {
+  return coords_layout_;
+}
+
 size_t ArraySchema::coords_size() const {
   return coords_size_;
 }
@@ -308,6 +387,17 @@ const void* ArraySchema::domain() const {
   return domain_;
 }
 
+int ArraySchema::filter(int attribute_id) const {
+  assert(attribute_id >= 0 && attribute_id <= attribute_num_+1);
+
+  // Special case for the "search tile", which is essentially the 
+  // coordinates tile
+  if(attribute_id == attribute_num_+1)
+    attribute_id = attribute_num_;
+
+  return filter_[attribute_id];
+}
+
 int ArraySchema::get_attribute_ids(
     const std::vector<std::string>& attributes,
     std::vector<int>& attribute_ids) const {
@@ -542,6 +632,44 @@ void ArraySchema::print() const {
     std::cout << "\tCoordinates: RLE\n";
   else if(compression_[attribute_num_] == TILEDB_NO_COMPRESSION)
     std::cout << "\tCoordinates: NONE\n";
+  // Compression parameters
+  std::cout << "Compression parameters:\n";
+  for(int i=0; i<=attribute_num_; ++i) {
+    if(compression_[i] == TILEDB_NO_COMPRESSION ||
+       compression_[i] == TILEDB_LZ4            ||
+       compression_[i] == TILEDB_RLE)
+      continue;
+    std::cout << "\t" 
+              << ((i == attribute_num_) ? "Coordinates" : attributes_[i]) 
+              << ": level=";
+    if(compression_level(i) == TILEDB_COMPRESSION_LEVEL_DEFAULT)
+      std::cout << "default";
+    else
+      std::cout << compression_level(i);
+    if(compression_[i] != TILEDB_GZIP && compression_[i] != TILEDB_ZSTD) 
+      std::cout << ", shuffle=" << blosc_shuffle_[i]
+                << ", typesize=" << blosc_typesize(i);
+    std::cout << "\n";
+  }
+  // Filter type
+  std::cout << "Filter type:\n";
+  for(int i=0; i<=attribute_num_; ++i) {
+    std::cout << "\t" 
+              << ((i == attribute_num_) ? "Coordinates" : attributes_[i]);
+    if(filter_[i] == TILEDB_DELTA)
+      std::cout << ": DELTA\n";
+    else if(filter_[i] == TILEDB_DOUBLE_DELTA)
+      std::cout << ": DOUBLE_DELTA\n";
+    else if(filter_[i] == TILEDB_DICTIONARY)
+      std::cout << ": DICTIONARY\n";
+    else if(filter_[i] == TILEDB_NO_FILTER)
+      std::cout << ": NONE\n";
+  }
+  // Coordinates layout
+  if(coords_layout_ == TILEDB_COORDS_COLUMNAR)
+    std::cout << "Coordinates layout:\n\tCOLUMNAR\n";
+  else if(coords_layout_ == TILEDB_COORDS_INTERLEAVED)
+    std::cout << "Coordinates layout:\n\tINTERLEAVED\n";
 }
 
 // ===== FORMAT =====
@@ -568,6 +696,11 @@ void ArraySchema::print() const {
 // type#1(char) type#2(char) ... 
 // cell_val_num#1(int) cell_val_num#2(int) ... 
 // compression#1(char) compression#2(char) ...
+// compression_level#1(int) compression_level#2(int) ...
+// blosc_shuffle#1(char) blosc_shuffle#2(char) ...
+// blosc_typesize#1(int) blosc_typesize#2(int) ...
+// filter#1(char) filter#2(char) ...
+// coords_layout(char)
 int ArraySchema::serialize(
     void*& array_schema_bin,
     size_t& array_schema_bin_size) const {
@@ -672,10 +805,43 @@ int ArraySchema::serialize(
   char compression; 
   for(int i=0; i<=attribute_num_; ++i) {
     compression = compression_[i];
-    assert(offset + sizeof(char) <= buffer_size);
+    assert(offset + sizeof(char) < buffer_size);
     memcpy(buffer + offset, &compression, sizeof(char));
     offset += sizeof(char);
   }
+  // Copy compression_level_
+  for(int i=0; i<=attribute_num_; ++i) {
+    assert(offset + sizeof(int) < buffer_size);
+    memcpy(buffer + offset, &compression_level_[i], sizeof(int));
+    offset += sizeof(int);
+  }
+  // Copy blosc_shuffle_
+  char blosc_shuffle; 
+  for(int i=0; i<=attribute_num_; ++i) {
+    blosc_shuffle = blosc_shuffle_[i];
+    assert(offset + sizeof(char) < buffer_size);
+    memcpy(buffer + offset, &blosc_shuffle, sizeof(char));
+    offset += sizeof(char);
+  }
+  // Copy blosc_typesize_
+  for(int i=0; i<=attribute_num_; ++i) {
+    assert(offset + sizeof(int) < buffer_size);
+    memcpy(buffer + offset, &blosc_typesize_[i], sizeof(int));
+    offset += sizeof(int);
+  }
+  // Copy filter_
+  char filter; 
+  for(int i=0; i<=attribute_num_; ++i) {
+    filter = filter_[i];
+    assert(offset + sizeof(char) < buffer_size);
+    memcpy(buffer + offset, &filter, sizeof(char));
+    offset += sizeof(char);
+  }
+  // Copy coords_layout_
+  char coords_layout = coords_layout_;
+  assert(offset + sizeof(char) <= buffer_size);
+  memcpy(buffer + offset, &coords_layout, sizeof(char));
+  offset += sizeof(char);
   assert(offset == buffer_size);
 
   // Success
@@ -907,6 +1073,11 @@ bool ArraySchema::var_size(int attribute_id) const {
 // type#1(char) type#2(char) ... 
 // cell_val_num#1(int) cell_val_num#2(int) ... 
 // compression#1(char) compression#2(char) ...
+// compression_level#1(int) compression_level#2(int) ...
+// blosc_shuffle#1(char) blosc_shuffle#2(char) ...
+// blosc_typesize#1(int) blosc_typesize#2(int) ...
+// filter#1(char) filter#2(char) ...
+// coords_layout(char)
 int ArraySchema::deserialize(
     const void* array_schema_bin, 
     size_t array_schema_bin_size) {
@@ -1022,6 +1193,53 @@ int ArraySchema::deserialize(
     offset += sizeof(char);
     compression_.push_back(static_cast<int>(compression));
   }
+  // Load compression parameters. They are absent from schemas written by
+  // older versions, in which case the defaults are used.
+  compression_level_.resize(attribute_num_+1, TILEDB_COMPRESSION_LEVEL_DEFAULT);
+  blosc_shuffle_.resize(attribute_num_+1, TILEDB_BLOSC_SHUFFLE);
+  blosc_typesize_.resize(attribute_num_+1, 0);
+  if(offset < buffer_size) {
+    // Load compression_level_
+    for(int i=0; i<=attribute_num_; ++i) {
+      assert(offset + sizeof(int) < buffer_size);
+      memcpy(&compression_level_[i], buffer + offset, sizeof(int));
+      offset += sizeof(int);
+    }
+    // Load blosc_shuffle_
+    char blosc_shuffle;
+    for(int i=0; i<=attribute_num_; ++i) {
+      assert(offset + sizeof(char) < buffer_size);
+      memcpy(&blosc_shuffle, buffer + offset, sizeof(char));
+      offset += sizeof(char);
+      blosc_shuffle_[i] = static_cast<int>(blosc_shuffle);
+    }
+    // Load blosc_typesize_
+    for(int i=0; i<=attribute_num_; ++i) {
+      assert(offset + sizeof(int) <= buffer_size);
+      memcpy(&blosc_typesize_[i], buffer + offset, sizeof(int));
+      offset += sizeof(int);
+    }
+  }
+  // Load filter_, which is also absent from schemas of older versions
+  filter_.resize(attribute_num_+1, TILEDB_NO_FILTER);
+  if(offset < buffer_size) {
+    char filter;
+    for(int i=0; i<=attribute_num_; ++i) {
+      assert(offset + sizeof(char) <= buffer_size);
+      memcpy(&filter, buffer + offset, sizeof(char));
+      offset += sizeof(char);
+      filter_[i] = static_cast<int>(filter);
+    }
+  }
+  // Load coords_layout_, which is also absent from schemas of older versions
+  coords_layout_ = TILEDB_COORDS_INTERLEAVED;
+  if(offset < buffer_size) {
+    char coords_layout;
+    assert(offset + sizeof(char) <= buffer_size);
+    memcpy(&coords_layout, buffer + offset, sizeof(char));
+    offset += sizeof(char);
+    coords_layout_ = static_cast<int>(coords_layout);
+  }
   assert(offset == buffer_size); 
   // Add extra coordinate attribute
   attributes_.push_back(TILEDB_COORDS);
@@ -1041,6 +1259,9 @@ int ArraySchema::deserialize(
   // Compute tile offsets
   compute_tile_offsets();
 
+  // Compute cell offsets
+  compute_cell_offsets();
+
   // Initialize Hilbert curve
   init_hilbert_curve();
 
@@ -1071,6 +1292,15 @@ int ArraySchema::init(const ArraySchemaC* array_schema_c) {
   // Set compression
   if(set_compression(array_schema_c->compression_) != TILEDB_AS_OK)
     return TILEDB_AS_ERR;
+  // Set compression parameters
+  if(set_compression_params(
+      array_schema_c->compression_level_,
+      array_schema_c->blosc_shuffle_,
+      array_schema_c->blosc_typesize_) != TILEDB_AS_OK)
+    return TILEDB_AS_ERR;
+  // Set coordinates layout
+  if(set_coords_layout(array_schema_c->coords_layout_) != TILEDB_AS_OK)
+    return TILEDB_AS_ERR;
   // Set dense
   set_dense(array_schema_c->dense_);
   // Set number of values per cell
@@ -1078,6 +1308,9 @@ int ArraySchema::init(const ArraySchemaC* array_schema_c) {
   // Set types
   if(set_types(array_schema_c->types_) != TILEDB_AS_OK)
     return TILEDB_AS_ERR;
+  // Set filter
+  if(set_filter(array_schema_c->filter_) != TILEDB_AS_OK)
+    return TILEDB_AS_ERR;
   // Set tile extents
   if(set_tile_extents(array_schema_c->tile_extents_) != TILEDB_AS_OK)
     return TILEDB_AS_ERR;
@@ -1100,6 +1333,9 @@ int ArraySchema::init(const ArraySchemaC* array_schema_c) {
   // Compute tile offsets
   compute_tile_offsets();
 
+  // Compute cell offsets
+  compute_cell_offsets();
+
   // Initialize Hilbert curve
   init_hilbert_curve();
 
@@ -1199,6 +1435,17 @@ int ArraySchema::init(const MetadataSchemaC* metadata_schema_c) {
   compression[metadata_schema_c->attribute_num_+1] = TILEDB_NO_COMPRESSION;
   array_schema_c.compression_ = compression;
 
+  // Use the default compression parameters
+  array_schema_c.compression_level_ = NULL;
+  array_schema_c.blosc_shuffle_ = NULL;
+  array_schema_c.blosc_typesize_ = NULL;
+
+  // No filters
+  array_schema_c.filter_ = NULL;
+
+  // Default coordinates layout
+  array_schema_c.coords_layout_ = TILEDB_COORDS_INTERLEAVED;
+
   // Initialize schema through the array schema C struct
   init(&array_schema_c);
 
@@ -1343,10 +1590,160 @@ int ArraySchema::set_compression(int* compression) {
   return TILEDB_AS_OK;
 }
 
+int ArraySchema::set_compression_params(
+    const int* compression_level,
+    const int* blosc_shuffle,
+    const int* blosc_typesize) {
+  // Set compression levels
+  compression_level_.clear();
+  for(int i=0; i<attribute_num_+1; ++i) {
+    int level = (compression_level == NULL) ? TILEDB_COMPRESSION_LEVEL_DEFAULT
+                                            : compression_level[i];
+    bool valid = true; 
+    if(level != TILEDB_COMPRESSION_LEVEL_DEFAULT) {
+      if(compression_[i] == TILEDB_GZIP)
+        valid = (level >= -1 && level <= 9);
+      else if(compression_[i] == TILEDB_ZSTD)
+        valid = (level >= 1 && level <= 22);
+      else if(compression_[i] == TILEDB_BLOSC        ||
+              compression_[i] == TILEDB_BLOSC_LZ4    ||
+              compression_[i] == TILEDB_BLOSC_LZ4HC  ||
+              compression_[i] == TILEDB_BLOSC_SNAPPY ||
+              compression_[i] == TILEDB_BLOSC_ZLIB   ||
+              compression_[i] == TILEDB_BLOSC_ZSTD)
+        valid = (level >= 0 && level <= 9);
+    }
+    if(!valid) {
+      std::string errmsg = 
+          "Cannot set compression parameters; Invalid compression level";
+      PRINT_ERROR(errmsg);
+      tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+      return TILEDB_AS_ERR;
+    }
+    compression_level_.push_back(level);
+  }
+
+  // Set Blosc shuffle modes
+  blosc_shuffle_.clear();
+  for(int i=0; i<attribute_num_+1; ++i) {
+    int shuffle = (blosc_shuffle == NULL) ? TILEDB_BLOSC_SHUFFLE 
+                                          : blosc_shuffle[i];
+    if(shuffle != TILEDB_BLOSC_NOSHUFFLE &&
+       shuffle != TILEDB_BLOSC_SHUFFLE   &&
+       shuffle != TILEDB_BLOSC_BITSHUFFLE) {
+      std::string errmsg = 
+          "Cannot set compression parameters; Invalid Blosc shuffle mode";
+      PRINT_ERROR(errmsg);
+      tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+      return TILEDB_AS_ERR;
+    }
+    blosc_shuffle_.push_back(shuffle);
+  }
+
+  // Set Blosc typesizes
+  blosc_typesize_.clear();
+  for(int i=0; i<attribute_num_+1; ++i) {
+    int typesize = (blosc_typesize == NULL) ? 0 : blosc_typesize[i];
+    if(typesize < 0 || typesize > 255) {
+      std::string errmsg = 
+          "Cannot set compression parameters; Invalid Blosc typesize";
+      PRINT_ERROR(errmsg);
+      tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+      return TILEDB_AS_ERR;
+    }
+    blosc_typesize_.push_back(typesize);
+  }
+
+  // Success
+  return TILEDB_AS_OK;
+}
+
+int ArraySchema::set_coords_layout(int coords_layout) {
+  // Check coordinates layout
+  if(coords_layout != TILEDB_COORDS_INTERLEAVED &&
+     coords_layout != TILEDB_COORDS_COLUMNAR) {
+    std::string errmsg = 
+        "Cannot set coordinates layout; Invalid coordinates layout";
+    PRINT_ERROR(errmsg);
+    tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+    return TILEDB_AS_ERR;
+  }
+
+  // The columnar layout is applied only upon compression
+  if(coords_layout == TILEDB_COORDS_COLUMNAR &&
+     compression_[attribute_num_] == TILEDB_NO_COMPRESSION) {
+    std::string errmsg = 
+        "Cannot set coordinates layout; The columnar layout applies only to "
+        "compressed coordinates";
+    PRINT_ERROR(errmsg);
+    tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+    return TILEDB_AS_ERR;
+  }
+
+  coords_layout_ = coords_layout;
+
+  // Success
+  return TILEDB_AS_OK;
+}
+
 void ArraySchema::set_dense(int dense) {
   dense_ = dense;
 }
 
+int ArraySchema::set_filter(const int* filter) {
+  filter_.clear();
+  for(int i=0; i<attribute_num_+1; ++i) {
+    int filter_i = (filter == NULL) ? TILEDB_NO_FILTER : filter[i];
+
+    // Check filter type
+    if(filter_i != TILEDB_NO_FILTER &&
+       filter_i != TILEDB_DELTA     &&
+       filter_i != TILEDB_DOUBLE_DELTA &&
+       filter_i != TILEDB_DICTIONARY) {
+      std::string errmsg = "Cannot set filter; Invalid filter type";
+      PRINT_ERROR(errmsg);
+      tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+      return TILEDB_AS_ERR;
+    }
+
+    // Check applicability
+    if(filter_i != TILEDB_NO_FILTER) {
+      // The filter of a variable-sized attribute applies to its cell
+      // offsets, which are always integers
+      bool var = (i < attribute_num_ && cell_val_num_[i] == TILEDB_VAR_NUM);
+      if(!var && types_[i] != TILEDB_INT32 && types_[i] != TILEDB_INT64) {
+        std::string errmsg = 
+            "Cannot set filter; Filters apply only to integer attributes, "
+            "coordinates and variable-sized attributes";
+        PRINT_ERROR(errmsg);
+        tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+        return TILEDB_AS_ERR;
+      }
+      if(!var && filter_i == TILEDB_DICTIONARY) {
+        std::string errmsg = 
+            "Cannot set filter; Dictionary encoding applies only to "
+            "variable-sized attributes";
+        PRINT_ERROR(errmsg);
+        tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+        return TILEDB_AS_ERR;
+      }
+      if(compression_[i] == TILEDB_NO_COMPRESSION) {
+        std::string errmsg = 
+            "Cannot set filter; Filters apply only to compressed attributes "
+            "and coordinates";
+        PRINT_ERROR(errmsg);
+        tiledb_as_errmsg = TILEDB_AS_ERRMSG + errmsg;
+        return TILEDB_AS_ERR;
+      }
+    }
+
+    filter_.push_back(filter_i);
+  }
+
+  // Success
+  return TILEDB_AS_OK;
+}
+
 int ArraySchema::set_dimensions(
     char** dimensions,
     int dim_num) {
@@ -1575,26 +1972,21 @@ int ArraySchema::set_types(const int* types) {
 
 template<class T>
 int ArraySchema::cell_order_cmp(const T* coords_a, const T* coords_b) const {
+  // Column- and row-major orders are handled by kernels specialized on the
+  // number of dimensions
+  if(cell_order_ == TILEDB_COL_MAJOR)          // COLUMN-MAJOR
+    TILEDB_UT_DIM_NUM_DISPATCH(
+        dim_num_, cell_order_cmp_col_kernel, T, coords_a, coords_b);
+  else if(cell_order_ == TILEDB_ROW_MAJOR)     // ROW-MAJOR
+    TILEDB_UT_DIM_NUM_DISPATCH(
+        dim_num_, cell_order_cmp_row_kernel, T, coords_a, coords_b);
+
   // Check if they are equal
   if(memcmp(coords_a, coords_b, coords_size_) == 0)
     return 0;
 
   // Check for precedence
-  if(cell_order_ == TILEDB_COL_MAJOR) {    // COLUMN-MAJOR
-    for(int i=dim_num_-1; i>=0; --i) {
-      if(coords_a[i] < coords_b[i])
-        return -1;
-      else if(coords_a[i] > coords_b[i])
-        return 1;
-    }
-  } else if(cell_order_ == TILEDB_ROW_MAJOR) { // ROW-MAJOR
-    for(int i=0; i<dim_num_; ++i) {
-      if(coords_a[i] < coords_b[i])
-        return -1;
-      else if(coords_a[i] > coords_b[i])
-        return 1;
-    }
-  } else if(cell_order_ == TILEDB_HILBERT) {   // HILBERT
+  if(cell_order_ == TILEDB_HILBERT) {          // HILBERT
     // Check hilbert ids
     int64_t id_a = hilbert_id(coords_a);
     int64_t id_b = hilbert_id(coords_b);
@@ -1620,6 +2012,44 @@ int ArraySchema::cell_order_cmp(const T* coords_a, const T* coords_b) const {
   return 0;
 }
 
+template<class T, int N>
+inline
+int ArraySchema::cell_order_cmp_col_kernel(
+    const T* coords_a, 
+    const T* coords_b) const {
+  // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
+
+  for(int i=dim_num-1; i>=0; --i) {
+    if(coords_a[i] < coords_b[i])
+      return -1;
+    else if(coords_a[i] > coords_b[i])
+      return 1;
+  }
+
+  // The coordinates are equal
+  return 0;
+}
+
+template<class T, int N>
+inline
+int ArraySchema::cell_order_cmp_row_kernel(
+    const T* coords_a, 
+    const T* coords_b) const {
+  // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
+
+  for(int i=0; i<dim_num; ++i) {
+    if(coords_a[i] < coords_b[i])
+      return -1;
+    else if(coords_a[i] > coords_b[i])
+      return 1;
+  }
+
+  // The coordinates are equal
+  return 0;
+}
+
 void ArraySchema::expand_domain(void* domain) const {
   if(types_[attribute_num_] == TILEDB_INT32)
     expand_domain<int>(static_cast<int*>(domain));
@@ -1858,112 +2288,16 @@ template<>
 int ArraySchema::tile_order_cmp(
     const int* coords_a, 
     const int* coords_b) const {
-  // For easy reference
-  int diff; 
-  int norm;
-  const int* domain = static_cast<const int*>(domain_);
-  const int* tile_extents = static_cast<const int*>(tile_extents_);
-
-  // If there are regular tiles, first check tile order
-  if(tile_extents_ != NULL) {
-    // ROW-MAJOR
-    if(tile_order_ == TILEDB_ROW_MAJOR) {
-      // Check if the cells are definitely IN the same tile
-      for(int i=0; i<dim_num_; ++i) {
-        diff = coords_a[i] - coords_b[i];
-
-        if(diff < 0)
-          norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
-        else if(diff > 0)
-          norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-      }
-    } else { // COLUMN-MAJOR
-      // Check if the cells are definitely IN the same tile
-      for(int i=dim_num_-1; i>=0; --i) {
-        diff = coords_a[i] - coords_b[i];
-
-        if(diff < 0)
-          norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
-        else if(diff > 0)
-          norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-      }
-    }
-  }
-
-  // Same tile order
-  return 0;
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num_, tile_order_cmp_kernel, int, coords_a, coords_b);
 }
 
 template<>
 int ArraySchema::tile_order_cmp(
     const int64_t* coords_a, 
     const int64_t* coords_b) const {
-  // For easy reference
-  int64_t diff; 
-  int64_t norm;
-  const int64_t* domain = static_cast<const int64_t*>(domain_);
-  const int64_t* tile_extents = static_cast<const int64_t*>(tile_extents_);
-
-  // If there are regular tiles, first check tile order
-  if(tile_extents_ != NULL) {
-    // ROW-MAJOR
-    if(tile_order_ == TILEDB_ROW_MAJOR) {
-      // Check if the cells are definitely IN the same tile
-      for(int i=0; i<dim_num_; ++i) {
-        diff = coords_a[i] - coords_b[i];
-       
-        if(diff < 0)
-          norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
-        else if(diff > 0)
-          norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-      }
-    } else { // COLUMN-MAJOR
-      // Check if the cells are definitely IN the same tile
-      for(int i=dim_num_-1; i>=0; --i) {
-        diff = coords_a[i] - coords_b[i];
-
-        if(diff < 0)
-          norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
-        else if(diff > 0)
-          norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-
-
-        if(diff < 0 && (norm - diff) >= tile_extents[i])
-          return -1;
-        else if(diff > 0 && (norm + diff) >= tile_extents[i]) 
-          return 1;
-      }
-    }
-  }
-
-  // Same tile order
-  return 0;
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num_, tile_order_cmp_kernel, int64_t, coords_a, coords_b);
 }
 
 template<>
@@ -2132,6 +2466,11 @@ int ArraySchema::tile_order_cmp(
 // type#1(char) type#2(char) ... 
 // cell_val_num#1(int) cell_val_num#2(int) ... 
 // compression#1(char) compression#2(char) ...
+// compression_level#1(int) compression_level#2(int) ...
+// blosc_shuffle#1(char) blosc_shuffle#2(char) ...
+// blosc_typesize#1(int) blosc_typesize#2(int) ...
+// filter#1(char) filter#2(char) ...
+// coords_layout(char)
 size_t ArraySchema::compute_bin_size() const {
   // Initialization
   size_t bin_size = 0;
@@ -2162,6 +2501,12 @@ size_t ArraySchema::compute_bin_size() const {
   bin_size += attribute_num_ * sizeof(int);
   // Size for compression_
   bin_size += (attribute_num_+1) * sizeof(char);
+  // Size for compression_level_, blosc_shuffle_ and blosc_typesize_
+  bin_size += (attribute_num_+1) * (2*sizeof(int) + sizeof(char));
+  // Size for filter_
+  bin_size += (attribute_num_+1) * sizeof(char);
+  // Size for coords_layout_
+  bin_size += sizeof(char);
 
   return bin_size;
 }
@@ -2190,6 +2535,49 @@ void ArraySchema::compute_cell_num_per_tile() {
     cell_num_per_tile_ *= tile_extents[i]; 
 }
 
+void ArraySchema::compute_cell_offsets() {
+  // Invoke the proper templated function
+  if(types_[attribute_num_] == TILEDB_INT32) {
+    compute_cell_offsets<int>();
+  } else if(types_[attribute_num_] == TILEDB_INT64) {
+    compute_cell_offsets<int64_t>();
+  } else if(types_[attribute_num_] == TILEDB_FLOAT32) {
+    compute_cell_offsets<float>();
+  } else if(types_[attribute_num_] == TILEDB_FLOAT64) {
+    compute_cell_offsets<double>();
+  } else { // The program should never reach this point
+    assert(0);
+  }
+}
+
+template<class T>
+void ArraySchema::compute_cell_offsets() {
+  // Applicable only to non-NULL space tiles
+  if(tile_extents_ == NULL)
+    return;
+
+  // For easy reference
+  const T* tile_extents = static_cast<const T*>(tile_extents_);
+  int64_t cell_num; // Per dimension
+
+  // Calculate cell offsets for column-major cell order
+  cell_offsets_col_.clear();
+  cell_offsets_col_.push_back(1);
+  for(int i=1; i<dim_num_; ++i) {
+    cell_num = tile_extents[i-1]; 
+    cell_offsets_col_.push_back(cell_offsets_col_.back() * cell_num);
+  }
+
+  // Calculate cell offsets for row-major cell order
+  cell_offsets_row_.clear();
+  cell_offsets_row_.push_back(1);
+  for(int i=dim_num_-2; i>=0; --i) {
+    cell_num = tile_extents[i+1];
+    cell_offsets_row_.push_back(cell_offsets_row_.back() * cell_num);
+  }
+  std::reverse(cell_offsets_row_.begin(), cell_offsets_row_.end());
+}
+
 size_t ArraySchema::compute_cell_size(int i) const {
   assert(i>= 0 && i <= attribute_num_);
 
@@ -2348,23 +2736,22 @@ size_t ArraySchema::compute_type_size(int i) const {
 
 template<class T>
 int64_t ArraySchema::get_cell_pos_col(const T* coords) const {
+  TILEDB_UT_DIM_NUM_DISPATCH(dim_num_, get_cell_pos_col_kernel, T, coords);
+}
+
+template<class T, int N>
+inline
+int64_t ArraySchema::get_cell_pos_col_kernel(const T* coords) const {
   // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
   const T* domain = static_cast<const T*>(domain_);
   const T* tile_extents = static_cast<const T*>(tile_extents_);
-
-  // Calculate cell offsets
-  int64_t cell_num; // Per dimension
-  std::vector<int64_t> cell_offsets;
-  cell_offsets.push_back(1);
-  for(int i=1; i<dim_num_; ++i) {
-    cell_num = tile_extents[i-1]; 
-    cell_offsets.push_back(cell_offsets.back() * cell_num);
-  }
+  const int64_t* cell_offsets = &cell_offsets_col_[0];
  
   // Calculate position
   T coords_norm; // Normalized coordinates inside the tile
   int64_t pos = 0;
-  for(int i=0; i<dim_num_; ++i) { 
+  for(int i=0; i<dim_num; ++i) { 
     coords_norm = (coords[i] - domain[2*i]);
     coords_norm -=  (coords_norm / tile_extents[i]) * tile_extents[i];
     pos += coords_norm * cell_offsets[i];
@@ -2376,24 +2763,22 @@ int64_t ArraySchema::get_cell_pos_col(const T* coords) const {
 
 template<class T>
 int64_t ArraySchema::get_cell_pos_row(const T* coords) const {
+  TILEDB_UT_DIM_NUM_DISPATCH(dim_num_, get_cell_pos_row_kernel, T, coords);
+}
+
+template<class T, int N>
+inline
+int64_t ArraySchema::get_cell_pos_row_kernel(const T* coords) const {
   // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
   const T* domain = static_cast<const T*>(domain_);
   const T* tile_extents = static_cast<const T*>(tile_extents_);
-
-  // Calculate cell offsets
-  int64_t cell_num; // Per dimension
-  std::vector<int64_t> cell_offsets;
-  cell_offsets.push_back(1);
-  for(int i=dim_num_-2; i>=0; --i) {
-    cell_num = tile_extents[i+1];
-    cell_offsets.push_back(cell_offsets.back() * cell_num);
-  }
-  std::reverse(cell_offsets.begin(), cell_offsets.end());
+  const int64_t* cell_offsets = &cell_offsets_row_[0];
  
   // Calculate position
   T coords_norm; // Normalized coordinates inside the tile
   int64_t pos = 0;
-  for(int i=0; i<dim_num_; ++i) { 
+  for(int i=0; i<dim_num; ++i) { 
     coords_norm = (coords[i] - domain[2*i]);
     coords_norm -=  (coords_norm / tile_extents[i]) * tile_extents[i];
     pos += coords_norm * cell_offsets[i];
@@ -2495,13 +2880,8 @@ void ArraySchema::get_next_tile_coords_row(
 
 template<class T>
 int64_t ArraySchema::get_tile_pos_col(const T* tile_coords) const {
-  // Calculate position
-  int64_t pos = 0;
-  for(int i=0; i<dim_num_; ++i) 
-    pos += tile_coords[i] * tile_offsets_col_[i];
-
-  // Return
-  return pos;
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num_, get_tile_pos_col_kernel, T, tile_coords);
 }
 
 template<class T>
@@ -2530,17 +2910,28 @@ int64_t ArraySchema::get_tile_pos_col(
   return pos;
 }
 
-template<class T>
-int64_t ArraySchema::get_tile_pos_row(const T* tile_coords) const {
+template<class T, int N>
+inline
+int64_t ArraySchema::get_tile_pos_col_kernel(const T* tile_coords) const {
+  // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
+  const int64_t* tile_offsets = &tile_offsets_col_[0];
+
   // Calculate position
   int64_t pos = 0;
-  for(int i=0; i<dim_num_; ++i) 
-    pos += tile_coords[i] * tile_offsets_row_[i];
+  for(int i=0; i<dim_num; ++i) 
+    pos += tile_coords[i] * tile_offsets[i];
 
   // Return
   return pos;
 }
 
+template<class T>
+int64_t ArraySchema::get_tile_pos_row(const T* tile_coords) const {
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num_, get_tile_pos_row_kernel, T, tile_coords);
+}
+
 template<class T>
 int64_t ArraySchema::get_tile_pos_row(
     const T* domain,
@@ -2568,6 +2959,22 @@ int64_t ArraySchema::get_tile_pos_row(
   return pos;
 }
 
+template<class T, int N>
+inline
+int64_t ArraySchema::get_tile_pos_row_kernel(const T* tile_coords) const {
+  // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
+  const int64_t* tile_offsets = &tile_offsets_row_[0];
+
+  // Calculate position
+  int64_t pos = 0;
+  for(int i=0; i<dim_num; ++i) 
+    pos += tile_coords[i] * tile_offsets[i];
+
+  // Return
+  return pos;
+}
+
 void ArraySchema::init_hilbert_curve() {
   // Applicable only to Hilbert cell order
   if(cell_order_ != TILEDB_HILBERT) 
@@ -2629,6 +3036,57 @@ bool ArraySchema::is_contained_in_tile_slab_row(const T* range) const {
   return true; 
 }
 
+template<class T, int N>
+inline
+int ArraySchema::tile_order_cmp_kernel(
+    const T* coords_a, 
+    const T* coords_b) const {
+  // Applicable only to regular tiles
+  if(tile_extents_ == NULL)
+    return 0;
+
+  // For easy reference
+  const int dim_num = (N > 0) ? N : dim_num_;
+  const T* domain = static_cast<const T*>(domain_);
+  const T* tile_extents = static_cast<const T*>(tile_extents_);
+  T diff; 
+  T norm;
+
+  // Check if the cells are definitely IN the same tile
+  if(tile_order_ == TILEDB_ROW_MAJOR) {     // ROW-MAJOR
+    for(int i=0; i<dim_num; ++i) {
+      diff = coords_a[i] - coords_b[i];
+
+      if(diff < 0) {
+        norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
+        if(norm - diff >= tile_extents[i])
+          return -1;
+      } else if(diff > 0) {
+        norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
+        if(norm + diff >= tile_extents[i])
+          return 1;
+      }
+    }
+  } else {                                  // COLUMN-MAJOR
+    for(int i=dim_num-1; i>=0; --i) {
+      diff = coords_a[i] - coords_b[i];
+
+      if(diff < 0) {
+        norm = (coords_a[i] - domain[2*i]) % tile_extents[i];
+        if(norm - diff >= tile_extents[i])
+          return -1;
+      } else if(diff > 0) {
+        norm = (coords_b[i] - domain[2*i]) % tile_extents[i];
+        if(norm + diff >= tile_extents[i])
+          return 1;
+      }
+    }
+  }
+
+  // Same tile order
+  return 0;
+}
+
 template<class T>
 int64_t ArraySchema::tile_slab_col_cell_num(const T* subarray) const {
   // For easy reference
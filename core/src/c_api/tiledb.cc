@@ -387,6 +387,119 @@ int tiledb_array_set_schema(
       tiledb_array_schema->compression_[i] = compression[i];
   }
 
+  // Set compression parameters to defaults
+  tiledb_array_schema->compression_level_ = NULL;
+  tiledb_array_schema->blosc_shuffle_ = NULL;
+  tiledb_array_schema->blosc_typesize_ = NULL;
+
+  // Set filter to default
+  tiledb_array_schema->filter_ = NULL;
+
+  // Set coordinates layout to default
+  tiledb_array_schema->coords_layout_ = TILEDB_COORDS_INTERLEAVED;
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_set_compression_params(
+    TileDB_ArraySchema* tiledb_array_schema,
+    const int* compression_level,
+    const int* blosc_shuffle,
+    const int* blosc_typesize) {
+  // Sanity check
+  if(tiledb_array_schema == NULL) {
+    std::string errmsg = "Invalid array schema pointer";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  int attribute_num = tiledb_array_schema->attribute_num_;
+
+  // Set compression level
+  if(tiledb_array_schema->compression_level_ != NULL) {
+    free(tiledb_array_schema->compression_level_);
+    tiledb_array_schema->compression_level_ = NULL;
+  }
+  if(compression_level != NULL) {
+    tiledb_array_schema->compression_level_ = 
+        (int*) malloc((attribute_num+1)*sizeof(int));
+    for(int i=0; i<attribute_num+1; ++i)
+      tiledb_array_schema->compression_level_[i] = compression_level[i];
+  }
+
+  // Set Blosc shuffle
+  if(tiledb_array_schema->blosc_shuffle_ != NULL) {
+    free(tiledb_array_schema->blosc_shuffle_);
+    tiledb_array_schema->blosc_shuffle_ = NULL;
+  }
+  if(blosc_shuffle != NULL) {
+    tiledb_array_schema->blosc_shuffle_ = 
+        (int*) malloc((attribute_num+1)*sizeof(int));
+    for(int i=0; i<attribute_num+1; ++i)
+      tiledb_array_schema->blosc_shuffle_[i] = blosc_shuffle[i];
+  }
+
+  // Set Blosc typesize
+  if(tiledb_array_schema->blosc_typesize_ != NULL) {
+    free(tiledb_array_schema->blosc_typesize_);
+    tiledb_array_schema->blosc_typesize_ = NULL;
+  }
+  if(blosc_typesize != NULL) {
+    tiledb_array_schema->blosc_typesize_ = 
+        (int*) malloc((attribute_num+1)*sizeof(int));
+    for(int i=0; i<attribute_num+1; ++i)
+      tiledb_array_schema->blosc_typesize_[i] = blosc_typesize[i];
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_set_filter(
+    TileDB_ArraySchema* tiledb_array_schema,
+    const int* filter) {
+  // Sanity check
+  if(tiledb_array_schema == NULL) {
+    std::string errmsg = "Invalid array schema pointer";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  int attribute_num = tiledb_array_schema->attribute_num_;
+
+  // Set filter
+  if(tiledb_array_schema->filter_ != NULL) {
+    free(tiledb_array_schema->filter_);
+    tiledb_array_schema->filter_ = NULL;
+  }
+  if(filter != NULL) {
+    tiledb_array_schema->filter_ = 
+        (int*) malloc((attribute_num+1)*sizeof(int));
+    for(int i=0; i<attribute_num+1; ++i)
+      tiledb_array_schema->filter_[i] = filter[i];
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_set_coords_layout(
+    TileDB_ArraySchema* tiledb_array_schema,
+    int coords_layout) {
+  // Sanity check
+  if(tiledb_array_schema == NULL) {
+    std::string errmsg = "Invalid array schema pointer";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  // Set coordinates layout
+  tiledb_array_schema->coords_layout_ = coords_layout;
+
   // Success
   return TILEDB_OK;
 }
@@ -407,6 +520,11 @@ int tiledb_array_create(
   array_schema_c.cell_order_ = array_schema->cell_order_;
   array_schema_c.cell_val_num_ = array_schema->cell_val_num_;
   array_schema_c.compression_ = array_schema->compression_;
+  array_schema_c.coords_layout_ = array_schema->coords_layout_;
+  array_schema_c.compression_level_ = array_schema->compression_level_;
+  array_schema_c.blosc_shuffle_ = array_schema->blosc_shuffle_;
+  array_schema_c.blosc_typesize_ = array_schema->blosc_typesize_;
+  array_schema_c.filter_ = array_schema->filter_;
   array_schema_c.dense_ = array_schema->dense_;
   array_schema_c.dimensions_ = array_schema->dimensions_;
   array_schema_c.dim_num_ = array_schema->dim_num_;
@@ -471,6 +589,52 @@ int tiledb_array_init(
   }
 }
 
+int tiledb_array_init_snapshot(
+    const TileDB_CTX* tiledb_ctx,
+    TileDB_Array** tiledb_array,
+    const char* array,
+    int mode,
+    const void* subarray,
+    const char** attributes,
+    int attribute_num) {
+  // Sanity check
+  if(!sanity_check(tiledb_ctx))
+    return TILEDB_ERR;
+
+  // Check array name length
+  if(array == NULL || strlen(array) > TILEDB_NAME_MAX_LEN) {
+    std::string errmsg = "Invalid array name length";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  // Allocate memory for the array struct
+  *tiledb_array = (TileDB_Array*) malloc(sizeof(struct TileDB_Array));
+
+  // Set TileDB context
+  (*tiledb_array)->tiledb_ctx_ = tiledb_ctx;
+
+  // Init the array on its shared snapshot
+  int rc = tiledb_ctx->storage_manager_->array_init(
+               (*tiledb_array)->array_,
+               array,
+               mode, 
+               subarray, 
+               attributes,
+               attribute_num,
+               true);
+
+  // Return
+  if(rc != TILEDB_SM_OK) {
+    free(*tiledb_array);
+    strcpy(tiledb_errmsg, tiledb_sm_errmsg.c_str());
+    return TILEDB_ERR; 
+  } else {
+    return TILEDB_OK;
+  }
+}
+
 int tiledb_array_reset_subarray(
     const TileDB_Array* tiledb_array,
     const void* subarray) {
@@ -488,6 +652,24 @@ int tiledb_array_reset_subarray(
   return TILEDB_OK;
 }
 
+int tiledb_array_reset_ranges(
+    const TileDB_Array* tiledb_array,
+    const void* ranges,
+    int range_num) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Reset ranges
+  if(tiledb_array->array_->reset_ranges(ranges, range_num) != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int tiledb_array_reset_attributes(
     const TileDB_Array* tiledb_array,
     const char** attributes, 
@@ -507,6 +689,111 @@ int tiledb_array_reset_attributes(
   return TILEDB_OK;
 }
 
+int tiledb_array_set_dictionary_codes(
+    const TileDB_Array* tiledb_array,
+    int dictionary_codes) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Set dictionary codes
+  if(tiledb_array->array_->set_dictionary_codes(dictionary_codes != 0) != 
+     TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_get_dictionary_code(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    const void* value,
+    size_t value_size,
+    int* code) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Get attribute id
+  int attribute_id = 
+      tiledb_array->array_->array_schema()->attribute_id(attribute);
+  if(attribute_id == TILEDB_AS_ERR) {
+    strcpy(tiledb_errmsg, tiledb_as_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Get dictionary code
+  if(tiledb_array->array_->dictionary_code(
+         attribute_id, 
+         value, 
+         value_size, 
+         *code) != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_add_predicate(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    int op,
+    const void* value) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Add predicate
+  if(tiledb_array->array_->add_predicate(attribute, op, value) != 
+     TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_clear_predicates(const TileDB_Array* tiledb_array) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Clear predicates
+  if(tiledb_array->array_->clear_predicates() != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_aggregate(
+    const TileDB_Array* tiledb_array,
+    const char* attribute,
+    int aggregate,
+    void* result) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Compute aggregate
+  if(tiledb_array->array_->aggregate(attribute, aggregate, result) != 
+     TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int tiledb_array_get_schema(
     const TileDB_Array* tiledb_array,
     TileDB_ArraySchema* tiledb_array_schema) {
@@ -526,6 +813,11 @@ int tiledb_array_get_schema(
   tiledb_array_schema->cell_order_ = array_schema_c.cell_order_;
   tiledb_array_schema->cell_val_num_ = array_schema_c.cell_val_num_;
   tiledb_array_schema->compression_ = array_schema_c.compression_;
+  tiledb_array_schema->coords_layout_ = array_schema_c.coords_layout_;
+  tiledb_array_schema->compression_level_ = array_schema_c.compression_level_;
+  tiledb_array_schema->blosc_shuffle_ = array_schema_c.blosc_shuffle_;
+  tiledb_array_schema->blosc_typesize_ = array_schema_c.blosc_typesize_;
+  tiledb_array_schema->filter_ = array_schema_c.filter_;
   tiledb_array_schema->dense_ = array_schema_c.dense_;
   tiledb_array_schema->dimensions_ = array_schema_c.dimensions_;
   tiledb_array_schema->dim_num_ = array_schema_c.dim_num_;
@@ -572,6 +864,11 @@ int tiledb_array_load_schema(
   tiledb_array_schema->cell_order_ = array_schema_c.cell_order_;
   tiledb_array_schema->cell_val_num_ = array_schema_c.cell_val_num_;
   tiledb_array_schema->compression_ = array_schema_c.compression_;
+  tiledb_array_schema->coords_layout_ = array_schema_c.coords_layout_;
+  tiledb_array_schema->compression_level_ = array_schema_c.compression_level_;
+  tiledb_array_schema->blosc_shuffle_ = array_schema_c.blosc_shuffle_;
+  tiledb_array_schema->blosc_typesize_ = array_schema_c.blosc_typesize_;
+  tiledb_array_schema->filter_ = array_schema_c.filter_;
   tiledb_array_schema->dense_ = array_schema_c.dense_;
   tiledb_array_schema->dimensions_ = array_schema_c.dimensions_;
   tiledb_array_schema->dim_num_ = array_schema_c.dim_num_;
@@ -629,6 +926,18 @@ int tiledb_array_free_schema(
   if(tiledb_array_schema->compression_ != NULL)
     free(tiledb_array_schema->compression_);
 
+  // Free compression parameters
+  if(tiledb_array_schema->compression_level_ != NULL)
+    free(tiledb_array_schema->compression_level_);
+  if(tiledb_array_schema->blosc_shuffle_ != NULL)
+    free(tiledb_array_schema->blosc_shuffle_);
+  if(tiledb_array_schema->blosc_typesize_ != NULL)
+    free(tiledb_array_schema->blosc_typesize_);
+
+  // Free filter
+  if(tiledb_array_schema->filter_ != NULL)
+    free(tiledb_array_schema->filter_);
+
   // Free cell val num
   if(tiledb_array_schema->cell_val_num_ != NULL)
     free(tiledb_array_schema->cell_val_num_);
@@ -637,6 +946,24 @@ int tiledb_array_free_schema(
   return TILEDB_OK;
 }
 
+int tiledb_array_set_skip_empty_tiles(
+    const TileDB_Array* tiledb_array,
+    int skip_empty_tiles) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Set skipping empty tiles
+  if(tiledb_array->array_->set_skip_empty_tiles(skip_empty_tiles != 0) != 
+     TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR; 
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int tiledb_array_write(
     const TileDB_Array* tiledb_array,
     const void** buffers,
@@ -655,6 +982,46 @@ int tiledb_array_write(
   return TILEDB_OK;
 }
 
+int tiledb_array_estimate_buffer_sizes(
+    const TileDB_Array* tiledb_array,
+    size_t* buffer_sizes) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Estimate
+  if(tiledb_array->array_->estimate_buffer_sizes(buffer_sizes) != 
+     TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_partition_subarray(
+    const TileDB_Array* tiledb_array,
+    int partition_num,
+    void* partitions,
+    int* result_num) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Partition
+  if(tiledb_array->array_->partition_subarray(
+         partition_num, 
+         partitions, 
+         result_num) != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int tiledb_array_read(
     const TileDB_Array* tiledb_array,
     void** buffers,
@@ -673,6 +1040,52 @@ int tiledb_array_read(
   return TILEDB_OK;
 }
 
+int tiledb_array_read_ranges(
+    const TileDB_Array* tiledb_array,
+    void** buffers,
+    size_t* buffer_sizes,
+    int64_t* range_offsets,
+    int64_t* range_cell_nums) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Read
+  if(tiledb_array->array_->read_ranges(
+         buffers, 
+         buffer_sizes, 
+         range_offsets, 
+         range_cell_nums) != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_array_read_validity(
+    const TileDB_Array* tiledb_array,
+    void** buffers,
+    size_t* buffer_sizes,
+    unsigned char** validity) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+  // Read
+  if(tiledb_array->array_->read_validity(
+         buffers, 
+         buffer_sizes, 
+         validity) != TILEDB_AR_OK) {
+    strcpy(tiledb_errmsg, tiledb_ar_errmsg.c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int tiledb_array_overflow(
     const TileDB_Array* tiledb_array,
     int attribute_id) {
@@ -684,6 +1097,38 @@ int tiledb_array_overflow(
   return (int) tiledb_array->array_->overflow(attribute_id);
 }
 
+int tiledb_array_stats_dump(
+    const TileDB_Array* tiledb_array,
+    FILE* out) {
+  // Sanity check
+  if(!sanity_check(tiledb_array))
+    return TILEDB_ERR;
+
+#ifdef TILEDB_STATS
+  // Collect the statistics of the array and its clone
+  Stats stats;
+  tiledb_array->array_->stats_collect(stats);
+
+  // Dump
+  if(fputs(stats.to_json().c_str(), out) == EOF) {
+    std::string errmsg = "Cannot dump array statistics; Write error";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+#else
+  // Error: statistics not supported
+  std::string errmsg = 
+      "Cannot dump array statistics; TileDB not compiled with TILEDB_STATS";
+  PRINT_ERROR(errmsg);
+  strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+  return TILEDB_ERR;
+#endif
+}
+
 int tiledb_array_consolidate(
     const TileDB_CTX* tiledb_ctx,
     const char* array) {
@@ -704,6 +1149,22 @@ int tiledb_array_consolidate(
     return TILEDB_OK;
 }
 
+int tiledb_array_refresh(
+    const TileDB_CTX* tiledb_ctx,
+    const char* array) {
+  // Sanity check
+  if(!sanity_check(tiledb_ctx))
+    return TILEDB_ERR;
+
+  // Refresh
+  if(tiledb_ctx->storage_manager_->array_refresh(array) != TILEDB_SM_OK) {
+    strcpy(tiledb_errmsg, tiledb_sm_errmsg.c_str());
+    return TILEDB_ERR;
+  }
+  else 
+    return TILEDB_OK;
+}
+
 int tiledb_array_finalize(TileDB_Array* tiledb_array) {
   // Sanity check
   if(!sanity_check(tiledb_array) ||
@@ -1562,6 +2023,49 @@ int tiledb_ls_c(
   return TILEDB_OK;
 }
 
+int tiledb_ctx_stat_saved_num(
+    const TileDB_CTX* tiledb_ctx,
+    int64_t* stat_saved_num) {
+  // Sanity check
+  if(!sanity_check(tiledb_ctx))
+    return TILEDB_ERR;
+
+  // Get the number of saved stat calls
+  *stat_saved_num = tiledb_ctx->storage_manager_->stat_saved_num();
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_ctx_stats_dump(
+    const TileDB_CTX* tiledb_ctx,
+    FILE* out) {
+  // Sanity check
+  if(!sanity_check(tiledb_ctx))
+    return TILEDB_ERR;
+
+#ifdef TILEDB_STATS
+  // Dump
+  const Stats& stats = tiledb_ctx->storage_manager_->stats();
+  if(fputs(stats.to_json().c_str(), out) == EOF) {
+    std::string errmsg = "Cannot dump context statistics; Write error";
+    PRINT_ERROR(errmsg);
+    strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+#else
+  // Error: statistics not supported
+  std::string errmsg = 
+      "Cannot dump context statistics; TileDB not compiled with TILEDB_STATS";
+  PRINT_ERROR(errmsg);
+  strcpy(tiledb_errmsg, (TILEDB_ERRMSG + errmsg).c_str());
+  return TILEDB_ERR;
+#endif
+}
+
 
 
 /* ****************************** */
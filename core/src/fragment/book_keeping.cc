@@ -33,6 +33,7 @@
 #include "book_keeping.h"
 #include "utils.h"
 #include <cassert>
+#include <bitset>
 #include <cstring>
 #include <fcntl.h>
 #include <iostream>
@@ -59,7 +60,7 @@
 /*        GLOBAL VARIABLES        */
 /* ****************************** */
 
-std::string tiledb_bk_errmsg = "";
+thread_local std::string tiledb_bk_errmsg = "";
 
 
 
@@ -79,6 +80,7 @@ BookKeeping::BookKeeping(
       mode_(mode) {
   domain_ = NULL;
   non_empty_domain_ = NULL;
+  tile_presence_num_ = 0;
 }
 
 BookKeeping::~BookKeeping() {
@@ -147,9 +149,33 @@ bool BookKeeping::read_mode() const {
   return array_read_mode(mode_);
 }
 
+int64_t BookKeeping::stored_tile_pos(int64_t tile_pos) const {
+  // All tiles are stored
+  if(tile_presence_.empty())
+    return tile_pos;
+
+  // Tiles beyond the bitmap are all stored
+  if(tile_pos >= tile_presence_num_)
+    return present_tile_num() + tile_pos - tile_presence_num_;
+
+  // Absent tile
+  int64_t word = tile_pos / 64;
+  uint64_t bit = uint64_t(1) << (tile_pos % 64);
+  if(!(tile_presence_[word] & bit))
+    return -1;
+
+  // Count the stored tiles before the input tile
+  return tile_presence_ranks_[word] + 
+         std::bitset<64>(tile_presence_[word] & (bit - 1)).count();
+}
+
 int64_t BookKeeping::tile_num() const {
   if(dense_) {
-    return array_schema_->tile_num(domain_);
+    if(tile_presence_.empty())
+      return array_schema_->tile_num(domain_);
+    else
+      return present_tile_num() + 
+             array_schema_->tile_num(domain_) - tile_presence_num_;
   } else { 
     return mbrs_.size();
   }
@@ -172,6 +198,36 @@ bool BookKeeping::write_mode() const {
   return array_write_mode(mode_);
 }
 
+const void* BookKeeping::zone_map(int attribute_id, int64_t tile_pos) const {
+  // For easy reference
+  size_t zone_map_size = this->zone_map_size(attribute_id);
+
+  // No zone map
+  if(zone_map_size == 0 ||
+     int64_t(zone_maps_[attribute_id].size()) <= tile_pos * 
+                                                int64_t(zone_map_size))
+    return NULL;
+
+  return &zone_maps_[attribute_id][tile_pos * zone_map_size];
+}
+
+size_t BookKeeping::zone_map_size(int attribute_id) const {
+  // Applicable only to compressed, fixed-sized numeric attributes
+  if(attribute_id < 0 || 
+     attribute_id >= array_schema_->attribute_num() ||
+     array_schema_->var_size(attribute_id) ||
+     array_schema_->compression(attribute_id) == TILEDB_NO_COMPRESSION)
+    return 0;
+
+  int type = array_schema_->type(attribute_id);
+  if(type != TILEDB_INT32 && type != TILEDB_INT64 &&
+     type != TILEDB_FLOAT32 && type != TILEDB_FLOAT64)
+    return 0;
+
+  // Minimum, maximum, number of non-empty and empty values
+  return 2*array_schema_->type_size(attribute_id) + 2*sizeof(int64_t);
+}
+
 
 
 
@@ -207,6 +263,20 @@ void BookKeeping::append_tile_offset(
   next_tile_offsets_[attribute_id] = new_offset;  
 }
 
+void BookKeeping::append_tile_presence(bool present) {
+  // Start a new word
+  if(tile_presence_num_ % 64 == 0) {
+    tile_presence_ranks_.push_back(
+        tile_presence_.empty() ? 0 : present_tile_num());
+    tile_presence_.push_back(0);
+  }
+
+  // Set the bit of the tile
+  if(present)
+    tile_presence_.back() |= uint64_t(1) << (tile_presence_num_ % 64);
+  ++tile_presence_num_;
+}
+
 void BookKeeping::append_tile_var_offset(
     int attribute_id,
     size_t step) {
@@ -222,6 +292,16 @@ void BookKeeping::append_tile_var_size(
   tile_var_sizes_[attribute_id].push_back(size);
 }
 
+void BookKeeping::append_zone_map(
+    int attribute_id,
+    const void* zone_map) {
+  const char* zone_map_c = static_cast<const char*>(zone_map);
+  zone_maps_[attribute_id].insert(
+      zone_maps_[attribute_id].end(),
+      zone_map_c,
+      zone_map_c + zone_map_size(attribute_id));
+}
+
 /* FORMAT:
  * non_empty_domain_size(size_t) non_empty_domain(void*)  
  * mbr_num(int64_t)
@@ -247,6 +327,12 @@ void BookKeeping::append_tile_var_size(
  * tile_var_sizes__attr#<attribute_num-1>_#1(size_t) 
  *     tile_var_sizes_attr#<attribute_num-1>_#2 (size_t) ...
  * last_tile_cell_num(int64_t)
+ * zone_maps_attr#0_size(int64_t) zone_maps_attr#0(void*)
+ * ...
+ * zone_maps_attr#<attribute_num-1>_size(int64_t) 
+ *     zone_maps_attr#<attribute_num-1>(void*)
+ * tile_presence_num(int64_t)
+ * tile_presence_word_#1(uint64_t) tile_presence_word_#2(uint64_t) ...
  */
 int BookKeeping::finalize() {
   // Nothing to do in READ mode
@@ -299,6 +385,14 @@ int BookKeeping::finalize() {
   if(flush_last_tile_cell_num(fd) != TILEDB_BK_OK)
     return TILEDB_BK_ERR;
 
+  // Write zone maps
+  if(flush_zone_maps(fd) != TILEDB_BK_OK)
+    return TILEDB_BK_ERR;
+
+  // Write tile presence bitmap
+  if(flush_tile_presence(fd) != TILEDB_BK_OK)
+    return TILEDB_BK_ERR;
+
   // Close file
   if(gzclose(fd) != Z_OK) {
     std::string errmsg = "Cannot finalize book-keeping; Cannot close file";
@@ -350,6 +444,9 @@ int BookKeeping::init(const void* non_empty_domain) {
   // Initialize variable tile sizes
   tile_var_sizes_.resize(attribute_num);
 
+  // Initialize zone maps
+  zone_maps_.resize(attribute_num);
+
   // Success
   return TILEDB_BK_OK;
 }
@@ -379,6 +476,12 @@ int BookKeeping::init(const void* non_empty_domain) {
  * tile_var_sizes__attr#<attribute_num-1>_#1(size_t) 
  *     tile_var_sizes_attr#<attribute_num-1>_#2 (size_t) ...
  * last_tile_cell_num(int64_t)
+ * zone_maps_attr#0_size(int64_t) zone_maps_attr#0(void*)
+ * ...
+ * zone_maps_attr#<attribute_num-1>_size(int64_t) 
+ *     zone_maps_attr#<attribute_num-1>(void*)
+ * tile_presence_num(int64_t)
+ * tile_presence_word_#1(uint64_t) tile_presence_word_#2(uint64_t) ...
  */
 int BookKeeping::load() {
   // Prepare file name
@@ -423,6 +526,14 @@ int BookKeeping::load() {
   if(load_last_tile_cell_num(fd) != TILEDB_BK_OK)
     return TILEDB_BK_ERR;
 
+  // Load zone maps
+  if(load_zone_maps(fd) != TILEDB_BK_OK)
+    return TILEDB_BK_ERR;
+
+  // Load tile presence bitmap
+  if(load_tile_presence(fd) != TILEDB_BK_OK)
+    return TILEDB_BK_ERR;
+
   // Close file
   if(gzclose(fd) != Z_OK) {
     std::string errmsg = "Cannot load book-keeping; Cannot close file";
@@ -613,6 +724,43 @@ int BookKeeping::flush_tile_offsets(gzFile fd) const {
   return TILEDB_BK_OK;
 }
 
+/* FORMAT:
+ * tile_presence_num(int64_t)
+ * tile_presence_word_#1(uint64_t) tile_presence_word_#2(uint64_t) ...
+ */
+int BookKeeping::flush_tile_presence(gzFile fd) const {
+  // The bitmap is omitted if all tiles are stored
+  int64_t tile_presence_num = 
+      (present_tile_num() == tile_presence_num_) ? 0 : tile_presence_num_;
+
+  // Write number of tiles in the bitmap
+  if(gzwrite(fd, &tile_presence_num, sizeof(int64_t)) != sizeof(int64_t)) {
+    std::string errmsg = 
+        "Cannot finalize book-keeping; Writing number of tile presence bits "
+        "failed";
+    PRINT_ERROR(errmsg);
+    tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+    return TILEDB_BK_ERR;
+  }
+
+  if(tile_presence_num == 0)
+    return TILEDB_BK_OK;
+
+  // Write bitmap
+  size_t tile_presence_size = tile_presence_.size() * sizeof(uint64_t);
+  if(gzwrite(fd, &tile_presence_[0], tile_presence_size) != 
+     int(tile_presence_size)) {
+    std::string errmsg = 
+        "Cannot finalize book-keeping; Writing tile presence bitmap failed";
+    PRINT_ERROR(errmsg);
+    tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+    return TILEDB_BK_ERR;
+  }
+
+  // Success
+  return TILEDB_BK_OK;
+}
+
 /* FORMAT:
  * tile_var_offsets_attr#0_num(int64_t)
  * tile_var_offsets_attr#0_#1 (off_t) tile_var_offsets_attr#0_#2 (off_t) ...
@@ -707,6 +855,47 @@ int BookKeeping::flush_tile_var_sizes(gzFile fd) const {
   return TILEDB_BK_OK;
 }
 
+/* FORMAT:
+ * zone_maps_attr#0_size(int64_t) zone_maps_attr#0(void*)
+ * ...
+ * zone_maps_attr#<attribute_num-1>_size(int64_t) 
+ *     zone_maps_attr#<attribute_num-1>(void*)
+ */
+int BookKeeping::flush_zone_maps(gzFile fd) const {
+  // For easy reference
+  int attribute_num = array_schema_->attribute_num();
+  int64_t zone_maps_size;
+
+  // Write zone maps for each attribute
+  for(int i=0; i<attribute_num; ++i) {
+    // Write size of zone maps
+    zone_maps_size = zone_maps_[i].size(); 
+    if(gzwrite(fd, &zone_maps_size, sizeof(int64_t)) != sizeof(int64_t)) {
+      std::string errmsg = 
+          "Cannot finalize book-keeping; Writing size of zone maps failed";
+      PRINT_ERROR(errmsg);
+      tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+      return TILEDB_BK_ERR;
+    }
+
+    if(zone_maps_size == 0)
+      continue;
+
+    // Write zone maps
+    if(gzwrite(fd, &zone_maps_[i][0], zone_maps_size) != 
+       int(zone_maps_size)) {
+      std::string errmsg = 
+          "Cannot finalize book-keeping; Writing zone maps failed";
+      PRINT_ERROR(errmsg);
+      tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+      return TILEDB_BK_ERR;
+    }
+  }
+
+  // Success
+  return TILEDB_BK_OK;
+}
+
 /* FORMAT:
  * bounding_coords_num (int64_t)
  * bounding_coords_#1 (void*) bounding_coords_#2 (void*) ...
@@ -887,6 +1076,54 @@ int BookKeeping::load_tile_offsets(gzFile fd) {
   return TILEDB_BK_OK;
 }
 
+/* FORMAT:
+ * tile_presence_num (int64_t)
+ * tile_presence_word_#1 (uint64_t) tile_presence_word_#2 (uint64_t) ...
+ */
+int BookKeeping::load_tile_presence(gzFile fd) {
+  // Get number of tiles in the bitmap
+  int64_t tile_presence_num;
+  int bytes_read = gzread(fd, &tile_presence_num, sizeof(int64_t));
+  if(bytes_read == 0) // Fragment created before the bitmap
+    return TILEDB_BK_OK;
+  if(bytes_read != sizeof(int64_t)) {
+    std::string errmsg = 
+        "Cannot load book-keeping; Reading number of tile presence bits "
+        "failed";
+    PRINT_ERROR(errmsg);
+    tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+    return TILEDB_BK_ERR;
+  }
+
+  if(tile_presence_num == 0)
+    return TILEDB_BK_OK;
+
+  // Get bitmap
+  int64_t word_num = (tile_presence_num + 63) / 64;
+  size_t tile_presence_size = word_num * sizeof(uint64_t);
+  tile_presence_.resize(word_num);
+  if(gzread(fd, &tile_presence_[0], tile_presence_size) != 
+     int(tile_presence_size)) {
+    std::string errmsg = 
+        "Cannot load book-keeping; Reading tile presence bitmap failed";
+    PRINT_ERROR(errmsg);
+    tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+    return TILEDB_BK_ERR;
+  }
+  tile_presence_num_ = tile_presence_num;
+
+  // Compute the number of stored tiles before each word
+  tile_presence_ranks_.resize(word_num);
+  int64_t rank = 0;
+  for(int64_t i=0; i<word_num; ++i) {
+    tile_presence_ranks_[i] = rank;
+    rank += std::bitset<64>(tile_presence_[i]).count();
+  }
+
+  // Success
+  return TILEDB_BK_OK;
+}
+
 /* FORMAT:
  * tile_var_offsets_attr#0_num (int64_t)
  * tile_var_offsets_attr#0_#1 (off_t) tile_var_offsets_attr#0_#2 (off_t) ...
@@ -986,3 +1223,57 @@ int BookKeeping::load_tile_var_sizes(gzFile fd) {
   // Success
   return TILEDB_BK_OK;
 }
+
+/* FORMAT:
+ * zone_maps_attr#0_size (int64_t) zone_maps_attr#0 (void*)
+ * ...
+ * zone_maps_attr#<attribute_num-1>_size (int64_t) 
+ *     zone_maps_attr#<attribute_num-1> (void*)
+ */
+int BookKeeping::load_zone_maps(gzFile fd) {
+  // For easy reference
+  int attribute_num = array_schema_->attribute_num();
+  int64_t zone_maps_size;
+  int bytes_read;
+
+  // Allocate zone maps
+  zone_maps_.resize(attribute_num);
+
+  // For all attributes, get the zone maps
+  for(int i=0; i<attribute_num; ++i) {
+    // Get size of zone maps 
+    bytes_read = gzread(fd, &zone_maps_size, sizeof(int64_t));
+    if(bytes_read == 0 && i == 0) // Fragment created before zone maps
+      break;
+    if(bytes_read != sizeof(int64_t)) {
+      std::string errmsg = 
+          "Cannot load book-keeping; Reading size of zone maps failed";
+      PRINT_ERROR(errmsg);
+      tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+      return TILEDB_BK_ERR;
+    }
+
+    if(zone_maps_size == 0)
+      continue;
+
+    // Get zone maps
+    zone_maps_[i].resize(zone_maps_size);
+    if(gzread(fd, &zone_maps_[i][0], zone_maps_size) != int(zone_maps_size)) {
+      std::string errmsg = "Cannot load book-keeping; Reading zone maps failed";
+      PRINT_ERROR(errmsg);
+      tiledb_bk_errmsg = TILEDB_BK_ERRMSG + errmsg;
+      return TILEDB_BK_ERR;
+    }
+  }
+
+  // Success
+  return TILEDB_BK_OK;
+}
+
+int64_t BookKeeping::present_tile_num() const {
+  if(tile_presence_.empty())
+    return 0;
+
+  return tile_presence_ranks_.back() + 
+         std::bitset<64>(tile_presence_.back()).count();
+}
@@ -97,6 +97,10 @@ const Array* Fragment::array() const {
   return array_;
 }
 
+BookKeeping* Fragment::book_keeping() const {
+  return book_keeping_;
+}
+
 int64_t Fragment::cell_num_per_tile() const {
   return (dense_) ? array_->array_schema()->cell_num_per_tile() : 
                     array_->array_schema()->capacity(); 
@@ -0,0 +1,218 @@
+/**
+ * @file   fragment_index.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ * 
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file implements the FragmentIndex class.
+ */
+
+#include "fragment_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+
+
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FragmentIndex::FragmentIndex(
+    const ArraySchema* array_schema,
+    const std::vector<BookKeeping*>& book_keeping)
+    : array_schema_(array_schema) {
+  // Initialization
+  fragment_num_ = book_keeping.size();
+  bounds_ = NULL;
+  lows_ = NULL;
+  max_highs_ = NULL;
+
+  // Trivial case
+  if(fragment_num_ == 0)
+    return;
+
+  // Build the index
+  int coords_type = array_schema_->coords_type();
+  if(coords_type == TILEDB_INT32)
+    build<int>(book_keeping);
+  else if(coords_type == TILEDB_INT64)
+    build<int64_t>(book_keeping);
+  else if(coords_type == TILEDB_FLOAT32)
+    build<float>(book_keeping);
+  else if(coords_type == TILEDB_FLOAT64)
+    build<double>(book_keeping);
+  else 
+    assert(0);
+}
+
+FragmentIndex::~FragmentIndex() {
+  if(bounds_ != NULL)
+    free(bounds_);
+  if(lows_ != NULL)
+    free(lows_);
+  if(max_highs_ != NULL)
+    free(max_highs_);
+}
+
+
+
+
+/* ****************************** */
+/*           ACCESSORS            */
+/* ****************************** */
+
+int FragmentIndex::fragment_num() const {
+  return fragment_num_;
+}
+
+void FragmentIndex::overlapping_fragments(
+    const void* subarray,
+    std::vector<int>& fragment_ids) const {
+  // Initialization
+  fragment_ids.clear();
+
+  // Trivial case
+  if(fragment_num_ == 0)
+    return;
+
+  // Invoke the proper templated function
+  int coords_type = array_schema_->coords_type();
+  if(coords_type == TILEDB_INT32)
+    overlapping_fragments(static_cast<const int*>(subarray), fragment_ids);
+  else if(coords_type == TILEDB_INT64)
+    overlapping_fragments(static_cast<const int64_t*>(subarray), fragment_ids);
+  else if(coords_type == TILEDB_FLOAT32)
+    overlapping_fragments(static_cast<const float*>(subarray), fragment_ids);
+  else if(coords_type == TILEDB_FLOAT64)
+    overlapping_fragments(static_cast<const double*>(subarray), fragment_ids);
+  else 
+    assert(0);
+}
+
+
+
+
+/* ****************************** */
+/*        PRIVATE METHODS         */
+/* ****************************** */
+
+template<class T>
+void FragmentIndex::build(const std::vector<BookKeeping*>& book_keeping) {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  size_t domain_size = 2*array_schema_->coords_size();
+  const void* array_domain = array_schema_->domain();
+
+  // Compute the bounding box of each fragment
+  bounds_ = malloc(fragment_num_*domain_size);
+  T* bounds = static_cast<T*>(bounds_);
+  for(int i=0; i<fragment_num_; ++i) {
+    T* fragment_bounds = &bounds[i*2*dim_num];
+
+    // Dense fragments are bounded by their non-empty domain, whereas sparse
+    // fragments by the union of their MBRs
+    const std::vector<void*>& mbrs = book_keeping[i]->mbrs();
+    int64_t mbr_num = mbrs.size();
+    if(!book_keeping[i]->dense() && mbr_num > 0) {
+      memcpy(fragment_bounds, mbrs[0], domain_size);
+      for(int64_t j=1; j<mbr_num; ++j) {
+        const T* mbr = static_cast<const T*>(mbrs[j]);
+        for(int d=0; d<dim_num; ++d) {
+          if(mbr[2*d] < fragment_bounds[2*d])
+            fragment_bounds[2*d] = mbr[2*d];
+          if(mbr[2*d+1] > fragment_bounds[2*d+1])
+            fragment_bounds[2*d+1] = mbr[2*d+1];
+        }
+      }
+    } else if(book_keeping[i]->non_empty_domain() != NULL) {
+      memcpy(fragment_bounds, book_keeping[i]->non_empty_domain(), domain_size);
+    } else {
+      memcpy(fragment_bounds, array_domain, domain_size);
+    }
+  }
+
+  // Sort the fragments on the lower bound of the first dimension
+  std::vector<std::pair<T, int> > sorted_lows;
+  sorted_lows.reserve(fragment_num_);
+  for(int i=0; i<fragment_num_; ++i)
+    sorted_lows.push_back(std::pair<T, int>(bounds[i*2*dim_num], i));
+  std::sort(sorted_lows.begin(), sorted_lows.end());
+
+  // Store the sorted lower bounds and the running maximum upper bounds
+  lows_ = malloc(fragment_num_*sizeof(T));
+  max_highs_ = malloc(fragment_num_*sizeof(T));
+  T* lows = static_cast<T*>(lows_);
+  T* max_highs = static_cast<T*>(max_highs_);
+  order_.resize(fragment_num_);
+  for(int i=0; i<fragment_num_; ++i) {
+    int fragment_id = sorted_lows[i].second;
+    T high = bounds[fragment_id*2*dim_num+1];
+    order_[i] = fragment_id;
+    lows[i] = sorted_lows[i].first;
+    max_highs[i] = (i == 0) ? high : std::max(max_highs[i-1], high);
+  }
+}
+
+template<class T>
+void FragmentIndex::overlapping_fragments(
+    const T* subarray,
+    std::vector<int>& fragment_ids) const {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* bounds = static_cast<const T*>(bounds_);
+  const T* lows = static_cast<const T*>(lows_);
+  const T* max_highs = static_cast<const T*>(max_highs_);
+
+  // The candidates start after the last position whose running maximum upper
+  // bound precedes the subarray, and end at the first lower bound that 
+  // follows the subarray on the first dimension
+  int last = 
+      std::upper_bound(lows, lows + fragment_num_, subarray[1]) - lows;
+  int first = 
+      std::lower_bound(max_highs, max_highs + last, subarray[0]) - max_highs;
+
+  // Check the candidates on all dimensions
+  for(int i=first; i<last; ++i) {
+    const T* fragment_bounds = &bounds[order_[i]*2*dim_num];
+    bool overlap = true;
+    for(int d=0; d<dim_num; ++d) {
+      if(fragment_bounds[2*d] > subarray[2*d+1] || 
+         fragment_bounds[2*d+1] < subarray[2*d]) {
+        overlap = false;
+        break;
+      }
+    }
+    if(overlap)
+      fragment_ids.push_back(order_[i]);
+  }
+
+  // Restore the order of the fragments
+  std::sort(fragment_ids.begin(), fragment_ids.end());
+}
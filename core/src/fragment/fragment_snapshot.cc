@@ -0,0 +1,99 @@
+/**
+ * @file   fragment_snapshot.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ * 
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file implements the FragmentSnapshot class.
+ */
+
+#include "fragment_snapshot.h"
+#include <cassert>
+
+
+
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FragmentSnapshot::FragmentSnapshot(
+    const ArraySchema* array_schema,
+    const std::vector<std::string>& fragment_names,
+    const std::vector<BookKeeping*>& book_keeping)
+    : book_keeping_(book_keeping),
+      fragment_names_(fragment_names) {
+  // Sanity check
+  assert(fragment_names.size() == book_keeping.size());
+
+  cnt_ = 1;
+  fragment_index_ = new FragmentIndex(array_schema, book_keeping);
+}
+
+FragmentSnapshot::~FragmentSnapshot() {
+  delete fragment_index_;
+}
+
+
+
+
+/* ****************************** */
+/*           ACCESSORS            */
+/* ****************************** */
+
+const std::vector<BookKeeping*>& FragmentSnapshot::book_keeping() const {
+  return book_keeping_;
+}
+
+const FragmentIndex* FragmentSnapshot::fragment_index() const {
+  return fragment_index_;
+}
+
+const std::vector<std::string>& FragmentSnapshot::fragment_names() const {
+  return fragment_names_;
+}
+
+int FragmentSnapshot::fragment_num() const {
+  return fragment_names_.size();
+}
+
+
+
+
+/* ****************************** */
+/*            MUTATORS            */
+/* ****************************** */
+
+int FragmentSnapshot::acquire() {
+  return ++cnt_;
+}
+
+int FragmentSnapshot::release() {
+  // Sanity check
+  assert(cnt_ > 0);
+
+  return --cnt_;
+}
@@ -40,6 +40,7 @@
 #include <fcntl.h>
 #include <iostream>
 #include <lz4.h>
+#include <pthread.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -65,7 +66,10 @@
 /*        GLOBAL VARIABLES        */
 /* ****************************** */
 
-std::string tiledb_rs_errmsg = "";
+thread_local std::string tiledb_rs_errmsg = "";
+
+/** Serializes the Blosc decompressions, since Blosc has global state. */
+static pthread_mutex_t blosc_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 
 
@@ -82,8 +86,12 @@ ReadState::ReadState(
   array_ = fragment_->array();
   array_schema_ = array_->array_schema();
   attribute_num_ = array_schema_->attribute_num();
+  cell_bitmap_ = NULL;
+  cell_bitmap_allocated_size_ = 0;
   coords_size_ = array_schema_->coords_size();
 
+  dictionaries_.resize(attribute_num_);
+  dictionary_sizes_.resize(attribute_num_);
   done_ = false;
   fetched_tile_.resize(attribute_num_+2);
   overflow_.resize(attribute_num_+1);
@@ -94,10 +102,17 @@ ReadState::ReadState(
   map_addr_compressed_length_ = 0;
   map_addr_var_.resize(attribute_num_);
   map_addr_var_lengths_.resize(attribute_num_);
+  predicate_read_state_ = NULL;
   search_tile_overlap_subarray_ = malloc(2*coords_size_);
   search_tile_pos_ = -1;
+  tile_cache_num_ = 0;
+  tile_codes_ = NULL;
+  tile_codes_allocated_size_ = 0;
+  tile_columnar_ = NULL;
+  tile_columnar_allocated_size_ = 0;
   tile_compressed_ = NULL;
   tile_compressed_allocated_size_ = 0;
+  tile_use_num_ = 0;
   tiles_.resize(attribute_num_+2);
   tiles_offsets_.resize(attribute_num_+2);
   tiles_file_offsets_.resize(attribute_num_+2);
@@ -108,8 +123,12 @@ ReadState::ReadState(
   tiles_var_sizes_.resize(attribute_num_);
   tiles_var_allocated_size_.resize(attribute_num_);
   tmp_coords_ = malloc(coords_size_);
+  values_ = NULL;
+  values_allocated_size_ = 0;
 
   for(int i=0; i<attribute_num_; ++i) {
+    dictionaries_[i] = NULL;
+    dictionary_sizes_[i] = 0;
     map_addr_var_[i] = NULL;
     map_addr_var_lengths_[i] = 0;
     tiles_var_[i] = NULL;
@@ -162,6 +181,29 @@ ReadState::~ReadState() {
   if(map_addr_compressed_ == NULL && tile_compressed_ != NULL)
     free(tile_compressed_);
 
+  if(tile_codes_ != NULL)
+    free(tile_codes_);
+
+  if(cell_bitmap_ != NULL)
+    free(cell_bitmap_);
+
+  if(predicate_read_state_ != NULL)
+    delete predicate_read_state_;
+
+  for(int i=0; i<int(prefetch_read_states_.size()); ++i) 
+    delete prefetch_read_states_[i];
+
+  if(values_ != NULL)
+    free(values_);
+
+  if(tile_columnar_ != NULL)
+    free(tile_columnar_);
+
+  for(int i=0; i<int(dictionaries_.size()); ++i) {
+    if(dictionaries_[i] != NULL)
+      free(dictionaries_[i]);
+  }
+
   for(int i=0; i<int(map_addr_.size()); ++i) {
     if(map_addr_[i] != NULL && munmap(map_addr_[i], map_addr_lengths_[i])) {
       std::string errmsg = 
@@ -231,6 +273,18 @@ bool ReadState::subarray_area_covered() const {
   return subarray_area_covered_;
 }
 
+bool ReadState::tile_fetched(int attribute_id, int64_t tile_i) const {
+  if(fetched_tile_[attribute_id] == tile_i)
+    return true;
+
+  int prefetch_num = prefetch_read_states_.size();
+  for(int i=0; i<prefetch_num; ++i) 
+    if(prefetch_read_states_[i]->fetched_tile_[attribute_id] == tile_i)
+      return true;
+
+  return false;
+}
+
 
 
 
@@ -261,6 +315,10 @@ void ReadState::reset_overflow() {
     overflow_[i] = false;
 }
 
+void ReadState::set_tile_cache_num(int tile_cache_num) {
+  tile_cache_num_ = tile_cache_num;
+}
+
 
 
 
@@ -268,6 +326,119 @@ void ReadState::reset_overflow() {
 /*             MISC               */
 /* ****************************** */
 
+template<class T, class S>
+int ReadState::aggregate(
+    int attribute_id,
+    int aggregate,
+    T empty_value,
+    int64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    int64_t& count,
+    S& sum,
+    T& min,
+    T& max) {
+  // Trivial case
+  if(is_empty_attribute(attribute_id))
+    return TILEDB_RS_OK;
+
+  // For easy reference
+  int64_t start_pos = cell_pos_range.first;
+  int64_t cell_num = cell_pos_range.second - start_pos + 1;
+
+  // Use the zone map if the range covers the entire tile
+  const void* zone_map = 
+      (aggregate != TILEDB_SUM && 
+       start_pos == 0 && 
+       cell_num == book_keeping_->cell_num(tile_i)) 
+          ? book_keeping_->zone_map(attribute_id, tile_i) 
+          : NULL;
+  if(zone_map != NULL) {
+    T zone_map_min, zone_map_max;
+    int64_t non_empty_num;
+    const char* zone_map_c = static_cast<const char*>(zone_map);
+    memcpy(&zone_map_min, zone_map_c, sizeof(T));
+    memcpy(&zone_map_max, zone_map_c + sizeof(T), sizeof(T));
+    memcpy(&non_empty_num, zone_map_c + 2*sizeof(T), sizeof(int64_t));
+    if(non_empty_num != 0) {
+      count += non_empty_num;
+      if(zone_map_min < min)
+        min = zone_map_min;
+      if(zone_map_max > max)
+        max = zone_map_max;
+    }
+    return TILEDB_RS_OK;
+  }
+
+  // Prepare attribute tile
+  if(prepare_tile_for_reading(attribute_id, tile_i) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+
+  // Get the values
+  const void* values;
+  if(get_values(attribute_id, start_pos, cell_num, values) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+
+  // Aggregate the values
+  cells_aggregate<T, S>(
+      static_cast<const T*>(values), 
+      cell_num, 
+      empty_value, 
+      count, 
+      sum, 
+      min, 
+      max);
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
+void ReadState::assign_prefetch_tiles(
+    int attribute_id,
+    const std::vector<int64_t>& tiles,
+    std::vector<std::pair<int, int64_t> >& tasks) {
+  // Trivial case - only decompressed tiles can be taken over
+  if(is_empty_attribute(attribute_id) ||
+     array_schema_->compression(attribute_id) == TILEDB_NO_COMPRESSION)
+    return;
+
+  // Create the missing prefetching read states
+  int tile_num = tiles.size();
+  create_prefetch_read_states(tile_num);
+  int prefetch_num = prefetch_read_states_.size();
+
+  // Keep the tiles that are already in main memory
+  std::vector<bool> tile_fetched(tile_num, false);
+  std::vector<bool> prefetch_busy(prefetch_num, false);
+  for(int i=0; i<tile_num; ++i) {
+    if(fetched_tile_[attribute_id] == tiles[i]) {
+      tile_fetched[i] = true;
+      continue;
+    }
+    for(int j=0; j<prefetch_num; ++j) {
+      if(!prefetch_busy[j] && 
+         prefetch_read_states_[j]->fetched_tile_[attribute_id] == tiles[i]) {
+        prefetch_busy[j] = true;
+        prefetch_tile_uses_[j][attribute_id] = ++tile_use_num_;
+        tile_fetched[i] = true;
+        break;
+      }
+    }
+  }
+
+  // Assign the rest of the tiles to the free prefetching read states,
+  // discarding the least recently used tiles first
+  for(int i=0; i<tile_num; ++i) {
+    if(tile_fetched[i])
+      continue;
+    int j = least_recently_used_prefetch_read_state(
+                attribute_id, 
+                prefetch_busy);
+    prefetch_busy[j] = true;
+    prefetch_tile_uses_[j][attribute_id] = ++tile_use_num_;
+    tasks.push_back(std::pair<int, int64_t>(j, tiles[i]));
+  }
+}
+
 int ReadState::copy_cells(
     int attribute_id,
     int tile_i,
@@ -457,6 +628,190 @@ int ReadState::copy_cells_var(
   return TILEDB_RS_OK;
 }
 
+int ReadState::dictionary_code(
+    int attribute_id,
+    const void* value,
+    size_t value_size,
+    int& code) {
+  // Load dictionary
+  if(load_dictionary(attribute_id) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+
+  // For easy reference
+  const char* dictionary = static_cast<const char*>(dictionaries_[attribute_id]);
+  int64_t entry_num;
+  memcpy(&entry_num, dictionary, sizeof(int64_t));
+  const size_t* entry_offsets = 
+      reinterpret_cast<const size_t*>(dictionary + sizeof(int64_t));
+  const char* values = dictionary + sizeof(int64_t) + entry_num*sizeof(size_t);
+  size_t values_size = dictionary_sizes_[attribute_id] - (values - dictionary);
+
+  // Look up value
+  size_t entry_size;
+  code = -1;
+  for(int64_t i=0; i<entry_num; ++i) {
+    entry_size = (i == entry_num-1) ? values_size - entry_offsets[i]
+                                    : entry_offsets[i+1] - entry_offsets[i];
+    if(entry_size == value_size &&
+       !memcmp(values + entry_offsets[i], value, value_size)) {
+      code = i;
+      break;
+    }
+  }
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
+int ReadState::estimate_result_size(
+    int64_t& cell_num, 
+    std::vector<size_t>& var_sizes) {
+  // For easy reference
+  int coords_type = array_schema_->coords_type();
+  const std::vector<int>& attribute_ids = array_->attribute_ids();
+  int attribute_id_num = attribute_ids.size();
+  const std::vector<std::vector<size_t> >& tile_var_sizes = 
+      book_keeping_->tile_var_sizes();
+
+  // Find the tiles overlapping the subarray
+  std::vector<int64_t> tiles;
+  if(fragment_->dense()) {
+    if(coords_type == TILEDB_INT32) 
+      get_overlapping_tiles_dense<int>(tiles);
+    else if(coords_type == TILEDB_INT64) 
+      get_overlapping_tiles_dense<int64_t>(tiles);
+  } else {
+    if(coords_type == TILEDB_INT32) 
+      get_overlapping_tiles_sparse<int>(tiles);
+    else if(coords_type == TILEDB_INT64) 
+      get_overlapping_tiles_sparse<int64_t>(tiles);
+    else if(coords_type == TILEDB_FLOAT32) 
+      get_overlapping_tiles_sparse<float>(tiles);
+    else if(coords_type == TILEDB_FLOAT64) 
+      get_overlapping_tiles_sparse<double>(tiles);
+  }
+  int64_t tile_num = tiles.size();
+
+  // Count the cells of the tiles
+  int64_t tiles_cell_num = 0;
+  for(int64_t i=0; i<tile_num; ++i)
+    tiles_cell_num += book_keeping_->cell_num(tiles[i]);
+  cell_num += tiles_cell_num;
+
+  // Add up the variable-sized values of the tiles
+  for(int i=0; i<attribute_id_num; ++i) {
+    int attribute_id = attribute_ids[i];
+    if(!array_schema_->var_size(attribute_id))
+      continue;
+
+    if(is_empty_attribute(attribute_id)) {
+      // A single empty value per cell
+      var_sizes[attribute_id] += 
+          tiles_cell_num * array_schema_->type_size(attribute_id);
+    } else if(array_schema_->filter(attribute_id) == TILEDB_DICTIONARY &&
+              !array_->dictionary_codes()) {
+      // The tiles hold codes - Bound each value by the longest entry
+      if(load_dictionary(attribute_id) != TILEDB_RS_OK)
+        return TILEDB_RS_ERR;
+      const char* dictionary = 
+          static_cast<const char*>(dictionaries_[attribute_id]);
+      int64_t entry_num;
+      memcpy(&entry_num, dictionary, sizeof(int64_t));
+      const size_t* entry_offsets = 
+          reinterpret_cast<const size_t*>(dictionary + sizeof(int64_t));
+      size_t values_size = 
+          dictionary_sizes_[attribute_id] - 
+          sizeof(int64_t) - entry_num*sizeof(size_t);
+      size_t max_entry_size = 0;
+      for(int64_t j=0; j<entry_num; ++j) {
+        size_t entry_end = 
+            (j == entry_num-1) ? values_size : entry_offsets[j+1];
+        max_entry_size = 
+            std::max(max_entry_size, entry_end - entry_offsets[j]);
+      }
+      var_sizes[attribute_id] += tiles_cell_num * max_entry_size;
+    } else {
+      for(int64_t j=0; j<tile_num; ++j)
+        var_sizes[attribute_id] += tile_var_sizes[attribute_id][tiles[j]];
+    }
+  }
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
+int ReadState::filter_fragment_cell_pos_range(
+    const FragmentCellPosRange& fragment_cell_pos_range,
+    FragmentCellPosRanges& fragment_cell_pos_ranges) {
+  // For easy reference
+  const std::vector<Predicate>& predicates = array_->predicates();
+  int predicate_num = predicates.size();
+  int64_t tile_i = fragment_cell_pos_range.first.second;
+  int64_t start_pos = fragment_cell_pos_range.second.first;
+  int64_t cell_num = fragment_cell_pos_range.second.second - start_pos + 1;
+
+  // Consult the zone maps, keeping the predicates they cannot decide
+  std::vector<int> undecided_predicates;
+  for(int i=0; i<predicate_num; ++i) {
+    int zone_map_cmp = this->zone_map_cmp(predicates[i], tile_i);
+    if(zone_map_cmp < 0)        // No cell satisfies the predicate
+      return TILEDB_RS_OK;
+    else if(zone_map_cmp == 0)  // Must be evaluated on the cells
+      undecided_predicates.push_back(i);
+  }
+
+  // All the cells satisfy the predicates
+  int undecided_predicate_num = undecided_predicates.size();
+  if(undecided_predicate_num == 0) {
+    fragment_cell_pos_ranges.push_back(fragment_cell_pos_range);
+    return TILEDB_RS_OK;
+  }
+
+  // Evaluate the rest of the predicates on the cells
+  if(allocate_cell_bitmap(cell_num) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+  memset(cell_bitmap_, 1, cell_num);
+  for(int i=0; i<undecided_predicate_num; ++i) {
+    if(evaluate_predicate(
+           predicates[undecided_predicates[i]], 
+           tile_i, 
+           start_pos, 
+           cell_num) != TILEDB_RS_OK)
+      return TILEDB_RS_ERR;
+  }
+
+  // Every run of 1s in the bitmap is a cell position range
+  const unsigned char* run;
+  int64_t run_start = 0, run_end;
+  for(;;) {
+    // Find the start of the next run
+    run = static_cast<const unsigned char*>(
+              memchr(cell_bitmap_ + run_start, 1, cell_num - run_start));
+    if(run == NULL)
+      break;
+    run_start = run - cell_bitmap_;
+
+    // Find the end of the run
+    run = static_cast<const unsigned char*>(
+              memchr(cell_bitmap_ + run_start, 0, cell_num - run_start));
+    run_end = (run == NULL) ? cell_num : run - cell_bitmap_;
+
+    // Add the cell position range
+    fragment_cell_pos_ranges.push_back(
+        FragmentCellPosRange(
+            fragment_cell_pos_range.first,
+            CellPosRange(start_pos + run_start, start_pos + run_end - 1)));
+
+    // Continue after the run
+    if(run_end == cell_num)
+      break;
+    run_start = run_end;
+  }
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 template<class T>
 int ReadState::get_coords_after(
     const T* coords,
@@ -763,6 +1118,14 @@ int ReadState::get_fragment_cell_ranges_sparse(
   int64_t start_pos = get_cell_pos_at_or_after(start_coords); 
   int64_t end_pos = get_cell_pos_at_or_before(end_coords); 
 
+  // Check all the cells at once if the coordinates tile is in main memory
+  if(tiles_[attribute_num_+1] != NULL)
+    return get_fragment_cell_ranges_sparse_bitmap<T>(
+               fragment_i,
+               start_pos,
+               end_pos,
+               fragment_cell_ranges);
+
   // Get the cell ranges
   const void* cell;
   int64_t current_start_pos, current_end_pos = -2; 
@@ -830,6 +1193,74 @@ int ReadState::get_fragment_cell_ranges_sparse(
   return TILEDB_RS_OK;
 }
 
+template<class T>
+int ReadState::get_fragment_cell_ranges_sparse_bitmap(
+    int fragment_i,
+    int64_t start_pos,
+    int64_t end_pos,
+    FragmentCellRanges& fragment_cell_ranges) {
+  // Trivial case
+  int64_t cell_num = end_pos - start_pos + 1;
+  if(cell_num <= 0)
+    return TILEDB_RS_OK;
+
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* subarray = static_cast<const T*>(array_->subarray());
+  const char* cells = 
+      static_cast<const char*>(tiles_[attribute_num_+1]) + 
+      start_pos*coords_size_;
+
+  // Allocate space for the bitmap
+  if(allocate_cell_bitmap(cell_num) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+
+  // Check all the cells against the subarray
+  cells_in_subarray<T>(
+      reinterpret_cast<const T*>(cells), 
+      cell_num, 
+      subarray, 
+      dim_num, 
+      cell_bitmap_);
+
+  // Every run of 1s in the bitmap is a cell range
+  const unsigned char* run;
+  int64_t run_start = 0, run_end;
+  for(;;) {
+    // Find the start of the next run
+    run = static_cast<const unsigned char*>(
+              memchr(cell_bitmap_ + run_start, 1, cell_num - run_start));
+    if(run == NULL)
+      break;
+    run_start = run - cell_bitmap_;
+
+    // Find the end of the run
+    run = static_cast<const unsigned char*>(
+              memchr(cell_bitmap_ + run_start, 0, cell_num - run_start));
+    run_end = (run == NULL) ? cell_num : run - cell_bitmap_;
+
+    // Add the cell range
+    FragmentCellRange fragment_cell_range;
+    fragment_cell_range.first = FragmentInfo(fragment_i, search_tile_pos_);
+    fragment_cell_range.second = malloc(2*coords_size_);
+    char* cell_range = static_cast<char*>(fragment_cell_range.second);
+    memcpy(cell_range, cells + run_start*coords_size_, coords_size_);
+    memcpy(
+        cell_range + coords_size_, 
+        cells + (run_end-1)*coords_size_, 
+        coords_size_);
+    fragment_cell_ranges.push_back(fragment_cell_range);
+
+    // Continue after the run
+    if(run_end == cell_num)
+      break;
+    run_start = run_end;
+  }
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 template<class T> 
 void ReadState::get_next_overlapping_tile_dense(const T* tile_coords) {
   // Trivial case
@@ -857,18 +1288,26 @@ void ReadState::get_next_overlapping_tile_dense(const T* tile_coords) {
             non_empty_domain, 
             tile_domain_overlap_subarray);
 
-  if(!tile_domain_overlap) {  // No overlap with the input tile
-    search_tile_overlap_ = 0;
-    subarray_area_covered_ = false;
-  } else {                    // Overlap with the input tile
-    // Find the search tile position
+  // Find the search tile position, treating the tiles that are not stored
+  // in the fragment as non-overlapping
+  if(tile_domain_overlap) {
     T* tile_coords_norm = new T[dim_num];
     for(int i=0; i<dim_num; ++i)
       tile_coords_norm[i] = 
           tile_coords[i] - (domain[2*i]-array_domain[2*i]) / tile_extents[i]; 
-    search_tile_pos_ = array_schema_->get_tile_pos(domain, tile_coords_norm);
+    int64_t tile_pos = book_keeping_->stored_tile_pos(
+        array_schema_->get_tile_pos(domain, tile_coords_norm));
     delete [] tile_coords_norm;
+    if(tile_pos == -1)
+      tile_domain_overlap = false;
+    else
+      search_tile_pos_ = tile_pos;
+  }
 
+  if(!tile_domain_overlap) {  // No overlap with the input tile
+    search_tile_overlap_ = 0;
+    subarray_area_covered_ = false;
+  } else {                    // Overlap with the input tile
     // Compute overlap of the query subarray with tile
     T* query_tile_overlap_subarray = new T[2*dim_num];
     array_schema_->subarray_overlap(
@@ -954,6 +1393,31 @@ void ReadState::get_next_overlapping_tile_sparse() {
   }
 }
 
+template<class T>
+void ReadState::get_next_overlapping_tiles_sparse(
+    int64_t tile_i,
+    int tile_num,
+    std::vector<int64_t>& tiles) const {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const std::vector<void*>& mbrs = book_keeping_->mbrs();
+  const T* subarray = static_cast<const T*>(array_->subarray());
+  T* overlap_subarray = new T[2*dim_num];
+
+  // Collect the next tiles whose MBRs overlap with the query range
+  int64_t pos = std::max(tile_i + 1, tile_search_range_[0]);
+  for(; pos <= tile_search_range_[1] && tile_num > 0; ++pos) {
+    const T* mbr = static_cast<const T*>(mbrs[pos]);
+    if(array_schema_->subarray_overlap(subarray, mbr, overlap_subarray)) {
+      tiles.push_back(pos);
+      --tile_num;
+    }
+  }
+
+  // Clean up
+  delete [] overlap_subarray;
+}
+
 template<class T> 
 void ReadState::get_next_overlapping_tile_sparse(
     const T* tile_coords) {
@@ -1062,6 +1526,23 @@ void ReadState::get_next_overlapping_tile_sparse(
   delete [] mbr_tile_overlap_subarray;
 }
 
+int ReadState::prefetch_tile(
+    int attribute_id, 
+    int64_t tile_i, 
+    int prefetch_i) {
+  // For easy reference
+  ReadState* read_state = prefetch_read_states_[prefetch_i];
+
+  // The previous tile is lost even if the fetch fails
+  read_state->fetched_tile_[attribute_id] = -1;
+
+  // Fetch the tile
+  if(array_schema_->var_size(attribute_id))
+    return read_state->prepare_tile_for_reading_var_cmp(attribute_id, tile_i);
+  else
+    return read_state->prepare_tile_for_reading_cmp(attribute_id, tile_i);
+}
+
 
 
 
@@ -1069,6 +1550,42 @@ void ReadState::get_next_overlapping_tile_sparse(
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
+int ReadState::allocate_cell_bitmap(int64_t cell_num) {
+  // The bitmap is large enough
+  if(cell_bitmap_allocated_size_ >= size_t(cell_num))
+    return TILEDB_RS_OK;
+
+  // Expand the bitmap
+  unsigned char* cell_bitmap = 
+      static_cast<unsigned char*>(realloc(cell_bitmap_, cell_num));
+  if(cell_bitmap == NULL) {
+    std::string errmsg = "Cannot allocate cell bitmap; Memory allocation error";
+    PRINT_ERROR(errmsg);
+    tiledb_rs_errmsg = TILEDB_RS_ERRMSG + errmsg;
+    return TILEDB_RS_ERR;
+  }
+  cell_bitmap_ = cell_bitmap;
+  cell_bitmap_allocated_size_ = cell_num;
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
+void ReadState::cache_tile(int attribute_id) {
+  // Trivial case
+  if(tile_cache_num_ == 0 || fetched_tile_[attribute_id] == -1)
+    return;
+
+  // Swap the tile with the least recently used one, which is overwritten by
+  // the next fetch
+  create_prefetch_read_states(tile_cache_num_);
+  std::vector<bool> prefetch_busy(prefetch_read_states_.size(), false);
+  int i = least_recently_used_prefetch_read_state(attribute_id, prefetch_busy);
+  swap_tile(attribute_id, prefetch_read_states_[i]);
+  prefetch_tile_uses_[i][attribute_id] = ++tile_use_num_;
+  fetched_tile_[attribute_id] = -1;
+}
+
 int ReadState::CMP_COORDS_TO_SEARCH_TILE(
     const void* buffer,
     size_t tile_offset) {
@@ -1081,6 +1598,8 @@ int ReadState::CMP_COORDS_TO_SEARCH_TILE(
   } 
 
   // We need to read from the disk
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, coords_size_);
   std::string filename = 
       fragment_->fragment_name() + "/" + TILEDB_COORDS + TILEDB_FILE_SUFFIX;
   int rc = TILEDB_UT_OK;
@@ -1229,6 +1748,8 @@ void ReadState::compute_tile_search_range() {
   if(fragment_->dense())
     return;
 
+  STATS_TIMER(array_->stats(), TIMER_TILE_SEARCH);
+
   // Invoke the proper templated function
   if(coords_type == TILEDB_INT32) {
     compute_tile_search_range<int>();
@@ -1430,12 +1951,102 @@ void ReadState::compute_tile_search_range_hil() {
   }
 } 
 
+void ReadState::create_prefetch_read_states(int prefetch_num) {
+  while(int(prefetch_read_states_.size()) < prefetch_num) {
+    prefetch_read_states_.push_back(new ReadState(fragment_, book_keeping_));
+    prefetch_tile_uses_.push_back(std::vector<int64_t>(attribute_num_+2, 0));
+  }
+}
+
+int ReadState::decode_dictionary_tile(
+    int attribute_id,
+    size_t& tile_var_size) {
+  // For easy reference
+  int64_t cell_num = tile_var_size / sizeof(int);
+  const int* codes = static_cast<const int*>(tile_codes_);
+  size_t* tile_s = static_cast<size_t*>(tiles_[attribute_id]);
+
+  // Compute the new cell offsets and the size of the variable tile
+  size_t new_tile_var_size; 
+  const char* values = NULL;
+  const size_t* entry_offsets = NULL;
+  if(array_->dictionary_codes()) {   // The cell values are the codes
+    for(int64_t i=0; i<cell_num; ++i) 
+      tile_s[i] = i*sizeof(int);
+    new_tile_var_size = tile_var_size;
+  } else {                           // The cell values are in the dictionary
+    // Load dictionary
+    if(load_dictionary(attribute_id) != TILEDB_RS_OK)
+      return TILEDB_RS_ERR;
+
+    // For easy reference
+    const char* dictionary = 
+        static_cast<const char*>(dictionaries_[attribute_id]);
+    int64_t entry_num;
+    memcpy(&entry_num, dictionary, sizeof(int64_t));
+    entry_offsets = 
+        reinterpret_cast<const size_t*>(dictionary + sizeof(int64_t));
+    values = dictionary + sizeof(int64_t) + entry_num*sizeof(size_t);
+    size_t values_size = 
+        dictionary_sizes_[attribute_id] - (values - dictionary);
+
+    // Compute cell offsets
+    size_t offset = 0;
+    for(int64_t i=0; i<cell_num; ++i) {
+      if(codes[i] < 0 || codes[i] >= entry_num) {
+        std::string errmsg = "Cannot decode dictionary tile; Invalid code";
+        PRINT_ERROR(errmsg);
+        tiledb_rs_errmsg = TILEDB_RS_ERRMSG + errmsg;
+        return TILEDB_RS_ERR;
+      }
+      tile_s[i] = offset;
+      offset += (codes[i] == entry_num-1) 
+                    ? values_size - entry_offsets[codes[i]]
+                    : entry_offsets[codes[i]+1] - entry_offsets[codes[i]];
+    }
+    new_tile_var_size = offset;
+  }
+
+  // Potentially allocate space for buffer
+  if(tiles_var_[attribute_id] == NULL) {
+    tiles_var_[attribute_id] = malloc(new_tile_var_size);
+    tiles_var_allocated_size_[attribute_id] = new_tile_var_size;
+  }
+
+  // Potentially expand buffer
+  if(new_tile_var_size > tiles_var_allocated_size_[attribute_id]) {
+    tiles_var_[attribute_id] = 
+        realloc(tiles_var_[attribute_id], new_tile_var_size);
+    tiles_var_allocated_size_[attribute_id] = new_tile_var_size;
+  }
+
+  // Copy the cell values
+  char* tile_var = static_cast<char*>(tiles_var_[attribute_id]);
+  if(array_->dictionary_codes()) {
+    memcpy(tile_var, codes, new_tile_var_size);
+  } else {
+    for(int64_t i=0; i<cell_num; ++i) {
+      memcpy(
+          tile_var + tile_s[i], 
+          values + entry_offsets[codes[i]], 
+          ((i == cell_num-1) ? new_tile_var_size : tile_s[i+1]) - tile_s[i]);
+    }
+  }
+  tile_var_size = new_tile_var_size;
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 int ReadState::decompress_tile(
     int attribute_id,
     unsigned char* tile_compressed,
     size_t tile_compressed_size,
     unsigned char* tile,
     size_t tile_size) {
+  STATS_TIMER(array_->stats(), TIMER_DECOMPRESS);
+  STATS_ADD(array_->stats(), TILES_DECOMPRESSED, 1);
+
   // For easy reference
   int compression = array_schema_->compression(attribute_id);
 
@@ -1583,6 +2194,10 @@ int ReadState::decompress_tile_blosc(
     unsigned char* tile,
     size_t tile_size,
     const char* compressor) {
+  // The Blosc global state is shared by the read states of all fragments,
+  // which may decompress tiles in parallel
+  pthread_mutex_lock(&blosc_mtx);
+
   // Initialization
   blosc_init();
 
@@ -1595,11 +2210,13 @@ int ReadState::decompress_tile_blosc(
     PRINT_ERROR(errmsg);
     tiledb_rs_errmsg = TILEDB_RS_ERRMSG + errmsg;
     blosc_destroy();
+    pthread_mutex_unlock(&blosc_mtx);
     return TILEDB_RS_ERR;
   }
 
   // Clean up
   blosc_destroy();
+  pthread_mutex_unlock(&blosc_mtx);
 
   // Success
   return TILEDB_RS_OK;
@@ -1671,6 +2288,88 @@ int ReadState::decompress_tile_rle(
   return TILEDB_RS_OK;
 }
 
+int ReadState::evaluate_predicate(
+    const Predicate& predicate,
+    int64_t tile_i,
+    int64_t start_pos,
+    int64_t cell_num) {
+  // For easy reference
+  int attribute_id = predicate.attribute_id_;
+  int type = array_schema_->type(attribute_id);
+
+  // All the cells of an empty attribute are empty
+  if(is_empty_attribute(attribute_id)) {
+    memset(cell_bitmap_, 0, cell_num);
+    return TILEDB_RS_OK;
+  }
+
+  // Use the tile of this read state only if it is already fetched, otherwise
+  // fetch the tile with the separate predicate read state
+  ReadState* read_state = this;
+  if(fetched_tile_[attribute_id] != tile_i) {
+    if(predicate_read_state_ == NULL)
+      predicate_read_state_ = new ReadState(fragment_, book_keeping_);
+    read_state = predicate_read_state_;
+    if(read_state->prepare_tile_for_reading(attribute_id, tile_i) != 
+       TILEDB_RS_OK)
+      return TILEDB_RS_ERR;
+  }
+
+  // Get the values
+  const void* values;
+  if(read_state->get_values(attribute_id, start_pos, cell_num, values) != 
+     TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+
+  // Compare the values
+  if(type == TILEDB_INT32) {
+    int value;
+    memcpy(&value, predicate.value_, sizeof(int));
+    cells_cmp_value<int>(
+        static_cast<const int*>(values), 
+        cell_num, 
+        predicate.op_, 
+        value, 
+        TILEDB_EMPTY_INT32, 
+        cell_bitmap_);
+  } else if(type == TILEDB_INT64) {
+    int64_t value;
+    memcpy(&value, predicate.value_, sizeof(int64_t));
+    cells_cmp_value<int64_t>(
+        static_cast<const int64_t*>(values), 
+        cell_num, 
+        predicate.op_, 
+        value, 
+        TILEDB_EMPTY_INT64, 
+        cell_bitmap_);
+  } else if(type == TILEDB_FLOAT32) {
+    float value;
+    memcpy(&value, predicate.value_, sizeof(float));
+    cells_cmp_value<float>(
+        static_cast<const float*>(values), 
+        cell_num, 
+        predicate.op_, 
+        value, 
+        TILEDB_EMPTY_FLOAT32, 
+        cell_bitmap_);
+  } else if(type == TILEDB_FLOAT64) {
+    double value;
+    memcpy(&value, predicate.value_, sizeof(double));
+    cells_cmp_value<double>(
+        static_cast<const double*>(values), 
+        cell_num, 
+        predicate.op_, 
+        value, 
+        TILEDB_EMPTY_FLOAT64, 
+        cell_bitmap_);
+  } else {  // The program should never reach this point
+    assert(0);
+  }
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 template<class T>
 int64_t ReadState::get_cell_pos_after(const T* coords) {
   // For easy reference
@@ -1797,6 +2496,8 @@ int ReadState::GET_COORDS_PTR_FROM_SEARCH_TILE(
   } 
 
   // We need to read from the disk
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, coords_size_);
   std::string filename = 
       fragment_->fragment_name() + "/" + TILEDB_COORDS + TILEDB_FILE_SUFFIX;
   int rc = TILEDB_UT_OK;
@@ -1856,6 +2557,8 @@ int ReadState::GET_CELL_PTR_FROM_OFFSET_TILE(
   } 
 
   // We need to read from the disk
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, sizeof(size_t));
   std::string filename = 
       fragment_->fragment_name() + "/" + 
       array_schema_->attribute(attribute_id) + 
@@ -1903,6 +2606,118 @@ int ReadState::GET_CELL_PTR_FROM_OFFSET_TILE(
   return TILEDB_RS_OK;
 }
 
+template<class T>
+void ReadState::get_overlapping_tiles_dense(
+    std::vector<int64_t>& tiles) const {
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const T* tile_extents = static_cast<const T*>(array_schema_->tile_extents());
+  const T* subarray = static_cast<const T*>(array_->subarray());
+  const T* domain = static_cast<const T*>(book_keeping_->domain());
+  const T* non_empty_domain = 
+      static_cast<const T*>(book_keeping_->non_empty_domain());
+
+  // Compute the overlap of the subarray with the non-empty domain
+  std::vector<T> overlap(2*dim_num);
+  if(!array_schema_->subarray_overlap(subarray, non_empty_domain, &overlap[0]))
+    return;
+
+  // Compute the range of the overlapping tiles inside the fragment domain
+  std::vector<T> tile_domain(2*dim_num);
+  for(int i=0; i<dim_num; ++i) {
+    tile_domain[2*i] = (overlap[2*i] - domain[2*i]) / tile_extents[i];
+    tile_domain[2*i+1] = (overlap[2*i+1] - domain[2*i]) / tile_extents[i];
+  }
+
+  // Visit every tile in the range
+  std::vector<T> tile_coords(dim_num);
+  for(int i=0; i<dim_num; ++i)
+    tile_coords[i] = tile_domain[2*i];
+  int64_t tile_pos;
+  for(;;) {
+    // Skip the tiles that are not stored in the fragment
+    tile_pos = book_keeping_->stored_tile_pos(
+        array_schema_->get_tile_pos(domain, &tile_coords[0]));
+    if(tile_pos != -1)
+      tiles.push_back(tile_pos);
+
+    // Advance the tile coordinates, the last dimension moving fastest
+    int i = dim_num-1;
+    while(i >= 0 && tile_coords[i] == tile_domain[2*i+1]) {
+      tile_coords[i] = tile_domain[2*i];
+      --i;
+    }
+    if(i < 0)
+      break;
+    ++tile_coords[i];
+  }
+}
+
+template<class T>
+void ReadState::get_overlapping_tiles_sparse(
+    std::vector<int64_t>& tiles) const {
+  // Trivial case
+  if(tile_search_range_[0] == -1 || tile_search_range_[1] == -1)
+    return;
+
+  // For easy reference
+  int dim_num = array_schema_->dim_num();
+  const std::vector<void*>& mbrs = book_keeping_->mbrs();
+  const T* subarray = static_cast<const T*>(array_->subarray());
+
+  // Keep the tiles whose MBR overlaps the subarray
+  std::vector<T> overlap(2*dim_num);
+  for(int64_t i=tile_search_range_[0]; i<=tile_search_range_[1]; ++i) {
+    if(array_schema_->subarray_overlap(
+           subarray,
+           static_cast<const T*>(mbrs[i]),
+           &overlap[0]))
+      tiles.push_back(i);
+  }
+}
+
+int ReadState::get_values(
+    int attribute_id,
+    int64_t start_pos,
+    int64_t cell_num,
+    const void*& values) {
+  // For easy reference
+  size_t cell_size = array_schema_->cell_size(attribute_id);
+  size_t values_size = cell_num * cell_size;
+
+  // The tile is in main memory
+  if(tiles_[attribute_id] != NULL) {
+    values = static_cast<const char*>(tiles_[attribute_id]) + 
+             start_pos * cell_size;
+    return TILEDB_RS_OK;
+  }
+
+  // Allocate space for the values
+  if(values_allocated_size_ < values_size) {
+    void* new_values = realloc(values_, values_size);
+    if(new_values == NULL) {
+      std::string errmsg = "Cannot get tile values; Memory allocation error";
+      PRINT_ERROR(errmsg);
+      tiledb_rs_errmsg = TILEDB_RS_ERRMSG + errmsg;
+      return TILEDB_RS_ERR;
+    }
+    values_ = new_values;
+    values_allocated_size_ = values_size;
+  }
+
+  // Read the values from the disk
+  if(READ_FROM_TILE(
+         attribute_id, 
+         values_, 
+         start_pos * cell_size, 
+         values_size) != TILEDB_RS_OK)
+    return TILEDB_RS_ERR;
+  values = values_;
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 bool ReadState::is_empty_attribute(int attribute_id) const {
   // Special case for search coordinate tiles
   if(attribute_id == attribute_num_ + 1) 
@@ -1911,10 +2726,61 @@ bool ReadState::is_empty_attribute(int attribute_id) const {
   return is_empty_attribute_[attribute_id];
 }
 
+int ReadState::least_recently_used_prefetch_read_state(
+    int attribute_id,
+    const std::vector<bool>& prefetch_busy) const {
+  int prefetch_num = prefetch_read_states_.size();
+  int lru = -1;
+  for(int i=0; i<prefetch_num; ++i) 
+    if(!prefetch_busy[i] && 
+       (lru == -1 || 
+        prefetch_tile_uses_[i][attribute_id] < 
+            prefetch_tile_uses_[lru][attribute_id]))
+      lru = i;
+
+  return lru;
+}
+
+int ReadState::load_dictionary(int attribute_id) {
+  // Trivial case - Already loaded
+  if(dictionaries_[attribute_id] != NULL)
+    return TILEDB_RS_OK;
+
+  // Prepare dictionary file name
+  std::string filename = fragment_->fragment_name() + "/" +
+             array_schema_->attribute(attribute_id) + "_dict" +
+             TILEDB_FILE_SUFFIX;
+
+  // Check file size
+  off_t file_size = ::file_size(filename);
+  if(file_size < (off_t) sizeof(int64_t)) {
+    std::string errmsg = "Cannot load dictionary; Invalid dictionary file";
+    PRINT_ERROR(errmsg);
+    tiledb_rs_errmsg = TILEDB_RS_ERRMSG + errmsg;
+    return TILEDB_RS_ERR;
+  }
+
+  // Read dictionary
+  void* dictionary = malloc(file_size);
+  if(read_from_file(filename, 0, dictionary, file_size) != TILEDB_UT_OK) {
+    free(dictionary);
+    tiledb_rs_errmsg = tiledb_ut_errmsg;
+    return TILEDB_RS_ERR;
+  }
+  dictionaries_[attribute_id] = dictionary;
+  dictionary_sizes_[attribute_id] = file_size;
+
+  // Success
+  return TILEDB_RS_OK;
+}
+
 int ReadState::map_tile_from_file_cmp(
     int attribute_id,
     off_t offset,
     size_t tile_size) {
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
+
   // To handle the special case of the search tile
   // The real attribute id corresponds to an actual attribute or coordinates 
   int attribute_id_real = 
@@ -1998,6 +2864,9 @@ int ReadState::map_tile_from_file_var_cmp(
     int attribute_id,
     off_t offset,
     size_t tile_size) {
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
+
   // Unmap
   if(map_addr_compressed_ != NULL) {
     if(munmap(map_addr_compressed_, map_addr_compressed_length_)) {
@@ -2082,6 +2951,9 @@ int ReadState::map_tile_from_file_cmp_none(
     int attribute_id,
     off_t offset,
     size_t tile_size) {
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
+
   // To handle the special case of the search tile
   // The real attribute id corresponds to an actual attribute or coordinates 
   int attribute_id_real = 
@@ -2165,6 +3037,9 @@ int ReadState::map_tile_from_file_var_cmp_none(
     int attribute_id,
     off_t offset,
     size_t tile_size) {
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
+
   // Unmap
   if(map_addr_var_[attribute_id] != NULL) {
     if(munmap(
@@ -2280,6 +3155,8 @@ int ReadState::mpi_io_read_tile_from_file_cmp(
       TILEDB_FILE_SUFFIX;
 
   // Read from file
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
   if(mpi_io_read_from_file(
          mpi_comm, 
          filename, 
@@ -2320,6 +3197,8 @@ int ReadState::mpi_io_read_tile_from_file_var_cmp(
       TILEDB_FILE_SUFFIX;
 
   // Read from file
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
   if(mpi_io_read_from_file(
          mpi_comm,
          filename, 
@@ -2365,8 +3244,18 @@ int ReadState::prepare_tile_for_reading_cmp(
     int attribute_id, 
     int64_t tile_i) {
   // Return if the tile has already been fetched
-  if(tile_i == fetched_tile_[attribute_id])
+  if(tile_i == fetched_tile_[attribute_id]) {
+    STATS_ADD(array_->stats(), CACHE_HITS, 1);
     return TILEDB_RS_OK;
+  }
+
+  // Return if the tile has been prefetched or cached
+  if(take_prefetched_tile(attribute_id, tile_i))
+    return TILEDB_RS_OK;
+  STATS_ADD(array_->stats(), TILES_FETCHED, 1);
+
+  // Keep the current tile in main memory
+  cache_tile(attribute_id);
 
   // To handle the special case of the search tile
   // The real attribute id corresponds to an actual attribute or coordinates 
@@ -2433,14 +3322,40 @@ int ReadState::prepare_tile_for_reading_cmp(
   if(rc != TILEDB_RS_OK)
     return TILEDB_RS_ERR;
 
+  // Coordinates in the columnar layout are decompressed in an auxiliary
+  // buffer and then restored to the cell layout. RLE already decompresses
+  // the coordinates of each dimension separately.
+  bool columnar = 
+      attribute_id_real == attribute_num_ &&
+      array_schema_->coords_layout() == TILEDB_COORDS_COLUMNAR &&
+      array_schema_->compression(attribute_id_real) != TILEDB_RLE;
+  void* tile = tiles_[attribute_id];
+  if(columnar) {
+    if(full_tile_size > tile_columnar_allocated_size_) {
+      tile_columnar_allocated_size_ = full_tile_size;
+      tile_columnar_ = realloc(tile_columnar_, full_tile_size);
+    }
+    tile = tile_columnar_;
+  }
+
   // Decompress tile
   if(decompress_tile(
          attribute_id, 
          static_cast<unsigned char*>(tile_compressed_), 
          tile_compressed_size, 
-         static_cast<unsigned char*>(tiles_[attribute_id]),
+         static_cast<unsigned char*>(tile),
          full_tile_size) != TILEDB_RS_OK)
     return TILEDB_RS_ERR;
+
+  // Restore the cell layout of the coordinates
+  if(columnar)
+    restore_coords_tile_layout(attribute_id, tile_size);
+
+  // Reverse the filter applied before compression
+  unfilter_tile(
+      attribute_id, 
+      static_cast<unsigned char*>(tiles_[attribute_id]), 
+      tile_size);
          
   // Set the tile size
   tiles_sizes_[attribute_id] = tile_size;
@@ -2459,8 +3374,11 @@ int ReadState::prepare_tile_for_reading_cmp_none(
     int attribute_id, 
     int64_t tile_i) {
   // Return if the tile has already been fetched
-  if(tile_i == fetched_tile_[attribute_id])
+  if(tile_i == fetched_tile_[attribute_id]) {
+    STATS_ADD(array_->stats(), CACHE_HITS, 1);
     return TILEDB_RS_OK;
+  }
+  STATS_ADD(array_->stats(), TILES_FETCHED, 1);
 
   // To handle the special case of the search tile
   // The real attribute id corresponds to an actual attribute or coordinates 
@@ -2511,8 +3429,18 @@ int ReadState::prepare_tile_for_reading_var_cmp(
     int attribute_id, 
     int64_t tile_i) {
   // Return if the tile has already been fetched
-  if(tile_i == fetched_tile_[attribute_id])
+  if(tile_i == fetched_tile_[attribute_id]) {
+    STATS_ADD(array_->stats(), CACHE_HITS, 1);
+    return TILEDB_RS_OK;
+  }
+
+  // Return if the tile has been prefetched or cached
+  if(take_prefetched_tile(attribute_id, tile_i))
     return TILEDB_RS_OK;
+  STATS_ADD(array_->stats(), TILES_FETCHED, 1);
+
+  // Keep the current tile in main memory
+  cache_tile(attribute_id);
 
   // Sanity check
   assert(
@@ -2591,6 +3519,12 @@ int ReadState::prepare_tile_for_reading_var_cmp(
          tile_size) != TILEDB_RS_OK)
     return TILEDB_RS_ERR;
 
+  // Restore the cell offsets from the cell lengths
+  unfilter_tile(
+      attribute_id, 
+      static_cast<unsigned char*>(tiles_[attribute_id]), 
+      tile_size);
+
   // Set the tile size
   tiles_sizes_[attribute_id] = tile_size;
 
@@ -2615,19 +3549,31 @@ int ReadState::prepare_tile_for_reading_var_cmp(
   // Get size of decompressed tile
   size_t tile_var_size = book_keeping_->tile_var_sizes()[attribute_id][tile_i];
 
+  // Dictionary-encoded tiles hold codes, decompressed into tile_codes_
+  bool dictionary = 
+      (array_schema_->filter(attribute_id) == TILEDB_DICTIONARY);
+
   //Non-empty tile, decompress
   if(tile_var_size > 0u) {
-    // Potentially allocate space for buffer
-    if(tiles_var_[attribute_id] == NULL) {
-      tiles_var_[attribute_id] = malloc(tile_var_size);
-      tiles_var_allocated_size_[attribute_id] = tile_var_size;
-    }
+    if(dictionary) {
+      // Potentially expand buffer
+      if(tile_var_size > tile_codes_allocated_size_) {
+        tile_codes_ = realloc(tile_codes_, tile_var_size);
+        tile_codes_allocated_size_ = tile_var_size;
+      }
+    } else {
+      // Potentially allocate space for buffer
+      if(tiles_var_[attribute_id] == NULL) {
+        tiles_var_[attribute_id] = malloc(tile_var_size);
+        tiles_var_allocated_size_[attribute_id] = tile_var_size;
+      }
 
-    // Potentially expand buffer
-    if(tile_var_size > tiles_var_allocated_size_[attribute_id]) {
-      tiles_var_[attribute_id] = 
-          realloc(tiles_var_[attribute_id], tile_var_size);
-      tiles_var_allocated_size_[attribute_id] = tile_var_size;
+      // Potentially expand buffer
+      if(tile_var_size > tiles_var_allocated_size_[attribute_id]) {
+        tiles_var_[attribute_id] = 
+            realloc(tiles_var_[attribute_id], tile_var_size);
+        tiles_var_allocated_size_[attribute_id] = tile_var_size;
+      }
     }
 
     // Read tile from file
@@ -2664,13 +3610,19 @@ int ReadState::prepare_tile_for_reading_var_cmp(
       return TILEDB_RS_ERR;
 
     // Decompress tile
+    void* tile_var = dictionary ? tile_codes_ : tiles_var_[attribute_id];
     if(decompress_tile(
            attribute_id, 
            static_cast<unsigned char*>(tile_compressed_), 
            tile_compressed_size, 
-           static_cast<unsigned char*>(tiles_var_[attribute_id]),
+           static_cast<unsigned char*>(tile_var),
            tile_var_size) != TILEDB_RS_OK)
       return TILEDB_RS_ERR;
+
+    // Decode the cell values
+    if(dictionary && 
+       decode_dictionary_tile(attribute_id, tile_var_size) != TILEDB_RS_OK)
+      return TILEDB_RS_ERR;
   }
 
   // Set the variable tile size
@@ -2693,8 +3645,11 @@ int ReadState::prepare_tile_for_reading_var_cmp_none(
     int attribute_id, 
     int64_t tile_i) {
   // Return if the tile has already been fetched
-  if(tile_i == fetched_tile_[attribute_id])
+  if(tile_i == fetched_tile_[attribute_id]) {
+    STATS_ADD(array_->stats(), CACHE_HITS, 1);
     return TILEDB_RS_OK;
+  }
+  STATS_ADD(array_->stats(), TILES_FETCHED, 1);
 
   // Sanity check
   assert(
@@ -2746,6 +3701,8 @@ int ReadState::prepare_tile_for_reading_var_cmp_none(
         TILEDB_FILE_SUFFIX;
 
   if(tile_i != tile_num - 1) { // Not the last tile
+    STATS_TIMER(array_->stats(), TIMER_IO);
+    STATS_ADD(array_->stats(), BYTES_READ, TILEDB_CELL_VAR_OFFSET_SIZE);
     if(read_method == TILEDB_IO_READ ||
        read_method == TILEDB_IO_MMAP) {
       if(read_from_file(
@@ -2830,6 +3787,8 @@ int ReadState::READ_FROM_TILE(
   } 
 
   // We need to read from the disk
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, bytes_to_copy);
   std::string filename = 
       fragment_->fragment_name() + "/" +
       array_schema_->attribute(attribute_id) + 
@@ -2890,6 +3849,8 @@ int ReadState::READ_FROM_TILE_VAR(
   } 
 
   // We need to read from the disk
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, bytes_to_copy);
   std::string filename = 
       fragment_->fragment_name() + "/" +
       array_schema_->attribute(attribute_id) + "_var" +
@@ -2962,6 +3923,8 @@ int ReadState::read_tile_from_file_cmp(
       TILEDB_FILE_SUFFIX;
 
   // Read from file
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
   if(read_from_file(filename, offset, tile_compressed_, tile_size) !=
      TILEDB_UT_OK) {
     tiledb_rs_errmsg = tiledb_ut_errmsg;
@@ -2995,6 +3958,8 @@ int ReadState::read_tile_from_file_var_cmp(
       TILEDB_FILE_SUFFIX;
 
   // Read from file
+  STATS_TIMER(array_->stats(), TIMER_IO);
+  STATS_ADD(array_->stats(), BYTES_READ, tile_size);
   if(read_from_file(filename, offset, tile_compressed_, tile_size) !=
      TILEDB_UT_OK) {
     tiledb_rs_errmsg = tiledb_ut_errmsg;
@@ -3005,6 +3970,30 @@ int ReadState::read_tile_from_file_var_cmp(
   return TILEDB_RS_OK;
 }
 
+void ReadState::restore_coords_tile_layout(
+    int attribute_id, 
+    size_t tile_size) {
+  // For easy reference
+  int coords_type = array_schema_->coords_type();
+  int dim_num = array_schema_->dim_num();
+  int64_t cell_num = tile_size / coords_size_;
+  void* tile = tiles_[attribute_id];
+
+  // Invoke the proper templated function
+  if(coords_type == TILEDB_INT32)
+    coords_from_columnar<int>(
+        (const int*) tile_columnar_, (int*) tile, cell_num, dim_num);
+  else if(coords_type == TILEDB_INT64)
+    coords_from_columnar<int64_t>(
+        (const int64_t*) tile_columnar_, (int64_t*) tile, cell_num, dim_num);
+  else if(coords_type == TILEDB_FLOAT32)
+    coords_from_columnar<float>(
+        (const float*) tile_columnar_, (float*) tile, cell_num, dim_num);
+  else if(coords_type == TILEDB_FLOAT64)
+    coords_from_columnar<double>(
+        (const double*) tile_columnar_, (double*) tile, cell_num, dim_num);
+}
+
 int ReadState::set_tile_file_offset(
     int attribute_id,
     off_t offset) {
@@ -3049,11 +4038,230 @@ void ReadState::shift_var_offsets(
     buffer_s[i] = buffer_s[i] - start_offset + new_start_offset;
 }
 
+void ReadState::swap_tile(int attribute_id, ReadState* read_state) {
+  std::swap(
+      fetched_tile_[attribute_id], 
+      read_state->fetched_tile_[attribute_id]);
+  std::swap(tiles_[attribute_id], read_state->tiles_[attribute_id]);
+  std::swap(tiles_sizes_[attribute_id], read_state->tiles_sizes_[attribute_id]);
+
+  // Swap the variable tile buffers
+  if(attribute_id < attribute_num_ && array_schema_->var_size(attribute_id)) {
+    std::swap(tiles_var_[attribute_id], read_state->tiles_var_[attribute_id]);
+    std::swap(
+        tiles_var_allocated_size_[attribute_id], 
+        read_state->tiles_var_allocated_size_[attribute_id]);
+    std::swap(
+        tiles_var_sizes_[attribute_id], 
+        read_state->tiles_var_sizes_[attribute_id]);
+  }
+}
+
+bool ReadState::take_prefetched_tile(int attribute_id, int64_t tile_i) {
+  // Find the prefetching read state holding the tile
+  int prefetch_i = -1;
+  int prefetch_num = prefetch_read_states_.size();
+  for(int i=0; i<prefetch_num; ++i) {
+    if(prefetch_read_states_[i]->fetched_tile_[attribute_id] == tile_i) {
+      prefetch_i = i;
+      break;
+    }
+  }
+
+  // Not prefetched
+  if(prefetch_i == -1)
+    return false;
+
+  // Swap the tiles, starting the copy from the beginning of the tile as upon
+  // a fetch. The prefetching read state now holds the previous tile.
+  swap_tile(attribute_id, prefetch_read_states_[prefetch_i]);
+  prefetch_tile_uses_[prefetch_i][attribute_id] = ++tile_use_num_;
+  tiles_offsets_[attribute_id] = 0;
+  if(attribute_id < attribute_num_ && array_schema_->var_size(attribute_id))
+    tiles_var_offsets_[attribute_id] = 0;
+
+  return true;
+}
+
+void ReadState::unfilter_tile(
+    int attribute_id,
+    unsigned char* tile,
+    size_t tile_size) {
+  // For easy reference
+  int filter = array_schema_->filter(attribute_id);
+
+  // Trivial case (dictionary encoding applies to the variable tiles)
+  if(filter == TILEDB_NO_FILTER || filter == TILEDB_DICTIONARY)
+    return;
+
+  // To handle the special case of the search tile
+  int attribute_id_real = 
+      (attribute_id == attribute_num_+1) ? attribute_num_ : attribute_id;
+
+  // Each value was encoded against the same value of the previous cell. For
+  // variable-sized attributes, the tile holds the cell offsets.
+  int stride, type;
+  if(array_schema_->var_size(attribute_id_real)) {
+    stride = 1;
+    type = TILEDB_INT64;
+  } else {
+    stride = (attribute_id_real == attribute_num_) 
+                 ? array_schema_->dim_num() 
+                 : array_schema_->cell_val_num(attribute_id_real);
+    type = array_schema_->type(attribute_id_real);
+  }
+
+  // Unfilter tile
+  if(type == TILEDB_INT32) {
+    int64_t value_num = tile_size / sizeof(int);
+    if(filter == TILEDB_DELTA)
+      delta_decode<int>((int*) tile, value_num, stride);
+    else if(filter == TILEDB_DOUBLE_DELTA)
+      double_delta_decode<int>((int*) tile, value_num, stride);
+  } else if(type == TILEDB_INT64) {
+    int64_t value_num = tile_size / sizeof(int64_t);
+    if(filter == TILEDB_DELTA)
+      delta_decode<int64_t>((int64_t*) tile, value_num, stride);
+    else if(filter == TILEDB_DOUBLE_DELTA)
+      double_delta_decode<int64_t>((int64_t*) tile, value_num, stride);
+  } else {
+    assert(0);
+  }
+}
+
+int ReadState::zone_map_cmp(
+    const Predicate& predicate, 
+    int64_t tile_i) const {
+  // For easy reference
+  int attribute_id = predicate.attribute_id_;
+  int type = array_schema_->type(attribute_id);
+  const void* zone_map = book_keeping_->zone_map(attribute_id, tile_i);
+
+  // No zone map for this tile
+  if(zone_map == NULL)
+    return 0;
+
+  // Invoke the proper templated function
+  if(type == TILEDB_INT32)
+    return zone_map_cmp<int>(predicate, zone_map);
+  else if(type == TILEDB_INT64)
+    return zone_map_cmp<int64_t>(predicate, zone_map);
+  else if(type == TILEDB_FLOAT32)
+    return zone_map_cmp<float>(predicate, zone_map);
+  else if(type == TILEDB_FLOAT64)
+    return zone_map_cmp<double>(predicate, zone_map);
+  else  // The program should never reach this point
+    assert(0);
+
+  return 0;
+}
+
+template<class T>
+int ReadState::zone_map_cmp(
+    const Predicate& predicate, 
+    const void* zone_map) const {
+  // Unpack the zone map and the predicate value
+  T min, max, value;
+  int64_t non_empty_num, empty_num;
+  const char* zone_map_c = static_cast<const char*>(zone_map);
+  memcpy(&min, zone_map_c, sizeof(T));
+  memcpy(&max, zone_map_c + sizeof(T), sizeof(T));
+  memcpy(&non_empty_num, zone_map_c + 2*sizeof(T), sizeof(int64_t));
+  memcpy(
+      &empty_num, 
+      zone_map_c + 2*sizeof(T) + sizeof(int64_t), 
+      sizeof(int64_t));
+  memcpy(&value, predicate.value_, sizeof(T));
+
+  // Empty cells never satisfy a predicate
+  if(non_empty_num == 0)
+    return -1;
+
+  // Check if no cell or all cells satisfy the predicate
+  bool none = false, all = false;
+  switch(predicate.op_) {
+    case TILEDB_LT:
+      none = (min >= value);
+      all = (max < value);
+      break;
+    case TILEDB_LE:
+      none = (min > value);
+      all = (max <= value);
+      break;
+    case TILEDB_GT:
+      none = (max <= value);
+      all = (min > value);
+      break;
+    case TILEDB_GE:
+      none = (max < value);
+      all = (min >= value);
+      break;
+    case TILEDB_EQ:
+      none = (value < min || value > max);
+      all = (min == value && max == value);
+      break;
+    case TILEDB_NE:
+      none = (min == value && max == value);
+      all = (value < min || value > max);
+      break;
+    default:  // The program should never reach this point
+      assert(0);
+  }
+
+  if(none)
+    return -1;
+  else if(all && empty_num == 0)
+    return 1;
+  else
+    return 0;
+}
+
 
 
 
 // Explicit template instantiations
 
+template int ReadState::aggregate<int, int64_t>(
+    int attribute_id,
+    int aggregate,
+    int empty_value,
+    int64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    int64_t& count,
+    int64_t& sum,
+    int& min,
+    int& max);
+template int ReadState::aggregate<int64_t, int64_t>(
+    int attribute_id,
+    int aggregate,
+    int64_t empty_value,
+    int64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    int64_t& count,
+    int64_t& sum,
+    int64_t& min,
+    int64_t& max);
+template int ReadState::aggregate<float, double>(
+    int attribute_id,
+    int aggregate,
+    float empty_value,
+    int64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    int64_t& count,
+    double& sum,
+    float& min,
+    float& max);
+template int ReadState::aggregate<double, double>(
+    int attribute_id,
+    int aggregate,
+    double empty_value,
+    int64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    int64_t& count,
+    double& sum,
+    double& min,
+    double& max);
+
 template int ReadState::get_coords_after<int>(
     const int* coords,
     int* coords_after,
@@ -3179,3 +4387,20 @@ template void ReadState::get_next_overlapping_tile_sparse<int64_t>();
 template void ReadState::get_next_overlapping_tile_sparse<float>();
 template void ReadState::get_next_overlapping_tile_sparse<double>();
 
+template void ReadState::get_next_overlapping_tiles_sparse<int>(
+    int64_t tile_i,
+    int tile_num,
+    std::vector<int64_t>& tiles) const;
+template void ReadState::get_next_overlapping_tiles_sparse<int64_t>(
+    int64_t tile_i,
+    int tile_num,
+    std::vector<int64_t>& tiles) const;
+template void ReadState::get_next_overlapping_tiles_sparse<float>(
+    int64_t tile_i,
+    int tile_num,
+    std::vector<int64_t>& tiles) const;
+template void ReadState::get_next_overlapping_tiles_sparse<double>(
+    int64_t tile_i,
+    int tile_num,
+    std::vector<int64_t>& tiles) const;
+
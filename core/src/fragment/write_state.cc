@@ -41,6 +41,7 @@
 #include <fcntl.h>
 #include <lz4.h>
 #include <iostream>
+#include <limits>
 #include <unistd.h>
 #include <zstd.h>
 
@@ -110,6 +111,14 @@ WriteState::WriteState(
   tile_compressed_ = NULL;
   tile_compressed_allocated_size_ = 0;
 
+  // Initialize tile buffer used for the columnar coordinates layout
+  tile_columnar_ = NULL;
+  tile_columnar_allocated_size_ = 0;
+
+  // Initialize tile buffer used in filtering
+  tile_filtered_ = NULL;
+  tile_filtered_allocated_size_ = 0;
+
   // Initialize current tile offsets
   tile_offsets_.resize(attribute_num+1);
   for(int i=0; i<attribute_num+1; ++i)
@@ -130,6 +139,16 @@ WriteState::WriteState(
   for(int i=0; i<attribute_num; ++i)
     buffer_var_offsets_[i] = 0;
 
+  // Initialize the dictionaries of the dictionary-encoded attributes
+  dictionaries_.resize(attribute_num);
+  dictionary_tile_cell_num_.resize(attribute_num);
+  for(int i=0; i<attribute_num; ++i)
+    dictionary_tile_cell_num_[i] = 0;
+
+  // Initialize the cells of the partially received dense tile
+  pending_cell_num_ = 0;
+  skip_empty_tiles_ = false;
+
   // Initialize current MBR
   mbr_ = malloc(2*coords_size);
 
@@ -154,6 +173,14 @@ WriteState::~WriteState() {
   if(tile_compressed_ != NULL)
     free(tile_compressed_);
 
+  // Free current columnar coordinates tile buffer
+  if(tile_columnar_ != NULL)
+    free(tile_columnar_);
+
+  // Free current filtered tile buffer
+  if(tile_filtered_ != NULL)
+    free(tile_filtered_);
+
   // Free current MBR
   if(mbr_ != NULL)
     free(mbr_);
@@ -182,6 +209,17 @@ int WriteState::finalize() {
     tile_cell_num_[attribute_num] = 0;
   }
 
+  // Write the incomplete last tile (applicable only to the dense case that
+  // skips the empty tiles)
+  if(pending_cell_num_ != 0) {
+    if(write_dense_pending_tile() != TILEDB_WS_OK)
+      return TILEDB_WS_ERR;
+  }
+
+  // Write the dictionaries of the dictionary-encoded attributes
+  if(write_dictionaries() != TILEDB_WS_OK)
+    return TILEDB_WS_ERR;
+
   // Sync all attributes 
   if(sync() != TILEDB_WS_OK) 
     return TILEDB_WS_ERR;
@@ -401,6 +439,9 @@ int WriteState::write(const void** buffers, const size_t* buffer_sizes) {
       tiledb_ws_errmsg = tiledb_ut_errmsg;
       return TILEDB_WS_ERR;
     }
+    // The empty tiles are skipped for the entire fragment, or not at all
+    skip_empty_tiles_ = 
+        fragment_->dense() && fragment_->array()->skip_empty_tiles();
     // For variable length attributes, ensure an empty file exists
     // This is because if the current fragment contains no valid values for this
     // attribute, then the file never gets created. This messes up querying
@@ -452,6 +493,94 @@ int WriteState::write(const void** buffers, const size_t* buffer_sizes) {
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
+void WriteState::buffer_dense_cells(
+    const void** buffers,
+    const size_t* buffer_sizes,
+    int64_t cell_pos,
+    int64_t cell_num) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  const std::vector<int>& attribute_ids = fragment_->array()->attribute_ids();
+  int attribute_id_num = attribute_ids.size(); 
+
+  // Append the cells of each attribute individually
+  int buffer_i = 0;
+  for(int i=0; i<attribute_id_num; ++i) {
+    std::vector<char>& pending_buffer = pending_buffers_[buffer_i];
+    const char* buffer_c = static_cast<const char*>(buffers[buffer_i]);
+    if(!array_schema->var_size(attribute_ids[i])) { // FIXED CELLS
+      size_t cell_size = array_schema->cell_size(attribute_ids[i]);
+      pending_buffer.insert(
+          pending_buffer.end(),
+          buffer_c + cell_pos*cell_size, 
+          buffer_c + (cell_pos+cell_num)*cell_size);
+      ++buffer_i;
+    } else {                                        // VARIABLE-SIZED CELLS
+      std::vector<char>& pending_buffer_var = pending_buffers_[buffer_i+1];
+      const size_t* buffer_s = static_cast<const size_t*>(buffers[buffer_i]);
+      const char* buffer_var_c = static_cast<const char*>(buffers[buffer_i+1]);
+      int64_t buffer_cell_num = 
+          buffer_sizes[buffer_i] / TILEDB_CELL_VAR_OFFSET_SIZE;
+      size_t start = buffer_s[cell_pos];
+      size_t end = (cell_pos + cell_num == buffer_cell_num) 
+                       ? buffer_sizes[buffer_i+1] 
+                       : buffer_s[cell_pos + cell_num];
+
+      // Append the offsets, relative to the held back values
+      size_t offset;
+      for(int64_t j=0; j<cell_num; ++j) {
+        offset = pending_buffer_var.size() + buffer_s[cell_pos+j] - start; 
+        pending_buffer.insert(
+            pending_buffer.end(),
+            reinterpret_cast<const char*>(&offset),
+            reinterpret_cast<const char*>(&offset) + sizeof(size_t));
+      }
+
+      // Append the values
+      pending_buffer_var.insert(
+          pending_buffer_var.end(),
+          buffer_var_c + start,
+          buffer_var_c + end);
+      buffer_i += 2;
+    }
+  }
+
+  pending_cell_num_ += cell_num;
+}
+
+void WriteState::columnarize_coords_tile(
+    unsigned char*& tile, 
+    size_t tile_size) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  int coords_type = array_schema->coords_type();
+  int dim_num = array_schema->dim_num();
+  int64_t cell_num = tile_size / array_schema->coords_size();
+
+  // Expand columnar tile buffer if necessary
+  if(tile_size > tile_columnar_allocated_size_) {
+    tile_columnar_allocated_size_ = tile_size; 
+    tile_columnar_ = realloc(tile_columnar_, tile_size);
+  }
+
+  // Invoke the proper templated function
+  if(coords_type == TILEDB_INT32)
+    coords_to_columnar<int>(
+        (const int*) tile, (int*) tile_columnar_, cell_num, dim_num);
+  else if(coords_type == TILEDB_INT64)
+    coords_to_columnar<int64_t>(
+        (const int64_t*) tile, (int64_t*) tile_columnar_, cell_num, dim_num);
+  else if(coords_type == TILEDB_FLOAT32)
+    coords_to_columnar<float>(
+        (const float*) tile, (float*) tile_columnar_, cell_num, dim_num);
+  else if(coords_type == TILEDB_FLOAT64)
+    coords_to_columnar<double>(
+        (const double*) tile, (double*) tile_columnar_, cell_num, dim_num);
+
+  // The columnar tile is the one to be compressed
+  tile = static_cast<unsigned char*>(tile_columnar_);
+}
+
 int WriteState::compress_tile(
     int attribute_id,
     unsigned char* tile, 
@@ -461,11 +590,26 @@ int WriteState::compress_tile(
   const ArraySchema* array_schema = fragment_->array()->array_schema();
   int compression = array_schema->compression(attribute_id);
 
+  // Store the coordinates of each dimension contiguously. RLE already 
+  // compresses the coordinates of each dimension separately.
+  if(attribute_id == array_schema->attribute_num() &&
+     array_schema->coords_layout() == TILEDB_COORDS_COLUMNAR &&
+     compression != TILEDB_RLE)
+    columnarize_coords_tile(tile, tile_size);
+
   // Handle different compression
   if(compression == TILEDB_GZIP)
-    return compress_tile_gzip(tile, tile_size, tile_compressed_size);
+    return compress_tile_gzip(
+               attribute_id, 
+               tile, 
+               tile_size, 
+               tile_compressed_size);
   else if(compression == TILEDB_ZSTD)
-    return compress_tile_zstd(tile, tile_size, tile_compressed_size);
+    return compress_tile_zstd(
+               attribute_id, 
+               tile, 
+               tile_size, 
+               tile_compressed_size);
   else if(compression == TILEDB_LZ4)
     return compress_tile_lz4(tile, tile_size, tile_compressed_size);
   else if(compression == TILEDB_BLOSC)
@@ -523,9 +667,13 @@ int WriteState::compress_tile(
 }
 
 int WriteState::compress_tile_gzip(
+    int attribute_id,
     unsigned char* tile, 
     size_t tile_size,
     size_t& tile_compressed_size) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+
   // Allocate space to store the compressed tile
   if(tile_compressed_ == NULL) {
     tile_compressed_allocated_size_ = 
@@ -548,7 +696,12 @@ int WriteState::compress_tile_gzip(
 
   // Compress tile
   ssize_t gzip_size = 
-      gzip(tile, tile_size, tile_compressed, tile_compressed_allocated_size_);
+      gzip(
+          tile, 
+          tile_size, 
+          tile_compressed, 
+          tile_compressed_allocated_size_,
+          array_schema->compression_level(attribute_id));
   if(gzip_size == static_cast<ssize_t>(TILEDB_UT_ERR)) {
     tiledb_ws_errmsg = tiledb_ut_errmsg;
     return TILEDB_WS_ERR;
@@ -560,9 +713,13 @@ int WriteState::compress_tile_gzip(
 }
 
 int WriteState::compress_tile_zstd(
+    int attribute_id,
     unsigned char* tile, 
     size_t tile_size,
     size_t& tile_compressed_size) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+
   // Allocate space to store the compressed tile
   size_t compress_bound = ZSTD_compressBound(tile_size);
   if(tile_compressed_ == NULL) {
@@ -587,7 +744,7 @@ int WriteState::compress_tile_zstd(
           tile_compressed_allocated_size_,
           tile, 
           tile_size,
-          TILEDB_COMPRESSION_LEVEL_ZSTD);
+          array_schema->compression_level(attribute_id));
   if(ZSTD_isError(zstd_size)) {
     std::string errmsg = "Failed compressing with Zstandard";
     PRINT_ERROR(errmsg);
@@ -676,9 +833,9 @@ int WriteState::compress_tile_blosc(
   // Compress tile
   int blosc_size = 
       blosc_compress(
-          TILEDB_COMPRESSION_LEVEL_BLOSC,
-          1,
-          array_schema->type_size(attribute_id),
+          array_schema->compression_level(attribute_id),
+          array_schema->blosc_shuffle(attribute_id),
+          array_schema->blosc_typesize(attribute_id),
           tile_size,
           tile, 
           tile_compressed, 
@@ -787,10 +944,23 @@ int WriteState::compress_and_write_tile(int attribute_id) {
   unsigned char* tile = static_cast<unsigned char*>(tiles_[attribute_id]);
   size_t tile_size = tile_offsets_[attribute_id];
 
+  // Keep the number of cells, which delimits the dictionary-encoded values
+  if(attribute_id != array_schema->attribute_num() &&
+     array_schema->filter(attribute_id) == TILEDB_DICTIONARY)
+    dictionary_tile_cell_num_[attribute_id] = 
+        tile_size / TILEDB_CELL_VAR_OFFSET_SIZE;
+
   // Trivial case - No in-memory tile
   if(tile_size == 0)
     return TILEDB_WS_OK;
 
+  // Record the zone map of the tile, before it gets filtered
+  if(book_keeping_->zone_map_size(attribute_id) != 0)
+    compute_zone_map(attribute_id, tile, tile_size);
+
+  // Filter tile before compression
+  filter_tile(attribute_id, tile, tile_size);
+
   // Compress tile
   size_t tile_compressed_size;
   if(compress_tile(
@@ -848,6 +1018,10 @@ int WriteState::compress_and_write_tile_var(int attribute_id) {
   unsigned char* tile = static_cast<unsigned char*>(tiles_var_[attribute_id]);
   size_t tile_size = tiles_var_offsets_[attribute_id];
 
+  // Replace the cell values with their dictionary codes
+  if(array_schema->filter(attribute_id) == TILEDB_DICTIONARY)
+    encode_dictionary_tile(attribute_id, tile, tile_size);
+
   // Trivial case - No in-memory tile
   if(tile_size == 0) {
     // Append offset to book-keeping
@@ -909,6 +1083,123 @@ int WriteState::compress_and_write_tile_var(int attribute_id) {
   return TILEDB_WS_OK;
 }
 
+void WriteState::compute_zone_map(
+    int attribute_id,
+    const void* tile,
+    size_t tile_size) {
+  // For easy reference
+  int type = fragment_->array()->array_schema()->type(attribute_id);
+
+  // Large enough for two values of any numeric type and the two counts
+  int64_t zone_map[4];
+
+  // Compute zone map
+  if(type == TILEDB_INT32)
+    compute_zone_map<int>(
+        static_cast<const int*>(tile), 
+        tile_size / sizeof(int),
+        TILEDB_EMPTY_INT32,
+        zone_map);
+  else if(type == TILEDB_INT64)
+    compute_zone_map<int64_t>(
+        static_cast<const int64_t*>(tile), 
+        tile_size / sizeof(int64_t),
+        TILEDB_EMPTY_INT64,
+        zone_map);
+  else if(type == TILEDB_FLOAT32)
+    compute_zone_map<float>(
+        static_cast<const float*>(tile), 
+        tile_size / sizeof(float),
+        TILEDB_EMPTY_FLOAT32,
+        zone_map);
+  else if(type == TILEDB_FLOAT64)
+    compute_zone_map<double>(
+        static_cast<const double*>(tile), 
+        tile_size / sizeof(double),
+        TILEDB_EMPTY_FLOAT64,
+        zone_map);
+  else  // The program should never reach this point
+    assert(0);
+
+  // Append zone map to book-keeping
+  book_keeping_->append_zone_map(attribute_id, zone_map);
+}
+
+template<class T>
+void WriteState::compute_zone_map(
+    const T* values,
+    int64_t value_num,
+    T empty_value,
+    void* zone_map) const {
+  // The empty value is the maximum value of the type
+  T min = empty_value;
+  T max = std::numeric_limits<T>::lowest();
+  int64_t empty_num = 0;
+
+  // Scan values
+  for(int64_t i=0; i<value_num; ++i) {
+    if(values[i] == empty_value) {
+      ++empty_num;
+      continue;
+    }
+    if(values[i] < min)
+      min = values[i];
+    if(values[i] > max)
+      max = values[i];
+  }
+
+  // All values are empty
+  int64_t non_empty_num = value_num - empty_num;
+  if(non_empty_num == 0)
+    max = empty_value;
+
+  // Store zone map
+  char* zone_map_c = static_cast<char*>(zone_map);
+  memcpy(zone_map_c, &min, sizeof(T));
+  memcpy(zone_map_c + sizeof(T), &max, sizeof(T));
+  memcpy(zone_map_c + 2*sizeof(T), &non_empty_num, sizeof(int64_t));
+  memcpy(
+      zone_map_c + 2*sizeof(T) + sizeof(int64_t), 
+      &empty_num, 
+      sizeof(int64_t));
+}
+
+void WriteState::encode_dictionary_tile(
+    int attribute_id,
+    unsigned char*& tile,
+    size_t& tile_size) {
+  // For easy reference
+  std::map<std::string, int>& dictionary = dictionaries_[attribute_id];
+  int64_t cell_num = dictionary_tile_cell_num_[attribute_id];
+  const size_t* tile_s = static_cast<const size_t*>(tiles_[attribute_id]);
+  const char* tile_c = reinterpret_cast<const char*>(tile);
+  size_t codes_size = cell_num * sizeof(int);
+
+  // Expand filtered tile buffer if necessary
+  if(codes_size > tile_filtered_allocated_size_) {
+    tile_filtered_allocated_size_ = codes_size; 
+    tile_filtered_ = realloc(tile_filtered_, codes_size);
+  }
+  int* codes = static_cast<int*>(tile_filtered_);
+
+  // Encode each cell value, assigning the next code to new values
+  size_t start, end;
+  for(int64_t i=0; i<cell_num; ++i) {
+    start = tile_s[i] - tile_s[0];
+    end = (i == cell_num-1) ? tile_size : tile_s[i+1] - tile_s[0];
+    std::pair<std::map<std::string, int>::iterator, bool> entry = 
+        dictionary.insert(
+            std::pair<std::string, int>(
+                std::string(tile_c + start, end - start), 
+                (int) dictionary.size()));
+    codes[i] = entry.first->second;
+  }
+
+  // The codes are the ones to be compressed
+  tile = static_cast<unsigned char*>(tile_filtered_);
+  tile_size = codes_size;
+}
+
 template<class T>
 void WriteState::expand_mbr(const T* coords) {
   // For easy reference
@@ -928,6 +1219,115 @@ void WriteState::expand_mbr(const T* coords) {
   }
 }
 
+void WriteState::filter_tile(
+    int attribute_id,
+    unsigned char*& tile,
+    size_t tile_size) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  int filter = array_schema->filter(attribute_id);
+
+  // Trivial case (dictionary encoding applies to the variable tiles)
+  if(filter == TILEDB_NO_FILTER || filter == TILEDB_DICTIONARY)
+    return;
+
+  // Expand filtered tile buffer if necessary
+  if(tile_size > tile_filtered_allocated_size_) {
+    tile_filtered_allocated_size_ = tile_size; 
+    tile_filtered_ = realloc(tile_filtered_, tile_size);
+  }
+
+  // Each value is encoded against the same value of the previous cell. For
+  // variable-sized attributes, the tile holds the cell offsets, which are
+  // thus turned into cell lengths.
+  int stride, type;
+  if(array_schema->var_size(attribute_id)) {
+    stride = 1;
+    type = TILEDB_INT64;
+  } else {
+    stride = (attribute_id == array_schema->attribute_num()) 
+                 ? array_schema->dim_num() 
+                 : array_schema->cell_val_num(attribute_id);
+    type = array_schema->type(attribute_id);
+  }
+
+  // Filter tile
+  if(type == TILEDB_INT32) {
+    int64_t value_num = tile_size / sizeof(int);
+    if(filter == TILEDB_DELTA)
+      delta_encode<int>(
+          (const int*) tile, (int*) tile_filtered_, value_num, stride);
+    else if(filter == TILEDB_DOUBLE_DELTA)
+      double_delta_encode<int>(
+          (const int*) tile, (int*) tile_filtered_, value_num, stride);
+  } else if(type == TILEDB_INT64) {
+    int64_t value_num = tile_size / sizeof(int64_t);
+    if(filter == TILEDB_DELTA)
+      delta_encode<int64_t>(
+          (const int64_t*) tile, (int64_t*) tile_filtered_, value_num, stride);
+    else if(filter == TILEDB_DOUBLE_DELTA)
+      double_delta_encode<int64_t>(
+          (const int64_t*) tile, (int64_t*) tile_filtered_, value_num, stride);
+  } else {
+    assert(0);
+    return;
+  }
+
+  // The filtered tile is the one to be compressed
+  tile = static_cast<unsigned char*>(tile_filtered_);
+}
+
+bool WriteState::is_empty_tile(
+    int attribute_id,
+    const void* tile,
+    size_t tile_size) const {
+  // For easy reference
+  int type = fragment_->array()->array_schema()->type(attribute_id);
+
+  // Check the values
+  if(type == TILEDB_INT32)
+    return is_empty_tile<int>(
+               static_cast<const int*>(tile), 
+               tile_size / sizeof(int),
+               TILEDB_EMPTY_INT32);
+  else if(type == TILEDB_INT64)
+    return is_empty_tile<int64_t>(
+               static_cast<const int64_t*>(tile), 
+               tile_size / sizeof(int64_t),
+               TILEDB_EMPTY_INT64);
+  else if(type == TILEDB_FLOAT32)
+    return is_empty_tile<float>(
+               static_cast<const float*>(tile), 
+               tile_size / sizeof(float),
+               TILEDB_EMPTY_FLOAT32);
+  else if(type == TILEDB_FLOAT64)
+    return is_empty_tile<double>(
+               static_cast<const double*>(tile), 
+               tile_size / sizeof(double),
+               TILEDB_EMPTY_FLOAT64);
+  else if(type == TILEDB_CHAR)
+    return is_empty_tile<char>(
+               static_cast<const char*>(tile), 
+               tile_size,
+               TILEDB_EMPTY_CHAR);
+
+  // The program should never reach this point
+  assert(0);
+  return false;
+}
+
+template<class T>
+bool WriteState::is_empty_tile(
+    const T* values, 
+    int64_t value_num, 
+    T empty) const {
+  for(int64_t i=0; i<value_num; ++i) 
+    if(values[i] != empty)
+      return false;
+
+  return true;
+}
+
 void WriteState::shift_var_offsets(
     int attribute_id,
     size_t buffer_var_size,
@@ -1138,6 +1538,10 @@ int WriteState::write_dense(
   const std::vector<int>& attribute_ids = fragment_->array()->attribute_ids();
   int attribute_id_num = attribute_ids.size(); 
 
+  // Handle the case of skipping the empty tiles
+  if(skip_empty_tiles_)
+    return write_dense_skip_empty(buffers, buffer_sizes);
+
   // Write each attribute individually
   int buffer_i = 0;
   for(int i=0; i<attribute_id_num; ++i) {
@@ -1613,6 +2017,272 @@ int WriteState::write_dense_attr_var_cmp(
   return TILEDB_WS_OK;
 }
 
+int WriteState::write_dense_pending_tile() {
+  // For easy reference
+  int buffer_num = pending_buffers_.size();
+
+  // Write the tile from the held back cells
+  std::vector<const void*> buffers(buffer_num);
+  std::vector<size_t> buffer_sizes(buffer_num);
+  for(int i=0; i<buffer_num; ++i) {
+    buffers[i] = pending_buffers_[i].data();
+    buffer_sizes[i] = pending_buffers_[i].size();
+  }
+  if(write_dense_tile(&buffers[0], &buffer_sizes[0], 0, pending_cell_num_) != 
+     TILEDB_WS_OK)
+    return TILEDB_WS_ERR;
+
+  // Clear the held back cells
+  for(int i=0; i<buffer_num; ++i) 
+    pending_buffers_[i].clear();
+  pending_cell_num_ = 0;
+
+  // Success
+  return TILEDB_WS_OK;
+}
+
+int WriteState::write_dense_skip_empty(
+    const void** buffers,
+    const size_t* buffer_sizes) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  const std::vector<int>& attribute_ids = fragment_->array()->attribute_ids();
+  int attribute_id_num = attribute_ids.size(); 
+  int64_t cell_num_per_tile = fragment_->cell_num_per_tile();
+
+  // Get the number of cells, which must be the same in all buffers
+  int64_t cell_num = -1;
+  int64_t buffer_cell_num;
+  int buffer_i = 0;
+  for(int i=0; i<attribute_id_num; ++i) {
+    if(!array_schema->var_size(attribute_ids[i])) { // FIXED CELLS
+      buffer_cell_num = 
+          buffer_sizes[buffer_i] / array_schema->cell_size(attribute_ids[i]);
+      ++buffer_i;
+    } else {                                        // VARIABLE-SIZED CELLS
+      buffer_cell_num = buffer_sizes[buffer_i] / TILEDB_CELL_VAR_OFFSET_SIZE;
+      buffer_i += 2;
+    }
+    if(cell_num == -1) {
+      cell_num = buffer_cell_num;
+    } else if(buffer_cell_num != cell_num) {
+      std::string errmsg = 
+          "Cannot write dense fragment skipping empty tiles; The buffers must "
+          "contain the same number of cells";
+      PRINT_ERROR(errmsg);
+      tiledb_ws_errmsg = TILEDB_WS_ERRMSG + errmsg;
+      return TILEDB_WS_ERR;
+    }
+  }
+  int buffer_num = buffer_i;
+  pending_buffers_.resize(buffer_num);
+
+  // Complete the partially received tile
+  int64_t cell_pos = 0;
+  if(pending_cell_num_ != 0) {
+    cell_pos = std::min(cell_num_per_tile - pending_cell_num_, cell_num);
+    buffer_dense_cells(buffers, buffer_sizes, 0, cell_pos);
+    if(pending_cell_num_ == cell_num_per_tile) {
+      if(write_dense_pending_tile() != TILEDB_WS_OK)
+        return TILEDB_WS_ERR;
+    }
+  }
+
+  // Write the entire tiles directly from the buffers
+  for(; cell_pos + cell_num_per_tile <= cell_num; cell_pos += cell_num_per_tile)
+    if(write_dense_tile(buffers, buffer_sizes, cell_pos, cell_num_per_tile) !=
+       TILEDB_WS_OK)
+      return TILEDB_WS_ERR;
+
+  // Hold back the cells of the (new) partially received tile
+  if(cell_pos < cell_num)
+    buffer_dense_cells(buffers, buffer_sizes, cell_pos, cell_num - cell_pos);
+
+  // Success
+  return TILEDB_WS_OK;
+}
+
+int WriteState::write_dense_tile(
+    const void** buffers,
+    const size_t* buffer_sizes,
+    int64_t cell_pos,
+    int64_t cell_num) {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  const std::vector<int>& attribute_ids = fragment_->array()->attribute_ids();
+  int attribute_id_num = attribute_ids.size(); 
+
+  // Locate the tile in each buffer
+  std::vector<size_t> tile_starts;
+  std::vector<size_t> tile_sizes;
+  for(int i=0; i<attribute_id_num; ++i) {
+    if(!array_schema->var_size(attribute_ids[i])) { // FIXED CELLS
+      size_t cell_size = array_schema->cell_size(attribute_ids[i]);
+      tile_starts.push_back(cell_pos * cell_size);
+      tile_sizes.push_back(cell_num * cell_size);
+    } else {                                        // VARIABLE-SIZED CELLS
+      int buffer_i = tile_starts.size();
+      const size_t* buffer_s = static_cast<const size_t*>(buffers[buffer_i]);
+      int64_t buffer_cell_num = 
+          buffer_sizes[buffer_i] / TILEDB_CELL_VAR_OFFSET_SIZE;
+      size_t start = buffer_s[cell_pos];
+      size_t end = (cell_pos + cell_num == buffer_cell_num) 
+                       ? buffer_sizes[buffer_i+1] 
+                       : buffer_s[cell_pos + cell_num];
+      tile_starts.push_back(cell_pos * TILEDB_CELL_VAR_OFFSET_SIZE);
+      tile_sizes.push_back(cell_num * TILEDB_CELL_VAR_OFFSET_SIZE);
+      tile_starts.push_back(start);
+      tile_sizes.push_back(end - start);
+    }
+  }
+
+  // Check if the tile is empty in every attribute, i.e., if all its
+  // values are empty and each variable-sized cell has a single value
+  bool empty = true;
+  int buffer_i = 0;
+  for(int i=0; i<attribute_id_num && empty; ++i) {
+    int attribute_id = attribute_ids[i];
+    if(!array_schema->var_size(attribute_id)) { // FIXED CELLS
+      empty = is_empty_tile(
+                  attribute_id, 
+                  static_cast<const char*>(buffers[buffer_i]) + 
+                      tile_starts[buffer_i],
+                  tile_sizes[buffer_i]);
+      ++buffer_i;
+    } else {                                    // VARIABLE-SIZED CELLS
+      empty = tile_sizes[buffer_i+1] == 
+                  cell_num * array_schema->type_size(attribute_id) &&
+              is_empty_tile(
+                  attribute_id, 
+                  static_cast<const char*>(buffers[buffer_i+1]) + 
+                      tile_starts[buffer_i+1],
+                  tile_sizes[buffer_i+1]);
+      buffer_i += 2;
+    }
+  }
+
+  // Record the presence of the tile, skipping it if it is empty
+  book_keeping_->append_tile_presence(!empty);
+  if(empty)
+    return TILEDB_WS_OK;
+
+  // Write the tile of each attribute individually
+  buffer_i = 0;
+  for(int i=0; i<attribute_id_num; ++i) {
+    int attribute_id = attribute_ids[i];
+    const char* buffer_c = static_cast<const char*>(buffers[buffer_i]);
+    if(!array_schema->var_size(attribute_id)) { // FIXED CELLS
+      if(write_dense_attr(
+             attribute_id, 
+             buffer_c + tile_starts[buffer_i], 
+             tile_sizes[buffer_i]) != TILEDB_WS_OK)
+        return TILEDB_WS_ERR;
+      ++buffer_i;
+    } else {                                    // VARIABLE-SIZED CELLS
+      // The offsets must be relative to the values of the tile
+      const size_t* buffer_s = static_cast<const size_t*>(buffers[buffer_i]);
+      std::vector<size_t> offsets(cell_num);
+      for(int64_t j=0; j<cell_num; ++j)
+        offsets[j] = buffer_s[cell_pos+j] - tile_starts[buffer_i+1];
+      if(write_dense_attr_var(
+             attribute_id, 
+             &offsets[0],
+             tile_sizes[buffer_i],
+             static_cast<const char*>(buffers[buffer_i+1]) + 
+                 tile_starts[buffer_i+1],
+             tile_sizes[buffer_i+1]) != TILEDB_WS_OK)
+        return TILEDB_WS_ERR;
+      buffer_i += 2;
+    }
+  }
+
+  // Success
+  return TILEDB_WS_OK;
+}
+
+int WriteState::write_dictionaries() {
+  // For easy reference
+  const ArraySchema* array_schema = fragment_->array()->array_schema();
+  const std::vector<int>& attribute_ids = fragment_->array()->attribute_ids();
+  int write_method = fragment_->array()->config()->write_method();
+  int rc = TILEDB_UT_OK;
+
+  for(int i=0; i<(int)attribute_ids.size(); ++i) {
+    // Only for dictionary-encoded attributes
+    int attribute_id = attribute_ids[i];
+    if(attribute_id == array_schema->attribute_num() ||
+       array_schema->filter(attribute_id) != TILEDB_DICTIONARY)
+      continue;
+
+    // Trivial case - No cells written
+    const std::map<std::string, int>& dictionary = dictionaries_[attribute_id];
+    if(dictionary.empty())
+      continue;
+
+    // Order the distinct values by code
+    int64_t entry_num = dictionary.size();
+    std::vector<const std::string*> entries(entry_num);
+    size_t values_size = 0;
+    std::map<std::string, int>::const_iterator it = dictionary.begin();
+    for(; it != dictionary.end(); ++it) {
+      entries[it->second] = &(it->first);
+      values_size += it->first.size();
+    }
+
+    // Serialize dictionary
+    size_t buffer_size = 
+        sizeof(int64_t) + entry_num*sizeof(size_t) + values_size;
+    char* buffer = static_cast<char*>(malloc(buffer_size));
+    size_t* offsets = reinterpret_cast<size_t*>(buffer + sizeof(int64_t));
+    char* values = buffer + sizeof(int64_t) + entry_num*sizeof(size_t);
+    size_t offset = 0;
+    memcpy(buffer, &entry_num, sizeof(int64_t));
+    for(int64_t j=0; j<entry_num; ++j) {
+      offsets[j] = offset;
+      memcpy(values + offset, entries[j]->data(), entries[j]->size());
+      offset += entries[j]->size();
+    }
+
+    // Get the dictionary file name
+    std::string filename = fragment_->fragment_name() + "/" + 
+        array_schema->attribute(attribute_id) + "_dict" + 
+        TILEDB_FILE_SUFFIX;
+
+    // Write dictionary to file
+    if(write_method == TILEDB_IO_WRITE) {
+      rc = write_to_file(filename.c_str(), buffer, buffer_size);
+      if(rc == TILEDB_UT_OK)
+        rc = ::sync(filename.c_str());
+    } else if(write_method == TILEDB_IO_MPI) {
+#ifdef HAVE_MPI
+      MPI_Comm* mpi_comm = fragment_->array()->config()->mpi_comm();
+      rc = mpi_io_write_to_file(mpi_comm, filename.c_str(), buffer, buffer_size);
+      if(rc == TILEDB_UT_OK)
+        rc = mpi_io_sync(mpi_comm, filename.c_str());
+#else
+      // Error: MPI not supported
+      free(buffer);
+      std::string errmsg = "Cannot write dictionary; MPI not supported";
+      PRINT_ERROR(errmsg);
+      tiledb_ws_errmsg = TILEDB_WS_ERRMSG + errmsg;
+      return TILEDB_WS_ERR;
+#endif
+    }
+
+    // Clean up
+    free(buffer);
+
+    // Error
+    if(rc != TILEDB_UT_OK) {
+      tiledb_ws_errmsg = tiledb_ut_errmsg;
+      return TILEDB_WS_ERR;
+    }
+  }
+
+  // Success
+  return TILEDB_WS_OK;
+}
+
 int WriteState::write_sparse(
     const void** buffers,
     const size_t* buffer_sizes) {
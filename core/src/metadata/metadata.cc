@@ -162,12 +162,12 @@ int Metadata::finalize() {
 
 int Metadata::init(
     const ArraySchema* array_schema,
-    const std::vector<std::string>& fragment_names,
-    const std::vector<BookKeeping*>& book_keeping,
+    FragmentSnapshot* fragment_snapshot,
     int mode,
     const char** attributes,
     int attribute_num,
-    const StorageManagerConfig* config) {
+    const StorageManagerConfig* config,
+    ThreadPool* thread_pool) {
   // Sanity check on mode
   if(mode != TILEDB_METADATA_READ &&
      mode != TILEDB_METADATA_WRITE) {
@@ -224,13 +224,13 @@ int Metadata::init(
   array_ = new Array();
   int rc = array_->init(
               array_schema, 
-              fragment_names,
-              book_keeping,
+              fragment_snapshot,
               array_mode, 
               (const char**) array_attributes, 
               array_attribute_num, 
               NULL,
-              config);
+              config,
+              thread_pool);
 
   // Clean up
   for(int i=0; i<array_attribute_num; ++i) 
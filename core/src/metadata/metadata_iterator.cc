@@ -75,6 +75,10 @@ MetadataIterator::~MetadataIterator() {
 /*           ACCESSORS            */
 /* ****************************** */
 
+Metadata* MetadataIterator::metadata() const {
+  return metadata_;
+}
+
 const std::string& MetadataIterator::metadata_name() const {
   return array_it_->array_name();
 }
@@ -0,0 +1,176 @@
+/**
+ * @file   stats.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements classes Stats and StatsTimer.
+ */
+
+#include "stats.h"
+#include <sstream>
+#include <time.h>
+
+
+
+
+/* ****************************** */
+/*           CONSTANTS            */
+/* ****************************** */
+
+/** The counter names, as they appear in the JSON output. */
+static const char* stats_counter_names[Stats::COUNTER_NUM] = {
+    "bytes_read",
+    "cache_hits",
+    "ranges_merged",
+    "tiles_decompressed",
+    "tiles_fetched" };
+
+/** The timer names, as they appear in the JSON output. */
+static const char* stats_timer_names[Stats::TIMER_NUM] = {
+    "book_keeping_load",
+    "copy",
+    "decompress",
+    "fragment_merge",
+    "io",
+    "read",
+    "tile_search" };
+
+
+
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Stats::Stats() {
+  reset();
+}
+
+Stats::~Stats() {
+}
+
+
+
+
+/* ****************************** */
+/*           ACCESSORS            */
+/* ****************************** */
+
+int64_t Stats::counter(Counter counter) const {
+  return counters_[counter].load(std::memory_order_relaxed);
+}
+
+int64_t Stats::time(Timer timer) const {
+  return times_[timer].load(std::memory_order_relaxed);
+}
+
+int64_t Stats::timer_calls(Timer timer) const {
+  return timer_calls_[timer].load(std::memory_order_relaxed);
+}
+
+std::string Stats::to_json() const {
+  std::stringstream ss;
+
+  ss << "{\n  \"counters\": {\n";
+  for(int i=0; i<COUNTER_NUM; ++i) {
+    ss << "    \"" << stats_counter_names[i] << "\": " 
+       << counter(static_cast<Counter>(i))
+       << ((i == COUNTER_NUM-1) ? "\n" : ",\n");
+  }
+  ss << "  },\n  \"timers\": {\n";
+  for(int i=0; i<TIMER_NUM; ++i) {
+    Timer timer = static_cast<Timer>(i);
+    ss << "    \"" << stats_timer_names[i] << "\": { \"calls\": " 
+       << timer_calls(timer) << ", \"seconds\": " << time(timer) / 1e9 << " }"
+       << ((i == TIMER_NUM-1) ? "\n" : ",\n");
+  }
+  ss << "  }\n}\n";
+
+  return ss.str();
+}
+
+
+
+
+/* ****************************** */
+/*            MUTATORS            */
+/* ****************************** */
+
+void Stats::add(Counter counter, int64_t value) {
+  counters_[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Stats::add_time(Timer timer, int64_t nsec) {
+  timer_calls_[timer].fetch_add(1, std::memory_order_relaxed);
+  times_[timer].fetch_add(nsec, std::memory_order_relaxed);
+}
+
+void Stats::merge(const Stats& stats) {
+  for(int i=0; i<COUNTER_NUM; ++i) 
+    add(static_cast<Counter>(i), stats.counter(static_cast<Counter>(i)));
+
+  for(int i=0; i<TIMER_NUM; ++i) {
+    Timer timer = static_cast<Timer>(i);
+    timer_calls_[i].fetch_add(
+        stats.timer_calls(timer), 
+        std::memory_order_relaxed);
+    times_[i].fetch_add(stats.time(timer), std::memory_order_relaxed);
+  }
+}
+
+void Stats::reset() {
+  for(int i=0; i<COUNTER_NUM; ++i) 
+    counters_[i].store(0, std::memory_order_relaxed);
+
+  for(int i=0; i<TIMER_NUM; ++i) {
+    timer_calls_[i].store(0, std::memory_order_relaxed);
+    times_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+
+
+
+/* ****************************** */
+/*          STATS TIMER           */
+/* ****************************** */
+
+/** Returns the current value of the monotonic clock in nanoseconds. */
+static inline int64_t stats_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+StatsTimer::StatsTimer(Stats* stats, Stats::Timer timer) 
+    : stats_(stats), timer_(timer) {
+  start_ = stats_now();
+}
+
+StatsTimer::~StatsTimer() {
+  stats_->add_time(timer_, stats_now() - start_);
+}
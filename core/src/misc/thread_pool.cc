@@ -0,0 +1,239 @@
+/**
+ * @file   thread_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @section DESCRIPTION
+ *
+ * This file implements the ThreadPool class.
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <iostream>
+
+
+
+
+/* ****************************** */
+/*             MACROS             */
+/* ****************************** */
+
+#ifdef TILEDB_VERBOSE
+#  define PRINT_ERROR(x) std::cerr << TILEDB_TP_ERRMSG << x << ".\n" 
+#else
+#  define PRINT_ERROR(x) do { } while(0) 
+#endif
+
+
+
+
+/* ****************************** */
+/*        GLOBAL VARIABLES        */
+/* ****************************** */
+
+thread_local std::string tiledb_tp_errmsg = "";
+
+
+
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ThreadPool::ThreadPool(int thread_num) 
+    : thread_num_(thread_num) {
+  func_ = NULL;
+  func_data_ = NULL;
+  initialized_ = false;
+  run_num_ = 0;
+  stop_ = false;
+  waiting_run_num_ = 0;
+}
+
+ThreadPool::~ThreadPool() {
+  // Trivial case
+  if(!initialized_)
+    return;
+
+  // Stop the threads
+  pthread_mutex_lock(&mtx_);
+  stop_ = true;
+  pthread_cond_broadcast(&work_cond_);
+  pthread_mutex_unlock(&mtx_);
+  int thread_num = threads_.size();
+  for(int i=0; i<thread_num; ++i)
+    pthread_join(threads_[i], NULL);
+
+  // Clean up
+  pthread_cond_destroy(&done_cond_);
+  pthread_cond_destroy(&work_cond_);
+  pthread_mutex_destroy(&mtx_);
+  pthread_mutex_destroy(&run_mtx_);
+}
+
+
+
+
+/* ****************************** */
+/*            MUTATORS            */
+/* ****************************** */
+
+int ThreadPool::init() {
+  // Initialize mutexes
+  if(pthread_mutex_init(&mtx_, NULL)) {
+    std::string errmsg = "Cannot initialize thread pool mutex";
+    PRINT_ERROR(errmsg);
+    tiledb_tp_errmsg = TILEDB_TP_ERRMSG + errmsg;
+    return TILEDB_TP_ERR;
+  }
+  if(pthread_mutex_init(&run_mtx_, NULL)) {
+    pthread_mutex_destroy(&mtx_);
+    std::string errmsg = "Cannot initialize thread pool mutex";
+    PRINT_ERROR(errmsg);
+    tiledb_tp_errmsg = TILEDB_TP_ERRMSG + errmsg;
+    return TILEDB_TP_ERR;
+  }
+
+  // Initialize conditions
+  if(pthread_cond_init(&done_cond_, NULL)) {
+    pthread_mutex_destroy(&run_mtx_);
+    pthread_mutex_destroy(&mtx_);
+    std::string errmsg = "Cannot initialize thread pool condition";
+    PRINT_ERROR(errmsg);
+    tiledb_tp_errmsg = TILEDB_TP_ERRMSG + errmsg;
+    return TILEDB_TP_ERR;
+  }
+  if(pthread_cond_init(&work_cond_, NULL)) {
+    pthread_cond_destroy(&done_cond_);
+    pthread_mutex_destroy(&run_mtx_);
+    pthread_mutex_destroy(&mtx_);
+    std::string errmsg = "Cannot initialize thread pool condition";
+    PRINT_ERROR(errmsg);
+    tiledb_tp_errmsg = TILEDB_TP_ERRMSG + errmsg;
+    return TILEDB_TP_ERR;
+  }
+  initialized_ = true;
+
+  // Success
+  return TILEDB_TP_OK;
+}
+
+int ThreadPool::run(void *(*func)(void*), void* data, int thread_num) {
+  // Sanity check
+  if(!initialized_) {
+    std::string errmsg = "Cannot run function; Thread pool not initialized";
+    PRINT_ERROR(errmsg);
+    tiledb_tp_errmsg = TILEDB_TP_ERRMSG + errmsg;
+    return TILEDB_TP_ERR;
+  }
+
+  // Trivial case - the pool is busy, so the calling thread runs the function
+  // alone
+  if(thread_num <= 1 || pthread_mutex_trylock(&run_mtx_)) {
+    func(data);
+    return TILEDB_TP_OK;
+  }
+
+  // Create the missing threads. If a thread cannot be created, the function
+  // runs on the threads created so far.
+  if(thread_num > thread_num_)
+    thread_num = thread_num_;
+  while(int(threads_.size()) < thread_num-1) {
+    pthread_t thread;
+    if(pthread_create(&thread, NULL, work_s, this))
+      break;
+    threads_.push_back(thread);
+  }
+  int pool_run_num = std::min(thread_num-1, int(threads_.size()));
+
+  // Trivial case - the calling thread runs the function alone
+  if(pool_run_num <= 0) {
+    pthread_mutex_unlock(&run_mtx_);
+    func(data);
+    return TILEDB_TP_OK;
+  }
+
+  // Hand the function to the pool threads
+  pthread_mutex_lock(&mtx_);
+  func_ = func;
+  func_data_ = data;
+  run_num_ = pool_run_num;
+  waiting_run_num_ = pool_run_num;
+  pthread_cond_broadcast(&work_cond_);
+  pthread_mutex_unlock(&mtx_);
+
+  // Run the function on the calling thread as well
+  func(data);
+
+  // Wait for the pool threads
+  pthread_mutex_lock(&mtx_);
+  while(run_num_ > 0)
+    pthread_cond_wait(&done_cond_, &mtx_);
+  func_ = NULL;
+  func_data_ = NULL;
+  pthread_mutex_unlock(&mtx_);
+  pthread_mutex_unlock(&run_mtx_);
+
+  // Success
+  return TILEDB_TP_OK;
+}
+
+
+
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void ThreadPool::work() {
+  pthread_mutex_lock(&mtx_);
+  for(;;) {
+    // Wait for a function to run
+    while(!stop_ && waiting_run_num_ == 0)
+      pthread_cond_wait(&work_cond_, &mtx_);
+    if(stop_)
+      break;
+
+    // Run the function
+    --waiting_run_num_;
+    void *(*func)(void*) = func_;
+    void* func_data = func_data_;
+    pthread_mutex_unlock(&mtx_);
+    func(func_data);
+    pthread_mutex_lock(&mtx_);
+
+    // Notify the calling thread if this is the last run
+    if(--run_num_ == 0)
+      pthread_cond_signal(&done_cond_);
+  }
+  pthread_mutex_unlock(&mtx_);
+}
+
+void *ThreadPool::work_s(void* data) {
+  static_cast<ThreadPool*>(data)->work();
+
+  return NULL;
+}
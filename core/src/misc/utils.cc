@@ -34,16 +34,20 @@
 #include "utils.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <dirent.h>
 #include <fcntl.h>
 #include <iostream>
+#include <limits>
 #include <netdb.h>
 #include <set>
+#include <type_traits>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 
 #if defined(__APPLE__) && defined(__MACH__)
   #include <sys/types.h>
@@ -82,7 +86,7 @@
 /*        GLOBAL VARIABLES        */
 /* ****************************** */
 
-std::string tiledb_ut_errmsg = "";
+thread_local std::string tiledb_ut_errmsg = "";
 
 
 
@@ -109,6 +113,42 @@ bool array_write_mode(int mode) {
          mode == TILEDB_ARRAY_WRITE_UNSORTED;
 }
 
+void balanced_partitions(
+    const std::vector<double>& weights,
+    int partition_num,
+    std::vector<int64_t>& partition_starts) {
+  // For easy reference
+  int64_t unit_num = weights.size();
+  partition_starts.clear();
+  if(unit_num == 0 || partition_num <= 0)
+    return;
+  partition_num = int(std::min(int64_t(partition_num), unit_num));
+
+  // Count the units if they carry no weight 
+  double weight_total = 0;
+  for(int64_t i=0; i<unit_num; ++i)
+    weight_total += weights[i];
+  bool count_units = (weight_total <= 0);
+  if(count_units)
+    weight_total = unit_num;
+
+  // Start a new partition at a unit whose weight midpoint exceeds the share
+  // of the partitions started so far, or when each of the remaining 
+  // partitions must get one of the remaining units
+  partition_starts.push_back(0);
+  double weight_before = 0;
+  for(int64_t i=0; i<unit_num; ++i) {
+    double weight = count_units ? 1 : weights[i];
+    int started = partition_starts.size();
+    if(i > 0 && started < partition_num &&
+       (weight_before + weight / 2 > 
+            weight_total * started / partition_num ||
+        unit_num - i <= partition_num - started))
+      partition_starts.push_back(i);
+    weight_before += weight;
+  }
+}
+
 bool both_slashes(char a, char b) {
   return a == '/' && b == '/';
 }
@@ -116,6 +156,17 @@ bool both_slashes(char a, char b) {
 template<class T>
 inline
 bool cell_in_subarray(const T* cell, const T* subarray, int dim_num) {
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num, cell_in_subarray_kernel, T, cell, subarray, dim_num);
+}
+
+template<class T, int N>
+inline
+bool cell_in_subarray_kernel(const T* cell, const T* subarray, int dim_num) {
+  // The number of dimensions is a compile-time constant, unless N is 0
+  if(N > 0)
+    dim_num = N;
+
   for(int i=0; i<dim_num; ++i) {
     if(cell[i] >= subarray[2*i] && cell[i] <= subarray[2*i+1])
       continue; // Inside this dimension domain
@@ -126,6 +177,129 @@ bool cell_in_subarray(const T* cell, const T* subarray, int dim_num) {
   return true;
 }
 
+template<class T, class S>
+void cells_aggregate(
+    const T* values,
+    int64_t value_num,
+    T empty_value,
+    int64_t& count,
+    S& sum,
+    T& min,
+    T& max) {
+  // Local accumulators and no branches inside the loop, so that it can be 
+  // vectorized. The empty value is the maximum of the type, hence it never
+  // changes the minimum.
+  int64_t local_count = 0;
+  S local_sum = 0;
+  T local_min = min;
+  T local_max = max;
+  for(int64_t i=0; i<value_num; ++i) {
+    T value = values[i];
+    bool non_empty = (value != empty_value);
+    local_count += non_empty;
+    local_sum += non_empty ? S(value) : S(0);
+    local_min = (value < local_min) ? value : local_min;
+    local_max = (non_empty && value > local_max) ? value : local_max;
+  }
+
+  count += local_count;
+  sum += local_sum;
+  min = local_min;
+  max = local_max;
+}
+
+template<class T>
+void cells_cmp_value(
+    const T* values,
+    int64_t value_num,
+    int op,
+    T value,
+    T empty_value,
+    unsigned char* bitmap) {
+  // One loop per operator, each without branches so that it can be vectorized
+  switch(op) {
+    case TILEDB_LT:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] < value) & (values[i] != empty_value);
+      break;
+    case TILEDB_LE:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] <= value) & (values[i] != empty_value);
+      break;
+    case TILEDB_GT:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] > value) & (values[i] != empty_value);
+      break;
+    case TILEDB_GE:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] >= value) & (values[i] != empty_value);
+      break;
+    case TILEDB_EQ:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] == value) & (values[i] != empty_value);
+      break;
+    case TILEDB_NE:
+      for(int64_t i=0; i<value_num; ++i)
+        bitmap[i] &= (values[i] != value) & (values[i] != empty_value);
+      break;
+    default:  // The program should never reach this point
+      assert(0);
+  }
+}
+
+template<class T>
+void cells_in_subarray(
+    const T* cells,
+    int64_t cell_num,
+    const T* subarray,
+    int dim_num,
+    unsigned char* bitmap) {
+  // The kernels return void, hence the dispatch cannot return their result
+  switch(dim_num) {
+    case 1: 
+      cells_in_subarray_kernel<T, 1>(cells, cell_num, subarray, 1, bitmap); 
+      break;
+    case 2: 
+      cells_in_subarray_kernel<T, 2>(cells, cell_num, subarray, 2, bitmap); 
+      break;
+    case 3: 
+      cells_in_subarray_kernel<T, 3>(cells, cell_num, subarray, 3, bitmap); 
+      break;
+    case 4: 
+      cells_in_subarray_kernel<T, 4>(cells, cell_num, subarray, 4, bitmap); 
+      break;
+    default:
+      cells_in_subarray_kernel<T, 0>(
+          cells, 
+          cell_num, 
+          subarray, 
+          dim_num, 
+          bitmap); 
+  }
+}
+
+template<class T, int N>
+inline
+void cells_in_subarray_kernel(
+    const T* cells,
+    int64_t cell_num,
+    const T* subarray,
+    int dim_num,
+    unsigned char* bitmap) {
+  // The number of dimensions is a compile-time constant, unless N is 0
+  if(N > 0)
+    dim_num = N;
+
+  // No branches inside the loop, so that it can be vectorized
+  const T* cell = cells;
+  for(int64_t c=0; c<cell_num; ++c, cell += dim_num) {
+    unsigned char in = 1;
+    for(int i=0; i<dim_num; ++i) 
+      in &= (cell[i] >= subarray[2*i]) & (cell[i] <= subarray[2*i+1]);
+    bitmap[c] = in;
+  }
+}
+
 template<class T>
 int64_t cell_num_in_subarray(const T* subarray, int dim_num) {
   int64_t cell_num = 1;
@@ -141,17 +315,8 @@ int cmp_col_order(
     const T* coords_a,
     const T* coords_b,
     int dim_num) {
-  for(int i=dim_num-1; i>=0; --i) {
-    // a precedes b
-    if(coords_a[i] < coords_b[i])
-      return -1;
-    // b precedes a
-    else if(coords_a[i] > coords_b[i])
-      return 1;
-  }
-
-  // a and b are equal
-  return 0;
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num, cmp_col_order_kernel, T, coords_a, coords_b, dim_num);
 }
 
 template<class T> 
@@ -170,6 +335,19 @@ int cmp_col_order(
     return 1;
 
   // ids are equal, check the coordinates
+  return cmp_col_order(coords_a, coords_b, dim_num);
+}
+
+template<class T, int N>
+inline
+int cmp_col_order_kernel(
+    const T* coords_a,
+    const T* coords_b,
+    int dim_num) {
+  // The number of dimensions is a compile-time constant, unless N is 0
+  if(N > 0)
+    dim_num = N;
+
   for(int i=dim_num-1; i>=0; --i) {
     // a precedes b
     if(coords_a[i] < coords_b[i])
@@ -188,17 +366,8 @@ int cmp_row_order(
     const T* coords_a,
     const T* coords_b,
     int dim_num) {
-  for(int i=0; i<dim_num; ++i) {
-    // a precedes b
-    if(coords_a[i] < coords_b[i])
-      return -1;
-    // b precedes a
-    else if(coords_a[i] > coords_b[i])
-      return 1;
-  }
-
-  // a and b are equal
-  return 0;
+  TILEDB_UT_DIM_NUM_DISPATCH(
+      dim_num, cmp_row_order_kernel, T, coords_a, coords_b, dim_num);
 }
 
 template<class T> 
@@ -217,6 +386,19 @@ int cmp_row_order(
     return 1;
 
   // ids are equal, check the coordinates
+  return cmp_row_order(coords_a, coords_b, dim_num);
+}
+
+template<class T, int N>
+inline
+int cmp_row_order_kernel(
+    const T* coords_a,
+    const T* coords_b,
+    int dim_num) {
+  // The number of dimensions is a compile-time constant, unless N is 0
+  if(N > 0)
+    dim_num = N;
+
   for(int i=0; i<dim_num; ++i) {
     // a precedes b
     if(coords_a[i] < coords_b[i])
@@ -230,6 +412,32 @@ int cmp_row_order(
   return 0;
 }
 
+template<class T>
+void coords_from_columnar(
+    const T* in, 
+    T* out, 
+    int64_t cell_num, 
+    int dim_num) {
+  for(int i=0; i<dim_num; ++i) {
+    const T* in_dim = in + i*cell_num;
+    for(int64_t j=0; j<cell_num; ++j)
+      out[j*dim_num+i] = in_dim[j];
+  }
+}
+
+template<class T>
+void coords_to_columnar(
+    const T* in, 
+    T* out, 
+    int64_t cell_num, 
+    int dim_num) {
+  for(int i=0; i<dim_num; ++i) {
+    T* out_dim = out + i*cell_num;
+    for(int64_t j=0; j<cell_num; ++j)
+      out_dim[j] = in[j*dim_num+i];
+  }
+}
+
 int create_dir(const std::string& dir) {
   // Get real directory path
   std::string real_dir = ::real_dir(dir);
@@ -339,6 +547,70 @@ int delete_dir(const std::string& dirname) {
   return TILEDB_UT_OK;
 }
 
+template<class T>
+void delta_decode(T* buffer, int64_t value_num, int stride) {
+  // Operate on unsigned values, so that overflows wrap around
+  typedef typename std::make_unsigned<T>::type U;
+  U* values = reinterpret_cast<U*>(buffer);
+
+  for(int64_t i=stride; i<value_num; ++i)
+    values[i] += values[i-stride];
+}
+
+template<class T>
+void delta_encode(const T* in, T* out, int64_t value_num, int stride) {
+  // Operate on unsigned values, so that overflows wrap around
+  typedef typename std::make_unsigned<T>::type U;
+  const U* in_values = reinterpret_cast<const U*>(in);
+  U* out_values = reinterpret_cast<U*>(out);
+
+  int64_t head = std::min(value_num, (int64_t) stride);
+  for(int64_t i=0; i<head; ++i)
+    out_values[i] = in_values[i];
+  for(int64_t i=stride; i<value_num; ++i)
+    out_values[i] = in_values[i] - in_values[i-stride];
+}
+
+template<class T>
+void double_delta_decode(T* buffer, int64_t value_num, int stride) {
+  // Operate on unsigned values, so that overflows wrap around
+  typedef typename std::make_unsigned<T>::type U;
+  U* values = reinterpret_cast<U*>(buffer);
+  U z, delta;
+
+  for(int64_t i=stride; i<value_num; ++i) {
+    // Zig-zag decoding
+    z = values[i];
+    delta = (z >> 1) ^ (U) (-(z & 1));
+    // The first deltas are stored as they are
+    if(i >= 2*stride)
+      delta += values[i-stride] - values[i-2*stride];
+    values[i] = values[i-stride] + delta;
+  }
+}
+
+template<class T>
+void double_delta_encode(const T* in, T* out, int64_t value_num, int stride) {
+  // Operate on unsigned values, so that overflows wrap around
+  typedef typename std::make_unsigned<T>::type U;
+  const int bits = 8 * sizeof(U);
+  const U* in_values = reinterpret_cast<const U*>(in);
+  U* out_values = reinterpret_cast<U*>(out);
+  U delta;
+
+  int64_t head = std::min(value_num, (int64_t) stride);
+  for(int64_t i=0; i<head; ++i)
+    out_values[i] = in_values[i];
+  for(int64_t i=stride; i<value_num; ++i) {
+    delta = in_values[i] - in_values[i-stride];
+    // The first deltas are stored as they are
+    if(i >= 2*stride)
+      delta -= in_values[i-stride] - in_values[i-2*stride];
+    // Zig-zag encoding
+    out_values[i] = (delta << 1) ^ (U) (-(delta >> (bits-1)));
+  }
+}
+
 template<class T>
 bool empty_value(T value) {
   if(&typeid(T) == &typeid(int))
@@ -398,6 +670,42 @@ off_t file_size(const std::string& filename) {
   return file_size;
 }
 
+void fill_offsets(
+    void* buffer, 
+    size_t start, 
+    size_t step, 
+    int64_t offset_num) {
+  size_t* offsets = static_cast<size_t*>(buffer);
+  for(int64_t i=0; i<offset_num; ++i)
+    offsets[i] = start + i * step;
+}
+
+void fill_pattern(
+    void* buffer, 
+    const void* pattern, 
+    size_t pattern_size, 
+    int64_t pattern_num) {
+  // Nothing to do
+  if(pattern_num <= 0)
+    return;
+
+  // Write the pattern once
+  char* buffer_c = static_cast<char*>(buffer);
+  size_t bytes_total = pattern_size * pattern_num;
+  memcpy(buffer_c, pattern, pattern_size);
+
+  // Copy the filled prefix after itself, doubling it up to the chunk size
+  size_t bytes_filled = pattern_size;
+  size_t chunk_size = pattern_size;
+  while(bytes_filled < bytes_total) {
+    size_t bytes_to_copy = std::min(chunk_size, bytes_total - bytes_filled);
+    memcpy(buffer_c + bytes_filled, buffer_c, bytes_to_copy);
+    bytes_filled += bytes_to_copy;
+    if(chunk_size < TILEDB_UT_FILL_CHUNK_SIZE)
+      chunk_size = bytes_filled;
+  }
+}
+
 std::vector<std::string> get_dirs(const std::string& dir) {
   std::vector<std::string> dirs;
   std::string new_dir; 
@@ -515,7 +823,8 @@ ssize_t gzip(
     unsigned char* in, 
     size_t in_size,
     unsigned char* out, 
-    size_t out_size) {
+    size_t out_size,
+    int level) {
 
   ssize_t ret;
   z_stream strm;
@@ -524,7 +833,9 @@ ssize_t gzip(
   strm.zalloc = Z_NULL;
   strm.zfree = Z_NULL;
   strm.opaque = Z_NULL;
-  ret = deflateInit(&strm, TILEDB_COMPRESSION_LEVEL_GZIP);
+  if(level == TILEDB_COMPRESSION_LEVEL_DEFAULT)
+    level = TILEDB_COMPRESSION_LEVEL_GZIP;
+  ret = deflateInit(&strm, level);
 
   if(ret != Z_OK) {
     std::string errmsg = "Cannot compress with GZIP";
@@ -973,6 +1284,65 @@ int mutex_unlock(pthread_mutex_t* mtx) {
   }
 }
 
+std::string new_fragment_id() {
+  // The MAC address is retrieved once per process
+  static const std::string mac = get_mac_addr();
+  if(mac == "")
+    return "";
+
+  // The process-wide generator state
+  static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+  static uint64_t last_ms = 0;
+  static uint64_t last_seq = 0;
+
+  // Get the current time in ms
+  struct timeval tp;
+  gettimeofday(&tp, NULL);
+  uint64_t ms = (uint64_t) tp.tv_sec * 1000L + tp.tv_usec / 1000;
+
+  // Draw the timestamp and the sequence number
+  if(mutex_lock(&mtx) != TILEDB_UT_OK)
+    return "";
+  if(ms < last_ms)
+    ms = last_ms;
+  else
+    last_ms = ms;
+  uint64_t seq = ++last_seq;
+  if(mutex_unlock(&mtx) != TILEDB_UT_OK)
+    return "";
+
+  // Get the thread id
+  pthread_t self = pthread_self();
+  uint64_t tid = 0;
+  memcpy(&tid, &self, std::min(sizeof(self), sizeof(tid)));
+
+  // Generate fragment id
+  char fragment_id[TILEDB_NAME_MAX_LEN];
+  int n = sprintf(
+              fragment_id, 
+              "%s%llu_%llu_%llu", 
+              mac.c_str(),
+              (unsigned long long) tid, 
+              (unsigned long long) ms,
+              (unsigned long long) seq);
+
+  // Handle error
+  if(n<0) 
+    return "";
+
+  // Return
+  return fragment_id;
+}
+
+template<class T>
+T next_value(T value) {
+  if(std::numeric_limits<T>::is_integer)
+    return value + 1;
+  else
+    return static_cast<T>(
+               std::nextafter(value, std::numeric_limits<T>::max()));
+}
+
 std::string parent_dir(const std::string& dir) {
   // Get real dir
   std::string real_dir = ::real_dir(dir);
@@ -991,6 +1361,15 @@ std::string parent_dir(const std::string& dir) {
   return real_dir.substr(0, pos); 
 }
 
+template<class T>
+T previous_value(T value) {
+  if(std::numeric_limits<T>::is_integer)
+    return value - 1;
+  else
+    return static_cast<T>(
+               std::nextafter(value, std::numeric_limits<T>::lowest()));
+}
+
 void purge_dots_from_path(std::string& path) {
   // For easy reference
   size_t path_size = path.size(); 
@@ -1809,6 +2188,35 @@ int RLE_decompress_coords_row(
   return TILEDB_UT_OK;
 }
 
+void set_bitmap_range(
+    unsigned char* bitmap, 
+    int64_t start, 
+    int64_t end, 
+    bool value) {
+  // Set the leading bits up to the first byte boundary
+  for(; start < end && (start & 7); ++start) {
+    if(value)
+      bitmap[start >> 3] |= (unsigned char) (1 << (start & 7));
+    else
+      bitmap[start >> 3] &= (unsigned char) ~(1 << (start & 7));
+  }
+
+  // Set the whole bytes at once
+  int64_t byte_num = (end - start) >> 3;
+  if(byte_num > 0) {
+    memset(bitmap + (start >> 3), value ? 0xff : 0, byte_num);
+    start += byte_num << 3;
+  }
+
+  // Set the trailing bits
+  for(; start < end; ++start) {
+    if(value)
+      bitmap[start >> 3] |= (unsigned char) (1 << (start & 7));
+    else
+      bitmap[start >> 3] &= (unsigned char) ~(1 << (start & 7));
+  }
+}
+
 bool starts_with(const std::string& value, const std::string& prefix) {
   if (prefix.size() > value.size())
     return false;
@@ -2002,6 +2410,93 @@ template bool cell_in_subarray<double>(
     const double* subarray,
     int dim_num);
 
+template void cells_aggregate<int, int64_t>(
+    const int* values,
+    int64_t value_num,
+    int empty_value,
+    int64_t& count,
+    int64_t& sum,
+    int& min,
+    int& max);
+template void cells_aggregate<int64_t, int64_t>(
+    const int64_t* values,
+    int64_t value_num,
+    int64_t empty_value,
+    int64_t& count,
+    int64_t& sum,
+    int64_t& min,
+    int64_t& max);
+template void cells_aggregate<float, double>(
+    const float* values,
+    int64_t value_num,
+    float empty_value,
+    int64_t& count,
+    double& sum,
+    float& min,
+    float& max);
+template void cells_aggregate<double, double>(
+    const double* values,
+    int64_t value_num,
+    double empty_value,
+    int64_t& count,
+    double& sum,
+    double& min,
+    double& max);
+
+template void cells_cmp_value<int>(
+    const int* values,
+    int64_t value_num,
+    int op,
+    int value,
+    int empty_value,
+    unsigned char* bitmap);
+template void cells_cmp_value<int64_t>(
+    const int64_t* values,
+    int64_t value_num,
+    int op,
+    int64_t value,
+    int64_t empty_value,
+    unsigned char* bitmap);
+template void cells_cmp_value<float>(
+    const float* values,
+    int64_t value_num,
+    int op,
+    float value,
+    float empty_value,
+    unsigned char* bitmap);
+template void cells_cmp_value<double>(
+    const double* values,
+    int64_t value_num,
+    int op,
+    double value,
+    double empty_value,
+    unsigned char* bitmap);
+
+template void cells_in_subarray<int>(
+    const int* cells,
+    int64_t cell_num,
+    const int* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+template void cells_in_subarray<int64_t>(
+    const int64_t* cells,
+    int64_t cell_num,
+    const int64_t* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+template void cells_in_subarray<float>(
+    const float* cells,
+    int64_t cell_num,
+    const float* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+template void cells_in_subarray<double>(
+    const double* cells,
+    int64_t cell_num,
+    const double* subarray,
+    int dim_num,
+    unsigned char* bitmap);
+
 template int cmp_col_order<int>(
     const int* coords_a,
     const int* coords_b,
@@ -2086,6 +2581,88 @@ template int cmp_row_order<double>(
     const double* coords_b,
     int dim_num);
 
+template void coords_from_columnar<int>(
+    const int* in, 
+    int* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_from_columnar<int64_t>(
+    const int64_t* in, 
+    int64_t* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_from_columnar<float>(
+    const float* in, 
+    float* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_from_columnar<double>(
+    const double* in, 
+    double* out, 
+    int64_t cell_num, 
+    int dim_num);
+
+template void coords_to_columnar<int>(
+    const int* in, 
+    int* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_to_columnar<int64_t>(
+    const int64_t* in, 
+    int64_t* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_to_columnar<float>(
+    const float* in, 
+    float* out, 
+    int64_t cell_num, 
+    int dim_num);
+template void coords_to_columnar<double>(
+    const double* in, 
+    double* out, 
+    int64_t cell_num, 
+    int dim_num);
+
+template void delta_decode<int>(
+    int* buffer, 
+    int64_t value_num, 
+    int stride);
+template void delta_decode<int64_t>(
+    int64_t* buffer, 
+    int64_t value_num, 
+    int stride);
+
+template void delta_encode<int>(
+    const int* in, 
+    int* out, 
+    int64_t value_num, 
+    int stride);
+template void delta_encode<int64_t>(
+    const int64_t* in, 
+    int64_t* out, 
+    int64_t value_num, 
+    int stride);
+
+template void double_delta_decode<int>(
+    int* buffer, 
+    int64_t value_num, 
+    int stride);
+template void double_delta_decode<int64_t>(
+    int64_t* buffer, 
+    int64_t value_num, 
+    int stride);
+
+template void double_delta_encode<int>(
+    const int* in, 
+    int* out, 
+    int64_t value_num, 
+    int stride);
+template void double_delta_encode<int64_t>(
+    const int64_t* in, 
+    int64_t* out, 
+    int64_t value_num, 
+    int stride);
+
 template bool empty_value<int>(int value);
 template bool empty_value<int64_t>(int64_t value);
 template bool empty_value<float>(float value);
@@ -2153,3 +2730,13 @@ template bool is_unary_subarray<int64_t>(const int64_t* subarray, int dim_num);
 template bool is_unary_subarray<float>(const float* subarray, int dim_num);
 template bool is_unary_subarray<double>(const double* subarray, int dim_num);
 
+template int next_value<int>(int value);
+template int64_t next_value<int64_t>(int64_t value);
+template float next_value<float>(float value);
+template double next_value<double>(double value);
+
+template int previous_value<int>(int value);
+template int64_t previous_value<int64_t>(int64_t value);
+template float previous_value<float>(float value);
+template double previous_value<double>(double value);
+
@@ -73,6 +73,11 @@
 
 std::string tiledb_sm_errmsg = "";
 
+std::map<std::string, StorageManager::OpenArray*> 
+    StorageManager::snapshot_arrays_;
+pthread_mutex_t StorageManager::snapshot_arrays_mtx_ = 
+    PTHREAD_MUTEX_INITIALIZER;
+
 
 
 
@@ -81,6 +86,8 @@ std::string tiledb_sm_errmsg = "";
 /* ****************************** */
 
 StorageManager::StorageManager() {
+  stat_saved_num_ = 0;
+  thread_pool_ = NULL;
 }
 
 StorageManager::~StorageManager() {
@@ -97,14 +104,42 @@ int StorageManager::finalize() {
   if(config_ != NULL)
     delete config_;
 
-  return open_array_mtx_destroy();
+  // Stop the threads of the pool
+  if(thread_pool_ != NULL) {
+    delete thread_pool_;
+    thread_pool_ = NULL;
+  }
+
+  // Clear the caches
+  object_type_cache_.clear();
+  schema_cache_.clear();
+
+  // Destroy mutexes
+  int rc_cache_mtx = cache_mtx_destroy();
+  int rc_open_array_mtx = open_array_mtx_destroy();
+  if(rc_cache_mtx != TILEDB_SM_OK || rc_open_array_mtx != TILEDB_SM_OK)
+    return TILEDB_SM_ERR;
+
+  // Success
+  return TILEDB_SM_OK;
 }
 
 int StorageManager::init(StorageManagerConfig* config) {
+  // Initialize the cache mutexes, used by the master catalog checks below
+  if(cache_mtx_init() != TILEDB_SM_OK)
+    return TILEDB_SM_ERR;
+
   // Set configuration parameters
   if(config_set(config) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
 
+  // Create the thread pool
+  thread_pool_ = new ThreadPool(TILEDB_CTX_THREAD_NUM);
+  if(thread_pool_->init() != TILEDB_TP_OK) {
+    tiledb_sm_errmsg = tiledb_tp_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
   // Set the master catalog directory
   master_catalog_dir_ = tiledb_home_ + "/" + TILEDB_SM_MASTER_CATALOG;
 
@@ -136,10 +171,10 @@ int StorageManager::init(StorageManagerConfig* config) {
 int StorageManager::workspace_create(const std::string& workspace) {
   // Check if the workspace is inside a workspace or another group
   std::string parent_dir = ::parent_dir(workspace);
-  if(is_workspace(parent_dir) || 
-     is_group(parent_dir) ||
-     is_array(parent_dir) ||
-     is_metadata(parent_dir)) {
+  if(is_object(parent_dir, TILEDB_WORKSPACE) || 
+     is_object(parent_dir, TILEDB_GROUP) ||
+     is_object(parent_dir, TILEDB_ARRAY) ||
+     is_object(parent_dir, TILEDB_METADATA)) {
     std::string errmsg =
         "The workspace cannot be contained in another workspace, "
         "group, array or metadata directory";
@@ -157,6 +192,7 @@ int StorageManager::workspace_create(const std::string& workspace) {
   // Create workspace file
   if(create_workspace_file(workspace) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
+  cache_invalidate(::real_dir(workspace));
 
   // Create master catalog entry
   if(create_master_catalog_entry(workspace, TILEDB_SM_MC_INS) != TILEDB_SM_OK)
@@ -281,7 +317,8 @@ int StorageManager::ls_workspaces_c(int& workspace_num) {
 int StorageManager::group_create(const std::string& group) const {
   // Check if the group is inside a workspace or another group
   std::string parent_dir = ::parent_dir(group);
-  if(!is_workspace(parent_dir) && !is_group(parent_dir)) {
+  if(!is_object(parent_dir, TILEDB_WORKSPACE) && 
+     !is_object(parent_dir, TILEDB_GROUP)) {
     std::string errmsg = 
         "The group must be contained in a workspace "
         "or another group";
@@ -299,6 +336,7 @@ int StorageManager::group_create(const std::string& group) const {
   // Create group file
   if(create_group_file(group) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
+  cache_invalidate(::real_dir(group));
 
   // Success
   return TILEDB_SM_OK;
@@ -330,7 +368,10 @@ int StorageManager::array_consolidate(const char* array_dir) {
       array->consolidate(new_fragment, old_fragment_names);
   
   // Close the array
-  int rc_array_close = array_close(array->array_schema()->array_name());
+  int rc_array_close = 
+      array_close(
+          array->array_schema()->array_name(), 
+          array->fragment_snapshot());
 
   // Finalize consolidation
   int rc_consolidation_finalize = 
@@ -368,8 +409,8 @@ int StorageManager::array_create(const ArraySchemaC* array_schema_c) const {
   std::string parent_dir = ::parent_dir(dir);
 
   // Check if the array directory is contained in a workspace, group or array
-  if(!is_workspace(parent_dir) && 
-     !is_group(parent_dir)) {
+  if(!is_object(parent_dir, TILEDB_WORKSPACE) && 
+     !is_object(parent_dir, TILEDB_GROUP)) {
     std::string errmsg = 
         std::string("Cannot create array; Directory '") + parent_dir + 
         "' must be a TileDB workspace or group";
@@ -410,6 +451,7 @@ int StorageManager::array_create(const ArraySchema* array_schema) const {
   // Store array schema
   if(array_store_schema(dir, array_schema) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
+  cache_invalidate(::real_dir(dir));
 
   // Create consolidation filelock
   if(consolidation_filelock_create(dir) != TILEDB_SM_OK)
@@ -435,39 +477,99 @@ int StorageManager::array_load_book_keeping(
     const std::vector<std::string>& fragment_names,
     std::vector<BookKeeping*>& book_keeping,
     int mode) {
+  STATS_TIMER(&stats_, TIMER_BOOK_KEEPING_LOAD);
+
   // For easy reference
   int fragment_num = fragment_names.size(); 
 
   // Initialization
-  book_keeping.resize(fragment_num);
-
-  // Load the book-keeping for each fragment
+  book_keeping.assign(fragment_num, NULL);
+  if(fragment_num == 0)
+    return TILEDB_SM_OK;
+  std::atomic<int> next_fragment(0);
+  std::vector<std::string> errmsgs(fragment_num);
+  BookKeepingLoadData data;
+  data.array_schema_ = array_schema;
+  data.book_keeping_ = &book_keeping;
+  data.errmsgs_ = &errmsgs;
+  data.fragment_names_ = &fragment_names;
+  data.mode_ = mode;
+  data.next_fragment_ = &next_fragment;
+
+  // Load the fragments on the thread pool, letting the calling thread work
+  // as well
+  if(thread_pool_->run(
+         array_load_book_keeping_s, 
+         &data, 
+         std::min(fragment_num, TILEDB_BOOK_KEEPING_THREAD_NUM)) != 
+     TILEDB_TP_OK) {
+    book_keeping.clear();
+    tiledb_sm_errmsg = tiledb_tp_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Aggregate the errors
+  int failed_num = 0;
+  std::string errmsg;
   for(int i=0; i<fragment_num; ++i) {
+    if(errmsgs[i].empty())
+      continue;
+    if(failed_num == 0)
+      errmsg = errmsgs[i];
+    ++failed_num;
+  }
+
+  // Clean up upon error
+  if(failed_num != 0) {
+    for(int i=0; i<fragment_num; ++i) 
+      if(book_keeping[i] != NULL)
+        delete book_keeping[i];
+    book_keeping.clear();
+    if(failed_num > 1)
+      errmsg += "; Book-keeping of " + std::to_string(failed_num - 1) + 
+                " more fragment(s) failed to load";
+    tiledb_sm_errmsg = errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+void *StorageManager::array_load_book_keeping_s(void* data) {
+  // For easy reference
+  BookKeepingLoadData* d = (BookKeepingLoadData*) data;
+  int fragment_num = d->fragment_names_->size();
+
+  // Claim fragments until none is left
+  for(int i = (*d->next_fragment_)++; 
+      i < fragment_num; 
+      i = (*d->next_fragment_)++) {
     // For easy reference
+    const std::string& fragment_name = (*d->fragment_names_)[i];
     int dense = 
-        !is_file(fragment_names[i] + "/" + TILEDB_COORDS + TILEDB_FILE_SUFFIX);
+        !is_file(fragment_name + "/" + TILEDB_COORDS + TILEDB_FILE_SUFFIX);
 
     // Create new book-keeping structure for the fragment
     BookKeeping* f_book_keeping = 
         new BookKeeping(
-            array_schema, 
+            d->array_schema_, 
             dense, 
-            fragment_names[i], 
-            mode);
+            fragment_name, 
+            d->mode_);
 
     // Load book-keeping
     if(f_book_keeping->load() != TILEDB_BK_OK) {
       delete f_book_keeping;
-      tiledb_sm_errmsg = tiledb_bk_errmsg;
-      return TILEDB_SM_ERR;
+      (*d->errmsgs_)[i] = tiledb_bk_errmsg;
+      continue;
     }
 
-    // Append to the open array entry
-    book_keeping[i] = f_book_keeping;
+    // Store in the slot of the fragment
+    (*d->book_keeping_)[i] = f_book_keeping;
   }
 
-  // Success
-  return TILEDB_SM_OK;
+  return NULL;
 }
 
 int StorageManager::array_load_schema(
@@ -476,8 +578,13 @@ int StorageManager::array_load_schema(
   // Get real array path
   std::string real_array_dir = ::real_dir(array_dir);
 
+  // Check the schema cache
+  std::string filename = real_array_dir + "/" + TILEDB_ARRAY_SCHEMA_FILENAME;
+  if(schema_cache_lookup(filename, array_schema)) 
+    return TILEDB_SM_OK;
+
   // Check if array exists
-  if(!is_array(real_array_dir)) {
+  if(!is_object(real_array_dir, TILEDB_ARRAY)) {
     std::string errmsg = 
         std::string("Cannot load array schema; Array '") + 
         real_array_dir + "' does not exist";
@@ -487,7 +594,6 @@ int StorageManager::array_load_schema(
   }
 
   // Open array schema file
-  std::string filename = real_array_dir + "/" + TILEDB_ARRAY_SCHEMA_FILENAME;
   int fd = ::open(filename.c_str(), O_RDONLY);
   if(fd == -1) {
     std::string errmsg = "Cannot load schema; File opening error";
@@ -528,6 +634,9 @@ int StorageManager::array_load_schema(
     return TILEDB_SM_ERR;
   }
 
+  // Cache the serialized schema
+  schema_cache_insert(filename, buffer, buffer_size);
+
   // Clean up
   free(buffer);
   if(::close(fd)) {
@@ -548,7 +657,8 @@ int StorageManager::array_init(
     int mode,
     const void* subarray,
     const char** attributes,
-    int attribute_num)  {
+    int attribute_num,
+    bool snapshot)  {
   // Check array name length
   if(array_dir == NULL || strlen(array_dir) > TILEDB_NAME_MAX_LEN) {
     std::string errmsg = "Invalid array name length";
@@ -557,29 +667,44 @@ int StorageManager::array_init(
     return TILEDB_SM_ERR;
   }
 
+  // Snapshots are read-only
+  if(snapshot && !array_read_mode(mode)) {
+    std::string errmsg = 
+        "Cannot initialize array; Snapshots can be opened only in read mode";
+    PRINT_ERROR(errmsg);
+    tiledb_sm_errmsg = TILEDB_SM_ERRMSG + errmsg;
+    return TILEDB_SM_ERR;
+  }
+
   // Load array schema
   ArraySchema* array_schema;
   if(array_load_schema(array_dir, array_schema) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
 
   // Open the array
-  OpenArray* open_array = NULL;
+  FragmentSnapshot* fragment_snapshot = NULL;
   if(array_read_mode(mode)) {
-    if(array_open(real_dir(array_dir), open_array, mode) != TILEDB_SM_OK)
+    int rc_open = 
+        snapshot ? 
+            array_snapshot_open(real_dir(array_dir), fragment_snapshot, mode) :
+            array_open(real_dir(array_dir), fragment_snapshot, mode);
+    if(rc_open != TILEDB_SM_OK) {
+      delete array_schema;
       return TILEDB_SM_ERR;
+    }
   }
 
   // Create the clone Array object
   Array* array_clone = new Array();
   int rc_clone = array_clone->init(
                      array_schema, 
-                     open_array->fragment_names_,
-                     open_array->book_keeping_,
+                     fragment_snapshot,
                      mode, 
                      attributes, 
                      attribute_num, 
                      subarray,
-                     config_);
+                     config_,
+                     thread_pool_);
 
   // Handle error
   if(rc_clone != TILEDB_AR_OK) {
@@ -587,7 +712,7 @@ int StorageManager::array_init(
     delete array_clone;
     array = NULL;
     if(array_read_mode(mode)) 
-      array_close(array_dir);
+      array_close(array_dir, fragment_snapshot);
     return TILEDB_SM_ERR;
   } 
 
@@ -595,13 +720,13 @@ int StorageManager::array_init(
   array = new Array();
   int rc = array->init(
                array_schema, 
-               open_array->fragment_names_,
-               open_array->book_keeping_,
+               fragment_snapshot,
                mode, 
                attributes, 
                attribute_num, 
                subarray,
                config_,
+               thread_pool_,
                array_clone);
 
   // Handle error
@@ -610,7 +735,7 @@ int StorageManager::array_init(
     delete array;
     array = NULL;
     if(array_read_mode(mode)) 
-      array_close(array_dir);
+      array_close(array_dir, fragment_snapshot);
     tiledb_sm_errmsg = tiledb_as_errmsg;
     return TILEDB_SM_ERR;
   }
@@ -624,11 +749,19 @@ int StorageManager::array_finalize(Array* array) {
   if(array == NULL)
     return TILEDB_SM_OK;
 
+#ifdef TILEDB_STATS
+  // Keep the statistics of the array
+  array->stats_collect(stats_);
+#endif
+
   // Finalize and close the array
   int rc_finalize = array->finalize();
   int rc_close = TILEDB_SM_OK;
   if(array->read_mode())
-    rc_close = array_close(array->array_schema()->array_name());
+    rc_close = 
+        array_close(
+            array->array_schema()->array_name(), 
+            array->fragment_snapshot());
 
   // Clean up
   delete array;
@@ -645,6 +778,52 @@ int StorageManager::array_finalize(Array* array) {
   return TILEDB_SM_OK;
 }
 
+int StorageManager::array_refresh(const char* array_dir) {
+  // Check array name length
+  if(array_dir == NULL || strlen(array_dir) > TILEDB_NAME_MAX_LEN) {
+    std::string errmsg = "Invalid array name length";
+    PRINT_ERROR(errmsg);
+    tiledb_sm_errmsg = TILEDB_SM_ERRMSG + errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Drop the shared snapshot of the array, unless it is in use
+  std::string array_name = real_dir(array_dir);
+  array_snapshot_evict(array_name);
+
+  // Lock mutexes
+  if(open_array_mtx_lock() != TILEDB_SM_OK)
+    return TILEDB_SM_ERR;
+
+  // Find the open array entry - nothing to refresh if the array is not open
+  std::map<std::string, OpenArray*>::iterator it = 
+      open_arrays_.find(array_name);
+  if(it == open_arrays_.end() || it->second->fragment_snapshot_ == NULL) 
+    return open_array_mtx_unlock();
+
+  // Lock the mutex of the array
+  if(it->second->mutex_lock() != TILEDB_SM_OK) {
+    open_array_mtx_unlock();
+    return TILEDB_SM_ERR;
+  }
+
+  // Refresh the fragments
+  int rc_refresh = 
+      array_refresh_fragments(array_name, it->second, TILEDB_ARRAY_READ);
+
+  // Unlock mutexes
+  int rc_mtx_unlock = it->second->mutex_unlock();
+  int rc_open_array_mtx_unlock = open_array_mtx_unlock();
+
+  // Return
+  if(rc_refresh != TILEDB_SM_OK      || 
+     rc_mtx_unlock != TILEDB_SM_OK   ||
+     rc_open_array_mtx_unlock != TILEDB_SM_OK)
+    return TILEDB_SM_ERR;
+  else
+    return TILEDB_SM_OK;
+}
+
 int StorageManager::array_sync(Array* array) {
   // If the array is NULL, do nothing
   if(array == NULL)
@@ -719,10 +898,17 @@ int StorageManager::array_iterator_finalize(
   if(array_it == NULL)
     return TILEDB_SM_OK;
 
+#ifdef TILEDB_STATS
+  // Keep the statistics of the array
+  array_it->array()->stats_collect(stats_);
+#endif
+
   // Finalize and close array
   std::string array_name = array_it->array_name();
+  FragmentSnapshot* fragment_snapshot = 
+      array_it->array()->fragment_snapshot();
   int rc_finalize = array_it->finalize();
-  int rc_close = array_close(array_name);
+  int rc_close = array_close(array_name, fragment_snapshot);
 
   // Clean up
   delete array_it;
@@ -791,7 +977,8 @@ int StorageManager::metadata_consolidate(const char* metadata_dir) {
   
   // Close the underlying array
   std::string array_name = metadata->array_schema()->array_name();
-  int rc_array_close = array_close(array_name);
+  int rc_array_close = 
+      array_close(array_name, metadata->array()->fragment_snapshot());
 
   // Finalize consolidation
   int rc_consolidation_finalize = 
@@ -830,9 +1017,9 @@ int StorageManager::metadata_create(
   std::string parent_dir = ::parent_dir(dir);
 
   // Check if the array directory is contained in a workspace, group or array
-  if(!is_workspace(parent_dir) && 
-     !is_group(parent_dir) &&
-     !is_array(parent_dir)) {
+  if(!is_object(parent_dir, TILEDB_WORKSPACE) && 
+     !is_object(parent_dir, TILEDB_GROUP) &&
+     !is_object(parent_dir, TILEDB_ARRAY)) {
     std::string errmsg = 
         std::string("Cannot create metadata; Directory '") + 
         parent_dir + "' must be a TileDB workspace, group, or array";
@@ -910,6 +1097,7 @@ int StorageManager::metadata_create(const ArraySchema* array_schema) const {
     tiledb_sm_errmsg = TILEDB_SM_ERRMSG + errmsg;
     return TILEDB_SM_ERR;
   }
+  cache_invalidate(::real_dir(dir));
 
   // Create consolidation filelock
   if(consolidation_filelock_create(dir) != TILEDB_SM_OK)
@@ -925,16 +1113,20 @@ int StorageManager::metadata_load_schema(
   // Get real array path
   std::string real_metadata_dir = ::real_dir(metadata_dir);
 
+  // Check the schema cache
+  std::string filename = 
+      real_metadata_dir + "/" + TILEDB_METADATA_SCHEMA_FILENAME;
+  if(schema_cache_lookup(filename, array_schema)) 
+    return TILEDB_SM_OK;
+
   // Check if metadata exists
-  if(!is_metadata(real_metadata_dir)) {
+  if(!is_object(real_metadata_dir, TILEDB_METADATA)) {
     PRINT_ERROR(std::string("Cannot load metadata schema; Metadata '") + 
                 real_metadata_dir + "' does not exist");
     return TILEDB_SM_ERR;
   }
 
   // Open array schema file
-  std::string filename = 
-      real_metadata_dir + "/" + TILEDB_METADATA_SCHEMA_FILENAME;
   int fd = ::open(filename.c_str(), O_RDONLY);
   if(fd == -1) {
     std::string errmsg = "Cannot load metadata schema; File opening error";
@@ -975,6 +1167,9 @@ int StorageManager::metadata_load_schema(
     return TILEDB_SM_ERR;
   }
 
+  // Cache the serialized schema
+  schema_cache_insert(filename, buffer, buffer_size);
+
   // Clean up
   free(buffer);
   if(::close(fd)) {
@@ -1009,11 +1204,11 @@ int StorageManager::metadata_init(
     return TILEDB_SM_ERR;
 
   // Open the array that implements the metadata
-  OpenArray* open_array = NULL;
+  FragmentSnapshot* fragment_snapshot = NULL;
   if(mode == TILEDB_METADATA_READ) {
     if(array_open(
            real_dir(metadata_dir), 
-           open_array, 
+           fragment_snapshot, 
            TILEDB_ARRAY_READ) != TILEDB_SM_OK)
       return TILEDB_SM_ERR;
   }
@@ -1022,19 +1217,20 @@ int StorageManager::metadata_init(
   metadata = new Metadata();
   int rc = metadata->init(
                array_schema, 
-               open_array->fragment_names_,
-               open_array->book_keeping_,
+               fragment_snapshot,
                mode, 
                attributes, 
                attribute_num,
-               config_);
+               config_,
+               thread_pool_);
 
   // Return
   if(rc != TILEDB_MT_OK) {
     delete array_schema;
     delete metadata;
     metadata = NULL;
-    array_close(metadata_dir);
+    if(mode == TILEDB_METADATA_READ) 
+      array_close(metadata_dir, fragment_snapshot);
     tiledb_sm_errmsg = tiledb_mt_errmsg;
     return TILEDB_SM_ERR;
   } else {
@@ -1050,10 +1246,11 @@ int StorageManager::metadata_finalize(Metadata* metadata) {
   // Finalize the metadata and close the underlying array
   std::string array_name = metadata->array_schema()->array_name();
   int mode = metadata->array()->mode();
+  FragmentSnapshot* fragment_snapshot = metadata->array()->fragment_snapshot();
   int rc_finalize = metadata->finalize();
   int rc_close = TILEDB_SM_OK;
   if(mode == TILEDB_METADATA_READ)
-    rc_close = array_close(array_name);
+    rc_close = array_close(array_name, fragment_snapshot);
 
   // Clean up
   delete metadata;
@@ -1111,8 +1308,10 @@ int StorageManager::metadata_iterator_finalize(
 
   // Close array and finalize metadata
   std::string metadata_name = metadata_it->metadata_name();
+  FragmentSnapshot* fragment_snapshot = 
+      metadata_it->metadata()->array()->fragment_snapshot();
   int rc_finalize = metadata_it->finalize();
-  int rc_close = array_close(metadata_name);
+  int rc_close = array_close(metadata_name, fragment_snapshot);
 
   // Clean up
   delete metadata_it;
@@ -1270,31 +1469,39 @@ int StorageManager::ls_c(const char* parent_dir, int& dir_num) const {
 }
 
 int StorageManager::clear(const std::string& dir) const {
+  int rc;
   if(is_workspace(dir)) {
-    return workspace_clear(dir);
+    rc = workspace_clear(dir);
   } else if(is_group(dir)) {
-    return group_clear(dir);
+    rc = group_clear(dir);
   } else if(is_array(dir)) {
-    return array_clear(dir);
+    rc = array_clear(dir);
   } else if(is_metadata(dir)) {
-    return metadata_clear(dir);
+    rc = metadata_clear(dir);
   } else {
     std::string errmsg = "Clear failed; Invalid directory";
     PRINT_ERROR(errmsg);
     tiledb_sm_errmsg = TILEDB_SM_ERRMSG + errmsg;
     return TILEDB_SM_ERR;
   }
+
+  // Invalidate the caches
+  cache_invalidate(::real_dir(dir));
+  array_snapshot_evict(::real_dir(dir));
+
+  return rc;
 }
 
 int StorageManager::delete_entire(const std::string& dir) {
+  int rc;
   if(is_workspace(dir)) {
-    return workspace_delete(dir);
+    rc = workspace_delete(dir);
   } else if(is_group(dir)) {
-    return group_delete(dir);
+    rc = group_delete(dir);
   } else if(is_array(dir)) {
-    return array_delete(dir);
+    rc = array_delete(dir);
   } else if(is_metadata(dir)) {
-    return metadata_delete(dir);
+    rc = metadata_delete(dir);
   } else {
     std::string errmsg = "Delete failed; Invalid directory";
     PRINT_ERROR(errmsg);
@@ -1302,21 +1509,25 @@ int StorageManager::delete_entire(const std::string& dir) {
     return TILEDB_SM_ERR;
   }
 
-  // Success
-  return TILEDB_SM_OK;
+  // Invalidate the caches
+  cache_invalidate(::real_dir(dir));
+  array_snapshot_evict(::real_dir(dir));
+
+  return rc;
 }
 
 int StorageManager::move(
     const std::string& old_dir,
     const std::string& new_dir) {
+  int rc;
   if(is_workspace(old_dir)) {
-    return workspace_move(old_dir, new_dir);
+    rc = workspace_move(old_dir, new_dir);
   } else if(is_group(old_dir)) {
-    return group_move(old_dir, new_dir);
+    rc = group_move(old_dir, new_dir);
   } else if(is_array(old_dir)) {
-    return array_move(old_dir, new_dir);
+    rc = array_move(old_dir, new_dir);
   } else if(is_metadata(old_dir)) {
-    return metadata_move(old_dir, new_dir);
+    rc = metadata_move(old_dir, new_dir);
   } else {
     std::string errmsg = "Move failed; Invalid source directory";
     PRINT_ERROR(errmsg);
@@ -1324,9 +1535,27 @@ int StorageManager::move(
     return TILEDB_SM_ERR;
   }
 
-  // Success
-  return TILEDB_SM_OK;
+  // Invalidate the caches
+  cache_invalidate(::real_dir(old_dir));
+  cache_invalidate(::real_dir(new_dir));
+  array_snapshot_evict(::real_dir(old_dir));
+
+  return rc;
+}
+
+int64_t StorageManager::stat_saved_num() const {
+  cache_mtx_lock();
+  int64_t stat_saved_num = stat_saved_num_;
+  cache_mtx_unlock();
+
+  return stat_saved_num;
+}
+
+#ifdef TILEDB_STATS
+const Stats& StorageManager::stats() const {
+  return stats_;
 }
+#endif
 
 
 
@@ -1374,9 +1603,10 @@ int StorageManager::array_clear(
     if(is_metadata(filename)) {         // Metadata
       metadata_delete(filename);
     } else if(is_fragment(filename)){   // Fragment
-      if(delete_dir(filename) != TILEDB_UT_OK)
+      if(delete_dir(filename) != TILEDB_UT_OK) {
         tiledb_sm_errmsg = tiledb_ut_errmsg;
         return TILEDB_SM_ERR;
+      }
     } else {                            // Non TileDB related
       std::string errmsg =
           std::string("Cannot delete non TileDB related element '") +
@@ -1401,7 +1631,13 @@ int StorageManager::array_clear(
   return TILEDB_SM_OK;
 }
 
-int StorageManager::array_close(const std::string& array) {
+int StorageManager::array_close(
+    const std::string& array,
+    FragmentSnapshot* fragment_snapshot) {
+  // Shared read-only snapshots have no open array entry
+  if(array_snapshot_release(array, fragment_snapshot))
+    return TILEDB_SM_OK;
+
   // Lock mutexes
   if(open_array_mtx_lock() != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
@@ -1422,6 +1658,10 @@ int StorageManager::array_close(const std::string& array) {
   if(it->second->mutex_lock() != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
 
+  // Release the fragment snapshot
+  if(fragment_snapshot != NULL)
+    it->second->release_fragment_snapshot(fragment_snapshot);
+
   // Decrement counter
   --(it->second->cnt_);
 
@@ -1429,10 +1669,9 @@ int StorageManager::array_close(const std::string& array) {
   int rc_mtx_destroy = TILEDB_SM_OK;
   int rc_filelock = TILEDB_SM_OK;
   if(it->second->cnt_ == 0) {
-    // Clean up book-keeping
-    std::vector<BookKeeping*>::iterator bit = it->second->book_keeping_.begin();
-    for(; bit != it->second->book_keeping_.end(); ++bit) 
-      delete *bit;
+    // Clean up the current fragment snapshot, along with the book-keeping
+    if(it->second->fragment_snapshot_ != NULL)
+      it->second->release_fragment_snapshot(it->second->fragment_snapshot_);
 
     // Unlock and destroy mutexes
     it->second->mutex_unlock();
@@ -1499,7 +1738,7 @@ int StorageManager::array_get_open_array_entry(
     open_array = new OpenArray();
     open_array->cnt_ = 0;
     open_array->consolidation_filelock_ = -1;
-    open_array->book_keeping_ = std::vector<BookKeeping*>();
+    open_array->fragment_snapshot_ = NULL;
     if(open_array->mutex_init() != TILEDB_SM_OK) {
       open_array->mutex_unlock();
       return TILEDB_SM_ERR;
@@ -1589,9 +1828,10 @@ int StorageManager::array_move(
 
 int StorageManager::array_open(
     const std::string& array_name, 
-    OpenArray*& open_array,
+    FragmentSnapshot*& fragment_snapshot,
     int mode) {
   // Get the open array entry
+  OpenArray* open_array;
   if(array_get_open_array_entry(array_name, open_array) != TILEDB_SM_OK)
     return TILEDB_SM_ERR;
 
@@ -1600,7 +1840,7 @@ int StorageManager::array_open(
     return TILEDB_SM_ERR;
 
   // First time the array is opened
-  if(open_array->fragment_names_.size() == 0) {
+  if(open_array->fragment_snapshot_ == NULL) {
     // Acquire shared lock on consolidation filelock
     if(consolidation_filelock_lock(
         array_name,
@@ -1610,11 +1850,8 @@ int StorageManager::array_open(
       return TILEDB_SM_ERR;
     }
 
-    // Get the fragment names
-    array_get_fragment_names(array_name, open_array->fragment_names_);
-
     // Get array schema
-    if(is_array(array_name)) { // Array
+    if(is_object(array_name, TILEDB_ARRAY)) { // Array
       if(array_load_schema(
              array_name.c_str(), 
              open_array->array_schema_) != TILEDB_SM_OK)
@@ -1625,20 +1862,29 @@ int StorageManager::array_open(
              open_array->array_schema_) != TILEDB_SM_OK)
         return TILEDB_SM_ERR;
     }
+  }
 
-    // Load the book-keeping for each fragment
-    if(array_load_book_keeping(
-           open_array->array_schema_, 
-           open_array->fragment_names_, 
-           open_array->book_keeping_,
+  // Load the book-keeping for each fragment, the first time the array is
+  // opened or while it has no fragments
+  if(open_array->fragment_snapshot_ == NULL ||
+     open_array->fragment_snapshot_->fragment_num() == 0) { 
+    if(array_refresh_fragments(
+           array_name, 
+           open_array, 
            mode) != TILEDB_SM_OK) {
-      delete open_array->array_schema_;
-      open_array->array_schema_ = NULL;
+      if(open_array->fragment_snapshot_ == NULL) {
+        delete open_array->array_schema_;
+        open_array->array_schema_ = NULL;
+      }
       open_array->mutex_unlock();
       return TILEDB_SM_ERR;
     } 
   }
 
+  // Acquire the current fragment snapshot
+  fragment_snapshot = open_array->fragment_snapshot_;
+  fragment_snapshot->acquire();
+
   // Unlock the mutex of the array
   if(open_array->mutex_unlock() != TILEDB_UT_OK) { 
     tiledb_sm_errmsg = tiledb_ut_errmsg;
@@ -1649,6 +1895,171 @@ int StorageManager::array_open(
   return TILEDB_SM_OK;
 }
 
+int StorageManager::array_refresh_fragments(
+    const std::string& array_name, 
+    OpenArray* open_array,
+    int mode) {
+  // Get the fragment names
+  std::vector<std::string> fragment_names;
+  array_get_fragment_names(array_name, fragment_names);
+  int fragment_num = fragment_names.size();
+
+  // Find the fragments whose book-keeping is already loaded
+  std::map<std::string, BookKeeping*> loaded_book_keeping;
+  FragmentSnapshot* old_fragment_snapshot = open_array->fragment_snapshot_;
+  if(old_fragment_snapshot != NULL) {
+    int old_fragment_num = old_fragment_snapshot->fragment_num();
+    for(int i=0; i<old_fragment_num; ++i) 
+      loaded_book_keeping[old_fragment_snapshot->fragment_names()[i]] = 
+          old_fragment_snapshot->book_keeping()[i];
+  }
+  std::vector<BookKeeping*> book_keeping(fragment_num, NULL);
+  std::vector<std::string> new_fragment_names;
+  for(int i=0; i<fragment_num; ++i) {
+    std::map<std::string, BookKeeping*>::iterator it = 
+        loaded_book_keeping.find(fragment_names[i]);
+    if(it != loaded_book_keeping.end()) 
+      book_keeping[i] = it->second;
+    else 
+      new_fragment_names.push_back(fragment_names[i]);
+  }
+
+  // Trivial case - The fragments have not changed
+  if(old_fragment_snapshot != NULL  &&
+     new_fragment_names.size() == 0 &&
+     fragment_num == old_fragment_snapshot->fragment_num()) 
+    return TILEDB_SM_OK;
+
+  // Load the book-keeping only for the new fragments
+  std::vector<BookKeeping*> new_book_keeping;
+  if(array_load_book_keeping(
+         open_array->array_schema_, 
+         new_fragment_names, 
+         new_book_keeping,
+         mode) != TILEDB_SM_OK) 
+    return TILEDB_SM_ERR;
+  for(int i=0, j=0; i<fragment_num; ++i) 
+    if(book_keeping[i] == NULL)
+      book_keeping[i] = new_book_keeping[j++];
+
+  // Replace the current fragment snapshot
+  open_array->set_fragment_snapshot(
+      new FragmentSnapshot(
+          open_array->array_schema_, 
+          fragment_names, 
+          book_keeping));
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+void StorageManager::array_snapshot_evict(const std::string& dir) const {
+  // Lock the shared snapshots
+  if(::mutex_lock(&snapshot_arrays_mtx_) != TILEDB_UT_OK)
+    return;
+
+  // Delete the unused snapshots of the directory and its subdirectories
+  std::map<std::string, OpenArray*>::iterator it = 
+      snapshot_arrays_.lower_bound(dir);
+  while(it != snapshot_arrays_.end() && starts_with(it->first, dir)) {
+    OpenArray* open_array = it->second;
+    if((it->first.size() == dir.size() || it->first[dir.size()] == '/') &&
+       open_array->cnt_ == 0) {
+      open_array->release_fragment_snapshot(open_array->fragment_snapshot_);
+      delete open_array->array_schema_;
+      delete open_array;
+      snapshot_arrays_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  // Unlock the shared snapshots
+  ::mutex_unlock(&snapshot_arrays_mtx_);
+}
+
+int StorageManager::array_snapshot_open(
+    const std::string& array_name,
+    FragmentSnapshot*& fragment_snapshot,
+    int mode) {
+  // Lock the shared snapshots
+  if(::mutex_lock(&snapshot_arrays_mtx_) != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Load the snapshot, the first time it is opened in the process
+  OpenArray* open_array;
+  std::map<std::string, OpenArray*>::iterator it = 
+      snapshot_arrays_.find(array_name);
+  if(it == snapshot_arrays_.end()) {
+    open_array = new OpenArray();
+    open_array->array_schema_ = NULL;
+    open_array->cnt_ = 0;
+    open_array->consolidation_filelock_ = -1;
+    open_array->fragment_snapshot_ = NULL;
+    if(array_load_schema(
+           array_name.c_str(), 
+           open_array->array_schema_) != TILEDB_SM_OK ||
+       array_refresh_fragments(
+           array_name, 
+           open_array, 
+           mode) != TILEDB_SM_OK) {
+      if(open_array->array_schema_ != NULL)
+        delete open_array->array_schema_;
+      delete open_array;
+      ::mutex_unlock(&snapshot_arrays_mtx_);
+      return TILEDB_SM_ERR;
+    }
+    snapshot_arrays_[array_name] = open_array;
+  } else {
+    open_array = it->second;
+  }
+
+  // Acquire the fragment snapshot
+  ++(open_array->cnt_);
+  fragment_snapshot = open_array->fragment_snapshot_;
+  fragment_snapshot->acquire();
+
+  // Unlock the shared snapshots
+  if(::mutex_unlock(&snapshot_arrays_mtx_) != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+bool StorageManager::array_snapshot_release(
+    const std::string& array_name,
+    FragmentSnapshot* fragment_snapshot) const {
+  // Trivial case
+  if(fragment_snapshot == NULL)
+    return false;
+
+  // Lock the shared snapshots
+  if(::mutex_lock(&snapshot_arrays_mtx_) != TILEDB_UT_OK)
+    return false;
+
+  // Release the snapshot only if it is the shared one. The entry holds its
+  // own reference, so the snapshot outlives the arrays that acquired it.
+  bool released = false;
+  std::map<std::string, OpenArray*>::iterator it = 
+      snapshot_arrays_.find(real_dir(array_name));
+  if(it != snapshot_arrays_.end() && 
+     it->second->fragment_snapshot_ == fragment_snapshot) {
+    it->second->release_fragment_snapshot(fragment_snapshot);
+    --(it->second->cnt_);
+    released = true;
+  }
+
+  // Unlock the shared snapshots
+  ::mutex_unlock(&snapshot_arrays_mtx_);
+
+  return released;
+}
+
 int StorageManager::array_store_schema(
     const std::string& dir, 
     const ArraySchema* array_schema) const {
@@ -1697,6 +2108,105 @@ int StorageManager::array_store_schema(
   return TILEDB_SM_OK;
 }
 
+void StorageManager::cache_invalidate(const std::string& dir) const {
+  cache_mtx_lock();
+
+  // Object types of the directory and its subdirectories
+  std::map<std::string, int>::iterator it_ot = 
+      object_type_cache_.lower_bound(dir);
+  while(it_ot != object_type_cache_.end() && 
+        starts_with(it_ot->first, dir)) {
+    if(it_ot->first.size() == dir.size() || it_ot->first[dir.size()] == '/')
+      object_type_cache_.erase(it_ot++);
+    else
+      ++it_ot;
+  }
+
+  // Schemas of the directory and its subdirectories
+  std::map<std::string, std::vector<char> >::iterator it_s = 
+      schema_cache_.lower_bound(dir);
+  while(it_s != schema_cache_.end() && starts_with(it_s->first, dir)) {
+    if(it_s->first.size() == dir.size() || it_s->first[dir.size()] == '/')
+      schema_cache_.erase(it_s++);
+    else
+      ++it_s;
+  }
+
+  cache_mtx_unlock();
+}
+
+int StorageManager::cache_mtx_destroy() {
+#ifdef HAVE_OPENMP
+  int rc_omp_mtx = ::mutex_destroy(&cache_omp_mtx_);
+#else
+  int rc_omp_mtx = TILEDB_UT_OK;
+#endif
+  int rc_pthread_mtx = ::mutex_destroy(&cache_pthread_mtx_);
+
+  // Errors
+  if(rc_pthread_mtx != TILEDB_UT_OK || rc_omp_mtx != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+int StorageManager::cache_mtx_init() {
+#ifdef HAVE_OPENMP
+  int rc_omp_mtx = ::mutex_init(&cache_omp_mtx_);
+#else
+  int rc_omp_mtx = TILEDB_UT_OK;
+#endif
+  int rc_pthread_mtx = ::mutex_init(&cache_pthread_mtx_);
+
+  // Errors
+  if(rc_pthread_mtx != TILEDB_UT_OK || rc_omp_mtx != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+int StorageManager::cache_mtx_lock() const {
+#ifdef HAVE_OPENMP
+  int rc_omp_mtx = ::mutex_lock(&cache_omp_mtx_);
+#else
+  int rc_omp_mtx = TILEDB_UT_OK;
+#endif
+  int rc_pthread_mtx = ::mutex_lock(&cache_pthread_mtx_);
+
+  // Errors
+  if(rc_pthread_mtx != TILEDB_UT_OK || rc_omp_mtx != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
+int StorageManager::cache_mtx_unlock() const {
+#ifdef HAVE_OPENMP
+  int rc_omp_mtx = ::mutex_unlock(&cache_omp_mtx_);
+#else
+  int rc_omp_mtx = TILEDB_UT_OK;
+#endif
+  int rc_pthread_mtx = ::mutex_unlock(&cache_pthread_mtx_);
+
+  // Errors
+  if(rc_pthread_mtx != TILEDB_UT_OK || rc_omp_mtx != TILEDB_UT_OK) {
+    tiledb_sm_errmsg = tiledb_ut_errmsg;
+    return TILEDB_SM_ERR;
+  }
+
+  // Success
+  return TILEDB_SM_OK;
+}
+
 int StorageManager::config_set(StorageManagerConfig* config) {
   // Store config locally
   config_ = config;
@@ -2103,6 +2613,48 @@ int StorageManager::group_move(
   return TILEDB_SM_OK;
 }
 
+bool StorageManager::is_object(
+    const std::string& dir, 
+    int object_type) const {
+  // For easy reference
+  std::string real_dir = ::real_dir(dir);
+  int object_type_bit = 1 << object_type;
+
+  // Check the cache
+  cache_mtx_lock();
+  std::map<std::string, int>::const_iterator it = 
+      object_type_cache_.find(real_dir);
+  bool cached = 
+      it != object_type_cache_.end() && (it->second & object_type_bit);
+  if(cached) 
+    stat_saved_num_ += 2;
+  cache_mtx_unlock();
+  if(cached)
+    return true;
+
+  // Check the filesystem
+  bool is;
+  if(object_type == TILEDB_WORKSPACE)
+    is = is_workspace(real_dir);
+  else if(object_type == TILEDB_GROUP)
+    is = is_group(real_dir);
+  else if(object_type == TILEDB_ARRAY)
+    is = is_array(real_dir);
+  else if(object_type == TILEDB_METADATA)
+    is = is_metadata(real_dir);
+  else
+    is = false;
+
+  // Cache only positive results
+  if(is) {
+    cache_mtx_lock();
+    object_type_cache_[real_dir] |= object_type_bit;
+    cache_mtx_unlock();
+  }
+
+  return is;
+}
+
 int StorageManager::master_catalog_consolidate() {
   // Consolidate master catalog
   if(metadata_consolidate(master_catalog_dir_.c_str()) != TILEDB_SM_OK)
@@ -2357,16 +2909,57 @@ int StorageManager::open_array_mtx_unlock() {
   return TILEDB_SM_OK;
 }
 
+void StorageManager::schema_cache_insert(
+    const std::string& filename,
+    const void* buffer,
+    size_t buffer_size) const {
+  cache_mtx_lock();
+  schema_cache_[filename].assign(
+      static_cast<const char*>(buffer), 
+      static_cast<const char*>(buffer) + buffer_size);
+  cache_mtx_unlock();
+}
+
+bool StorageManager::schema_cache_lookup(
+    const std::string& filename,
+    ArraySchema*& array_schema) const {
+  // Copy the serialized schema, so that it is deserialized without the lock 
+  std::vector<char> buffer;
+  cache_mtx_lock();
+  std::map<std::string, std::vector<char> >::const_iterator it = 
+      schema_cache_.find(filename);
+  bool cached = (it != schema_cache_.end());
+  if(cached) {
+    buffer = it->second;
+    // Saves the directory and file checks, as well as the fstat on the file
+    stat_saved_num_ += 3;
+  }
+  cache_mtx_unlock();
+  if(!cached)
+    return false;
+
+  // Deserialize, falling back to the disk upon error
+  array_schema = new ArraySchema();
+  if(array_schema->deserialize(&buffer[0], buffer.size()) != TILEDB_AS_OK) {
+    delete array_schema;
+    return false;
+  }
+
+  return true;
+}
+
 void StorageManager::sort_fragment_names(
     std::vector<std::string>& fragment_names) const {
   // Initializations
   int fragment_num = fragment_names.size();
   std::string t_str;
-  int64_t stripped_fragment_name_size, t;
-  std::vector<std::pair<int64_t, int> > t_pos_vec;
+  int64_t stripped_fragment_name_size, t, seq;
+  std::vector<std::pair<std::pair<int64_t, int64_t>, int> > t_pos_vec;
   t_pos_vec.resize(fragment_num);
 
-  // Get the timestamp for each fragment
+  // Get the timestamp and sequence number for each fragment. The sequence
+  // number orders the fragments created within the same millisecond, and it
+  // is 0 for names that do not carry one.
   for(int i=0; i<fragment_num; ++i) {
     // Strip fragment name
     std::string& fragment_name = fragment_names[i];
@@ -2381,8 +2974,16 @@ void StorageManager::sort_fragment_names(
       if(stripped_fragment_name[j] == '_') {
         t_str = stripped_fragment_name.substr(
                     j+1,stripped_fragment_name_size-j);
-        sscanf(t_str.c_str(), "%lld", (long long int*)&t); 
-        t_pos_vec[i] = std::pair<int64_t, int>(t, i);
+        seq = 0;
+        sscanf(
+            t_str.c_str(), 
+            "%lld_%lld", 
+            (long long int*)&t, 
+            (long long int*)&seq); 
+        t_pos_vec[i] = 
+            std::pair<std::pair<int64_t, int64_t>, int>(
+                std::pair<int64_t, int64_t>(t, seq), 
+                i);
         break;
       }
    }
@@ -2659,3 +3260,43 @@ int StorageManager::OpenArray::mutex_unlock() {
   // Success
   return TILEDB_SM_OK;
 }
+
+void StorageManager::OpenArray::release_fragment_snapshot(
+    FragmentSnapshot* fragment_snapshot) {
+  // The snapshot is still in use
+  if(fragment_snapshot->release() > 0)
+    return;
+
+  // Delete the book-keeping structures no other snapshot refers to
+  const std::vector<BookKeeping*>& book_keeping = 
+      fragment_snapshot->book_keeping();
+  int fragment_num = book_keeping.size();
+  for(int i=0; i<fragment_num; ++i) {
+    std::map<BookKeeping*, int>::iterator it = 
+        book_keeping_cnt_.find(book_keeping[i]);
+    assert(it != book_keeping_cnt_.end());
+    if(--(it->second) == 0) {
+      delete it->first;
+      book_keeping_cnt_.erase(it);
+    }
+  }
+
+  // Delete the snapshot
+  delete fragment_snapshot;
+}
+
+void StorageManager::OpenArray::set_fragment_snapshot(
+    FragmentSnapshot* fragment_snapshot) {
+  // The new snapshot refers to its book-keeping structures
+  const std::vector<BookKeeping*>& book_keeping = 
+      fragment_snapshot->book_keeping();
+  int fragment_num = book_keeping.size();
+  for(int i=0; i<fragment_num; ++i) 
+    ++book_keeping_cnt_[book_keeping[i]];
+
+  // Replace the current snapshot
+  FragmentSnapshot* old_fragment_snapshot = fragment_snapshot_;
+  fragment_snapshot_ = fragment_snapshot;
+  if(old_fragment_snapshot != NULL)
+    release_fragment_snapshot(old_fragment_snapshot);
+}
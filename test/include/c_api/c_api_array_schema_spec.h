@@ -80,6 +80,35 @@ class ArraySchemaTestFixture: public testing::Test {
    */
   int create_dense_array();
 
+  /** 
+   * Creates a dense array with user-defined compression parameters. 
+   *
+   * @param compression_level The compression levels.
+   * @param blosc_shuffle The Blosc shuffle modes.
+   * @param blosc_typesize The Blosc typesizes.
+   * @return TILEDB_OK on success and TILEDB_ERR on error.
+   */
+  int create_dense_array_compressed(
+      const int* compression_level,
+      const int* blosc_shuffle,
+      const int* blosc_typesize);
+
+  /** 
+   * Creates a sparse array with filters. 
+   *
+   * @param filter The filters.
+   * @param coords_layout The coordinates layout.
+   * @return TILEDB_OK on success and TILEDB_ERR on error.
+   */
+  int create_sparse_array_filtered(const int* filter, int coords_layout);
+
+  /** 
+   * Writes cells to the sparse array created by 
+   * create_sparse_array_filtered(), reads them back, and checks that they
+   * are intact.
+   */
+  void check_sparse_array_round_trip();
+
 
   /* ********************************* */
   /*         PUBLIC ATTRIBUTES         */
@@ -117,6 +117,14 @@ class DenseArrayTestFixture: public testing::Test {
       const int cell_order,
       const int tile_order);
 
+  /**
+   * Creates a 20x20 dense array with 10x10 tiles, an int32 and a 
+   * variable-sized char attribute, compressed with GZIP.
+   *
+   * @return TILEDB_OK on success and TILEDB_ERR on error.
+   */
+  int create_dense_array_var_2D();
+
   /**
    * Generates a 1D buffer containing the cell values of a 2D array.
    * Each cell value equals (row index * total number of columns + col index).
@@ -92,6 +92,15 @@ class SparseArrayTestFixture: public testing::Test {
       const int cell_order,
       const int tile_order);
 
+  /**
+   * Creates a 100x100 sparse array with an int32, a float32 and a 
+   * variable-sized char attribute, setting the input filters.
+   *
+   * @param filter The filter of each attribute and the coordinates.
+   * @return TILEDB_OK on success and TILEDB_ERR on error.
+   */
+  int create_sparse_array_filtered_2D(const int* filter);
+
   /**
    * Reads a subarray oriented by the input boundaries and outputs the buffer
    * containing the attribute values of the corresponding cells.
@@ -131,6 +140,15 @@ class SparseArrayTestFixture: public testing::Test {
       const int64_t domain_size_0,
       const int64_t domain_size_1);
 
+  /**
+   * Writes every third cell of the array created by 
+   * create_sparse_array_filtered_2D() in row-major order, with 1 to 5 
+   * characters per variable-sized value.
+   *
+   * @return TILEDB_OK on success and TILEDB_ERR on error.
+   */
+  int write_sparse_array_var_2D();
+
 
 
 
@@ -32,7 +32,9 @@
 
 #include "c_api_array_schema_spec.h"
 #include "utils.h"
+#include <string>
 #include <unistd.h>
+#include <vector>
 
 
 /* ****************************** */
@@ -143,6 +145,205 @@ int ArraySchemaTestFixture::create_dense_array() {
   return tiledb_array_create(tiledb_ctx_, &array_schema_);
 }
 
+int ArraySchemaTestFixture::create_dense_array_compressed(
+    const int* compression_level,
+    const int* blosc_shuffle,
+    const int* blosc_typesize) {
+  // Initialization s
+  int rc;
+  const char* attributes[] = { "ATTR_INT32", "ATTR_FLOAT64" };
+  const char* dimensions[] = { "X", "Y" };
+  int64_t domain[] = { 0, 99, 0, 99 };
+  int64_t tile_extents[] = { 10, 10 };
+  const int types[] = { TILEDB_INT32, TILEDB_FLOAT64, TILEDB_INT64 };
+  const int compression[] = 
+      { TILEDB_GZIP, TILEDB_BLOSC_LZ4, TILEDB_ZSTD };
+
+  // Set array schema
+  rc = tiledb_array_set_schema(
+      &array_schema_,
+      array_name_.c_str(),
+      attributes,
+      2,
+      1000,
+      TILEDB_ROW_MAJOR,
+      NULL,
+      compression,
+      1,
+      dimensions,
+      2,
+      domain,
+      4*sizeof(int64_t),
+      tile_extents,
+      2*sizeof(int64_t),
+      0,
+      types);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Remember that the array schema is set
+  array_schema_set_ = true;
+
+  // Set compression parameters
+  rc = tiledb_array_set_compression_params(
+           &array_schema_,
+           compression_level,
+           blosc_shuffle,
+           blosc_typesize);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Create the array
+  return tiledb_array_create(tiledb_ctx_, &array_schema_);
+}
+
+int ArraySchemaTestFixture::create_sparse_array_filtered(
+    const int* filter,
+    int coords_layout) {
+  // Initialization s
+  int rc;
+  const char* attributes[] = { "ATTR_INT32", "ATTR_FLOAT32", "ATTR_CHAR_VAR" };
+  const char* dimensions[] = { "X", "Y" };
+  int64_t domain[] = { 0, 99, 0, 99 };
+  const int cell_val_num[] = { 1, 1, TILEDB_VAR_NUM };
+  const int types[] = 
+      { TILEDB_INT32, TILEDB_FLOAT32, TILEDB_CHAR, TILEDB_INT64 };
+  const int compression[] = 
+      { TILEDB_GZIP, TILEDB_LZ4, TILEDB_ZSTD, TILEDB_ZSTD };
+
+  // Set array schema
+  rc = tiledb_array_set_schema(
+      &array_schema_,
+      array_name_.c_str(),
+      attributes,
+      3,
+      1000,
+      TILEDB_ROW_MAJOR,
+      cell_val_num,
+      compression,
+      0,
+      dimensions,
+      2,
+      domain,
+      4*sizeof(int64_t),
+      NULL,
+      0,
+      0,
+      types);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Remember that the array schema is set
+  array_schema_set_ = true;
+
+  // Set filters
+  rc = tiledb_array_set_filter(&array_schema_, filter);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Set coordinates layout
+  rc = tiledb_array_set_coords_layout(&array_schema_, coords_layout);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Create the array
+  return tiledb_array_create(tiledb_ctx_, &array_schema_);
+}
+
+void ArraySchemaTestFixture::check_sparse_array_round_trip() {
+  // Error code 
+  int rc;
+
+  // Prepare cells in row-major order, every third cell of the domain
+  const int64_t cell_num = 100*100/3;
+  int* a1 = new int[cell_num];
+  float* a2 = new float[cell_num];
+  size_t* a3 = new size_t[cell_num];
+  char* a3_var = new char[5*cell_num];
+  int64_t* coords = new int64_t[2*cell_num];
+  size_t a3_var_size = 0;
+  for(int64_t i=0; i<cell_num; ++i) {
+    a1[i] = (int) (1000 - 7*i);
+    a2[i] = 0.25f * i;
+    a3[i] = a3_var_size;
+    for(int64_t j=0; j<=i%5; ++j) 
+      a3_var[a3_var_size++] = 'a' + i%26;
+    coords[2*i] = (3*i) / 100;
+    coords[2*i+1] = (3*i) % 100;
+  }
+
+  // Write the array
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_WRITE, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const void* write_buffers[] = { a1, a2, a3, a3_var, coords };
+  size_t write_buffer_sizes[] = { 
+      cell_num*sizeof(int), 
+      cell_num*sizeof(float), 
+      cell_num*sizeof(size_t), 
+      a3_var_size, 
+      2*cell_num*sizeof(int64_t) };
+  rc = tiledb_array_write(tiledb_array, write_buffers, write_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read the array back
+  int* r1 = new int[cell_num];
+  float* r2 = new float[cell_num];
+  size_t* r3 = new size_t[cell_num];
+  char* r3_var = new char[5*cell_num];
+  int64_t* r_coords = new int64_t[2*cell_num];
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_READ, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  void* read_buffers[] = { r1, r2, r3, r3_var, r_coords };
+  size_t read_buffer_sizes[] = { 
+      cell_num*sizeof(int), 
+      cell_num*sizeof(float), 
+      cell_num*sizeof(size_t), 
+      5*cell_num, 
+      2*cell_num*sizeof(int64_t) };
+  rc = tiledb_array_read(tiledb_array, read_buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(read_buffer_sizes[0], cell_num*sizeof(int));
+  ASSERT_EQ(read_buffer_sizes[2], cell_num*sizeof(size_t));
+  ASSERT_EQ(read_buffer_sizes[3], a3_var_size);
+  ASSERT_EQ(read_buffer_sizes[4], 2*cell_num*sizeof(int64_t));
+  ASSERT_FALSE(memcmp(a1, r1, cell_num*sizeof(int)));
+  ASSERT_FALSE(memcmp(a2, r2, cell_num*sizeof(float)));
+  ASSERT_FALSE(memcmp(a3, r3, cell_num*sizeof(size_t)));
+  ASSERT_FALSE(memcmp(a3_var, r3_var, a3_var_size));
+  ASSERT_FALSE(memcmp(coords, r_coords, 2*cell_num*sizeof(int64_t)));
+
+  // Clean up
+  delete [] a1;
+  delete [] a2;
+  delete [] a3;
+  delete [] a3_var;
+  delete [] coords;
+  delete [] r1;
+  delete [] r2;
+  delete [] r3;
+  delete [] r3_var;
+  delete [] r_coords;
+}
+
 
 
 
@@ -200,4 +401,432 @@ TEST_F(ArraySchemaTestFixture, test_array_schema) {
   ASSERT_EQ(rc, TILEDB_OK);
 }
 
+/**
+ * Tests that the per-attribute compression parameters are persisted in the
+ * array schema and that they are applied when writing and reading.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_compression_params) {
+  // Error code 
+  int rc;
+
+  // Create array
+  const int compression_level[] = { 9, 3, 19 };
+  const int blosc_shuffle[] = 
+      { TILEDB_BLOSC_SHUFFLE, TILEDB_BLOSC_BITSHUFFLE, TILEDB_BLOSC_SHUFFLE };
+  const int blosc_typesize[] = { 0, 4, 0 };
+  rc = create_dense_array_compressed(
+           compression_level, 
+           blosc_shuffle, 
+           blosc_typesize);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Load array schema from the disk
+  TileDB_ArraySchema array_schema_disk;
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           array_name_.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Tests
+  for(int i=0; i<3; ++i) {
+    ASSERT_EQ(array_schema_disk.compression_level_[i], compression_level[i]);
+    ASSERT_EQ(array_schema_disk.blosc_shuffle_[i], blosc_shuffle[i]);
+    ASSERT_EQ(array_schema_disk.blosc_typesize_[i], blosc_typesize[i]);
+  }
+
+  // Free array schema
+  rc = tiledb_array_free_schema(&array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write the array
+  const int64_t cell_num = 100*100;
+  int* a1 = new int[cell_num];
+  double* a2 = new double[cell_num];
+  for(int64_t i=0; i<cell_num; ++i) {
+    a1[i] = (int) (i % 37);
+    a2[i] = 0.5 * i;
+  }
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_WRITE, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const void* write_buffers[] = { a1, a2 };
+  size_t write_buffer_sizes[] = 
+      { cell_num*sizeof(int), cell_num*sizeof(double) };
+  rc = tiledb_array_write(tiledb_array, write_buffers, write_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read the array back
+  int* r1 = new int[cell_num];
+  double* r2 = new double[cell_num];
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_READ, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  void* read_buffers[] = { r1, r2 };
+  size_t read_buffer_sizes[] = 
+      { cell_num*sizeof(int), cell_num*sizeof(double) };
+  rc = tiledb_array_read(tiledb_array, read_buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(read_buffer_sizes[0], cell_num*sizeof(int));
+  ASSERT_EQ(read_buffer_sizes[1], cell_num*sizeof(double));
+  for(int64_t i=0; i<cell_num; ++i) {
+    ASSERT_EQ(r1[i], a1[i]);
+    ASSERT_EQ(r2[i], a2[i]);
+  }
+
+  // Clean up
+  delete [] a1;
+  delete [] a2;
+  delete [] r1;
+  delete [] r2;
+}
+
+/**
+ * Tests that invalid compression parameters are rejected.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_invalid_compression_params) {
+  // Error code 
+  int rc;
 
+  // Invalid ZSTD level for the coordinates
+  const int compression_level[] = 
+      { TILEDB_COMPRESSION_LEVEL_DEFAULT, TILEDB_COMPRESSION_LEVEL_DEFAULT, 23 };
+  rc = create_dense_array_compressed(compression_level, NULL, NULL);
+  ASSERT_EQ(rc, TILEDB_ERR);
+}
+
+/**
+ * Tests that the filters are persisted in the array schema and that filtered
+ * coordinates and attributes (including the offsets of a variable-sized
+ * attribute) are read back intact.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_filter) {
+  // Error code 
+  int rc;
+
+  // Create array
+  const int filter[] = 
+      { TILEDB_DELTA, TILEDB_NO_FILTER, TILEDB_DELTA, TILEDB_DOUBLE_DELTA };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Load array schema from the disk
+  TileDB_ArraySchema array_schema_disk;
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           array_name_.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<4; ++i) 
+    ASSERT_EQ(array_schema_disk.filter_[i], filter[i]);
+  rc = tiledb_array_free_schema(&array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Check writing and reading
+  check_sparse_array_round_trip();
+}
+
+/**
+ * Tests that filters on non-integer attributes are rejected.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_invalid_filter) {
+  // Error code 
+  int rc;
+
+  // Delta filter on a float attribute
+  const int filter[] = 
+      { TILEDB_NO_FILTER, TILEDB_DELTA, TILEDB_NO_FILTER, TILEDB_NO_FILTER };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_ERR);
+
+  // Dictionary encoding on a fixed-sized attribute
+  const int filter_dict[] = 
+      { TILEDB_DICTIONARY, 
+        TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER };
+  rc = create_sparse_array_filtered(filter_dict, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_ERR);
+}
+
+/**
+ * Tests the columnar layout of the coordinates, alone and combined with a
+ * filter on the coordinates.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_coords_columnar) {
+  // Error code 
+  int rc;
+
+  // Create array
+  const int filter[] = 
+      { TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER, 
+        TILEDB_DOUBLE_DELTA, 
+        TILEDB_DOUBLE_DELTA };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_COLUMNAR);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Load array schema from the disk
+  TileDB_ArraySchema array_schema_disk;
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           array_name_.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(array_schema_disk.coords_layout_, TILEDB_COORDS_COLUMNAR);
+  rc = tiledb_array_free_schema(&array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Check writing and reading
+  check_sparse_array_round_trip();
+}
+
+/**
+ * Tests dictionary encoding on a variable-sized attribute, reading both the
+ * values and the dictionary codes.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_dictionary) {
+  // Error code 
+  int rc;
+
+  // Create array
+  const int filter[] = 
+      { TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER, 
+        TILEDB_DICTIONARY, 
+        TILEDB_NO_FILTER };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Check writing and reading
+  check_sparse_array_round_trip();
+
+  // Read the dictionary codes
+  const int64_t cell_num = 100*100/3;
+  size_t* offsets = new size_t[cell_num];
+  int* codes = new int[cell_num];
+  const char* attributes[] = { "ATTR_CHAR_VAR" };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_READ, 
+           NULL, 
+           attributes, 
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_set_dictionary_codes(tiledb_array, 1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  void* read_buffers[] = { offsets, codes };
+  size_t read_buffer_sizes[] = 
+      { cell_num*sizeof(size_t), cell_num*sizeof(int) };
+  rc = tiledb_array_read(tiledb_array, read_buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(read_buffer_sizes[1], cell_num*sizeof(int));
+
+  // Check that each cell carries the code of its value
+  char value[5];
+  int code;
+  for(int64_t i=0; i<cell_num; ++i) {
+    ASSERT_EQ(offsets[i], i*sizeof(int));
+    memset(value, 'a' + i%26, 5);
+    rc = tiledb_array_get_dictionary_code(
+             tiledb_array, 
+             "ATTR_CHAR_VAR", 
+             value, 
+             i%5 + 1, 
+             &code);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(codes[i], code);
+  }
+
+  // A value that does not appear has no code
+  rc = tiledb_array_get_dictionary_code(
+           tiledb_array, 
+           "ATTR_CHAR_VAR", 
+           "z", 
+           0, 
+           &code);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(code, -1);
+
+  // Clean up
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  delete [] offsets;
+  delete [] codes;
+}
+
+/**
+ * Tests that the dictionary look-up does not depend on whether the subarray
+ * overlaps the fragment.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_dictionary_subarray) {
+  // Error code 
+  int rc;
+
+  // Create array
+  const int filter[] = 
+      { TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER, 
+        TILEDB_DICTIONARY, 
+        TILEDB_NO_FILTER };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write a single fragment in the first rows of the domain, with values
+  // "aa" and "bbb" in turn
+  const int64_t cell_num = 20*100;
+  std::vector<int> a1(cell_num, 1);
+  std::vector<float> a2(cell_num, 0.5f);
+  std::vector<size_t> a3(cell_num);
+  std::string a3_var;
+  std::vector<int64_t> coords(2*cell_num);
+  for(int64_t i=0; i<cell_num; ++i) {
+    a3[i] = a3_var.size();
+    a3_var += (i % 2 == 0) ? "aa" : "bbb";
+    coords[2*i] = i / 100;
+    coords[2*i+1] = i % 100;
+  }
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_WRITE, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const void* write_buffers[] = 
+      { &a1[0], &a2[0], &a3[0], a3_var.c_str(), &coords[0] };
+  size_t write_buffer_sizes[] = { 
+      cell_num*sizeof(int), 
+      cell_num*sizeof(float), 
+      cell_num*sizeof(size_t), 
+      a3_var.size(), 
+      2*cell_num*sizeof(int64_t) };
+  rc = tiledb_array_write(tiledb_array, write_buffers, write_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Look up the values with a subarray that overlaps the fragment and with
+  // one that does not
+  const int64_t subarray_in[] = { 0, 9, 0, 9 };
+  const int64_t subarray_out[] = { 50, 99, 50, 99 };
+  const int64_t* subarrays[] = { subarray_in, subarray_out };
+  int codes[2][2];
+  for(int s=0; s<2; ++s) {
+    rc = tiledb_array_init(
+             tiledb_ctx_, 
+             &tiledb_array, 
+             array_name_.c_str(), 
+             TILEDB_ARRAY_READ, 
+             subarrays[s], 
+             NULL, 
+             0);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_get_dictionary_code(
+             tiledb_array, "ATTR_CHAR_VAR", "aa", 2, &codes[s][0]);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_get_dictionary_code(
+             tiledb_array, "ATTR_CHAR_VAR", "bbb", 3, &codes[s][1]);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+  ASSERT_NE(codes[0][0], -1);
+  ASSERT_NE(codes[0][1], -1);
+  ASSERT_NE(codes[0][0], codes[0][1]);
+  ASSERT_EQ(codes[1][0], codes[0][0]);
+  ASSERT_EQ(codes[1][1], codes[0][1]);
+}
+
+/**
+ * Tests that the array schemas are served from the schema cache of the
+ * context, and that the cache is invalidated when arrays are deleted,
+ * re-created and moved.
+ */
+TEST_F(ArraySchemaTestFixture, test_array_schema_cache) {
+  // Error code 
+  int rc;
+
+  // Create a dense array and load its schema twice
+  rc = create_dense_array();
+  ASSERT_EQ(rc, TILEDB_OK);
+  TileDB_ArraySchema array_schema_disk;
+  int64_t stat_saved_num_before, stat_saved_num_after;
+  for(int i=0; i<2; ++i) {
+    rc = tiledb_ctx_stat_saved_num(tiledb_ctx_, &stat_saved_num_before);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_load_schema(
+             tiledb_ctx_, 
+             array_name_.c_str(), 
+             &array_schema_disk);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(array_schema_disk.dense_, 1);
+    rc = tiledb_array_free_schema(&array_schema_disk);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_ctx_stat_saved_num(tiledb_ctx_, &stat_saved_num_after);
+    ASSERT_EQ(rc, TILEDB_OK);
+    if(i == 1) {
+      ASSERT_GT(stat_saved_num_after, stat_saved_num_before);
+    }
+  }
+
+  // Re-create the array as sparse, which must not be served from the cache
+  rc = tiledb_delete(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_free_schema(&array_schema_);
+  ASSERT_EQ(rc, TILEDB_OK);
+  array_schema_set_ = false;
+  const int filter[] = 
+      { TILEDB_DELTA, TILEDB_NO_FILTER, TILEDB_DELTA, TILEDB_DOUBLE_DELTA };
+  rc = create_sparse_array_filtered(filter, TILEDB_COORDS_INTERLEAVED);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           array_name_.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(array_schema_disk.dense_, 0);
+  rc = tiledb_array_free_schema(&array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Move the array, after which only the new name is valid
+  std::string new_array_name = array_name_ + "_moved";
+  rc = tiledb_move(tiledb_ctx_, array_name_.c_str(), new_array_name.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           array_name_.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_ERR);
+  rc = tiledb_array_load_schema(
+           tiledb_ctx_, 
+           new_array_name.c_str(), 
+           &array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(array_schema_disk.dense_, 0);
+  rc = tiledb_array_free_schema(&array_schema_disk);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
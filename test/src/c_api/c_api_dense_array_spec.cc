@@ -32,6 +32,9 @@
 
 #include "c_api_dense_array_spec.h"
 #include "progress_bar.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <time.h>
 #include <sys/time.h>
@@ -191,6 +194,55 @@ int DenseArrayTestFixture::create_dense_array_2D(
   return TILEDB_OK;
 } 
 
+int DenseArrayTestFixture::create_dense_array_var_2D() {
+  // Error code
+  int rc;
+
+  // Prepare the array schema object and data structures
+  const char* attributes[] = { "ATTR_INT32", "ATTR_CHAR_VAR" };
+  const char* dimensions[] = { "X", "Y" };
+  int64_t domain[] = { 0, 19, 0, 19 };
+  int64_t tile_extents[] = { 10, 10 };
+  const int cell_val_num[] = { 1, TILEDB_VAR_NUM };
+  const int types[] = { TILEDB_INT32, TILEDB_CHAR, TILEDB_INT64 };
+  const int compression[] = { TILEDB_GZIP, TILEDB_GZIP, TILEDB_GZIP };
+
+  // Set the array schema
+  rc = tiledb_array_set_schema(
+           &array_schema_,
+           array_name_.c_str(),
+           attributes,
+           2,
+           0,
+           TILEDB_ROW_MAJOR,
+           cell_val_num,
+           compression,
+           1,
+           dimensions,
+           2,
+           domain,
+           4*sizeof(int64_t),
+           tile_extents,
+           2*sizeof(int64_t),
+           TILEDB_ROW_MAJOR,
+           types);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Create the array
+  rc = tiledb_array_create(tiledb_ctx_, &array_schema_);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Free array schema
+  rc = tiledb_array_free_schema(&array_schema_);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+  
+  // Success
+  return TILEDB_OK;
+} 
+
 int* DenseArrayTestFixture::generate_1D_int_buffer(
     const int64_t domain_size_0,
     const int64_t domain_size_1) {
@@ -782,3 +834,1120 @@ TEST_F(DenseArrayTestFixture, test_random_dense_updates) {
   delete [] buffer_coords;
 }
 
+
+/**
+ * Tests reads over an array whose fragments cover disjoint row bands, so
+ * that each subarray overlaps only some of them, including reads after the
+ * subarray is reset to a different band.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_fragment_pruning) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 100;
+  int64_t domain_size_1 = 100;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t domain_0_lo = 0;
+  int64_t domain_0_hi = domain_size_0-1;
+  int64_t domain_1_lo = 0;
+  int64_t domain_1_hi = domain_size_1-1;
+  int64_t capacity = 0; // 0 means use default capacity
+  int cell_order = TILEDB_ROW_MAJOR;
+  int tile_order = TILEDB_ROW_MAJOR;
+  int64_t band_num = 4;
+  int64_t band_size = domain_size_0 / band_num;
+
+  // Set array name
+  set_array_name("dense_test_100x100_10x10");
+
+  // Create a dense integer array
+  rc = create_dense_array_2D(
+           tile_extent_0,
+           tile_extent_1,
+           domain_0_lo,
+           domain_0_hi,
+           domain_1_lo,
+           domain_1_hi,
+           capacity,
+           false,
+           cell_order,
+           tile_order);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write one fragment per row band, with value = -(row id * COLUMNS + col id)
+  int64_t cell_num_in_band = band_size * domain_size_1;
+  int* buffer = new int[cell_num_in_band];
+  size_t buffer_sizes[] = { cell_num_in_band*sizeof(int) };
+  for(int64_t b = 0; b < band_num; ++b) {
+    int64_t subarray[] = 
+        { b*band_size, (b+1)*band_size-1, domain_1_lo, domain_1_hi };
+    int64_t index = 0;
+    for(int64_t r = subarray[0]; r <= subarray[1]; ++r)
+      for(int64_t c = subarray[2]; c <= subarray[3]; ++c)
+        buffer[index++] = -int(r*domain_size_1+c);
+    rc = write_dense_subarray_2D(
+             subarray,
+             TILEDB_ARRAY_WRITE_SORTED_ROW,
+             buffer,
+             buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+  delete [] buffer;
+
+  // Subarrays within a single band, and across bands
+  int64_t subarrays[][4] = { 
+      { 30, 40, 10, 20 }, 
+      { 80, 90, 50, 60 }, 
+      { 20, 60, 0, 5 },
+      { 35, 45, 10, 20 } 
+  };
+  int subarray_num = 4;
+
+  // Initialize the array on the first subarray
+  TileDB_Array* tiledb_array;
+  const char* attributes[] = { "ATTR_INT32" };
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ_SORTED_ROW,
+           subarrays[0],
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read the subarrays, both with new array objects and by resetting the
+  // subarray of the same array object
+  for(int s = 0; s < subarray_num; ++s) {
+    const int64_t* subarray = subarrays[s];
+
+    // Check with a new array object
+    int* read_buffer = 
+        read_dense_array_2D(
+            subarray[0],
+            subarray[1],
+            subarray[2],
+            subarray[3],
+            TILEDB_ARRAY_READ_SORTED_ROW);
+    ASSERT_TRUE(read_buffer != NULL);
+    int64_t index = 0;
+    for(int64_t r = subarray[0]; r <= subarray[1]; ++r)
+      for(int64_t c = subarray[2]; c <= subarray[3]; ++c)
+        ASSERT_EQ(read_buffer[index++], -int(r*domain_size_1+c));
+    delete [] read_buffer;
+
+    // Check with the same array object
+    if(s > 0) {
+      rc = tiledb_array_reset_subarray(tiledb_array, subarray);
+      ASSERT_EQ(rc, TILEDB_OK);
+    }
+    int64_t cell_num = 
+        (subarray[1]-subarray[0]+1) * (subarray[3]-subarray[2]+1);
+    read_buffer = new int[cell_num];
+    void* buffers[] = { read_buffer };
+    size_t read_buffer_sizes[] = { cell_num*sizeof(int) };
+    rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(read_buffer_sizes[0], cell_num*sizeof(int));
+    index = 0;
+    for(int64_t r = subarray[0]; r <= subarray[1]; ++r)
+      for(int64_t c = subarray[2]; c <= subarray[3]; ++c)
+        ASSERT_EQ(read_buffer[index++], -int(r*domain_size_1+c));
+    delete [] read_buffer;
+  }
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that refreshing an open array makes the new fragments visible to the
+ * arrays initialized afterwards, without affecting the arrays that are
+ * already initialized, and that it drops the fragments removed by a
+ * consolidation.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_array_refresh) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 100;
+  int64_t domain_size_1 = 100;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t domain_0_lo = 0;
+  int64_t domain_0_hi = domain_size_0-1;
+  int64_t domain_1_lo = 0;
+  int64_t domain_1_hi = domain_size_1-1;
+  int64_t capacity = 0; // 0 means use default capacity
+  int cell_order = TILEDB_ROW_MAJOR;
+  int tile_order = TILEDB_ROW_MAJOR;
+
+  // Set array name
+  set_array_name("dense_test_100x100_10x10");
+
+  // Create a dense integer array
+  rc = create_dense_array_2D(
+           tile_extent_0,
+           tile_extent_1,
+           domain_0_lo,
+           domain_0_hi,
+           domain_1_lo,
+           domain_1_hi,
+           capacity,
+           false,
+           cell_order,
+           tile_order);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write array cells with value = row id * COLUMNS + col id
+  rc = write_dense_array_by_tiles(
+           domain_size_0,
+           domain_size_1,
+           tile_extent_0,
+           tile_extent_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Keep the array open with a long-lived reader
+  int64_t subarray[] = { 10, 19, 10, 19 };
+  int64_t cell_num = 100;
+  const char* attributes[] = { "ATTR_INT32" };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ_SORTED_ROW,
+           subarray,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Update the subarray with a new fragment
+  int buffer[100];
+  for(int64_t i = 0; i < cell_num; ++i)
+    buffer[i] = -1;
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  rc = write_dense_subarray_2D(
+           subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           buffer,
+           buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The new fragment is not visible before the refresh
+  int* read_buffer = 
+      read_dense_array_2D(10, 19, 10, 19, TILEDB_ARRAY_READ_SORTED_ROW);
+  ASSERT_TRUE(read_buffer != NULL);
+  ASSERT_EQ(read_buffer[0], 10*domain_size_1+10);
+  delete [] read_buffer;
+
+  // The new fragment is visible after the refresh
+  rc = tiledb_array_refresh(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  read_buffer = 
+      read_dense_array_2D(10, 19, 10, 19, TILEDB_ARRAY_READ_SORTED_ROW);
+  ASSERT_TRUE(read_buffer != NULL);
+  for(int64_t i = 0; i < cell_num; ++i)
+    ASSERT_EQ(read_buffer[i], -1);
+  delete [] read_buffer;
+
+  // The long-lived reader still reads from the old fragments
+  int old_buffer[100];
+  void* buffers[] = { old_buffer };
+  size_t old_buffer_sizes[] = { sizeof(old_buffer) };
+  rc = tiledb_array_read(tiledb_array, buffers, old_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t index = 0;
+  for(int64_t r = subarray[0]; r <= subarray[1]; ++r)
+    for(int64_t c = subarray[2]; c <= subarray[3]; ++c)
+      ASSERT_EQ(old_buffer[index++], r*domain_size_1+c);
+
+  // Consolidate and refresh, which drops the consolidated fragments
+  rc = tiledb_array_consolidate(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_refresh(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  read_buffer = 
+      read_dense_array_2D(5, 24, 5, 24, TILEDB_ARRAY_READ_SORTED_ROW);
+  ASSERT_TRUE(read_buffer != NULL);
+  index = 0;
+  for(int64_t r = 5; r <= 24; ++r) {
+    for(int64_t c = 5; c <= 24; ++c) {
+      bool updated = r >= 10 && r <= 19 && c >= 10 && c <= 19;
+      ASSERT_EQ(read_buffer[index++], updated ? -1 : r*domain_size_1+c);
+    }
+  }
+  delete [] read_buffer;
+
+  // Finalize the long-lived reader
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests clearing and deleting an array with more than one fragment.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_array_clear) {
+  // Error code
+  int rc;
+
+  // Create a dense integer array
+  set_array_name("dense_test_clear");
+  rc = create_dense_array_2D(
+           10,
+           10,
+           0,
+           19,
+           0,
+           19,
+           0,
+           false,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write two fragments
+  rc = write_dense_array_by_tiles(20, 20, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t subarray[] = { 0, 9, 0, 9 };
+  int buffer[100];
+  for(int i = 0; i < 100; ++i)
+    buffer[i] = -1;
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  rc = write_dense_subarray_2D(
+           subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           buffer,
+           buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Clearing removes all the fragments but keeps the array
+  rc = tiledb_clear(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  void* buffers[] = { buffer };
+  rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], 0);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write two fragments again and delete the array
+  rc = write_dense_array_by_tiles(20, 20, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+  buffer_sizes[0] = sizeof(buffer);
+  rc = write_dense_subarray_2D(
+           subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           buffer,
+           buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_delete(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  int* read_buffer = 
+      read_dense_array_2D(0, 19, 0, 19, TILEDB_ARRAY_READ_SORTED_ROW);
+  ASSERT_TRUE(read_buffer == NULL);
+}
+
+/**
+ * Tests that arrays opened on the shared read-only snapshot see a fixed
+ * fragment set across contexts, until the unused snapshot is refreshed.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_array_snapshot) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 100;
+  int64_t domain_size_1 = 100;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t domain_0_lo = 0;
+  int64_t domain_0_hi = domain_size_0-1;
+  int64_t domain_1_lo = 0;
+  int64_t domain_1_hi = domain_size_1-1;
+  int64_t capacity = 0; // 0 means use default capacity
+  int cell_order = TILEDB_ROW_MAJOR;
+  int tile_order = TILEDB_ROW_MAJOR;
+
+  // Set array name
+  set_array_name("dense_test_100x100_10x10");
+
+  // Create a dense integer array
+  rc = create_dense_array_2D(
+           tile_extent_0,
+           tile_extent_1,
+           domain_0_lo,
+           domain_0_hi,
+           domain_1_lo,
+           domain_1_hi,
+           capacity,
+           false,
+           cell_order,
+           tile_order);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write array cells with value = row id * COLUMNS + col id
+  rc = write_dense_array_by_tiles(
+           domain_size_0,
+           domain_size_1,
+           tile_extent_0,
+           tile_extent_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Open the snapshot from two contexts 
+  TileDB_CTX* tiledb_ctx_2;
+  rc = tiledb_ctx_init(&tiledb_ctx_2, NULL);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t subarray[] = { 10, 19, 10, 19 };
+  int64_t cell_num = 100;
+  const char* attributes[] = { "ATTR_INT32" };
+  TileDB_Array* tiledb_arrays[3];
+  for(int i=0; i<2; ++i) {
+    rc = tiledb_array_init_snapshot(
+             (i == 0) ? tiledb_ctx_ : tiledb_ctx_2,
+             &tiledb_arrays[i],
+             array_name_.c_str(),
+             TILEDB_ARRAY_READ_SORTED_ROW,
+             subarray,
+             attributes,
+             1);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+
+  // Snapshots cannot be written
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init_snapshot(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_WRITE,
+           NULL,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_ERR);
+
+  // Update the subarray with a new fragment
+  int buffer[100];
+  for(int64_t i = 0; i < cell_num; ++i)
+    buffer[i] = -1;
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  rc = write_dense_subarray_2D(
+           subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           buffer,
+           buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The snapshot is fixed, even when it is re-opened or refreshed in use
+  rc = tiledb_array_refresh(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_init_snapshot(
+           tiledb_ctx_2,
+           &tiledb_arrays[2],
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ_SORTED_ROW,
+           subarray,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int read_buffer[100];
+  void* buffers[] = { read_buffer };
+  for(int i=0; i<3; ++i) {
+    size_t read_buffer_sizes[] = { sizeof(read_buffer) };
+    rc = tiledb_array_read(tiledb_arrays[i], buffers, read_buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(read_buffer_sizes[0], sizeof(read_buffer));
+    int64_t index = 0;
+    for(int64_t r = subarray[0]; r <= subarray[1]; ++r)
+      for(int64_t c = subarray[2]; c <= subarray[3]; ++c)
+        ASSERT_EQ(read_buffer[index++], r*domain_size_1+c);
+    rc = tiledb_array_finalize(tiledb_arrays[i]);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+
+  // Once unused, the refresh drops the snapshot and the update is visible
+  rc = tiledb_array_refresh(tiledb_ctx_2, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_init_snapshot(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ_SORTED_ROW,
+           subarray,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t read_buffer_sizes[] = { sizeof(read_buffer) };
+  rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int64_t i = 0; i < cell_num; ++i)
+    ASSERT_EQ(read_buffer[i], -1);
+
+  // Clean up, dropping the snapshot
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_refresh(tiledb_ctx_, array_name_.c_str());
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_ctx_finalize(tiledb_ctx_2);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests the query statistics of an array and of its context.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_array_stats) {
+  // Error code
+  int rc;
+
+  // Set array name
+  set_array_name("dense_test_100x100_10x10");
+
+  // Create a compressed dense integer array and write it
+  rc = create_dense_array_2D(
+           10, 10, 0, 99, 0, 99, 0, true, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_dense_array_by_tiles(100, 100, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read a subarray spanning 4 tiles
+  int64_t subarray[] = { 5, 14, 5, 14 };
+  const char* attributes[] = { "ATTR_INT32" };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           subarray,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int buffer[100];
+  void* buffers[] = { buffer };
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], sizeof(buffer));
+
+  // Dump the array statistics
+  FILE* out = tmpfile();
+  ASSERT_TRUE(out != NULL);
+  rc = tiledb_array_stats_dump(tiledb_array, out);
+#ifdef TILEDB_STATS
+  ASSERT_EQ(rc, TILEDB_OK);
+  std::string json(4096, '\0');
+  rewind(out);
+  json.resize(fread(&json[0], 1, json.size(), out));
+  EXPECT_NE(json.find("\"tiles_fetched\": 4\n"), std::string::npos);
+  EXPECT_NE(json.find("\"tiles_decompressed\": 4,"), std::string::npos);
+  EXPECT_NE(json.find("\"read\": { \"calls\": 1,"), std::string::npos);
+  EXPECT_EQ(json.find("\"bytes_read\": 0,"), std::string::npos);
+#else
+  ASSERT_EQ(rc, TILEDB_ERR);
+#endif
+  fclose(out);
+
+  // The context accumulates the statistics of the finalized arrays
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  out = tmpfile();
+  ASSERT_TRUE(out != NULL);
+  rc = tiledb_ctx_stats_dump(tiledb_ctx_, out);
+#ifdef TILEDB_STATS
+  ASSERT_EQ(rc, TILEDB_OK);
+  json.assign(4096, '\0');
+  rewind(out);
+  json.resize(fread(&json[0], 1, json.size(), out));
+  EXPECT_NE(json.find("\"tiles_fetched\": 4\n"), std::string::npos);
+  EXPECT_EQ(json.find("\"book_keeping_load\": { \"calls\": 0,"), 
+            std::string::npos);
+#else
+  ASSERT_EQ(rc, TILEDB_ERR);
+#endif
+  fclose(out);
+}
+
+/**
+ * Tests aggregates computed over a dense array with two fragments, where the
+ * cells of the most recent fragment take precedence.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_aggregates) {
+  // Error code
+  int rc;
+
+  // Set array name
+  set_array_name("dense_test_20x20_10x10");
+
+  // Create a dense integer array and write it
+  rc = create_dense_array_2D(
+           10, 10, 0, 19, 0, 19, 0, false, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_dense_array_by_tiles(20, 20, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Overwrite cells (0,0), (0,1), (1,0) and (1,1) with -1
+  int64_t update_subarray[] = { 0, 1, 0, 1 };
+  int update_buffer[] = { -1, -1, -1, -1 };
+  size_t update_buffer_sizes[] = { sizeof(update_buffer) };
+  rc = write_dense_subarray_2D(
+           update_subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           update_buffer,
+           update_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Initialize the array
+  const char* attribute = "ATTR_INT32";
+  const char* attributes[] = { attribute };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Aggregates over the entire array
+  int64_t count, sum;
+  int min, max;
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_COUNT, &count);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(count, 400);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_SUM, &sum);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(sum, 399*400/2 - (0 + 1 + 20 + 21) - 4);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MIN, &min);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(min, -1);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MAX, &max);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(max, 399);
+
+  // Aggregates over a subarray spanning 4 tiles
+  int64_t subarray[] = { 1, 10, 1, 10 };
+  rc = tiledb_array_reset_subarray(tiledb_array, subarray);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_COUNT, &count);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(count, 100);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MIN, &min);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(min, -1);
+  rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MAX, &max);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(max, 210);
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests reading a batch of ranges of a dense array in a single query.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_read_ranges) {
+  // Error code
+  int rc;
+
+  // Set array name
+  set_array_name("dense_test_20x20_10x10");
+
+  // Create a dense integer array and write it
+  rc = create_dense_array_2D(
+           10, 10, 0, 19, 0, 19, 0, false, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_dense_array_by_tiles(20, 20, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Initialize the array and set the ranges
+  const char* attributes[] = { "ATTR_INT32" };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const int range_num = 3;
+  int64_t ranges[] = { 12, 13, 1, 2,
+                        0,  1, 0, 1,
+                        0,  0, 9, 10 };
+  rc = tiledb_array_reset_ranges(tiledb_array, ranges, range_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read all the ranges at once
+  int buffer[10];
+  void* buffers[] = { buffer };
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  int64_t range_offsets[range_num];
+  int64_t range_cell_nums[range_num];
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], sizeof(buffer));
+  ASSERT_FALSE(tiledb_array_overflow(tiledb_array, 0));
+
+  // The ranges are grouped in the buffer in the tile order
+  ASSERT_EQ(range_offsets[1], 0);
+  ASSERT_EQ(range_offsets[2], 4);
+  ASSERT_EQ(range_offsets[0], 6);
+  ASSERT_EQ(range_cell_nums[0], 4);
+  ASSERT_EQ(range_cell_nums[1], 4);
+  ASSERT_EQ(range_cell_nums[2], 2);
+  int range_0[] = { 241, 242, 261, 262 };
+  int range_1[] = { 0, 1, 20, 21 };
+  int range_2[] = { 9, 10 };
+  int* expected[] = { range_0, range_1, range_2 };
+  for(int r=0; r<range_num; ++r) {
+    std::vector<int> cells(
+        buffer + range_offsets[r], 
+        buffer + range_offsets[r] + range_cell_nums[r]);
+    std::sort(cells.begin(), cells.end());
+    for(int64_t i=0; i<range_cell_nums[r]; ++i)
+      ASSERT_EQ(cells[i], expected[r][i]);
+  }
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that the estimated buffer size of a dense subarray is exact.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_buffer_size_estimate) {
+  // Error code
+  int rc;
+
+  // Set array name
+  set_array_name("dense_test_20x20_10x10");
+
+  // Create a dense integer array and write it
+  rc = create_dense_array_2D(
+           10, 10, 0, 19, 0, 19, 0, true, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_dense_array_by_tiles(20, 20, 10, 10);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Estimate the buffer size of a subarray spanning 4 tiles
+  int64_t subarray[] = { 5, 14, 5, 14 };
+  const char* attributes[] = { "ATTR_INT32" };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           subarray,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t buffer_sizes[1];
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], 100*sizeof(int));
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that the estimated buffer sizes of a partially written dense array 
+ * with a variable-sized attribute count every cell of the subarray exactly, 
+ * with one empty value for each empty variable-sized cell.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_var_buffer_size_estimate) {
+  // Error code
+  int rc;
+
+  // Create a dense array with a variable-sized attribute
+  set_array_name("dense_test_var_20x20_10x10");
+  rc = create_dense_array_var_2D();
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write only the first tile, with 1 to 3 characters per cell
+  int64_t subarray[] = { 0, 9, 0, 9 };
+  int a1[100];
+  size_t a2[100];
+  char a2_var[300];
+  size_t a2_var_size = 0;
+  for(int i=0; i<100; ++i) {
+    a1[i] = i;
+    a2[i] = a2_var_size;
+    for(int j=0; j<=i%3; ++j) 
+      a2_var[a2_var_size++] = 'a' + i%26;
+  }
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           subarray,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const void* write_buffers[] = { a1, a2, a2_var };
+  size_t write_buffer_sizes[] = { sizeof(a1), sizeof(a2), a2_var_size };
+  rc = tiledb_array_write(tiledb_array, write_buffers, write_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The estimates of the entire array count all 400 cells
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t buffer_sizes[3];
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], 400*sizeof(int));
+  ASSERT_EQ(buffer_sizes[1], 400*sizeof(size_t));
+  ASSERT_EQ(buffer_sizes[2], a2_var_size + 400*sizeof(char));
+
+  // A single read with the estimated sizes does not overflow, and returns 
+  // one empty value for each of the 300 empty cells
+  void* buffers[3];
+  size_t read_buffer_sizes[3];
+  for(int i=0; i<3; ++i) {
+    buffers[i] = malloc(buffer_sizes[i]);
+    read_buffer_sizes[i] = buffer_sizes[i];
+  }
+  rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<2; ++i) 
+    ASSERT_EQ(tiledb_array_overflow(tiledb_array, i), 0);
+  ASSERT_EQ(read_buffer_sizes[0], 400*sizeof(int));
+  ASSERT_EQ(read_buffer_sizes[1], 400*sizeof(size_t));
+  ASSERT_EQ(read_buffer_sizes[2], a2_var_size + 300*sizeof(char));
+
+  // The estimates of a subarray partially overlapping the written tile 
+  // count its cells exactly
+  int64_t subarray_2[] = { 5, 14, 5, 14 };
+  rc = tiledb_array_reset_subarray(tiledb_array, subarray_2);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], 100*sizeof(int));
+  ASSERT_EQ(buffer_sizes[1], 100*sizeof(size_t));
+  ASSERT_EQ(buffer_sizes[2], a2_var_size + 100*sizeof(char));
+  for(int i=0; i<3; ++i) 
+    read_buffer_sizes[i] = buffer_sizes[i];
+  rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<2; ++i) 
+    ASSERT_EQ(tiledb_array_overflow(tiledb_array, i), 0);
+  ASSERT_EQ(read_buffer_sizes[0], 100*sizeof(int));
+  ASSERT_EQ(read_buffer_sizes[1], 100*sizeof(size_t));
+  size_t written_var_size = 0;
+  for(int i=5; i<10; ++i) 
+    for(int j=5; j<10; ++j) 
+      written_var_size += (i*10+j)%3 + 1;
+  ASSERT_EQ(read_buffer_sizes[2], written_var_size + 75*sizeof(char));
+
+  // Clean up
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<3; ++i) 
+    free(buffers[i]);
+}
+
+/**
+ * Tests writing scattered updates as a dense fragment that stores only the
+ * tiles they modify.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_skip_empty_tiles) {
+  // Error code
+  int rc;
+
+  // Buffer holding an update of the entire array
+  const int64_t cell_num = 400;
+  int* buffer = new int[cell_num];
+  const void* buffers[] = { buffer };
+  const char* attributes[] = { "ATTR_INT32" };
+
+  // Without compression the update is given in row-major order, whereas with
+  // compression it is given in the global cell order in two writes, the
+  // first of which ends in the middle of a tile
+  for(int i=0; i<2; ++i) {
+    bool compression = (i == 1);
+
+    // Create a dense integer array and write it
+    set_array_name(
+        compression ? "dense_test_20x20_5x5_cmp" : "dense_test_20x20_5x5");
+    rc = create_dense_array_2D(
+             5, 5, 0, 19, 0, 19, 0, compression, 
+             TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = write_dense_array_by_tiles(20, 20, 5, 5);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Update cells (2,3) and (17,16), leaving all other cells empty
+    for(int64_t j=0; j<cell_num; ++j)
+      buffer[j] = TILEDB_EMPTY_INT32;
+    TileDB_Array* tiledb_array;
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             compression ? TILEDB_ARRAY_WRITE : TILEDB_ARRAY_WRITE_SORTED_ROW,
+             NULL,
+             attributes,
+             1);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_set_skip_empty_tiles(tiledb_array, 1);
+    ASSERT_EQ(rc, TILEDB_OK);
+    if(!compression) {
+      buffer[2*20 + 3] = -1;
+      buffer[17*20 + 16] = -2;
+      size_t buffer_sizes[] = { cell_num*sizeof(int) };
+      rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+      ASSERT_EQ(rc, TILEDB_OK);
+    } else {
+      buffer[0*25 + 2*5 + 3] = -1;   // Tile (0,0), cell (2,3) in the tile
+      buffer[15*25 + 2*5 + 1] = -2;  // Tile (3,3), cell (2,1) in the tile
+      size_t buffer_sizes[] = { 130*sizeof(int) };
+      rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+      ASSERT_EQ(rc, TILEDB_OK);
+      const void* buffers_2[] = { buffer + 130 };
+      size_t buffer_sizes_2[] = { (cell_num-130)*sizeof(int) };
+      rc = tiledb_array_write(tiledb_array, buffers_2, buffer_sizes_2);
+      ASSERT_EQ(rc, TILEDB_OK);
+    }
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // The skipped tiles retain the values of the first fragment, whereas the
+    // cells of the two stored tiles are overwritten (mostly with empty cells)
+    int* read_buffer = 
+        read_dense_array_2D(0, 19, 0, 19, TILEDB_ARRAY_READ_SORTED_ROW);
+    ASSERT_TRUE(read_buffer != NULL);
+    int64_t mismatch_num = 0;
+    for(int64_t j=0; j<cell_num; ++j) {
+      int64_t row = j / 20, col = j % 20;
+      int expected = int(j);
+      if(row < 5 && col < 5) 
+        expected = (j == 2*20 + 3) ? -1 : TILEDB_EMPTY_INT32;
+      else if(row >= 15 && col >= 15) 
+        expected = (j == 17*20 + 16) ? -2 : TILEDB_EMPTY_INT32;
+      if(read_buffer[j] != expected)
+        ++mismatch_num;
+    }
+    delete [] read_buffer;
+    ASSERT_EQ(mismatch_num, 0);
+
+    // The update fragment stores only the two modified tiles
+    if(!compression) {
+      std::vector<std::string> fragment_dirs = get_fragment_dirs(array_name_);
+      ASSERT_EQ(fragment_dirs.size(), 2);
+      off_t attribute_file_size = 0;
+      for(int j=0; j<2; ++j) 
+        attribute_file_size += 
+            file_size(fragment_dirs[j] + "/ATTR_INT32" + TILEDB_FILE_SUFFIX);
+      ASSERT_EQ(attribute_file_size, (cell_num + 2*25)*sizeof(int));
+    }
+  }
+
+  // Clean up
+  delete [] buffer;
+}
+
+/**
+ * Tests the validity bitmaps, which tell the cells of a partially written
+ * array apart from the empty ones, even when a cell holds the special empty
+ * value.
+ */
+TEST_F(DenseArrayTestFixture, test_dense_read_validity) {
+  // Error code
+  int rc;
+
+  // Create a dense integer array
+  set_array_name("dense_test_20x20_5x5");
+  rc = create_dense_array_2D(
+           5, 5, 0, 19, 0, 19, 0, false, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write the first two tiles only, storing the special empty value in a cell
+  int64_t subarray[] = { 0, 4, 0, 9 };
+  int buffer[50];
+  for(int i=0; i<50; ++i)
+    buffer[i] = i;
+  buffer[1*10 + 1] = TILEDB_EMPTY_INT32;
+  size_t buffer_sizes[] = { sizeof(buffer) };
+  rc = write_dense_subarray_2D(
+           subarray,
+           TILEDB_ARRAY_WRITE_SORTED_ROW,
+           buffer,
+           buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read the whole array in small chunks, so that the reads overflow 
+  TileDB_Array* tiledb_array;
+  const char* attributes[] = { "ATTR_INT32" };
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int read_buffer[30];
+  void* read_buffers[] = { read_buffer };
+  unsigned char bitmap[4];
+  unsigned char* validity[] = { bitmap };
+  int64_t cell_num = 0, valid_cell_num = 0, mismatch_num = 0;
+  do {
+    size_t read_buffer_sizes[] = { sizeof(read_buffer) };
+    rc = tiledb_array_read_validity(
+             tiledb_array, 
+             read_buffers, 
+             read_buffer_sizes, 
+             validity);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // The cells are returned in the global cell order, so the first 50 cells
+    // are the written ones
+    int64_t read_cell_num = read_buffer_sizes[0] / sizeof(int);
+    for(int64_t i=0; i<read_cell_num; ++i, ++cell_num) {
+      bool valid = (bitmap[i >> 3] >> (i & 7)) & 1;
+      valid_cell_num += valid;
+      if(valid != (cell_num < 50) ||
+         (!valid && read_buffer[i] != TILEDB_EMPTY_INT32))
+        ++mismatch_num;
+    }
+  } while(tiledb_array_overflow(tiledb_array, 0) == 1);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(cell_num, 400);
+  ASSERT_EQ(valid_cell_num, 50);
+  ASSERT_EQ(mismatch_num, 0);
+
+  // Validity is applicable only to the native cell order
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ_SORTED_ROW,
+           NULL,
+           attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t read_buffer_sizes[] = { sizeof(read_buffer) };
+  rc = tiledb_array_read_validity(
+           tiledb_array, 
+           read_buffers, 
+           read_buffer_sizes, 
+           validity);
+  ASSERT_EQ(rc, TILEDB_ERR);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/** Tests the partitioning of a subarray along the tile grid. */
+TEST_F(DenseArrayTestFixture, test_dense_partition_subarray) {
+  // Error code
+  int rc;
+
+  // Create a dense integer array and write it
+  set_array_name("dense_test_20x20_5x5");
+  rc = create_dense_array_2D(
+           5, 5, 0, 19, 0, 19, 0, false, TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_dense_array_by_tiles(20, 20, 5, 5);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Partition a subarray that is not aligned with the tiles
+  int64_t subarray[] = { 2, 17, 3, 18 };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           subarray,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t partitions[4*10];
+  int result_num;
+  rc = tiledb_array_partition_subarray(
+           tiledb_array, 3, partitions, &result_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(result_num, 3);
+
+  // The partitions are slabs of tiles along the rows that cover the subarray
+  int64_t next_row = subarray[0];
+  for(int p=0; p<result_num; ++p) {
+    const int64_t* partition = &partitions[4*p];
+    ASSERT_EQ(partition[0], next_row);
+    ASSERT_TRUE(partition[1] == subarray[1] || partition[1] % 5 == 4);
+    ASSERT_EQ(partition[2], subarray[2]);
+    ASSERT_EQ(partition[3], subarray[3]);
+    next_row = partition[1] + 1;
+
+    // Each partition is read back correctly
+    int* read_buffer = 
+        read_dense_array_2D(
+            partition[0], 
+            partition[1], 
+            partition[2], 
+            partition[3], 
+            TILEDB_ARRAY_READ_SORTED_ROW);
+    ASSERT_TRUE(read_buffer != NULL);
+    int64_t index = 0, mismatch_num = 0;
+    for(int64_t r=partition[0]; r<=partition[1]; ++r) 
+      for(int64_t c=partition[2]; c<=partition[3]; ++c)
+        if(read_buffer[index++] != r*20 + c)
+          ++mismatch_num;
+    delete [] read_buffer;
+    ASSERT_EQ(mismatch_num, 0);
+  }
+  ASSERT_EQ(next_row, subarray[1] + 1);
+
+  // The subarray spans only 4 tiles along each dimension
+  rc = tiledb_array_partition_subarray(
+           tiledb_array, 10, partitions, &result_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(result_num, 4);
+
+  // Invalid number of partitions
+  rc = tiledb_array_partition_subarray(
+           tiledb_array, 0, partitions, &result_num);
+  ASSERT_EQ(rc, TILEDB_ERR);
+
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
@@ -30,14 +30,20 @@
  * Tests of C API for sparse array operations.
  */
 
+#include "array_schema.h"
+#include "book_keeping.h"
 #include "c_api_sparse_array_spec.h"
 #include "progress_bar.h"
+#include "utils.h"
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <map>
 #include <time.h>
 #include <sys/time.h>
 #include <sstream>
+#include <unistd.h>
+#include <zlib.h>
 
 
 
@@ -149,6 +155,62 @@ int SparseArrayTestFixture::create_sparse_array_2D(
   return TILEDB_OK;
 }
 
+int SparseArrayTestFixture::create_sparse_array_filtered_2D(
+    const int* filter) {
+  // Error code
+  int rc;
+
+  // Prepare the array schema object and data structures
+  const char* attributes[] = { "ATTR_INT32", "ATTR_FLOAT32", "ATTR_CHAR_VAR" };
+  const char* dimensions[] = { "X", "Y" };
+  int64_t domain[] = { 0, 99, 0, 99 };
+  const int cell_val_num[] = { 1, 1, TILEDB_VAR_NUM };
+  const int types[] = 
+      { TILEDB_INT32, TILEDB_FLOAT32, TILEDB_CHAR, TILEDB_INT64 };
+  const int compression[] = 
+      { TILEDB_GZIP, TILEDB_LZ4, TILEDB_ZSTD, TILEDB_ZSTD };
+
+  // Set the array schema
+  rc = tiledb_array_set_schema(
+           &array_schema_,
+           array_name_.c_str(),
+           attributes,
+           3,
+           1000,
+           TILEDB_ROW_MAJOR,
+           cell_val_num,
+           compression,
+           0,
+           dimensions,
+           2,
+           domain,
+           4*sizeof(int64_t),
+           NULL,
+           0,
+           0,
+           types);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Set the filters
+  rc = tiledb_array_set_filter(&array_schema_, filter);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Create the array
+  rc = tiledb_array_create(tiledb_ctx_, &array_schema_);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Free array schema
+  rc = tiledb_array_free_schema(&array_schema_);
+  if(rc != TILEDB_OK)
+    return TILEDB_ERR;
+
+  // Success
+  return TILEDB_OK;
+}
+
 int* SparseArrayTestFixture::read_sparse_array_2D(
     const int64_t domain_0_lo,
     const int64_t domain_0_hi,
@@ -267,6 +329,62 @@ int SparseArrayTestFixture::write_sparse_array_unsorted_2D(
   return TILEDB_OK;
 } 
 
+int SparseArrayTestFixture::write_sparse_array_var_2D() {
+  // Error code
+  int rc;
+
+  // Prepare cells in row-major order, every third cell of the domain
+  const int64_t cell_num = 100*100/3;
+  int* buffer_a1 = new int[cell_num];
+  float* buffer_a2 = new float[cell_num];
+  size_t* buffer_a3 = new size_t[cell_num];
+  char* buffer_a3_var = new char[5*cell_num];
+  int64_t* buffer_coords = new int64_t[2*cell_num];
+  size_t buffer_a3_var_size = 0;
+  for(int64_t i=0; i<cell_num; ++i) {
+    buffer_a1[i] = (int) (1000 - 7*i);
+    buffer_a2[i] = 0.25f * i;
+    buffer_a3[i] = buffer_a3_var_size;
+    for(int64_t j=0; j<=i%5; ++j) 
+      buffer_a3_var[buffer_a3_var_size++] = 'a' + i%26;
+    buffer_coords[2*i] = (3*i) / 100;
+    buffer_coords[2*i+1] = (3*i) % 100;
+  }
+
+  // Write the array
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_WRITE,
+           NULL,
+           NULL,
+           0);
+  if(rc == TILEDB_OK) {
+    const void* buffers[] = 
+        { buffer_a1, buffer_a2, buffer_a3, buffer_a3_var, buffer_coords };
+    size_t buffer_sizes[] = { 
+        cell_num*sizeof(int), 
+        cell_num*sizeof(float), 
+        cell_num*sizeof(size_t), 
+        buffer_a3_var_size, 
+        2*cell_num*sizeof(int64_t) };
+    rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+    if(tiledb_array_finalize(tiledb_array) != TILEDB_OK)
+      rc = TILEDB_ERR;
+  }
+
+  // Clean up
+  delete [] buffer_a1;
+  delete [] buffer_a2;
+  delete [] buffer_a3;
+  delete [] buffer_a3_var;
+  delete [] buffer_coords;
+
+  return (rc == TILEDB_OK) ? TILEDB_OK : TILEDB_ERR;
+} 
+
 
 
 /**
@@ -370,3 +488,1239 @@ TEST_F(SparseArrayTestFixture, test_random_sparse_sorted_reads) {
 
 
 
+
+/**
+ * Test is to read the array with attribute predicates, using small buffers
+ * so that the reads overflow, and check that exactly the qualifying cells
+ * are returned for both the attribute and the coordinates, with and without
+ * compression (i.e., with and without tile zone maps).
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_predicates) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t capacity = 50;
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+
+  for(int compression=0; compression<2; ++compression) {
+    // Set array name
+    set_array_name(compression ? "sparse_pred_gzip" : "sparse_pred");
+
+    // Create and write the array
+    rc = create_sparse_array_2D(
+             tile_extent_0,
+             tile_extent_1,
+             0,
+             domain_size_0-1,
+             0,
+             domain_size_1-1,
+             capacity,
+             compression != 0,
+             TILEDB_ROW_MAJOR,
+             TILEDB_ROW_MAJOR);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Initialize the array
+    TileDB_Array* tiledb_array;
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             TILEDB_ARRAY_READ,
+             NULL,
+             attributes,
+             2);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Invalid predicates
+    int value = 0;
+    rc = tiledb_array_add_predicate(tiledb_array, "ATTR_INT32", 6, &value);
+    ASSERT_EQ(rc, TILEDB_ERR);
+    rc = tiledb_array_add_predicate(
+             tiledb_array, 
+             TILEDB_COORDS, 
+             TILEDB_LT, 
+             &value);
+    ASSERT_EQ(rc, TILEDB_ERR);
+
+    // 50 <= a1 < 130 and a1 != 77
+    int lo = 50, hi = 130, excluded = 77;
+    rc = tiledb_array_add_predicate(tiledb_array, "ATTR_INT32", TILEDB_GE, &lo);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_add_predicate(tiledb_array, "ATTR_INT32", TILEDB_LT, &hi);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_add_predicate(
+             tiledb_array, 
+             "ATTR_INT32", 
+             TILEDB_NE, 
+             &excluded);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Read in small batches
+    int buffer_a1[7];
+    int64_t buffer_coords[2*7];
+    void* buffers[] = { buffer_a1, buffer_coords };
+    std::map<int, bool> found;
+    do {
+      size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+      rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+      ASSERT_EQ(rc, TILEDB_OK);
+      int64_t cell_num = buffer_sizes[0] / sizeof(int);
+      ASSERT_EQ(buffer_sizes[1], 2*cell_num*sizeof(int64_t));
+      for(int64_t i=0; i<cell_num; ++i) {
+        ASSERT_TRUE(buffer_a1[i] >= lo && buffer_a1[i] < hi);
+        ASSERT_NE(buffer_a1[i], excluded);
+        ASSERT_EQ(
+            buffer_a1[i], 
+            buffer_coords[2*i]*domain_size_1 + buffer_coords[2*i+1]);
+        ASSERT_TRUE(found.find(buffer_a1[i]) == found.end());
+        found[buffer_a1[i]] = true;
+      }
+    } while(tiledb_array_overflow(tiledb_array, 0));
+    ASSERT_EQ(int(found.size()), hi - lo - 1);
+
+    // No cell satisfies the predicates
+    int max = domain_size_0*domain_size_1;
+    rc = tiledb_array_add_predicate(
+             tiledb_array, 
+             "ATTR_INT32", 
+             TILEDB_GE, 
+             &max);
+    ASSERT_EQ(rc, TILEDB_OK);
+    size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+    rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(buffer_sizes[0], 0);
+    ASSERT_EQ(buffer_sizes[1], 0);
+
+    // All cells are returned without predicates
+    rc = tiledb_array_clear_predicates(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+    int64_t cell_num = 0;
+    do {
+      size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+      rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+      ASSERT_EQ(rc, TILEDB_OK);
+      cell_num += buffer_sizes[0] / sizeof(int);
+    } while(tiledb_array_overflow(tiledb_array, 0));
+    ASSERT_EQ(cell_num, domain_size_0*domain_size_1);
+
+    // Finalize the array
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+}
+
+/**
+ * Tests aggregates computed over a sparse array, with and without a
+ * subarray and predicates.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_aggregates) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t capacity = 50;
+  const char* attribute = "ATTR_INT32";
+  const char* attributes[] = { attribute };
+
+  for(int compression=0; compression<2; ++compression) {
+    // Set array name
+    set_array_name(compression ? "sparse_aggr_gzip" : "sparse_aggr");
+
+    // Create and write the array
+    rc = create_sparse_array_2D(
+             tile_extent_0,
+             tile_extent_1,
+             0,
+             domain_size_0-1,
+             0,
+             domain_size_1-1,
+             capacity,
+             compression != 0,
+             TILEDB_ROW_MAJOR,
+             TILEDB_ROW_MAJOR);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Initialize the array
+    TileDB_Array* tiledb_array;
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             TILEDB_ARRAY_READ,
+             NULL,
+             attributes,
+             1);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Invalid aggregates
+    int64_t count;
+    rc = tiledb_array_aggregate(tiledb_array, attribute, 4, &count);
+    ASSERT_EQ(rc, TILEDB_ERR);
+    rc = tiledb_array_aggregate(
+             tiledb_array,
+             TILEDB_COORDS,
+             TILEDB_COUNT,
+             &count);
+    ASSERT_EQ(rc, TILEDB_ERR);
+
+    // Aggregates over the entire array
+    int64_t sum;
+    int min, max;
+    int64_t cell_num = domain_size_0*domain_size_1;
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_COUNT, &count);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(count, cell_num);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_SUM, &sum);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(sum, cell_num*(cell_num-1)/2);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MIN, &min);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(min, 0);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MAX, &max);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(max, cell_num-1);
+
+    // Aggregates over rows [2,6], i.e., values [40,139]
+    int64_t subarray[] = { 2, 6, 0, domain_size_1-1 };
+    rc = tiledb_array_reset_subarray(tiledb_array, subarray);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_COUNT, &count);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(count, 100);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_SUM, &sum);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(sum, 8950);
+
+    // Aggregates over rows [2,6] with a1 >= 50, i.e., values [50,139]
+    int lo = 50;
+    rc = tiledb_array_add_predicate(tiledb_array, attribute, TILEDB_GE, &lo);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_COUNT, &count);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(count, 90);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_SUM, &sum);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(sum, 8505);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MIN, &min);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(min, 50);
+    rc = tiledb_array_aggregate(tiledb_array, attribute, TILEDB_MAX, &max);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(max, 139);
+
+    // Reads are unaffected by the aggregates
+    int buffer_a1[200];
+    void* buffers[] = { buffer_a1 };
+    size_t buffer_sizes[] = { sizeof(buffer_a1) };
+    rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_EQ(buffer_sizes[0], 90*sizeof(int));
+
+    // Finalize the array
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+}
+
+/**
+ * Tests reading a batch of ranges in a single query, with buffers that
+ * overflow in the middle of the ranges.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_read_ranges) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t capacity = 50;
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+
+  // Set array name
+  set_array_name("sparse_ranges");
+
+  // Create and write the array
+  rc = create_sparse_array_2D(
+           tile_extent_0,
+           tile_extent_1,
+           0,
+           domain_size_0-1,
+           0,
+           domain_size_1-1,
+           capacity,
+           false,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Initialize the array
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           2);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The ranges must be set before reading them. The buffers hold different
+  // numbers of cells, so the attributes overflow at different cells.
+  const int range_num = 4;
+  int buffer_a1[3];
+  int64_t buffer_coords[2*5];
+  void* buffers[] = { buffer_a1, buffer_coords };
+  size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+  int64_t range_offsets[2*range_num];
+  int64_t range_cell_nums[2*range_num];
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_ERR);
+
+  // Set the ranges, in an order different from the tile order
+  int64_t ranges[] = { 15, 16, 15, 16,
+                        0,  0,  0,  3,
+                        2,  3,  2,  3,
+                        9, 10,  9, 10 };
+  rc = tiledb_array_reset_ranges(tiledb_array, ranges, range_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read in small batches, collecting the cells of each range separately
+  // for each attribute
+  std::vector<std::vector<int> > range_a1(range_num);
+  std::vector<std::vector<int64_t> > range_coords(range_num);
+  bool counts_differ = false;
+  do {
+    size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+    rc = tiledb_array_read_ranges(
+             tiledb_array, 
+             buffers, 
+             buffer_sizes, 
+             range_offsets, 
+             range_cell_nums);
+    ASSERT_EQ(rc, TILEDB_OK);
+    int64_t a1_cell_num = 0, coords_cell_num = 0;
+    for(int r=0; r<range_num; ++r) {
+      int64_t a1_offset = range_offsets[r];
+      int64_t a1_num = range_cell_nums[r];
+      int64_t coords_offset = range_offsets[range_num + r];
+      int64_t coords_num = range_cell_nums[range_num + r];
+      if(a1_num != coords_num)
+        counts_differ = true;
+      for(int64_t i=a1_offset; i<a1_offset + a1_num; ++i) 
+        range_a1[r].push_back(buffer_a1[i]);
+      for(int64_t i=coords_offset; i<coords_offset + coords_num; ++i) {
+        const int64_t* coords = &buffer_coords[2*i];
+        const int64_t* range = &ranges[4*r];
+        ASSERT_TRUE(coords[0] >= range[0] && coords[0] <= range[1]);
+        ASSERT_TRUE(coords[1] >= range[2] && coords[1] <= range[3]);
+        range_coords[r].push_back(coords[0]*domain_size_1 + coords[1]);
+      }
+      a1_cell_num += a1_num;
+      coords_cell_num += coords_num;
+    }
+    ASSERT_EQ(a1_cell_num*sizeof(int), buffer_sizes[0]);
+    ASSERT_EQ(2*coords_cell_num*sizeof(int64_t), buffer_sizes[1]);
+  } while(tiledb_array_overflow(tiledb_array, 0) || 
+          tiledb_array_overflow(tiledb_array, 1));
+  ASSERT_TRUE(counts_differ);
+
+  // Check the cells of each range, which must match across the attributes
+  for(int r=0; r<range_num; ++r) {
+    const int64_t* range = &ranges[4*r];
+    int64_t cell_num = 
+        (range[1] - range[0] + 1) * (range[3] - range[2] + 1);
+    ASSERT_EQ(int64_t(range_a1[r].size()), cell_num);
+    ASSERT_EQ(int64_t(range_coords[r].size()), cell_num);
+    for(int64_t i=0; i<cell_num; ++i) 
+      ASSERT_EQ(range_a1[r][i], range_coords[r][i]);
+  }
+
+  // All ranges have been read
+  buffer_sizes[0] = sizeof(buffer_a1);
+  buffer_sizes[1] = sizeof(buffer_coords);
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], 0);
+  ASSERT_EQ(buffer_sizes[1], 0);
+
+  // Resetting the subarray discards the ranges
+  rc = tiledb_array_reset_subarray(tiledb_array, NULL);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_ERR);
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that the tiles a compressed array shares among non-adjacent ranges
+ * are fetched once, and that changing the predicates keeps the ranges.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_read_ranges_tile_cache) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t tile_extent_0 = 10;
+  int64_t tile_extent_1 = 10;
+  int64_t capacity = 50;
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+
+  // Set array name
+  set_array_name("sparse_ranges_tile_cache");
+
+  // Create and write the array
+  rc = create_sparse_array_2D(
+           tile_extent_0,
+           tile_extent_1,
+           0,
+           domain_size_0-1,
+           0,
+           domain_size_1-1,
+           capacity,
+           true,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Initialize the array
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           2);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The first range spans the tiles of two space tiles, to which the next
+  // ranges return in turn
+  const int range_num = 3;
+  int64_t ranges[] = { 0, 9,  0, 19,
+                       5, 6,  5,  6,
+                       0, 0, 15, 15 };
+  rc = tiledb_array_reset_ranges(tiledb_array, ranges, range_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read the ranges twice. The second time all the tiles are in main memory.
+  int buffer_a1[400];
+  int64_t buffer_coords[2*400];
+  void* buffers[] = { buffer_a1, buffer_coords };
+  int64_t range_offsets[2*range_num];
+  int64_t range_cell_nums[2*range_num];
+  int64_t tiles_fetched[2] = { 0, 0 };
+  for(int pass=0; pass<2; ++pass) {
+    size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+    rc = tiledb_array_read_ranges(
+             tiledb_array, 
+             buffers, 
+             buffer_sizes, 
+             range_offsets, 
+             range_cell_nums);
+    ASSERT_EQ(rc, TILEDB_OK);
+    ASSERT_FALSE(tiledb_array_overflow(tiledb_array, 0));
+    for(int r=0; r<range_num; ++r) {
+      const int64_t* range = &ranges[4*r];
+      int64_t cell_num = 
+          (range[1] - range[0] + 1) * (range[3] - range[2] + 1);
+      ASSERT_EQ(range_cell_nums[r], cell_num);
+      ASSERT_EQ(range_cell_nums[range_num + r], cell_num);
+      for(int64_t i=0; i<cell_num; ++i) {
+        const int64_t* coords = 
+            &buffer_coords[2*(range_offsets[range_num + r] + i)];
+        ASSERT_TRUE(coords[0] >= range[0] && coords[0] <= range[1]);
+        ASSERT_TRUE(coords[1] >= range[2] && coords[1] <= range[3]);
+        ASSERT_EQ(
+            buffer_a1[range_offsets[r] + i], 
+            coords[0]*domain_size_1 + coords[1]);
+      }
+    }
+
+#ifdef TILEDB_STATS
+    FILE* out = tmpfile();
+    ASSERT_TRUE(out != NULL);
+    rc = tiledb_array_stats_dump(tiledb_array, out);
+    ASSERT_EQ(rc, TILEDB_OK);
+    std::string json(4096, '\0');
+    rewind(out);
+    json.resize(fread(&json[0], 1, json.size(), out));
+    fclose(out);
+    size_t pos = json.find("\"tiles_fetched\": ");
+    ASSERT_NE(pos, std::string::npos);
+    tiles_fetched[pass] = atoll(json.c_str() + pos + 17);
+#endif
+
+    rc = tiledb_array_reset_ranges(tiledb_array, ranges, range_num);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+#ifdef TILEDB_STATS
+  ASSERT_GT(tiles_fetched[0], 0);
+  ASSERT_EQ(tiles_fetched[1], tiles_fetched[0]);
+#endif
+
+  // A predicate keeps the ranges, which are read again from the first one.
+  // Only the cells in the first five rows qualify.
+  int value = 5*domain_size_1;
+  rc = tiledb_array_add_predicate(
+           tiledb_array, 
+           "ATTR_INT32", 
+           TILEDB_LT, 
+           &value);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(range_cell_nums[0], 5*domain_size_1);
+  ASSERT_EQ(range_cell_nums[1], 0);
+  ASSERT_EQ(range_cell_nums[2], 1);
+  ASSERT_EQ(buffer_sizes[0], (5*domain_size_1 + 1)*sizeof(int));
+
+  // Clearing the predicates keeps the ranges as well
+  rc = tiledb_array_clear_predicates(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  buffer_sizes[0] = sizeof(buffer_a1);
+  buffer_sizes[1] = sizeof(buffer_coords);
+  rc = tiledb_array_read_ranges(
+           tiledb_array, 
+           buffers, 
+           buffer_sizes, 
+           range_offsets, 
+           range_cell_nums);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(range_cell_nums[0], 10*domain_size_1);
+  ASSERT_EQ(range_cell_nums[1], 4);
+  ASSERT_EQ(range_cell_nums[2], 1);
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that the estimated buffer sizes of a sparse array with a 
+ * dictionary-encoded variable-sized attribute are upper bounds that allow
+ * reading without overflow.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_buffer_size_estimate) {
+  // Error code 
+  int rc;
+
+  // Create and populate the array
+  set_array_name("sparse_test_100x100_filtered");
+  const int filter[] = 
+      { TILEDB_NO_FILTER, 
+        TILEDB_NO_FILTER, 
+        TILEDB_DICTIONARY, 
+        TILEDB_NO_FILTER };
+  rc = create_sparse_array_filtered_2D(filter);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_sparse_array_var_2D();
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Estimate the buffer sizes for the entire array
+  const int64_t cell_num = 100*100/3;
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_, 
+           &tiledb_array, 
+           array_name_.c_str(), 
+           TILEDB_ARRAY_READ, 
+           NULL, 
+           NULL, 
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  size_t buffer_sizes[5];
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[0], cell_num*sizeof(int));
+  ASSERT_EQ(buffer_sizes[1], cell_num*sizeof(float));
+  ASSERT_EQ(buffer_sizes[2], cell_num*sizeof(size_t));
+  ASSERT_EQ(buffer_sizes[3], 5*cell_num);
+  ASSERT_EQ(buffer_sizes[4], 2*cell_num*sizeof(int64_t));
+
+  // A single read with the estimated sizes does not overflow
+  void* buffers[5];
+  size_t read_buffer_sizes[5];
+  for(int i=0; i<5; ++i) {
+    buffers[i] = malloc(buffer_sizes[i]);
+    read_buffer_sizes[i] = buffer_sizes[i];
+  }
+  rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<4; ++i) 
+    ASSERT_EQ(tiledb_array_overflow(tiledb_array, i), 0);
+  ASSERT_EQ(read_buffer_sizes[0], cell_num*sizeof(int));
+
+  // The estimate of a smaller subarray is a tighter upper bound
+  int64_t subarray[] = { 0, 9, 0, 99 };
+  rc = tiledb_array_reset_subarray(tiledb_array, subarray);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<5; ++i) 
+    read_buffer_sizes[i] = buffer_sizes[i];
+  rc = tiledb_array_read(tiledb_array, buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<4; ++i) 
+    ASSERT_EQ(tiledb_array_overflow(tiledb_array, i), 0);
+  ASSERT_EQ(read_buffer_sizes[0], 334*sizeof(int));
+  ASSERT_LT(buffer_sizes[0], cell_num*sizeof(int));
+  for(int i=0; i<5; ++i) 
+    ASSERT_LE(read_buffer_sizes[i], buffer_sizes[i]);
+
+  // With dictionary codes, the values are replaced with int codes
+  rc = tiledb_array_set_dictionary_codes(tiledb_array, 1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_reset_subarray(tiledb_array, NULL);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_estimate_buffer_sizes(tiledb_array, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(buffer_sizes[3], cell_num*sizeof(int));
+
+  // Clean up
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int i=0; i<5; ++i) 
+    free(buffers[i]);
+}
+
+/** Tests the partitioning of a subarray into parts of balanced cell counts. */
+TEST_F(SparseArrayTestFixture, test_sparse_partition_subarray) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 100;
+  int64_t domain_size_1 = 100;
+  int64_t capacity = 50;
+
+  // Create and write the array
+  set_array_name("sparse_partitions");
+  rc = create_sparse_array_2D(
+           10,
+           10,
+           0,
+           domain_size_0-1,
+           0,
+           domain_size_1-1,
+           capacity,
+           false,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Partition a subarray of 80 rows, in which the cells are uniform
+  int64_t subarray[] = { 10, 89, 20, 59 };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           subarray,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t partitions[4*4];
+  int result_num;
+  rc = tiledb_array_partition_subarray(
+           tiledb_array, 4, partitions, &result_num);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(result_num, 4);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // The partitions split the rows into balanced parts and cover the subarray
+  int64_t next_row = subarray[0];
+  for(int p=0; p<result_num; ++p) {
+    const int64_t* partition = &partitions[4*p];
+    ASSERT_EQ(partition[0], next_row);
+    ASSERT_GE(partition[1] - partition[0] + 1, 18);
+    ASSERT_LE(partition[1] - partition[0] + 1, 22);
+    ASSERT_EQ(partition[2], subarray[2]);
+    ASSERT_EQ(partition[3], subarray[3]);
+    next_row = partition[1] + 1;
+
+    // Each partition is read back correctly
+    int* read_buffer = 
+        read_sparse_array_2D(
+            partition[0], 
+            partition[1], 
+            partition[2], 
+            partition[3], 
+            TILEDB_ARRAY_READ_SORTED_ROW);
+    ASSERT_TRUE(read_buffer != NULL);
+    int64_t index = 0, mismatch_num = 0;
+    for(int64_t r=partition[0]; r<=partition[1]; ++r) 
+      for(int64_t c=partition[2]; c<=partition[3]; ++c)
+        if(read_buffer[index++] != r*domain_size_1 + c)
+          ++mismatch_num;
+    delete [] read_buffer;
+    ASSERT_EQ(mismatch_num, 0);
+  }
+  ASSERT_EQ(next_row, subarray[1] + 1);
+}
+
+/**
+ * Tests reading an array with several overlapping fragments, whose tiles are
+ * processed in parallel, in small batches.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_read_fragments) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t cell_num = domain_size_0*domain_size_1;
+  int64_t capacity = 30;
+  const int fragment_num = 4;
+
+  // Create the array and write the first fragment with all the cells
+  set_array_name("sparse_fragments");
+  rc = create_sparse_array_2D(
+           10,
+           10,
+           0,
+           domain_size_0-1,
+           0,
+           domain_size_1-1,
+           capacity,
+           true,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Each following fragment overwrites every fragment_num-th diagonal
+  std::vector<int> expected(cell_num);
+  for(int64_t i=0; i<cell_num; ++i)
+    expected[i] = i;
+  for(int f=1; f<fragment_num; ++f) {
+    std::vector<int> buffer_a1;
+    std::vector<int64_t> buffer_coords;
+    for(int64_t i=0; i<domain_size_0; ++i) {
+      for(int64_t j=0; j<domain_size_1; ++j) {
+        if((i+j) % fragment_num != f)
+          continue;
+        expected[i*domain_size_1+j] = 1000*f + i*domain_size_1 + j;
+        buffer_a1.push_back(expected[i*domain_size_1+j]);
+        buffer_coords.push_back(i);
+        buffer_coords.push_back(j);
+      }
+    }
+    TileDB_Array* tiledb_array;
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             TILEDB_ARRAY_WRITE_UNSORTED,
+             NULL,
+             NULL,
+             0);
+    ASSERT_EQ(rc, TILEDB_OK);
+    const void* buffers[] = { &buffer_a1[0], &buffer_coords[0] };
+    size_t buffer_sizes[] = { 
+        buffer_a1.size()*sizeof(int), 
+        buffer_coords.size()*sizeof(int64_t) 
+    };
+    rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+
+  // Initialize the array
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           attributes,
+           2);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Read in small batches, checking the values and the global cell order
+  int buffer_a1[7];
+  int64_t buffer_coords[2*7];
+  void* buffers[] = { buffer_a1, buffer_coords };
+  int64_t result_num = 0, last_pos = -1;
+  do {
+    size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+    rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+    ASSERT_EQ(rc, TILEDB_OK);
+    int64_t batch_num = buffer_sizes[0] / sizeof(int);
+    ASSERT_EQ(buffer_sizes[1], 2*batch_num*sizeof(int64_t));
+    for(int64_t i=0; i<batch_num; ++i) {
+      int64_t x = buffer_coords[2*i], y = buffer_coords[2*i+1];
+      int64_t pos = ((x/10)*2 + y/10)*100 + (x%10)*10 + y%10;
+      ASSERT_GT(pos, last_pos);
+      ASSERT_EQ(buffer_a1[i], expected[x*domain_size_1+y]);
+      last_pos = pos;
+    }
+    result_num += batch_num;
+  } while(tiledb_array_overflow(tiledb_array, 0));
+  ASSERT_EQ(result_num, cell_num);
+
+  // Finalize the array
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests the tile zone maps of a sparse array after reloading the fragment
+ * book-keeping, including tiles with empty values, a variable-sized
+ * attribute, and a fragment without zone maps.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_zone_maps) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  const int64_t domain_size = 10;
+  const int64_t cell_num = domain_size*domain_size;
+
+  // Create an array with a fixed- and a variable-sized attribute, with one
+  // row per tile
+  set_array_name("sparse_zone_maps");
+  const char* attributes[] = { "a1", "a2" };
+  const char* dimensions[] = { "X", "Y" };
+  int64_t domain[] = { 0, domain_size-1, 0, domain_size-1 };
+  int64_t tile_extents[] = { domain_size, domain_size };
+  const int types[] = { TILEDB_INT32, TILEDB_CHAR, TILEDB_INT64 };
+  const int cell_val_num[] = { 1, TILEDB_VAR_NUM };
+  const int compression[] = { TILEDB_GZIP, TILEDB_GZIP, TILEDB_GZIP };
+  rc = tiledb_array_set_schema(
+           &array_schema_,
+           array_name_.c_str(),
+           attributes,
+           2,
+           domain_size,
+           TILEDB_ROW_MAJOR,
+           cell_val_num,
+           compression,
+           0,
+           dimensions,
+           2,
+           domain,
+           sizeof(domain),
+           tile_extents,
+           sizeof(tile_extents),
+           TILEDB_ROW_MAJOR,
+           types);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_create(tiledb_ctx_, &array_schema_);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_free_schema(&array_schema_);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Write all cells in the global order. The values of row 3 are all empty,
+  // and those of the even columns of row 5.
+  std::vector<int> buffer_a1(cell_num);
+  std::vector<size_t> buffer_a2(cell_num);
+  std::vector<char> buffer_var_a2(cell_num, 'x');
+  std::vector<int64_t> buffer_coords(2*cell_num);
+  for(int64_t i=0; i<domain_size; ++i) {
+    for(int64_t j=0; j<domain_size; ++j) {
+      int64_t pos = i*domain_size + j;
+      bool empty = (i == 3) || (i == 5 && j % 2 == 0);
+      buffer_a1[pos] = empty ? TILEDB_EMPTY_INT32 : pos;
+      buffer_a2[pos] = pos;
+      buffer_coords[2*pos] = i;
+      buffer_coords[2*pos+1] = j;
+    }
+  }
+  TileDB_Array* tiledb_array;
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_WRITE,
+           NULL,
+           NULL,
+           0);
+  ASSERT_EQ(rc, TILEDB_OK);
+  const void* buffers[] = 
+      { &buffer_a1[0], &buffer_a2[0], &buffer_var_a2[0], &buffer_coords[0] };
+  size_t buffer_sizes[] = { 
+      cell_num*sizeof(int), 
+      cell_num*sizeof(size_t), 
+      size_t(cell_num), 
+      2*cell_num*sizeof(int64_t) 
+  };
+  rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+
+  // Load the array schema
+  std::string schema_filename = 
+      array_name_ + "/" + TILEDB_ARRAY_SCHEMA_FILENAME;
+  size_t schema_size = file_size(schema_filename);
+  std::vector<char> schema_bin(schema_size);
+  rc = read_from_file(schema_filename, 0, &schema_bin[0], schema_size);
+  ASSERT_EQ(rc, TILEDB_UT_OK);
+  ArraySchema array_schema;
+  rc = array_schema.deserialize(&schema_bin[0], schema_size);
+  ASSERT_EQ(rc, TILEDB_AS_OK);
+
+  // Reload the book-keeping of the fragment
+  std::vector<std::string> fragment_dirs = get_fragment_dirs(array_name_);
+  ASSERT_EQ(fragment_dirs.size(), 1);
+  BookKeeping* book_keeping = new BookKeeping(
+      &array_schema, false, fragment_dirs[0], TILEDB_ARRAY_READ);
+  rc = book_keeping->load();
+  ASSERT_EQ(rc, TILEDB_BK_OK);
+  ASSERT_EQ(book_keeping->tile_num(), domain_size);
+
+  // Check the zone map of each tile
+  size_t zone_map_size = 2*sizeof(int) + 2*sizeof(int64_t);
+  ASSERT_EQ(book_keeping->zone_map_size(0), zone_map_size);
+  for(int64_t i=0; i<domain_size; ++i) {
+    const char* zone_map = 
+        static_cast<const char*>(book_keeping->zone_map(0, i));
+    ASSERT_TRUE(zone_map != NULL);
+    int min, max;
+    int64_t non_empty_num, empty_num;
+    memcpy(&min, zone_map, sizeof(int));
+    memcpy(&max, zone_map + sizeof(int), sizeof(int));
+    memcpy(&non_empty_num, zone_map + 2*sizeof(int), sizeof(int64_t));
+    memcpy(
+        &empty_num, 
+        zone_map + 2*sizeof(int) + sizeof(int64_t), 
+        sizeof(int64_t));
+    if(i == 3) {
+      ASSERT_EQ(min, TILEDB_EMPTY_INT32);
+      ASSERT_EQ(max, TILEDB_EMPTY_INT32);
+      ASSERT_EQ(non_empty_num, 0);
+      ASSERT_EQ(empty_num, domain_size);
+    } else if(i == 5) {
+      ASSERT_EQ(min, i*domain_size + 1);
+      ASSERT_EQ(max, i*domain_size + domain_size-1);
+      ASSERT_EQ(non_empty_num, domain_size/2);
+      ASSERT_EQ(empty_num, domain_size/2);
+    } else {
+      ASSERT_EQ(min, i*domain_size);
+      ASSERT_EQ(max, i*domain_size + domain_size-1);
+      ASSERT_EQ(non_empty_num, domain_size);
+      ASSERT_EQ(empty_num, 0);
+    }
+  }
+  ASSERT_TRUE(book_keeping->zone_map(0, domain_size) == NULL);
+
+  // The variable-sized attribute and the coordinates have no zone maps
+  ASSERT_EQ(book_keeping->zone_map_size(1), 0);
+  ASSERT_TRUE(book_keeping->zone_map(1, 0) == NULL);
+  ASSERT_EQ(book_keeping->zone_map_size(2), 0);
+  ASSERT_TRUE(book_keeping->zone_map(2, 0) == NULL);
+
+  // Strip the zone maps and the (empty) tile presence bitmap from the
+  // book-keeping file, as in fragments created before zone maps
+  std::string book_keeping_filename = 
+      fragment_dirs[0] + "/" + TILEDB_BOOK_KEEPING_FILENAME + 
+      TILEDB_FILE_SUFFIX + TILEDB_GZIP_SUFFIX;
+  gzFile fd = gzopen(book_keeping_filename.c_str(), "rb");
+  ASSERT_TRUE(fd != NULL);
+  std::vector<char> book_keeping_bin;
+  char chunk[4096];
+  int bytes_read;
+  while((bytes_read = gzread(fd, chunk, sizeof(chunk))) > 0)
+    book_keeping_bin.insert(
+        book_keeping_bin.end(), 
+        chunk, 
+        chunk + bytes_read);
+  ASSERT_EQ(gzclose(fd), Z_OK);
+  size_t stripped_size = 
+      book_keeping_bin.size() - 
+      domain_size*zone_map_size -       // Zone maps of "a1"
+      2*sizeof(int64_t) -               // Zone map sizes of "a1" and "a2" 
+      sizeof(int64_t);                  // Number of tile presence bits
+  rc = write_to_file_cmp_gzip(
+           book_keeping_filename.c_str(), 
+           &book_keeping_bin[0], 
+           stripped_size);
+  ASSERT_EQ(rc, TILEDB_UT_OK);
+  delete book_keeping;
+
+  // The fragment now loads without zone maps
+  book_keeping = new BookKeeping(
+      &array_schema, false, fragment_dirs[0], TILEDB_ARRAY_READ);
+  rc = book_keeping->load();
+  ASSERT_EQ(rc, TILEDB_BK_OK);
+  ASSERT_EQ(book_keeping->tile_num(), domain_size);
+  ASSERT_EQ(book_keeping->zone_map_size(0), zone_map_size);
+  for(int64_t i=0; i<domain_size; ++i)
+    ASSERT_TRUE(book_keeping->zone_map(0, i) == NULL);
+  delete book_keeping;
+
+  // Aggregates and predicates fall back to the attribute values
+  const char* read_attributes[] = { "a1" };
+  rc = tiledb_array_init(
+           tiledb_ctx_,
+           &tiledb_array,
+           array_name_.c_str(),
+           TILEDB_ARRAY_READ,
+           NULL,
+           read_attributes,
+           1);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int64_t count;
+  int min, max;
+  rc = tiledb_array_aggregate(tiledb_array, "a1", TILEDB_COUNT, &count);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(count, cell_num - 3*domain_size/2);
+  rc = tiledb_array_aggregate(tiledb_array, "a1", TILEDB_MIN, &min);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(min, 0);
+  rc = tiledb_array_aggregate(tiledb_array, "a1", TILEDB_MAX, &max);
+  ASSERT_EQ(rc, TILEDB_OK);
+  ASSERT_EQ(max, cell_num-1);
+  int value = 55;
+  rc = tiledb_array_add_predicate(tiledb_array, "a1", TILEDB_LE, &value);
+  ASSERT_EQ(rc, TILEDB_OK);
+  int buffer_read_a1[cell_num];
+  void* read_buffers[] = { buffer_read_a1 };
+  size_t read_buffer_sizes[] = { sizeof(buffer_read_a1) };
+  rc = tiledb_array_read(tiledb_array, read_buffers, read_buffer_sizes);
+  ASSERT_EQ(rc, TILEDB_OK);
+  // Cells 0-55 without row 3 and cells 50, 52 and 54
+  ASSERT_EQ(read_buffer_sizes[0], (value + 1 - domain_size - 3)*sizeof(int));
+  rc = tiledb_array_finalize(tiledb_array);
+  ASSERT_EQ(rc, TILEDB_OK);
+}
+
+/**
+ * Tests that an error in one of several fragments whose tiles are processed
+ * in parallel fails the read and the aggregates with the error message of
+ * that fragment.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_read_fragments_error) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  int64_t capacity = 30;
+  const int fragment_num = 4;
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+  const char* array_names[] = { "sparse_error_a1", "sparse_error_coords" };
+
+  // Truncate the attribute and the coordinates file of a fragment in turn
+  for(int a=0; a<2; ++a) {
+    // Create the array
+    set_array_name(array_names[a]);
+    rc = create_sparse_array_2D(
+             10,
+             10,
+             0,
+             domain_size_0-1,
+             0,
+             domain_size_1-1,
+             capacity,
+             true,
+             TILEDB_ROW_MAJOR,
+             TILEDB_ROW_MAJOR);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Each fragment writes a different band of rows, so that the tiles of
+    // all fragments are read
+    int64_t band_size = domain_size_0 / fragment_num;
+    for(int f=0; f<fragment_num; ++f) {
+      std::vector<int> buffer_a1;
+      std::vector<int64_t> buffer_coords;
+      for(int64_t i=f*band_size; i<(f+1)*band_size; ++i) {
+        for(int64_t j=0; j<domain_size_1; ++j) {
+          buffer_a1.push_back(i*domain_size_1 + j);
+          buffer_coords.push_back(i);
+          buffer_coords.push_back(j);
+        }
+      }
+      TileDB_Array* tiledb_array;
+      rc = tiledb_array_init(
+               tiledb_ctx_,
+               &tiledb_array,
+               array_name_.c_str(),
+               TILEDB_ARRAY_WRITE_UNSORTED,
+               NULL,
+               NULL,
+               0);
+      ASSERT_EQ(rc, TILEDB_OK);
+      const void* buffers[] = { &buffer_a1[0], &buffer_coords[0] };
+      size_t buffer_sizes[] = { 
+          buffer_a1.size()*sizeof(int), 
+          buffer_coords.size()*sizeof(int64_t) 
+      };
+      rc = tiledb_array_write(tiledb_array, buffers, buffer_sizes);
+      ASSERT_EQ(rc, TILEDB_OK);
+      rc = tiledb_array_finalize(tiledb_array);
+      ASSERT_EQ(rc, TILEDB_OK);
+    }
+
+    // Truncate the last tile of one fragment
+    std::vector<std::string> fragment_dirs = get_fragment_dirs(array_name_);
+    ASSERT_EQ(fragment_dirs.size(), fragment_num);
+    std::string filename = 
+        fragment_dirs[1] + "/" + attributes[a] + TILEDB_FILE_SUFFIX;
+    rc = truncate(filename.c_str(), file_size(filename) - 4);
+    ASSERT_EQ(rc, 0);
+
+    // Initialize the array
+    TileDB_Array* tiledb_array;
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             TILEDB_ARRAY_READ,
+             NULL,
+             attributes,
+             2);
+    ASSERT_EQ(rc, TILEDB_OK);
+
+    // Read in small batches until the truncated tile is reached
+    int buffer_a1[7];
+    int64_t buffer_coords[2*7];
+    void* buffers[] = { buffer_a1, buffer_coords };
+    tiledb_errmsg[0] = '\0';
+    do {
+      size_t buffer_sizes[] = { sizeof(buffer_a1), sizeof(buffer_coords) };
+      rc = tiledb_array_read(tiledb_array, buffers, buffer_sizes);
+    } while(rc == TILEDB_OK && tiledb_array_overflow(tiledb_array, 0));
+    ASSERT_EQ(rc, TILEDB_ERR);
+    ASSERT_TRUE(strstr(tiledb_errmsg, "Cannot decompress with GZIP") != NULL);
+
+    // The aggregates fail likewise
+    int64_t sum;
+    tiledb_errmsg[0] = '\0';
+    rc = tiledb_array_aggregate(tiledb_array, "ATTR_INT32", TILEDB_SUM, &sum);
+    ASSERT_EQ(rc, TILEDB_ERR);
+    ASSERT_TRUE(strstr(tiledb_errmsg, "Cannot decompress with GZIP") != NULL);
+
+    // Finalize the array
+    rc = tiledb_array_finalize(tiledb_array);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+}
+
+/**
+ * Tests that the array initialization fails with the error of the fragments
+ * whose book-keeping cannot be loaded, which is loaded in parallel.
+ */
+TEST_F(SparseArrayTestFixture, test_sparse_book_keeping_error) {
+  // Error code
+  int rc;
+
+  // Parameters used in this test
+  int64_t domain_size_0 = 20;
+  int64_t domain_size_1 = 20;
+  const int fragment_num = 4;
+  const char* attributes[] = { "ATTR_INT32", TILEDB_COORDS };
+
+  // Set array name
+  set_array_name("sparse_book_keeping_error");
+
+  // Create the array and write a few fragments
+  rc = create_sparse_array_2D(
+           10,
+           10,
+           0,
+           domain_size_0-1,
+           0,
+           domain_size_1-1,
+           30,
+           true,
+           TILEDB_ROW_MAJOR,
+           TILEDB_ROW_MAJOR);
+  ASSERT_EQ(rc, TILEDB_OK);
+  for(int f=0; f<fragment_num; ++f) {
+    rc = write_sparse_array_unsorted_2D(domain_size_0, domain_size_1);
+    ASSERT_EQ(rc, TILEDB_OK);
+  }
+  std::vector<std::string> fragment_dirs = get_fragment_dirs(array_name_);
+  ASSERT_EQ(fragment_dirs.size(), fragment_num);
+
+  // Empty the book-keeping file of one fragment, and then of another one
+  for(int f=1; f<3; ++f) {
+    std::string filename = 
+        fragment_dirs[f] + "/" + TILEDB_BOOK_KEEPING_FILENAME + 
+        TILEDB_FILE_SUFFIX + TILEDB_GZIP_SUFFIX;
+    rc = truncate(filename.c_str(), 0);
+    ASSERT_EQ(rc, 0);
+
+    // The initialization reports the error of the first failed fragment, and
+    // the number of the other failed fragments
+    TileDB_Array* tiledb_array;
+    tiledb_errmsg[0] = '\0';
+    rc = tiledb_array_init(
+             tiledb_ctx_,
+             &tiledb_array,
+             array_name_.c_str(),
+             TILEDB_ARRAY_READ,
+             NULL,
+             attributes,
+             2);
+    ASSERT_EQ(rc, TILEDB_ERR);
+    ASSERT_TRUE(
+        strstr(
+            tiledb_errmsg, 
+            "[TileDB::BookKeeping] Error: Cannot load book-keeping; "
+            "Reading domain size failed") != NULL);
+    ASSERT_EQ(
+        strstr(tiledb_errmsg, "1 more fragment(s) failed to load") != NULL,
+        f == 2);
+  }
+}
@@ -31,6 +31,8 @@
  */
 
 #include "utils_spec.h"
+#include <climits>
+#include <set>
 
 
 /* ****************************** */
@@ -539,3 +541,290 @@ TEST_F(UtilsTestFixture, test_RLE_coords_col) {
   ASSERT_EQ(rc, TILEDB_UT_OK);
   ASSERT_FALSE(memcmp(input, decompressed, input_size));
 }
+
+/** Tests delta and double-delta encoding. */
+TEST_F(UtilsTestFixture, test_delta) {
+  // Initializations
+  const int64_t value_num = 1000;
+  int input[value_num];
+  int encoded[value_num];
+  int64_t input_64[value_num];
+  int64_t encoded_64[value_num];
+
+  // Test delta encoding of increasing values (stride 1)
+  for(int64_t i=0; i<value_num; ++i) 
+    input[i] = 100 + 3*i;
+  delta_encode<int>(input, encoded, value_num, 1);
+  ASSERT_EQ(encoded[0], 100);
+  for(int64_t i=1; i<value_num; ++i) 
+    ASSERT_EQ(encoded[i], 3);
+  delta_decode<int>(encoded, value_num, 1);
+  ASSERT_FALSE(memcmp(input, encoded, value_num*sizeof(int)));
+
+  // Test double-delta encoding of increasing values (stride 1)
+  double_delta_encode<int>(input, encoded, value_num, 1);
+  ASSERT_EQ(encoded[0], 100);
+  ASSERT_EQ(encoded[1], 6);     // Zig-zag encoding of 3
+  for(int64_t i=2; i<value_num; ++i) 
+    ASSERT_EQ(encoded[i], 0);
+  double_delta_decode<int>(encoded, value_num, 1);
+  ASSERT_FALSE(memcmp(input, encoded, value_num*sizeof(int)));
+
+  // Test values with overflowing differences (stride 2, as in 2D coordinates)
+  for(int64_t i=0; i<value_num; ++i) 
+    input[i] = (i % 3 == 0) ? INT_MIN : ((i % 3 == 1) ? INT_MAX : -(int) i);
+  delta_encode<int>(input, encoded, value_num, 2);
+  delta_decode<int>(encoded, value_num, 2);
+  ASSERT_FALSE(memcmp(input, encoded, value_num*sizeof(int)));
+  double_delta_encode<int>(input, encoded, value_num, 2);
+  double_delta_decode<int>(encoded, value_num, 2);
+  ASSERT_FALSE(memcmp(input, encoded, value_num*sizeof(int)));
+
+  // Test 64-bit values with stride larger than the number of values
+  for(int64_t i=0; i<value_num; ++i) 
+    input_64[i] = (int64_t) i * 1000000007LL - 5;
+  delta_encode<int64_t>(input_64, encoded_64, 3, 4);
+  ASSERT_FALSE(memcmp(input_64, encoded_64, 3*sizeof(int64_t)));
+  delta_decode<int64_t>(encoded_64, 3, 4);
+  ASSERT_FALSE(memcmp(input_64, encoded_64, 3*sizeof(int64_t)));
+
+  // Test 64-bit double-delta encoding (stride 3)
+  double_delta_encode<int64_t>(input_64, encoded_64, value_num, 3);
+  for(int64_t i=6; i<value_num; ++i) 
+    ASSERT_EQ(encoded_64[i], 0);
+  double_delta_decode<int64_t>(encoded_64, value_num, 3);
+  ASSERT_FALSE(memcmp(input_64, encoded_64, value_num*sizeof(int64_t)));
+
+  // Test empty input
+  delta_encode<int>(input, encoded, 0, 1);
+  double_delta_decode<int>(encoded, 0, 1);
+}
+
+/** Tests the conversion of coordinates to and from the columnar layout. */
+TEST_F(UtilsTestFixture, test_coords_columnar) {
+  // Initializations
+  const int64_t cell_num = 5;
+  const int dim_num = 3;
+  int64_t coords[cell_num*dim_num];
+  int64_t columnar[cell_num*dim_num];
+  int64_t restored[cell_num*dim_num];
+  for(int64_t i=0; i<cell_num; ++i) 
+    for(int j=0; j<dim_num; ++j) 
+      coords[i*dim_num+j] = 10*j + i;
+
+  // Test columnar layout
+  coords_to_columnar<int64_t>(coords, columnar, cell_num, dim_num);
+  for(int j=0; j<dim_num; ++j) 
+    for(int64_t i=0; i<cell_num; ++i) 
+      ASSERT_EQ(columnar[j*cell_num+i], 10*j + i);
+
+  // Test restoring the cell layout
+  coords_from_columnar<int64_t>(columnar, restored, cell_num, dim_num);
+  ASSERT_FALSE(memcmp(coords, restored, cell_num*dim_num*sizeof(int64_t)));
+}
+
+/**
+ * Tests the coordinate comparisons and subarray checks across the specialized
+ * and the generic numbers of dimensions.
+ */
+TEST_F(UtilsTestFixture, test_coords_cmp) {
+  const int dim_num_max = 6;
+  int coords_a[dim_num_max], coords_b[dim_num_max];
+  int subarray[2*dim_num_max];
+  for(int i=0; i<dim_num_max; ++i) {
+    subarray[2*i] = 1;
+    subarray[2*i+1] = 2;
+  }
+
+  for(int dim_num=1; dim_num<=dim_num_max; ++dim_num) {
+    for(int64_t trial=0; trial<1000; ++trial) {
+      // Coordinates in [0,3] per dimension, often tied on some dimensions
+      for(int i=0; i<dim_num; ++i) {
+        coords_a[i] = (trial * 7 + i * 13) % 4;
+        coords_b[i] = (trial * 11 + i * 5 + trial / 4) % 4;
+      }
+
+      // Expected results
+      int row_cmp = 0, col_cmp = 0;
+      bool in_subarray = true;
+      for(int i=0; i<dim_num && !row_cmp; ++i)
+        row_cmp = (coords_a[i] > coords_b[i]) - (coords_a[i] < coords_b[i]);
+      for(int i=dim_num-1; i>=0 && !col_cmp; --i)
+        col_cmp = (coords_a[i] > coords_b[i]) - (coords_a[i] < coords_b[i]);
+      for(int i=0; i<dim_num; ++i)
+        if(coords_a[i] < 1 || coords_a[i] > 2)
+          in_subarray = false;
+
+      ASSERT_EQ(cmp_row_order<int>(coords_a, coords_b, dim_num), row_cmp);
+      ASSERT_EQ(cmp_col_order<int>(coords_a, coords_b, dim_num), col_cmp);
+      ASSERT_EQ(
+          cmp_row_order<int>(0, coords_a, 0, coords_b, dim_num),
+          row_cmp);
+      ASSERT_EQ(cmp_col_order<int>(1, coords_a, 0, coords_b, dim_num), 1);
+      ASSERT_EQ(
+          cell_in_subarray<int>(coords_a, subarray, dim_num),
+          in_subarray);
+    }
+  }
+}
+
+/** Tests the subarray bitmap against the check of individual cells. */
+TEST_F(UtilsTestFixture, test_cells_in_subarray) {
+  const int dim_num_max = 6;
+  const int64_t cell_num = 500;
+  int64_t cells[cell_num*dim_num_max];
+  int64_t subarray[2*dim_num_max];
+  unsigned char bitmap[cell_num];
+  for(int i=0; i<dim_num_max; ++i) {
+    subarray[2*i] = 2;
+    subarray[2*i+1] = 5;
+  }
+
+  for(int dim_num=1; dim_num<=dim_num_max; ++dim_num) {
+    // Coordinates in [0,7] per dimension
+    for(int64_t c=0; c<cell_num*dim_num; ++c)
+      cells[c] = (c * 37 + c / 3) % 8;
+
+    cells_in_subarray<int64_t>(cells, cell_num, subarray, dim_num, bitmap);
+    for(int64_t c=0; c<cell_num; ++c)
+      ASSERT_EQ(
+          bitmap[c],
+          cell_in_subarray<int64_t>(&cells[c*dim_num], subarray, dim_num));
+  }
+}
+
+/** Generates fragment ids concurrently (used by test_new_fragment_id). */
+void* generate_fragment_ids(void* data) {
+  std::vector<std::string>* fragment_ids = (std::vector<std::string>*) data;
+  for(int i=0; i<1000; ++i)
+    fragment_ids->push_back(new_fragment_id());
+  return NULL;
+}
+
+/** Tests the uniqueness and order of the generated fragment ids. */
+TEST_F(UtilsTestFixture, test_new_fragment_id) {
+  // Generate ids in several threads, all within a few milliseconds
+  const int thread_num = 4;
+  pthread_t threads[thread_num];
+  std::vector<std::string> fragment_ids[thread_num];
+  for(int t=0; t<thread_num; ++t) 
+    ASSERT_EQ(
+        pthread_create(
+            &threads[t], 
+            NULL, 
+            generate_fragment_ids, 
+            &fragment_ids[t]), 
+        0);
+  for(int t=0; t<thread_num; ++t) 
+    ASSERT_EQ(pthread_join(threads[t], NULL), 0);
+
+  // All ids are distinct, and each thread sees increasing (timestamp,
+  // sequence number) pairs
+  std::set<std::string> distinct_ids;
+  for(int t=0; t<thread_num; ++t) {
+    long long prev_ms = -1, prev_seq = -1;
+    for(int i=0; i<1000; ++i) {
+      const std::string& fragment_id = fragment_ids[t][i];
+      ASSERT_NE(fragment_id, "");
+      distinct_ids.insert(fragment_id);
+      long long ms, seq;
+      ASSERT_EQ(
+          sscanf(
+              fragment_id.substr(fragment_id.find('_') + 1).c_str(), 
+              "%lld_%lld", 
+              &ms, 
+              &seq), 
+          2);
+      ASSERT_TRUE(ms > prev_ms || (ms == prev_ms && seq > prev_seq));
+      prev_ms = ms;
+      prev_seq = seq;
+    }
+  }
+  ASSERT_EQ(distinct_ids.size(), size_t(thread_num*1000));
+}
+
+/** Tests setting bit ranges of a bitmap. */
+TEST_F(UtilsTestFixture, test_set_bitmap_range) {
+  unsigned char bitmap[5];
+  memset(bitmap, 0, sizeof(bitmap));
+
+  // Range within a single byte
+  set_bitmap_range(bitmap, 2, 5, true);
+  EXPECT_EQ(bitmap[0], 0x1c);
+
+  // Range spanning partial and whole bytes
+  set_bitmap_range(bitmap, 6, 35, true);
+  EXPECT_EQ(bitmap[0], 0xdc);
+  EXPECT_EQ(bitmap[1], 0xff);
+  EXPECT_EQ(bitmap[2], 0xff);
+  EXPECT_EQ(bitmap[3], 0xff);
+  EXPECT_EQ(bitmap[4], 0x07);
+
+  // Clearing
+  set_bitmap_range(bitmap, 3, 17, false);
+  EXPECT_EQ(bitmap[0], 0x04);
+  EXPECT_EQ(bitmap[1], 0x00);
+  EXPECT_EQ(bitmap[2], 0xfe);
+
+  // Empty range
+  set_bitmap_range(bitmap, 9, 9, true);
+  EXPECT_EQ(bitmap[1], 0x00);
+}
+
+/** Tests filling buffers with patterns and offsets. */
+TEST_F(UtilsTestFixture, test_fill) {
+  // Patterns of various sizes, copied up to and beyond the chunk size
+  const int64_t value_num = 3 * TILEDB_UT_FILL_CHUNK_SIZE / sizeof(int) + 7;
+  std::vector<int> buffer(value_num + 1, 0);
+  int pattern[] = { 1, 2, 3 };
+  for(int pattern_val_num=1; pattern_val_num<=3; ++pattern_val_num) {
+    int64_t pattern_num = value_num / pattern_val_num;
+    fill_pattern(
+        &buffer[0], 
+        pattern, 
+        pattern_val_num * sizeof(int), 
+        pattern_num);
+    int64_t mismatch_num = 0;
+    for(int64_t i=0; i<pattern_num*pattern_val_num; ++i) 
+      if(buffer[i] != pattern[i % pattern_val_num])
+        ++mismatch_num;
+    EXPECT_EQ(mismatch_num, 0);
+  }
+  EXPECT_EQ(buffer[value_num], 0);
+
+  // No patterns
+  buffer[0] = 0;
+  fill_pattern(&buffer[0], pattern, sizeof(int), 0);
+  EXPECT_EQ(buffer[0], 0);
+
+  // Offsets
+  size_t offsets[5];
+  fill_offsets(offsets, 12, 4, 5);
+  for(int i=0; i<5; ++i)
+    EXPECT_EQ(offsets[i], size_t(12 + 4*i));
+}
+
+/** Tests grouping weighted units into balanced partitions. */
+TEST_F(UtilsTestFixture, test_balanced_partitions) {
+  std::vector<int64_t> partition_starts;
+
+  // Balanced weights
+  std::vector<double> weights = { 3, 5, 5, 3 };
+  balanced_partitions(weights, 2, partition_starts);
+  ASSERT_EQ(partition_starts, std::vector<int64_t>({ 0, 2 }));
+
+  // A heavy unit gets its own partition
+  weights = { 1, 1, 10, 1, 1 };
+  balanced_partitions(weights, 3, partition_starts);
+  ASSERT_EQ(partition_starts, std::vector<int64_t>({ 0, 2, 3 }));
+
+  // Fewer units than partitions, each getting one unit
+  weights = { 0, 0, 7 };
+  balanced_partitions(weights, 5, partition_starts);
+  ASSERT_EQ(partition_starts, std::vector<int64_t>({ 0, 1, 2 }));
+
+  // Zero weights are counted as units
+  weights = { 0, 0, 0, 0 };
+  balanced_partitions(weights, 2, partition_starts);
+  ASSERT_EQ(partition_starts, std::vector<int64_t>({ 0, 2 }));
+}